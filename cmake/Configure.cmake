@@ -110,6 +110,7 @@ file(APPEND ${AUTOCONFIG_SRC} "
 #cmakedefine PACKAGE_VERSION \"${PACKAGE_VERSION}\"
 #cmakedefine GRAPHICS_DISABLED ${GRAPHICS_DISABLED}
 #cmakedefine DISABLED_LEGACY_ENGINE ${DISABLED_LEGACY_ENGINE}
+#cmakedefine DISABLED_STAGE_STATS ${DISABLED_STAGE_STATS}
 #cmakedefine HAVE_LIBARCHIVE ${HAVE_LIBARCHIVE}
 ")
 
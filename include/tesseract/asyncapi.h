@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////////////
+// File:        asyncapi.h
+// Description: Recognition in a background thread with streamed results.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_API_ASYNCAPI_H_
+#define TESSERACT_API_ASYNCAPI_H_
+
+#include "export.h"
+
+#include <functional> // for std::function
+#include <memory>     // for std::unique_ptr
+#include <string>     // for std::string
+
+namespace tesseract {
+
+class TessBaseAPI;
+
+/** A text line of the page, reported as soon as its words are recognized. */
+struct RecognizedLine {
+  /// Index of the block among the blocks of the page with recognized lines,
+  /// from 0. Blocks without text lines, such as images, are not counted.
+  int block = 0;
+  int line = 0;         ///< Index of the line in its block, from 0.
+  int left = 0;         ///< Bounding box in the coordinates of the image.
+  int top = 0;
+  int right = 0;
+  int bottom = 0;
+  float confidence = 0; ///< Mean confidence of the words, 0..100.
+  std::string text;     ///< UTF-8 text of the words, separated by spaces.
+};
+
+/**
+ * Runs TessBaseAPI::Recognize in a background thread. Each text line is
+ * reported as soon as the first recognition pass has finished it, so clients
+ * can show the first lines of a page long before the page is complete.
+ * The final results (which the legacy engine may still improve in later
+ * passes) are available from the TessBaseAPI once IsDone() returns true.
+ *
+ * Cancel() is checked before each text line is recognized, so it stops the
+ * recognition after at most one more line. Layout analysis is not
+ * interrupted.
+ *
+ * Example:
+ *   api.SetImage(pix);
+ *   TessAsyncRecognition recognition(&api);
+ *   RecognizedLine line;
+ *   while (recognition.NextLine(&line, true)) {
+ *     Show(line.text);
+ *   }
+ */
+class TESS_API TessAsyncRecognition {
+public:
+  using LineCallback = std::function<void(const RecognizedLine &line)>;
+
+  /**
+   * Starts recognizing the image which was set on the api. The api must
+   * not be used by the caller until the recognition is done. If a callback
+   * is given, it is called in the recognition thread for each line.
+   * Otherwise the lines are queued for NextLine. The recognition is stopped
+   * after timeout_millisec milliseconds if that is > 0.
+   */
+  explicit TessAsyncRecognition(TessBaseAPI *api, LineCallback callback = nullptr,
+                                int timeout_millisec = 0);
+  /** Cancels the recognition if it is still running and waits for it. */
+  ~TessAsyncRecognition();
+
+  /** Requests the recognition to stop as soon as possible. */
+  void Cancel();
+  /** Returns true if the recognition was cancelled or timed out. */
+  bool IsCancelled() const;
+  /** Returns true once the recognition has finished. */
+  bool IsDone() const;
+  /** Returns the progress of the recognition in percent. */
+  int Progress() const;
+
+  /**
+   * Waits for the recognition to finish and returns the result of
+   * TessBaseAPI::Recognize: 0 on success, -1 on failure or cancellation.
+   */
+  int Wait();
+
+  /**
+   * Takes the next queued line. If wait is true, blocks until a line is
+   * available or the recognition is done. Returns false if there is no line.
+   */
+  bool NextLine(RecognizedLine *line, bool wait);
+
+private:
+  // Converts a box from the coordinates of the thresholded image to those of
+  // the input image, as PageIterator::BoundingBox does.
+  static void ToImageCoords(const TessBaseAPI *api, int *left, int *top, int *right,
+                            int *bottom);
+
+  struct Internal;
+  std::unique_ptr<Internal> internal_;
+};
+
+} // namespace tesseract.
+
+#endif // TESSERACT_API_ASYNCAPI_H_
@@ -32,9 +32,13 @@
 
 #include <tesseract/version.h>
 
+#include <cstdint>    // for uint64_t
 #include <cstdio>
-#include <vector> // for std::vector
-#include <tuple>  // for std::tuple
+#include <functional> // for std::function
+#include <memory>     // for std::unique_ptr
+#include <string>     // for std::string
+#include <vector>     // for std::vector
+#include <tuple>      // for std::tuple
 
 struct Pix;
 struct Pixa;
@@ -53,9 +57,14 @@ class Dawg;
 class Dict;
 class EquationDetect;
 class PageIterator;
+class LogSink;
 class LTRResultIterator;
+class MemoryRecorder;
 class ResultIterator;
 class MutableIterator;
+class PageFormatter;
+class ParamsOverlay;
+class StageRecorder;
 class TessResultRenderer;
 class Tesseract;
 
@@ -322,6 +331,23 @@ public:
    */
   void SetImage(Pix *pix);
 
+  /**
+   * Provide an image for Tesseract to recognize without copying it, for
+   * callers such as video pipelines which already hold the frame in memory.
+   * Format is as the raw SetImage above, but only 8 bit greyscale
+   * (bytes_per_pixel=1) and RGB or RGBA color (bytes_per_pixel=3 or 4)
+   * are accepted, and any alpha is ignored.
+   * The data is borrowed: it must remain valid and unchanged until the next
+   * SetImage, SetImageBorrowed, Clear or End, or the destruction of the api.
+   * Thresholding reads the rectangle once and makes just the greyscale image
+   * which recognition needs, so color images are thresholded on greyscale.
+   * After thresholding, GetInputImage returns a greyscale version of the
+   * whole image, like the input image of a copied image, which is not
+   * cropped to the rectangle.
+   */
+  void SetImageBorrowed(const unsigned char *imagedata, int width, int height,
+                        int bytes_per_pixel, int bytes_per_line);
+
   /**
    * Set the resolution of the source image in pixels per inch so font size
    * information can be calculated in results.  Call this after SetImage().
@@ -462,6 +488,38 @@ public:
    */
   int Recognize(ETEXT_DESC *monitor);
 
+  /** A field of the image for RecognizeRegions. */
+  struct Region {
+    int left = 0; ///< Rectangle in the coordinates used by SetRectangle.
+    int top = 0;
+    int width = 0;
+    int height = 0;
+    /** Page segmentation mode of the region. */
+    PageSegMode psm = PSM_SINGLE_LINE;
+    /** tessedit_char_whitelist for the region. Empty uses the current one. */
+    std::string whitelist;
+  };
+  /** The result of a Region. */
+  struct RegionResult {
+    bool ok = false;         ///< False if the region could not be recognized.
+    std::string text;        ///< UTF-8 text, words separated by spaces.
+    int mean_confidence = 0; ///< Mean word confidence, as MeanTextConf.
+  };
+
+  /**
+   * Recognizes many regions of the image which was set by SetImage, such as
+   * the fields of a form, and stores one result per region in *results.
+   * The image is thresholded once for all regions. With the LSTM engine,
+   * regions with PSM_SINGLE_LINE, PSM_RAW_LINE or PSM_SINGLE_WORD skip layout
+   * analysis: each of them is recognized as a single text line, and all such
+   * regions with the same whitelist are recognized in one pass. Other
+   * regions are recognized like SetRectangle and Recognize would.
+   * Afterwards the rectangle is restored and the recognition results are
+   * cleared. Returns 0 if all regions were recognized, -1 otherwise.
+   */
+  int RecognizeRegions(const std::vector<Region> &regions, std::vector<RegionResult> *results,
+                       ETEXT_DESC *monitor = nullptr);
+
   /**
    * Methods to retrieve information after SetAndThresholdImage(),
    * Recognize() or TesseractRect(). (Recognize is called implicitly if needed.)
@@ -507,6 +565,28 @@ public:
   bool ProcessPage(Pix *pix, int page_index, const char *filename, const char *retry_config,
                    int timeout_millisec, TessResultRenderer *renderer);
 
+  /**
+   * Recognizes the page of a replay bundle again, to investigate why it was
+   * slow or failed. ProcessPage writes a bundle to the directory replay_dir
+   * for each page which fails, takes replay_min_seconds or more, or needs
+   * replay_min_mb (if > 0) or more of memory. <name> is the name of the
+   * input file without extension and the page index, like "scan-0", with
+   * "-2", "-3", ... added if a bundle of that name exists already.
+   * The bundle is the manifest <name>.replay, the page image <name>.png,
+   * its thresholded image
+   * <name>.bin.png and the variables which differ from their defaults in the
+   * config file <name>.config. The manifest names these and holds the
+   * languages, the engine mode, the versions of the models and the stage
+   * times and memory of the page.
+   *
+   * Initializes this api as the one which wrote the bundle, from datapath if
+   * not nullptr, else from the datapath in the manifest, and processes the
+   * page. If profile_file is not nullptr, the page is profiled and the
+   * profile is written to it as for the variable profile_file.
+   * Returns false if the bundle could not be read or the page failed.
+   */
+  bool ReplayPage(const char *manifest, const char *datapath, const char *profile_file);
+
   /**
    * Get a reading-order iterator to the results of LayoutAnalysis and/or
    * Recognize. The returned iterator must be deleted after use.
@@ -673,9 +753,143 @@ public:
    * freeing any recognition data that would be time-consuming to reload.
    * Afterwards, you must call SetImage or TesseractRect before doing
    * any Recognize or Get* operation.
+   * The storage of the deleted results is kept by the calling thread and
+   * reused for the results of the next page, see GetAllocatorStats.
    */
   void Clear();
 
+  /** Allocation counts of one kind of page result object. */
+  struct AllocatorStats {
+    const char *name;       ///< Class of the objects, such as "WERD_RES".
+    size_t object_size;     ///< Size of an object in bytes.
+    uint64_t allocated;     ///< Objects made in new storage from the heap.
+    uint64_t reused;        ///< Objects made in the storage of deleted ones.
+    uint64_t recycled;      ///< Deleted objects whose storage was kept.
+    uint64_t released;      ///< Deleted objects whose storage was freed.
+    size_t cached;          ///< Storage blocks kept at the moment.
+    size_t peak_cached;     ///< Most storage blocks kept at any time.
+  };
+
+  /**
+   * Returns the allocation counts of the page result objects (PAGE_RES,
+   * BLOCK_RES, ROW_RES, WERD_RES, WERD_CHOICE and BLOB_CHOICE) in the
+   * calling thread. The storage of deleted objects is kept for reuse up to
+   * recycler_max_objects objects of each kind.
+   */
+  static std::vector<AllocatorStats> GetAllocatorStats();
+
+  /**
+   * Frees the storage of deleted page result objects which the calling
+   * thread keeps for reuse.
+   */
+  static void ReleaseRecycledMemory();
+
+  /**
+   * Time spent in one stage of the recognition, or the value of a counter.
+   * The stages are "threshold", "layout", "lstm_forward", "beam_search",
+   * "legacy_classify", "post_passes", "paragraphs" and "render". Stages may
+   * run inside others, like "legacy_classify" in "post_passes" or the
+   * recognition in "render" when a renderer starts it, but the time of the
+   * inner stage is not counted in the outer one, so the times of the stages
+   * add up to the time which is accounted for. The counters are "pages",
+   * "lstm_lines", "lstm_timesteps", "words", for the layout analysis
+   * "partition_passes", "partition_visits" and "merge_candidates", and
+   * "skipped_passes", the passes which were skipped because
+   * tessedit_output_profile or paragraph_detection say that the outputs do
+   * not need them. The time of "skipped_passes" is the time saved, estimated
+   * from the mean time of each pass on the pages on which it ran. To have
+   * such pages, a pass which the profile skips still runs on the first page
+   * and then after every 100 skips, without changing the output. The time is
+   * -1 (unknown) if none of the skipped passes has run, which happens if
+   * paragraph_detection is off.
+   */
+  struct StageStats {
+    const char *name;     ///< Name of the stage or counter.
+    bool is_counter;      ///< Counters have no time, except skipped_passes.
+    double page_seconds;  ///< Time spent on the current page.
+    double total_seconds; ///< Time spent since the api was made or reset.
+    uint64_t page_count;  ///< Runs of the stage or counted events on the page.
+    uint64_t total_count; ///< Runs or events since the api was made or reset.
+  };
+
+  /**
+   * Returns the time spent in each stage and the counters, for the current
+   * page (since the last SetImage) and in total. Pages which ProcessPages
+   * recognizes with pipeline_workers count in the totals of this api.
+   * Returns only zeros if Tesseract was built with DISABLED_STAGE_STATS.
+   */
+  std::vector<StageStats> GetStageStats() const;
+
+  /**
+   * Returns the values of GetStageStats as a JSON object:
+   * {"page":{"threshold":{"seconds":0.012,"calls":1},...,"pages":1,...,
+   *  "saved_seconds":0.004},"total":{...}}
+   */
+  std::string GetStageStatsJSON() const;
+
+  /** Clears the times and counters of the page and the totals. */
+  void ResetStageStats();
+
+  /**
+   * Returns a table of the layers of the LSTM network of each language, with
+   * the time spent in each and estimates of its arithmetic and memory
+   * traffic, summed over the lines recognized while the variable
+   * lstm_profile_layers was set. Returns an empty string if no language has
+   * been profiled. Pages which ProcessPages recognizes with pipeline_workers
+   * are not included.
+   */
+  std::string GetLSTMLayerProfile() const;
+
+  /**
+   * Bytes used by a subsystem of this api. The subsystems are
+   * "lstm_weights", "lstm_scratch", "unicharsets", "dictionaries",
+   * "legacy_templates", "images", "grids" and "page_res", followed by their
+   * "total" and "dawg_cache", the dawgs shared by all apis of the process.
+   * The sizes are those of the data of the structures, not of the heap.
+   */
+  struct MemoryStats {
+    const char *name;  ///< Name of the subsystem.
+    size_t bytes;      ///< Bytes used now.
+    size_t page_peak;  ///< Most bytes used on the current page.
+    size_t peak;       ///< Most bytes used since the api was made or reset.
+  };
+
+  /**
+   * Measures the memory of the models, the images and the results now.
+   * Init, SetImage and Recognize measure it, so call this only to see the
+   * effect of other changes, such as freeing the results with Clear.
+   */
+  void MeasureMemory();
+
+  /**
+   * Returns the memory used by the subsystems of this api, as of the last
+   * measurement, and its peaks while the current page (since the last
+   * SetImage) was recognized. The grids are charged as they are made and
+   * freed, and only if Tesseract was not built with DISABLED_STAGE_STATS.
+   * Pages which ProcessPages recognizes with pipeline_workers are not
+   * included.
+   */
+  std::vector<MemoryStats> GetMemoryStats() const;
+
+  /**
+   * Returns the values of GetMemoryStats as a JSON object:
+   * {"lstm_weights":{"bytes":1234,"page_peak":1234,"peak":1234},...,
+   *  "total":{...},"dawg_cache":{...}}
+   */
+  std::string GetMemoryStatsJSON() const;
+
+  /** Sets the peaks of the page and the totals to the current bytes. */
+  void ResetMemoryPeaks();
+
+  /**
+   * Sends the log messages of the work of this api to sink instead of the
+   * default destination (debug_file or stderr). Messages of the shared
+   * parts, such as loading a shared dictionary, may still go to the
+   * default. The sink remains owned by the caller and must live until it
+   * is replaced or the api is deleted. nullptr restores the default.
+   */
+  void SetLogSink(LogSink *sink);
+
   /**
    * Close down tesseract and free up all memory. End() is equivalent to
    * destructing and reconstructing your TessBaseAPI.
@@ -802,6 +1016,11 @@ protected:
   std::string language_;             ///< Last initialized language.
   OcrEngineMode last_oem_requested_; ///< Last ocr language mode requested.
   bool recognition_done_;            ///< page_res_ contains recognition data.
+  StageRecorder *stage_recorder_;    ///< Time of the stages of recognition.
+  MemoryRecorder *memory_recorder_;  ///< Memory of the subsystems.
+  LogSink *log_sink_;                ///< Destination of the log messages.
+  ParamsOverlay *retry_overlay_;     ///< Variables of retry_config_.
+  std::string retry_config_;         ///< Config file of retry_overlay_.
 
   /**
    * @defgroup ThresholderParams Thresholder Parameters
@@ -817,6 +1036,28 @@ protected:
   /* @} */
 
 private:
+  // Needs the image rectangle and scale to report lines in image coordinates.
+  friend class TessAsyncRecognition;
+  // Renders the pages of all its chained renderers with RenderPage.
+  friend class TessResultRenderer;
+
+  // Walks the results once and passes each position to all the given
+  // formatters, recognizing the page first if needed. Returns false if
+  // there is no recognition result.
+  bool RenderPage(ETEXT_DESC *monitor, const std::vector<PageFormatter *> &formatters);
+
+  // Writes the replay bundle of the page which ProcessPage just processed,
+  // for the given reason ("failed", "seconds" or "memory").
+  void WriteReplayBundle(Pix *pix, int page_index, const char *filename, double seconds,
+                         const char *reason);
+
+  // Recognizes the given regions, which all have a single line page
+  // segmentation mode, as text lines in a single pass over a block list
+  // made for them. The image must be thresholded already.
+  bool RecognizeLineRegions(const std::vector<Region> &regions,
+                            const std::vector<size_t> &indices, ETEXT_DESC *monitor,
+                            std::vector<RegionResult> *results);
+
   // A list of image filenames gets special consideration
   bool ProcessPagesFileList(FILE *fp, std::string *buf, const char *retry_config,
                             int timeout_millisec, TessResultRenderer *renderer,
@@ -825,6 +1066,24 @@ private:
   bool ProcessPagesMultipageTiff(const unsigned char *data, size_t size, const char *filename,
                                  const char *retry_config, int timeout_millisec,
                                  TessResultRenderer *renderer, int tessedit_page_number);
+
+  // Supplies the decoded pages of a document one at a time, in page order.
+  // Returns nullptr at the end of the input or if a page could not be read.
+  using PageSource = std::function<Pix *(int *page_index, std::string *filename)>;
+
+  // Returns the recognition workers to be used for pipelined processing of
+  // a multi-page document, or an empty vector if the pages have to be
+  // processed sequentially by this instance (pipeline_workers is 0, a single
+  // page was requested, or a worker could not be initialized).
+  std::vector<std::unique_ptr<TessBaseAPI>> CreatePipelineWorkers(const char *retry_config,
+                                                                  int tessedit_page_number);
+  // Processes all pages from next_page with a look-ahead decoder thread and
+  // one recognition thread per worker. The renderer is fed in page order.
+  // If set_applybox_page, the applybox_page variable of each worker is set to
+  // the page index before recognition, as ProcessPagesMultipageTiff does.
+  bool ProcessPagesPipelined(const std::vector<std::unique_ptr<TessBaseAPI>> &workers,
+                             const PageSource &next_page, bool set_applybox_page,
+                             int timeout_millisec, TessResultRenderer *renderer);
 }; // class TessBaseAPI.
 
 /** Escape a char string - remove &<>"' with HTML codes. */
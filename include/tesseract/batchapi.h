@@ -0,0 +1,139 @@
+///////////////////////////////////////////////////////////////////////
+// File:        batchapi.h
+// Description: Recognition of many images on a pool of worker threads.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_API_BATCHAPI_H_
+#define TESSERACT_API_BATCHAPI_H_
+
+#include "export.h"
+#include "publictypes.h"
+
+#include <functional> // for std::function
+#include <future>     // for std::future
+#include <memory>     // for std::unique_ptr
+#include <string>     // for std::string
+#include <utility>    // for std::pair
+#include <vector>     // for std::vector
+
+struct Pix;
+
+namespace tesseract {
+
+class TessBaseAPI;
+
+/**
+ * Runs the recognition of many independent images on an internal pool of
+ * worker threads. All workers use the same traineddata and the same
+ * initial parameters, and each item can override the page segmentation
+ * mode, the rectangles to recognize and any non-init variables which are
+ * not global.
+ *
+ * Example:
+ *   TessBatchAPI batch;
+ *   batch.Init(nullptr, "eng", OEM_DEFAULT, 4);
+ *   TessBatchAPI::Item item;
+ *   item.pix = pix;
+ *   std::future<TessBatchAPI::Result> result = batch.Submit(item);
+ *   printf("%s", result.get().text.c_str());
+ */
+class TESS_API TessBatchAPI {
+public:
+  /** A rectangle of the image, in the coordinates used by SetRectangle. */
+  struct Rectangle {
+    int left;
+    int top;
+    int width;
+    int height;
+  };
+
+  /** One image to recognize with its own settings. */
+  struct Item {
+    /**
+     * The image to recognize. The batch takes a clone of it, so the caller
+     * may destroy its pix as soon as Submit returns.
+     */
+    Pix *pix = nullptr;
+    /**
+     * Alternatively an image file in memory, in any format supported by
+     * Leptonica. It is copied by Submit and decoded by the worker.
+     */
+    std::string data;
+    /** Page segmentation mode, or PSM_COUNT to use the initial one. */
+    PageSegMode psm = PSM_COUNT;
+    /**
+     * Rectangles to recognize. The whole image if empty, or for a rectangle
+     * without width or height.
+     */
+    std::vector<Rectangle> rectangles;
+    /**
+     * Variables set for this item only, as name/value pairs. Global
+     * variables, which all workers share, cannot be set per item and are
+     * ignored with a warning.
+     */
+    std::vector<std::pair<std::string, std::string>> variables;
+  };
+
+  /** The outcome of one item. */
+  struct Result {
+    int id = -1;                  ///< Returned by Submit, in submission order.
+    bool ok = false;              ///< False if the image could not be read or recognized.
+    std::string text;             ///< UTF-8 text, rectangles in the given order.
+    int mean_confidence = 0;      ///< Mean text confidence, 0..100.
+    double queue_seconds = 0;     ///< Time from Submit until a worker took the item.
+    double decode_seconds = 0;    ///< Time to decode the image data, if any.
+    double recognize_seconds = 0; ///< Time for layout analysis and recognition.
+  };
+
+  /**
+   * Called by the worker thread which recognized the item. The api holds the
+   * results of the item (of its last rectangle if there are several) and may
+   * be used to get further output such as iterators or hOCR, but only until
+   * the callback returns. It is nullptr if the image could not be read.
+   */
+  using Callback = std::function<void(const Result &result, TessBaseAPI *api)>;
+
+  TessBatchAPI();
+  /** Waits for all submitted items, then stops the workers. */
+  ~TessBatchAPI();
+
+  /**
+   * Starts num_workers worker threads (the number of hardware threads if
+   * num_workers <= 0), each initialized like TessBaseAPI::Init with the given
+   * arguments. Returns 0 on success and -1 on initialization failure.
+   * Must be called once, before any Submit.
+   */
+  int Init(const char *datapath, const char *language, OcrEngineMode oem, int num_workers,
+           const std::vector<std::string> *vars_vec = nullptr,
+           const std::vector<std::string> *vars_values = nullptr);
+
+  /** Queues an item and returns a future for its result. */
+  std::future<Result> Submit(const Item &item);
+  /** Queues an item and returns its id. The callback may be empty. */
+  int Submit(const Item &item, Callback callback);
+
+  /** Blocks until all submitted items have been processed. */
+  void Wait();
+
+  /** Returns the number of worker threads, 0 before a successful Init. */
+  int NumWorkers() const;
+
+private:
+  struct Internal;
+  std::unique_ptr<Internal> internal_;
+};
+
+} // namespace tesseract.
+
+#endif // TESSERACT_API_BATCHAPI_H_
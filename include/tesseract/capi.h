@@ -21,7 +21,9 @@
 #include "export.h"
 
 #ifdef __cplusplus
+#  include <tesseract/asyncapi.h>
 #  include <tesseract/baseapi.h>
+#  include <tesseract/batchapi.h>
 #  include <tesseract/ocrclass.h>
 #  include <tesseract/pageiterator.h>
 #  include <tesseract/renderer.h>
@@ -57,6 +59,10 @@ typedef tesseract::WritingDirection TessWritingDirection;
 typedef tesseract::TextlineOrder TessTextlineOrder;
 typedef tesseract::PolyBlockType TessPolyBlockType;
 typedef tesseract::ETEXT_DESC ETEXT_DESC;
+typedef tesseract::TessBatchAPI TessBatchAPI;
+typedef tesseract::TessBatchAPI::Item TessBatchItem;
+typedef tesseract::TessBatchAPI::Result TessBatchResult;
+typedef tesseract::TessAsyncRecognition TessAsyncRecognition;
 #else
 typedef struct TessResultRenderer TessResultRenderer;
 typedef struct TessBaseAPI TessBaseAPI;
@@ -135,10 +141,18 @@ typedef enum TessTextlineOrder {
   TEXTLINE_ORDER_TOP_TO_BOTTOM
 } TessTextlineOrder;
 typedef struct ETEXT_DESC ETEXT_DESC;
+typedef struct TessBatchAPI TessBatchAPI;
+typedef struct TessBatchItem TessBatchItem;
+typedef struct TessBatchResult TessBatchResult;
+typedef struct TessAsyncRecognition TessAsyncRecognition;
 #endif
 
 typedef bool (*TessCancelFunc)(void *cancel_this, int words);
 typedef bool (*TessProgressFunc)(ETEXT_DESC *ths, int left, int right, int top, int bottom);
+typedef void (*TessBatchCallback)(const TessBatchResult *result, TessBaseAPI *api,
+                                  void *user_data);
+typedef void (*TessLineFunc)(int block, int line, int left, int top, int right, int bottom,
+                             float confidence, const char *text, void *user_data);
 
 struct Pix;
 struct Boxa;
@@ -239,6 +253,9 @@ TESS_API void TessBaseAPIClearAdaptiveClassifier(TessBaseAPI *handle);
 TESS_API void TessBaseAPISetImage(TessBaseAPI *handle, const unsigned char *imagedata, int width,
                                   int height, int bytes_per_pixel, int bytes_per_line);
 TESS_API void TessBaseAPISetImage2(TessBaseAPI *handle, struct Pix *pix);
+TESS_API void TessBaseAPISetImageBorrowed(TessBaseAPI *handle, const unsigned char *imagedata,
+                                          int width, int height, int bytes_per_pixel,
+                                          int bytes_per_line);
 
 TESS_API void TessBaseAPISetSourceResolution(TessBaseAPI *handle, int ppi);
 
@@ -302,6 +319,9 @@ TESS_API BOOL TessBaseAPIAdaptToWordStr(TessBaseAPI *handle, TessPageSegMode mod
 TESS_API void TessBaseAPIClear(TessBaseAPI *handle);
 TESS_API void TessBaseAPIEnd(TessBaseAPI *handle);
 
+TESS_API char *TessBaseAPIGetStageStatsJSON(TessBaseAPI *handle);
+TESS_API void TessBaseAPIResetStageStats(TessBaseAPI *handle);
+
 TESS_API int TessBaseAPIIsValidWord(TessBaseAPI *handle, const char *word);
 TESS_API BOOL TessBaseAPIGetTextDirection(TessBaseAPI *handle, int *out_offset, float *out_slope);
 
@@ -412,6 +432,49 @@ TESS_API void TessMonitorSetProgressFunc(ETEXT_DESC *monitor, TessProgressFunc p
 TESS_API int TessMonitorGetProgress(ETEXT_DESC *monitor);
 TESS_API void TessMonitorSetDeadlineMSecs(ETEXT_DESC *monitor, int deadline);
 
+/* Asynchronous recognition */
+
+TESS_API TessAsyncRecognition *TessBaseAPIRecognizeAsync(TessBaseAPI *handle,
+                                                         int timeout_millisec,
+                                                         TessLineFunc callback, void *user_data);
+TESS_API void TessAsyncRecognitionDelete(TessAsyncRecognition *handle);
+TESS_API void TessAsyncRecognitionCancel(TessAsyncRecognition *handle);
+TESS_API BOOL TessAsyncRecognitionIsCancelled(const TessAsyncRecognition *handle);
+TESS_API BOOL TessAsyncRecognitionIsDone(const TessAsyncRecognition *handle);
+TESS_API int TessAsyncRecognitionProgress(const TessAsyncRecognition *handle);
+TESS_API int TessAsyncRecognitionWait(TessAsyncRecognition *handle);
+TESS_API char *TessAsyncRecognitionNextLine(TessAsyncRecognition *handle, BOOL wait, int *block,
+                                            int *line, int *left, int *top, int *right,
+                                            int *bottom, float *confidence);
+
+/* Batch API */
+
+TESS_API TessBatchAPI *TessBatchAPICreate();
+TESS_API void TessBatchAPIDelete(TessBatchAPI *handle);
+TESS_API int TessBatchAPIInit(TessBatchAPI *handle, const char *datapath, const char *language,
+                              TessOcrEngineMode oem, int num_workers);
+TESS_API int TessBatchAPISubmit(TessBatchAPI *handle, const TessBatchItem *item,
+                                TessBatchCallback callback, void *user_data);
+TESS_API void TessBatchAPIWait(TessBatchAPI *handle);
+TESS_API int TessBatchAPINumWorkers(const TessBatchAPI *handle);
+
+TESS_API TessBatchItem *TessBatchItemCreate();
+TESS_API void TessBatchItemDelete(TessBatchItem *item);
+TESS_API void TessBatchItemSetImage(TessBatchItem *item, struct Pix *pix);
+TESS_API void TessBatchItemSetImageData(TessBatchItem *item, const unsigned char *data,
+                                       size_t size);
+TESS_API void TessBatchItemSetPageSegMode(TessBatchItem *item, TessPageSegMode mode);
+TESS_API void TessBatchItemAddRectangle(TessBatchItem *item, int left, int top, int width,
+                                        int height);
+TESS_API void TessBatchItemSetVariable(TessBatchItem *item, const char *name, const char *value);
+
+TESS_API int TessBatchResultId(const TessBatchResult *result);
+TESS_API BOOL TessBatchResultSucceeded(const TessBatchResult *result);
+TESS_API const char *TessBatchResultText(const TessBatchResult *result);
+TESS_API int TessBatchResultMeanTextConf(const TessBatchResult *result);
+TESS_API void TessBatchResultTimes(const TessBatchResult *result, double *queue_seconds,
+                                   double *decode_seconds, double *recognize_seconds);
+
 #ifdef __cplusplus
 }
 #endif
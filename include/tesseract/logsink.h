@@ -0,0 +1,62 @@
+///////////////////////////////////////////////////////////////////////
+// File:        logsink.h
+// Description: Destination of the log messages of Tesseract.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_API_LOGSINK_H_
+#define TESSERACT_API_LOGSINK_H_
+
+#include "export.h"
+
+#include <cstddef> // for size_t
+#include <cstdint> // for uint32_t
+
+namespace tesseract {
+
+/** Severity of a log message. Lower values are more severe. */
+enum TessLogLevel {
+  TESS_LOG_ERROR,   ///< Something failed.
+  TESS_LOG_WARNING, ///< Something is unusual, but the work goes on.
+  TESS_LOG_INFO,    ///< Progress and results, the default of tprintf.
+  TESS_LOG_DEBUG,   ///< Output of the debug variables.
+};
+
+/** A log message with its context. */
+struct LogRecord {
+  TessLogLevel level;
+  uint32_t thread;    ///< Small number of the thread, in order of first use.
+  double seconds;     ///< Time since the first message of the process.
+  const char *text;   ///< The formatted message, usually ending with '\n'.
+  size_t length;      ///< Length of text.
+};
+
+/**
+ * Receives the log messages of a TessBaseAPI, see TessBaseAPI::SetLogSink.
+ * Without a sink of its own, messages go to the file named by the variable
+ * debug_file or to stderr.
+ * Write is called one message at a time and in the order of the messages
+ * of each thread, by a background thread if the variable log_async is set,
+ * so it need not be thread safe, but must not log itself.
+ */
+class TESS_API LogSink {
+public:
+  virtual ~LogSink();
+  virtual void Write(const LogRecord &record) = 0;
+  /** Called after the pending messages have been written. */
+  virtual void Flush() {}
+};
+
+} // namespace tesseract.
+
+#endif // TESSERACT_API_LOGSINK_H_
@@ -23,6 +23,7 @@
 // To avoid collision with other typenames include the ABSOLUTE MINIMUM
 // complexity of includes here. Use forward declarations wherever possible
 // and hide includes of complex types in baseapi.cpp.
+#include <memory> // for std::unique_ptr
 #include <string> // for std::string
 #include <vector> // for std::vector
 
@@ -216,6 +217,14 @@ public:
   // datadir is the location of the TESSDATA. We need it because
   // we load a custom PDF font from this location.
   TessPDFRenderer(const char *outputbase, const char *datadir, bool textonly = false);
+  ~TessPDFRenderer() override;
+
+  // Returns the index of the first page whose image could not be encoded,
+  // or -1. With pdf_encode_threads, the failure shows when the page is
+  // written, which may be during a later AddImage or EndDocument.
+  int failed_page() const {
+    return failed_page_;
+  }
 
 protected:
   bool BeginDocumentHandler() override;
@@ -233,6 +242,22 @@ private:
   std::vector<long int> pages_;   // object number for every /Page object
   std::string datadir_;           // where to find the custom font
   bool textonly_;                 // skip images if set
+  // Pages whose objects are written as soon as their image is encoded
+  // in the background, in page order.
+  struct PendingPage;
+  std::vector<std::unique_ptr<PendingPage>> pending_;
+  // The background threads, started when the first image is encoded.
+  class ImageEncoder;
+  std::unique_ptr<ImageEncoder> encoder_;
+  // Time spent in the stages of the rendering, for pdf_report_timings.
+  double text_seconds_;   // text layer
+  double image_seconds_;  // image encoding, also in background threads
+  double wait_seconds_;   // waiting for background image encoding
+  double write_seconds_;  // writing the objects
+  int passthrough_images_; // images copied from the input file
+  int failed_page_;        // first page whose image failed, or -1
+  // Writes the objects of the oldest pending page, waiting for its image.
+  bool WritePendingPage();
   // Bookkeeping only. DIY = Do It Yourself.
   void AppendPDFObjectDIY(size_t objectsize);
   // Bookkeeping + emit data.
@@ -54,6 +54,28 @@ public:
   void SetImage(const unsigned char *imagedata, int width, int height, int bytes_per_pixel,
                 int bytes_per_line);
 
+  /// SetImageBorrowed uses the image data in place instead of copying it.
+  /// The data must remain valid and unchanged until the next SetImage,
+  /// SetImageBorrowed or Clear, or the destruction of the thresholder.
+  /// Greyscale of 8 bits (bytes_per_pixel=1) and color of 24 or 32 bits
+  /// per pixel in RGB(A) byte order may be given. Alpha is ignored.
+  /// Only the rectangle is read, once per thresholding, into a greyscale Pix
+  /// which serves as the source image from then on. Color images are
+  /// thresholded on that greyscale image instead of channel by channel.
+  void SetImageBorrowed(const unsigned char *imagedata, int width, int height,
+                        int bytes_per_pixel, int bytes_per_line);
+
+  /// Return true if the image data is borrowed from the caller.
+  bool IsBorrowed() const {
+    return borrowed_data_ != nullptr;
+  }
+
+  /// Returns a greyscale version of the whole borrowed image, not only of
+  /// the rectangle, as the input image which SetImage keeps for a copied
+  /// image. Returns nullptr if no image is borrowed.
+  /// The returned Pix must be pixDestroyed.
+  Pix *GetBorrowedImageGrey();
+
   /// Store the coordinates of the rectangle to process for later use.
   /// Doesn't actually do any thresholding.
   void SetRectangle(int left, int top, int width, int height);
@@ -164,6 +186,15 @@ protected:
   void ThresholdRectToPix(Pix *src_pix, int num_channels, const int *thresholds,
                           const int *hi_values, Pix **pix) const;
 
+private:
+  /// Otsu thresholds the rectangle of the borrowed image via its greyscale
+  /// version, reading the borrowed data only once.
+  void ThresholdBorrowedToPix(Pix **pix);
+  /// Converts a rectangle of the borrowed image data to a new greyscale
+  /// Pix with the source resolution, computing its histogram in the same
+  /// pass.
+  Pix *BorrowedRectToGrey(int left, int top, int width, int height, int *histogram) const;
+
 protected:
   /// Clone or other copy of the source Pix.
   /// The pix will always be PixDestroy()ed on destruction of the class.
@@ -181,6 +212,13 @@ protected:
   int rect_top_;
   int rect_width_;
   int rect_height_;
+  /// Caller owned image data given to SetImageBorrowed, or nullptr.
+  const unsigned char *borrowed_data_;
+  int borrowed_bytes_per_pixel_;
+  int borrowed_bytes_per_line_;
+  /// Greyscale version of the rectangle of the borrowed image, made by
+  /// ThresholdToPix or GetPixRect.
+  Pix *borrowed_grey_;
 };
 
 } // namespace tesseract.
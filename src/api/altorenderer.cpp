@@ -13,41 +13,38 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#ifdef _WIN32
-#  include "host.h" // windows.h for MultiByteToWideChar, ...
-#endif
-
 #include <tesseract/baseapi.h>
 #include <tesseract/renderer.h>
+#include <tesseract/resultiterator.h>
+#include "pagerenderer.h" // for AltoFormatter, BufferedWriter
 
+#include <cstring> // for strcpy
 #include <memory>
-#include <sstream> // for std::stringstream
 
 namespace tesseract {
 
 /// Add coordinates to specified TextBlock, TextLine or String bounding box.
 /// Add word confidence if adding to a String bounding box.
 ///
-static void AddBoxToAlto(const ResultIterator *it, PageIteratorLevel level,
-                         std::stringstream &alto_str) {
+void AltoFormatter::AddBox(const ResultIterator &it, PageIteratorLevel level) {
   int left, top, right, bottom;
-  it->BoundingBox(level, &left, &top, &right, &bottom);
+  it.BoundingBox(level, &left, &top, &right, &bottom);
 
   int hpos = left;
   int vpos = top;
   int height = bottom - top;
   int width = right - left;
 
-  alto_str << " HPOS=\"" << hpos << "\"";
-  alto_str << " VPOS=\"" << vpos << "\"";
-  alto_str << " WIDTH=\"" << width << "\"";
-  alto_str << " HEIGHT=\"" << height << "\"";
+  *out_ << " HPOS=\"" << hpos << "\"";
+  *out_ << " VPOS=\"" << vpos << "\"";
+  *out_ << " WIDTH=\"" << width << "\"";
+  *out_ << " HEIGHT=\"" << height << "\"";
 
   if (level == RIL_WORD) {
-    int wc = it->Confidence(RIL_WORD);
-    alto_str << " WC=\"0." << wc << "\"";
+    int wc = it.Confidence(RIL_WORD);
+    *out_ << " WC=\"0." << wc << "\"";
   } else {
-    alto_str << ">";
+    *out_ << ">";
   }
 }
 
@@ -122,123 +119,96 @@ char *TessBaseAPI::GetAltoText(int page_number) {
   return GetAltoText(nullptr, page_number);
 }
 
-///
-/// Make an XML-formatted string with ALTO markup from the internal
-/// data structures.
-///
-char *TessBaseAPI::GetAltoText(ETEXT_DESC *monitor, int page_number) {
-  if (tesseract_ == nullptr || (page_res_ == nullptr && Recognize(monitor) < 0)) {
-    return nullptr;
-  }
-
-  int lcnt = 0, tcnt = 0, bcnt = 0, wcnt = 0;
+void AltoFormatter::BeginPage(const PageInfo &page) {
+  *out_ << "\t\t<Page WIDTH=\"" << page.width << "\" HEIGHT=\"" << page.height
+        << "\" PHYSICAL_IMG_NR=\"" << page_number_ << "\""
+        << " ID=\"page_" << page_number_ << "\">\n"
+        << "\t\t\t<PrintSpace HPOS=\"0\" VPOS=\"0\""
+        << " WIDTH=\"" << page.width << "\""
+        << " HEIGHT=\"" << page.height << "\">\n";
+}
 
-  if (input_file_.empty()) {
-    SetInputName(nullptr);
+void AltoFormatter::BeginElement(const ResultIterator &it, PageIteratorLevel level) {
+  switch (level) {
+    case RIL_BLOCK:
+      *out_ << "\t\t\t\t<ComposedBlock ID=\"cblock_" << bcnt_ << "\"";
+      break;
+    case RIL_PARA:
+      *out_ << "\t\t\t\t\t<TextBlock ID=\"block_" << tcnt_ << "\"";
+      break;
+    case RIL_TEXTLINE:
+      *out_ << "\t\t\t\t\t\t<TextLine ID=\"line_" << lcnt_ << "\"";
+      break;
+    default:
+      return;
   }
+  AddBox(it, level);
+  *out_ << "\n";
+}
 
-#ifdef _WIN32
-  // convert input name from ANSI encoding to utf-8
-  int str16_len = MultiByteToWideChar(CP_ACP, 0, input_file_.c_str(), -1, nullptr, 0);
-  wchar_t *uni16_str = new WCHAR[str16_len];
-  str16_len = MultiByteToWideChar(CP_ACP, 0, input_file_.c_str(), -1, uni16_str, str16_len);
-  int utf8_len =
-      WideCharToMultiByte(CP_UTF8, 0, uni16_str, str16_len, nullptr, 0, nullptr, nullptr);
-  char *utf8_str = new char[utf8_len];
-  WideCharToMultiByte(CP_UTF8, 0, uni16_str, str16_len, utf8_str, utf8_len, nullptr, nullptr);
-  input_file_ = utf8_str;
-  delete[] uni16_str;
-  delete[] utf8_str;
-#endif
-
-  std::stringstream alto_str;
-  // Use "C" locale (needed for int values larger than 999).
-  alto_str.imbue(std::locale::classic());
-  alto_str << "\t\t<Page WIDTH=\"" << rect_width_ << "\" HEIGHT=\"" << rect_height_
-           << "\" PHYSICAL_IMG_NR=\"" << page_number << "\""
-           << " ID=\"page_" << page_number << "\">\n"
-           << "\t\t\t<PrintSpace HPOS=\"0\" VPOS=\"0\""
-           << " WIDTH=\"" << rect_width_ << "\""
-           << " HEIGHT=\"" << rect_height_ << "\">\n";
-
-  ResultIterator *res_it = GetIterator();
-  while (!res_it->Empty(RIL_BLOCK)) {
-    if (res_it->Empty(RIL_WORD)) {
-      res_it->Next(RIL_WORD);
-      continue;
-    }
-
-    if (res_it->IsAtBeginningOf(RIL_BLOCK)) {
-      alto_str << "\t\t\t\t<ComposedBlock ID=\"cblock_" << bcnt << "\"";
-      AddBoxToAlto(res_it, RIL_BLOCK, alto_str);
-      alto_str << "\n";
-    }
+void AltoFormatter::BeginWord(const ResultIterator &it) {
+  *out_ << "\t\t\t\t\t\t\t<String ID=\"string_" << wcnt_ << "\"";
+  AddBox(it, RIL_WORD);
+  *out_ << " CONTENT=\"";
 
-    if (res_it->IsAtBeginningOf(RIL_PARA)) {
-      alto_str << "\t\t\t\t\t<TextBlock ID=\"block_" << tcnt << "\"";
-      AddBoxToAlto(res_it, RIL_PARA, alto_str);
-      alto_str << "\n";
-    }
+  int left, bottom;
+  it.BoundingBox(RIL_WORD, &left, &word_top_, &word_right_, &bottom);
+}
 
-    if (res_it->IsAtBeginningOf(RIL_TEXTLINE)) {
-      alto_str << "\t\t\t\t\t\t<TextLine ID=\"line_" << lcnt << "\"";
-      AddBoxToAlto(res_it, RIL_TEXTLINE, alto_str);
-      alto_str << "\n";
-    }
+void AltoFormatter::Symbol(const ResultIterator &it, const char *text) {
+  out_->WriteEscaped(text);
+}
 
-    alto_str << "\t\t\t\t\t\t\t<String ID=\"string_" << wcnt << "\"";
-    AddBoxToAlto(res_it, RIL_WORD, alto_str);
-    alto_str << " CONTENT=\"";
+void AltoFormatter::EndWord(const ResultIterator &it, bool last_in_line, bool last_in_para,
+                            bool last_in_block) {
+  *out_ << "\"/>";
 
-    bool last_word_in_line = res_it->IsAtFinalElement(RIL_TEXTLINE, RIL_WORD);
-    bool last_word_in_tblock = res_it->IsAtFinalElement(RIL_PARA, RIL_WORD);
-    bool last_word_in_cblock = res_it->IsAtFinalElement(RIL_BLOCK, RIL_WORD);
+  wcnt_++;
 
+  if (last_in_line) {
+    *out_ << "\n\t\t\t\t\t\t</TextLine>\n";
+    lcnt_++;
+  } else {
+    int hpos = word_right_;
+    int vpos = word_top_;
     int left, top, right, bottom;
-    res_it->BoundingBox(RIL_WORD, &left, &top, &right, &bottom);
-
-    do {
-      const std::unique_ptr<const char[]> grapheme(res_it->GetUTF8Text(RIL_SYMBOL));
-      if (grapheme && grapheme[0] != 0) {
-        alto_str << HOcrEscape(grapheme.get()).c_str();
-      }
-      res_it->Next(RIL_SYMBOL);
-    } while (!res_it->Empty(RIL_BLOCK) && !res_it->IsAtBeginningOf(RIL_WORD));
-
-    alto_str << "\"/>";
-
-    wcnt++;
-
-    if (last_word_in_line) {
-      alto_str << "\n\t\t\t\t\t\t</TextLine>\n";
-      lcnt++;
-    } else {
-      int hpos = right;
-      int vpos = top;
-      res_it->BoundingBox(RIL_WORD, &left, &top, &right, &bottom);
-      int width = left - hpos;
-      alto_str << "<SP WIDTH=\"" << width << "\" VPOS=\"" << vpos << "\" HPOS=\"" << hpos
-               << "\"/>\n";
-    }
+    it.BoundingBox(RIL_WORD, &left, &top, &right, &bottom);
+    int width = left - hpos;
+    *out_ << "<SP WIDTH=\"" << width << "\" VPOS=\"" << vpos << "\" HPOS=\"" << hpos
+          << "\"/>\n";
+  }
 
-    if (last_word_in_tblock) {
-      alto_str << "\t\t\t\t\t</TextBlock>\n";
-      tcnt++;
-    }
+  if (last_in_para) {
+    *out_ << "\t\t\t\t\t</TextBlock>\n";
+    tcnt_++;
+  }
 
-    if (last_word_in_cblock) {
-      alto_str << "\t\t\t\t</ComposedBlock>\n";
-      bcnt++;
-    }
+  if (last_in_block) {
+    *out_ << "\t\t\t\t</ComposedBlock>\n";
+    bcnt_++;
   }
+}
 
-  alto_str << "\t\t\t</PrintSpace>\n"
-           << "\t\t</Page>\n";
-  const std::string &text = alto_str.str();
+void AltoFormatter::EndPage() {
+  *out_ << "\t\t\t</PrintSpace>\n"
+        << "\t\t</Page>\n";
+}
 
+///
+/// Make an XML-formatted string with ALTO markup from the internal
+/// data structures.
+///
+char *TessBaseAPI::GetAltoText(ETEXT_DESC *monitor, int page_number) {
+  std::string text;
+  {
+    BufferedWriter writer(&text);
+    AltoFormatter formatter(&writer, page_number);
+    if (!RenderPage(monitor, {&formatter})) {
+      return nullptr;
+    }
+  }
   char *result = new char[text.length() + 1];
   strcpy(result, text.c_str());
-  delete res_it;
   return result;
 }
 
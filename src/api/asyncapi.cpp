@@ -0,0 +1,204 @@
+///////////////////////////////////////////////////////////////////////
+// File:        asyncapi.cpp
+// Description: Recognition in a background thread with streamed results.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// Include automatically generated configuration file if running autoconf.
+#ifdef HAVE_CONFIG_H
+#  include "config_auto.h"
+#endif
+
+#include <tesseract/asyncapi.h>
+#include <tesseract/baseapi.h>  // for TessBaseAPI
+#include <tesseract/ocrclass.h> // for ETEXT_DESC
+#include "helpers.h"            // for ClipToRange
+#include "ocrblock.h"           // for BLOCK
+#include "ocrrow.h"             // for ROW
+#include "pageres.h"            // for BLOCK_RES, ROW_RES, WERD_RES
+#include "tesseractclass.h"     // for Tesseract
+
+#include <atomic>             // for std::atomic
+#include <condition_variable> // for std::condition_variable
+#include <deque>              // for std::deque
+#include <mutex>              // for std::mutex
+#include <thread>             // for std::thread
+
+namespace tesseract {
+
+struct TessAsyncRecognition::Internal {
+  // Builds the record of a completed row and delivers it.
+  void AddRow(BLOCK_RES *block, ROW_RES *row);
+
+  TessBaseAPI *api;
+  LineCallback callback;
+  // Only used by the recognition thread, which publishes monitor.progress
+  // in progress.
+  ETEXT_DESC monitor;
+  std::thread thread;
+  std::atomic<bool> cancelled{false};
+  std::atomic<int> progress{0};
+  mutable std::mutex mutex;
+  std::condition_variable changed;
+  std::deque<RecognizedLine> lines;
+  bool done = false;
+  bool timed_out = false;
+  int result = -1;
+  // Position of the last reported line.
+  BLOCK_RES *last_block = nullptr;
+  int block_index = -1;
+  int line_index = -1;
+};
+
+void TessAsyncRecognition::Internal::AddRow(BLOCK_RES *block, ROW_RES *row) {
+  if (block != last_block) {
+    last_block = block;
+    ++block_index;
+    line_index = -1;
+  }
+  RecognizedLine line;
+  line.block = block_index;
+  line.line = ++line_index;
+
+  float mean_certainty = 0.0f;
+  int certainty_count = 0;
+  WERD_RES_IT word_it(&row->word_res_list);
+  for (word_it.mark_cycle_pt(); !word_it.cycled_list(); word_it.forward()) {
+    WERD_CHOICE *best_choice = word_it.data()->best_choice;
+    if (best_choice == nullptr) {
+      continue;
+    }
+    if (!line.text.empty()) {
+      line.text += ' ';
+    }
+    line.text += best_choice->unichar_string();
+    mean_certainty += best_choice->certainty();
+    ++certainty_count;
+  }
+  if (certainty_count > 0) {
+    mean_certainty /= certainty_count;
+    line.confidence = ClipToRange(100 + 5 * mean_certainty, 0.0f, 100.0f);
+  }
+
+  // Convert the box to a top-down system like PageIterator does.
+  TBOX box = row->row->restricted_bounding_box(false, false);
+  box.rotate(block->block->re_rotation());
+  const int pix_height = api->tesseract()->ImageHeight();
+  const int pix_width = api->tesseract()->ImageWidth();
+  line.left = ClipToRange(static_cast<int>(box.left()), 0, pix_width);
+  line.top = ClipToRange(pix_height - box.top(), 0, pix_height);
+  line.right = ClipToRange(static_cast<int>(box.right()), line.left, pix_width);
+  line.bottom = ClipToRange(pix_height - box.bottom(), line.top, pix_height);
+  ToImageCoords(api, &line.left, &line.top, &line.right, &line.bottom);
+
+  if (callback) {
+    callback(line);
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  lines.push_back(std::move(line));
+  changed.notify_all();
+}
+
+void TessAsyncRecognition::ToImageCoords(const TessBaseAPI *api, int *left, int *top, int *right,
+                                         int *bottom) {
+  const int scale = api->thresholder_->GetScaleFactor();
+  *left = ClipToRange(*left / scale + api->rect_left_, api->rect_left_,
+                      api->rect_left_ + api->rect_width_);
+  *top = ClipToRange(*top / scale + api->rect_top_, api->rect_top_,
+                     api->rect_top_ + api->rect_height_);
+  *right = ClipToRange((*right + scale - 1) / scale + api->rect_left_, *left,
+                       api->rect_left_ + api->rect_width_);
+  *bottom = ClipToRange((*bottom + scale - 1) / scale + api->rect_top_, *top,
+                        api->rect_top_ + api->rect_height_);
+}
+
+TessAsyncRecognition::TessAsyncRecognition(TessBaseAPI *api, LineCallback callback,
+                                           int timeout_millisec)
+    : internal_(new Internal) {
+  Internal *internal = internal_.get();
+  internal->api = api;
+  internal->callback = std::move(callback);
+  // The engine calls cancel after each update of the progress.
+  internal->monitor.cancel = [](void *cancel_this, int) {
+    auto *recognition = static_cast<Internal *>(cancel_this);
+    recognition->progress.store(recognition->monitor.progress, std::memory_order_relaxed);
+    return recognition->cancelled.load();
+  };
+  internal->monitor.cancel_this = internal;
+  internal->monitor.set_deadline_msecs(timeout_millisec);
+  internal->thread = std::thread([internal] {
+    int result = -1;
+    Tesseract *tesseract = internal->api->tesseract();
+    if (tesseract != nullptr && !internal->cancelled) {
+      tesseract->set_row_done_callback(
+          [internal](BLOCK_RES *block, ROW_RES *row) { internal->AddRow(block, row); });
+      result = internal->api->Recognize(&internal->monitor);
+      tesseract->set_row_done_callback(nullptr);
+    }
+    internal->progress.store(internal->monitor.progress, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(internal->mutex);
+    internal->timed_out = result < 0 && internal->monitor.deadline_exceeded();
+    internal->result = result;
+    internal->done = true;
+    internal->changed.notify_all();
+  });
+}
+
+TessAsyncRecognition::~TessAsyncRecognition() {
+  Cancel();
+  internal_->thread.join();
+}
+
+void TessAsyncRecognition::Cancel() {
+  internal_->cancelled = true;
+}
+
+bool TessAsyncRecognition::IsCancelled() const {
+  if (internal_->cancelled) {
+    return true;
+  }
+  std::lock_guard<std::mutex> lock(internal_->mutex);
+  return internal_->timed_out;
+}
+
+bool TessAsyncRecognition::IsDone() const {
+  std::lock_guard<std::mutex> lock(internal_->mutex);
+  return internal_->done;
+}
+
+int TessAsyncRecognition::Progress() const {
+  return internal_->progress.load(std::memory_order_relaxed);
+}
+
+int TessAsyncRecognition::Wait() {
+  std::unique_lock<std::mutex> lock(internal_->mutex);
+  internal_->changed.wait(lock, [this] { return internal_->done; });
+  return internal_->result;
+}
+
+bool TessAsyncRecognition::NextLine(RecognizedLine *line, bool wait) {
+  std::unique_lock<std::mutex> lock(internal_->mutex);
+  if (wait) {
+    internal_->changed.wait(lock,
+                            [this] { return internal_->done || !internal_->lines.empty(); });
+  }
+  if (internal_->lines.empty()) {
+    return false;
+  }
+  *line = std::move(internal_->lines.front());
+  internal_->lines.pop_front();
+  return true;
+}
+
+} // namespace tesseract.
@@ -39,22 +39,32 @@
 #ifndef DISABLED_LEGACY_ENGINE
 #  include "intfx.h" // for INT_FX_RESULT_STRUCT
 #endif
+#include "lstmrecognizer.h"  // for LSTMRecognizer
+#include "memorystats.h"     // for MemoryRecorder, MEMORY_RECORDER_SCOPE
 #include "mutableiterator.h" // for MutableIterator
+#include "networkprofile.h"  // for NetworkProfile
 #include "normalis.h"        // for kBlnBaselineOffset, kBlnXHeight
+#include "ocrblock.h"        // for BLOCK, BLOCK_IT
+#include "ocrrow.h"          // for ROW, ROW_IT
 #if defined(USE_OPENCL)
 #  include "openclwrapper.h" // for OpenclDevice
 #endif
 #include "pageres.h"         // for PAGE_RES_IT, WERD_RES, PAGE_RES, CR_DE...
-#include "paragraphs.h"      // for DetectParagraphs
+#include "pagerenderer.h"    // for BufferedWriter, TsvFormatter
+#include "paragraphs.h"      // for DetectPageParagraphs
 #include "params.h"          // for BoolParam, IntParam, DoubleParam, Stri...
 #include "pdblock.h"         // for PDBLK
 #include "points.h"          // for FCOORD
 #include "polyblk.h"         // for POLY_BLOCK
+#include "profiler.h"        // for Profiler, PROFILE_SCOPE
+#include "ratngs.h"          // for WERD_CHOICE, BLOB_CHOICE
+#include "recycler.h"        // for Recycler, RecyclerStats
 #include "rect.h"            // for TBOX
+#include "stagestats.h"      // for StageRecorder, STAGE_TIMER
 #include "stepblob.h"        // for C_BLOB_IT, C_BLOB, C_BLOB_LIST
 #include "tessdatamanager.h" // for TessdataManager, kTrainedDataSuffix
 #include "tesseractclass.h"  // for Tesseract
-#include "tprintf.h"         // for tprintf
+#include "tprintf.h"         // for tprintf, LogSinkScope, LogFlush
 #include "werd.h"            // for WERD, WERD_IT, W_FUZZY_NON, W_FUZZY_SP
 #include "tabletransfer.h"   // for detected tables from tablefind.h
 
@@ -66,16 +76,25 @@
 #include <tesseract/thresholder.h>    // for ImageThresholder
 #include "helpers.h"                  // for IntCastRounded, chomp_string
 
-#include <cmath>    // for round, M_PI
-#include <cstdint>  // for int32_t
-#include <cstring>  // for strcmp, strcpy
-#include <fstream>  // for size_t
-#include <iostream> // for std::cin
-#include <locale>   // for std::locale::classic
-#include <memory>   // for std::unique_ptr
-#include <set>      // for std::pair
-#include <sstream>  // for std::stringstream
-#include <vector>   // for std::vector
+#include <algorithm>          // for std::max
+#include <cerrno>             // for errno, EEXIST
+#include <chrono>             // for std::chrono
+#include <cmath>              // for round, M_PI
+#include <condition_variable> // for std::condition_variable
+#include <cstdint>            // for int32_t
+#include <cstdio>             // for fopen, fclose
+#include <cstring>            // for strcmp, strcpy
+#include <deque>              // for std::deque
+#include <fstream>            // for size_t
+#include <iostream>           // for std::cin
+#include <locale>             // for std::locale::classic
+#include <map>                // for std::map
+#include <memory>             // for std::unique_ptr
+#include <mutex>              // for std::mutex
+#include <set>                // for std::pair
+#include <sstream>            // for std::stringstream
+#include <thread>             // for std::thread
+#include <vector>             // for std::vector
 
 #include <allheaders.h> // for pixDestroy, boxCreate, boxaAddBox, box...
 #ifdef HAVE_LIBCURL
@@ -101,6 +120,32 @@ namespace tesseract {
 
 static BOOL_VAR(stream_filelist, false, "Stream a filelist from stdin");
 static STRING_VAR(document_title, "", "Title of output document (used for hOCR and PDF output)");
+static INT_VAR(pipeline_workers, 0,
+               "Number of recognition threads for multi-page input, each with its own"
+               " instance of the model (0 = recognize the pages sequentially)");
+static INT_VAR(pipeline_lookahead, 2,
+               "Max number of decoded pages waiting for a pipeline worker");
+static INT_VAR(line_fast_path, 0,
+               "Skip layout analysis with the LSTM engine in single line modes:"
+               " 0=never, 1=PSM_RAW_LINE and PSM_SINGLE_WORD, which recognize the whole"
+               " image anyway, 2=also PSM_SINGLE_LINE. Off by default, as the fast"
+               " path recognizes images without any text components too");
+static STRING_VAR(stage_stats_file, "",
+                  "Append the stage times of each page processed by ProcessPages"
+                  " to this file as a line of JSON");
+static STRING_VAR(profile_file, "",
+                  "Profile ProcessPages and write the profile to this file, as folded"
+                  " stacks for flame graphs if the name ends in .folded, else as"
+                  " a Chrome trace. Later documents of the process insert their"
+                  " number before the extension");
+static STRING_VAR(replay_dir, "",
+                  "Write a replay bundle of each page which ProcessPage processes and which"
+                  " fails or exceeds replay_min_seconds or replay_min_mb to this directory");
+static double_VAR(replay_min_seconds, 10.0,
+                  "Write a replay bundle of pages which take at least this many seconds");
+static INT_VAR(replay_min_mb, 0,
+               "Write a replay bundle of pages which need at least this many MB of memory"
+               " (0 = never for the memory)");
 
 /** Minimum sensible image size to be worth running tesseract. */
 const int kMinRectSize = 10;
@@ -115,10 +160,6 @@ const char kUNLVSuspect = '^';
  * for a possible UNLV zone file, if none is specified by SetInputName.
  */
 static const char *kInputFile = "noname.tif";
-/**
- * Temp file used for storing current parameters before applying retry values.
- */
-static const char *kOldVarsFile = "failed_vars.txt";
 /** Max string length of an int.  */
 const int kMaxIntSize = 22;
 
@@ -224,6 +265,10 @@ TessBaseAPI::TessBaseAPI()
     , page_res_(nullptr)
     , last_oem_requested_(OEM_DEFAULT)
     , recognition_done_(false)
+    , stage_recorder_(new StageRecorder)
+    , memory_recorder_(new MemoryRecorder)
+    , log_sink_(nullptr)
+    , retry_overlay_(nullptr)
     , rect_left_(0)
     , rect_top_(0)
     , rect_width_(0)
@@ -248,6 +293,9 @@ TessBaseAPI::TessBaseAPI()
 
 TessBaseAPI::~TessBaseAPI() {
   End();
+  delete stage_recorder_;
+  // After End, as the grids of the deleted Tesseract release their memory.
+  delete memory_recorder_;
 }
 
 /**
@@ -295,8 +343,14 @@ bool TessBaseAPI::SetVariable(const char *name, const char *value) {
   if (tesseract_ == nullptr) {
     tesseract_ = new Tesseract;
   }
-  return ParamUtils::SetParam(name, value, SET_PARAM_CONSTRAINT_NON_INIT_ONLY,
-                              tesseract_->params());
+  if (!ParamUtils::SetParam(name, value, SET_PARAM_CONSTRAINT_NON_INIT_ONLY,
+                            tesseract_->params())) {
+    return false;
+  }
+  if (strcmp(name, "tessedit_output_profile") == 0) {
+    tesseract_->CheckOutputProfile();
+  }
+  return true;
 }
 
 bool TessBaseAPI::SetDebugVariable(const char *name, const char *value) {
@@ -374,6 +428,7 @@ int TessBaseAPI::Init(const char *data, int data_size, const char *language, Ocr
                       char **configs, int configs_size, const std::vector<std::string> *vars_vec,
                       const std::vector<std::string> *vars_values, bool set_only_non_debug_params,
                       FileReader reader) {
+  LogSinkScope log_sink_scope(log_sink_);
   // Default language is "eng".
   if (language == nullptr) {
     language = "eng";
@@ -430,6 +485,10 @@ int TessBaseAPI::Init(const char *data, int data_size, const char *language, Ocr
     tesseract_->ResetAdaptiveClassifier();
   }
 #endif // ndef DISABLED_LEGACY_ENGINE
+  // The config files and vars may have set the profile.
+  tesseract_->CheckOutputProfile();
+  memory_recorder_->Set(MEMORY_UNICHARSETS, tesseract_->UnicharsetsMemoryUsed());
+  MeasureMemory();
   return 0;
 }
 
@@ -626,6 +685,20 @@ void TessBaseAPI::SetImage(Pix *pix) {
   }
 }
 
+/**
+ * Provide an image for Tesseract to recognize without copying it.
+ * The data must remain valid and unchanged until the next SetImage,
+ * SetImageBorrowed, Clear or End.
+ */
+void TessBaseAPI::SetImageBorrowed(const unsigned char *imagedata, int width, int height,
+                                   int bytes_per_pixel, int bytes_per_line) {
+  if (InternalSetImage()) {
+    thresholder_->SetImageBorrowed(imagedata, width, height, bytes_per_pixel, bytes_per_line);
+    // There is no copy of the image yet. Threshold sets the greyscale image.
+    SetInputImage(nullptr);
+  }
+}
+
 /**
  * Restrict recognition to a sub-rectangle of the image. Call after SetImage.
  * Each SetRectangle clears the recogntion results so multiple rectangles
@@ -851,9 +924,15 @@ int TessBaseAPI::Recognize(ETEXT_DESC *monitor) {
   if (tesseract_ == nullptr) {
     return -1;
   }
+  STAGE_RECORDER_SCOPE(stage_recorder_);
+  MEMORY_RECORDER_SCOPE(memory_recorder_);
+  LogSinkScope log_sink_scope(log_sink_);
   if (FindLines() != 0) {
     return -1;
   }
+  STAGE_COUNT_EVENT(COUNTER_PAGES, 1);
+  // The images are all made by now.
+  MeasureMemory();
   delete page_res_;
   if (block_list_->empty()) {
     page_res_ = new PAGE_RES(false, block_list_, &tesseract_->prev_word_best_choice_);
@@ -861,6 +940,7 @@ int TessBaseAPI::Recognize(ETEXT_DESC *monitor) {
   }
 
   tesseract_->SetBlackAndWhitelist();
+  tesseract_->SetLSTMLayerProfiling();
   recognition_done_ = true;
 #ifndef DISABLED_LEGACY_ENGINE
   if (tesseract_->tessedit_resegment_from_line_boxes) {
@@ -929,9 +1009,225 @@ int TessBaseAPI::Recognize(ETEXT_DESC *monitor) {
       result = -1;
     }
   }
+  MeasureMemory();
   return result;
 }
 
+// Makes a block with a single row holding a single word of one fake blob
+// for the given box, so that the LSTM recognizes the box as a text line
+// without any layout analysis. The baseline is a quarter of the height above
+// the bottom and the x-height, ascenders and descenders fill the rest of
+// the box, so LSTMRecognizeWord recognizes exactly the box.
+static BLOCK *MakeLineBlock(const TBOX &box) {
+  auto *block = new BLOCK("", true, 0, 0, box.left(), box.bottom(), box.right(), box.top());
+  const float height = box.height();
+  int32_t xstarts[] = {box.left(), box.right()};
+  double coeffs[] = {0.0, 0.0, box.bottom() + height / 4};
+  auto *row = new ROW(1, xstarts, coeffs, height / 2, height / 4, -height / 4, 0, 0);
+  C_BLOB_LIST blobs;
+  C_BLOB_IT blob_it(&blobs);
+  blob_it.add_after_then_move(C_BLOB::FakeBlob(box));
+  auto *word = new WERD(&blobs, 0, nullptr);
+  word->set_flag(W_BOL, true);
+  word->set_flag(W_EOL, true);
+  WERD_IT word_it(row->word_list());
+  word_it.add_after_then_move(word);
+  row->recalc_bounding_box();
+  ROW_IT row_it(block->row_list());
+  row_it.add_after_then_move(row);
+  return block;
+}
+
+// Returns the confidence of a word in 0..100, as AllWordConfidences and
+// MeanTextConf report it.
+static int WordConfidence(const WERD_CHOICE &choice) {
+  // This is the eq for converting Tesseract confidence to 1..100
+  return ClipToRange(static_cast<int>(100 + 5 * choice.certainty()), 0, 100);
+}
+
+// Accumulates the words of a region into its result: words are separated
+// by spaces and rows by newlines. The confidence is the mean of the word
+// confidences, as MeanTextConf computes it for a page.
+class RegionTextCollector {
+public:
+  explicit RegionTextCollector(TessBaseAPI::RegionResult *result) : result_(result) {}
+
+  void AddWord(const ROW_RES *row, const WERD_RES *word) {
+    if (word->best_choice == nullptr) {
+      return;
+    }
+    if (last_row_ != nullptr) {
+      result_->text += row == last_row_ ? ' ' : '\n';
+    }
+    last_row_ = row;
+    result_->text += word->best_choice->unichar_string();
+    conf_sum_ += WordConfidence(*word->best_choice);
+    ++conf_count_;
+  }
+
+  void Finish() {
+    result_->ok = true;
+    result_->mean_confidence = conf_count_ > 0 ? conf_sum_ / conf_count_ : 0;
+  }
+
+private:
+  TessBaseAPI::RegionResult *result_;
+  const ROW_RES *last_row_ = nullptr;
+  int conf_sum_ = 0;
+  int conf_count_ = 0;
+};
+
+// Returns true if FindLines may skip layout analysis for the page
+// segmentation mode of tess, as set by line_fast_path. Only the LSTM
+// recognizes a block made by MakeLineBlock, and the training and box modes
+// need the blobs of the page.
+static bool UseLineFastPath(const Tesseract &tess) {
+  const auto pageseg_mode = static_cast<PageSegMode>(static_cast<int>(tess.tessedit_pageseg_mode));
+  if (pageseg_mode == PSM_RAW_LINE || pageseg_mode == PSM_SINGLE_WORD) {
+    if (line_fast_path < 1) {
+      return false;
+    }
+  } else if (pageseg_mode != PSM_SINGLE_LINE || line_fast_path < 2) {
+    return false;
+  }
+  return !tess.AnyTessLang() && !tess.tessedit_resegment_from_boxes &&
+         !tess.tessedit_resegment_from_line_boxes && !tess.tessedit_train_from_boxes &&
+         !tess.tessedit_make_boxes_from_boxes && !tess.tessedit_train_line_recognizer &&
+         !tess.tessedit_ambigs_training && !tess.textord_equation_detect;
+}
+
+/**
+ * Recognizes many regions of the image which was set by SetImage.
+ * The image is thresholded once, and with the LSTM engine all single line
+ * regions with the same whitelist are recognized in one pass, without
+ * layout analysis.
+ */
+int TessBaseAPI::RecognizeRegions(const std::vector<Region> &regions,
+                                  std::vector<RegionResult> *results, ETEXT_DESC *monitor) {
+  results->assign(regions.size(), RegionResult());
+  if (tesseract_ == nullptr || thresholder_ == nullptr || thresholder_->IsEmpty()) {
+    tprintf("Please call SetImage before attempting recognition.\n");
+    return -1;
+  }
+  STAGE_RECORDER_SCOPE(stage_recorder_);
+  MEMORY_RECORDER_SCOPE(memory_recorder_);
+  LogSinkScope log_sink_scope(log_sink_);
+  int left, top, width, height, image_width, image_height;
+  thresholder_->GetImageSizes(&left, &top, &width, &height, &image_width, &image_height);
+  const PageSegMode pageseg_mode = GetPageSegMode();
+  const std::string whitelist = GetStringVariable("tessedit_char_whitelist");
+
+  // Line regions are grouped by their whitelist, as it applies to a pass.
+  std::map<std::string, std::vector<size_t>> line_groups;
+  std::vector<size_t> other_regions;
+  for (size_t i = 0; i < regions.size(); ++i) {
+    const Region &region = regions[i];
+    if (!tesseract_->AnyTessLang() &&
+        (region.psm == PSM_SINGLE_LINE || region.psm == PSM_RAW_LINE ||
+         region.psm == PSM_SINGLE_WORD)) {
+      line_groups[region.whitelist.empty() ? whitelist : region.whitelist].push_back(i);
+    } else {
+      other_regions.push_back(i);
+    }
+  }
+
+  bool all_ok = true;
+  if (!line_groups.empty()) {
+    // Threshold the whole image once for all line regions.
+    SetRectangle(0, 0, image_width, image_height);
+    if (Threshold(tesseract_->mutable_pix_binary())) {
+      // As FindLines does, but without a segmentation.
+      tesseract_->PrepareForPageseg();
+      tesseract_->PrepareForTessOCR(block_list_, nullptr, nullptr);
+      // The single line modes would keep only one row of the page.
+      SetPageSegMode(PSM_SINGLE_BLOCK);
+      for (auto &group : line_groups) {
+        SetVariable("tessedit_char_whitelist", group.first.c_str());
+        if (!RecognizeLineRegions(regions, group.second, monitor, results)) {
+          all_ok = false;
+        }
+      }
+    } else {
+      all_ok = false;
+    }
+  }
+
+  for (auto index : other_regions) {
+    const Region &region = regions[index];
+    SetPageSegMode(region.psm);
+    SetVariable("tessedit_char_whitelist",
+                region.whitelist.empty() ? whitelist.c_str() : region.whitelist.c_str());
+    SetRectangle(region.left, region.top, region.width, region.height);
+    if (Recognize(monitor) < 0) {
+      all_ok = false;
+      continue;
+    }
+    RegionTextCollector collector(&(*results)[index]);
+    PAGE_RES_IT page_res_it(page_res_);
+    for (page_res_it.restart_page(); page_res_it.word() != nullptr; page_res_it.forward()) {
+      collector.AddWord(page_res_it.row(), page_res_it.word());
+    }
+    collector.Finish();
+  }
+
+  SetPageSegMode(pageseg_mode);
+  SetVariable("tessedit_char_whitelist", whitelist.c_str());
+  SetRectangle(left, top, width, height);
+  return all_ok ? 0 : -1;
+}
+
+// Recognizes the given line regions as the text lines of one page made of
+// a block per region.
+bool TessBaseAPI::RecognizeLineRegions(const std::vector<Region> &regions,
+                                       const std::vector<size_t> &indices, ETEXT_DESC *monitor,
+                                       std::vector<RegionResult> *results) {
+  delete page_res_;
+  page_res_ = nullptr;
+  block_list_->clear();
+  bool all_ok = true;
+  std::map<const BLOCK *, RegionTextCollector> collectors;
+  BLOCK_IT block_it(block_list_);
+  const TBOX image_box(0, 0, image_width_, image_height_);
+  for (auto index : indices) {
+    const Region &region = regions[index];
+    // The blocks use the bottom-up coordinates of the thresholded image.
+    TBOX box(region.left, image_height_ - region.top - region.height,
+             region.left + region.width, image_height_ - region.top);
+    box &= image_box;
+    if (box.null_box() || box.area() == 0) {
+      tprintf("Region (%d, %d, %d, %d) is outside the image\n", region.left, region.top,
+              region.width, region.height);
+      all_ok = false;
+      continue;
+    }
+    BLOCK *block = MakeLineBlock(box);
+    block_it.add_to_end(block);
+    collectors.emplace(block, RegionTextCollector(&(*results)[index]));
+  }
+  if (block_list_->empty()) {
+    return all_ok;
+  }
+
+  tesseract_->SetBlackAndWhitelist();
+  recognition_done_ = true;
+  page_res_ =
+      new PAGE_RES(tesseract_->AnyLSTMLang(), block_list_, &tesseract_->prev_word_best_choice_);
+  if (!tesseract_->recog_all_words(page_res_, monitor, nullptr, nullptr, 0)) {
+    return false;
+  }
+  PAGE_RES_IT page_res_it(page_res_);
+  for (page_res_it.restart_page(); page_res_it.word() != nullptr; page_res_it.forward()) {
+    auto collector = collectors.find(page_res_it.block()->block);
+    if (collector != collectors.end()) {
+      collector->second.AddWord(page_res_it.row(), page_res_it.word());
+    }
+  }
+  for (auto &collector : collectors) {
+    collector.second.Finish();
+  }
+  return all_ok;
+}
+
 // Takes ownership of the input pix.
 void TessBaseAPI::SetInputImage(Pix *pix) {
   tesseract_->set_pix_original(pix);
@@ -1004,15 +1300,16 @@ bool TessBaseAPI::ProcessPagesFileList(FILE *flist, std::string *buf, const char
     return false;
   }
 
-  // Loop over all pages - or just the requested one
-  while (true) {
+  // Reads the next image of the list.
+  bool read_error = false;
+  auto next_page = [&](int *page_index, std::string *filename) -> Pix * {
     if (flist) {
       if (fgets(pagename, sizeof(pagename), flist) == nullptr) {
-        break;
+        return nullptr;
       }
     } else {
       if (page >= lines.size()) {
-        break;
+        return nullptr;
       }
       snprintf(pagename, sizeof(pagename), "%s", lines[page].c_str());
     }
@@ -1020,18 +1317,43 @@ bool TessBaseAPI::ProcessPagesFileList(FILE *flist, std::string *buf, const char
     Pix *pix = pixRead(pagename);
     if (pix == nullptr) {
       tprintf("Image file %s cannot be read!\n", pagename);
-      return false;
+      read_error = true;
+      return nullptr;
     }
     tprintf("Page %u : %s\n", page, pagename);
-    bool r = ProcessPage(pix, page, pagename, retry_config, timeout_millisec, renderer);
-    pixDestroy(&pix);
-    if (!r) {
+    *page_index = page++;
+    *filename = pagename;
+    return pix;
+  };
+
+  auto workers = CreatePipelineWorkers(retry_config, tessedit_page_number);
+  if (!workers.empty()) {
+    if (!ProcessPagesPipelined(workers, next_page, false, timeout_millisec, renderer) ||
+        read_error) {
       return false;
     }
-    if (tessedit_page_number >= 0) {
-      break;
+  } else {
+    // Loop over all pages - or just the requested one
+    while (true) {
+      int page_index;
+      std::string filename;
+      Pix *pix = next_page(&page_index, &filename);
+      if (pix == nullptr) {
+        if (read_error) {
+          return false;
+        }
+        break;
+      }
+      bool r = ProcessPage(pix, page_index, filename.c_str(), retry_config, timeout_millisec,
+                           renderer);
+      pixDestroy(&pix);
+      if (!r) {
+        return false;
+      }
+      if (tessedit_page_number >= 0) {
+        break;
+      }
     }
-    ++page;
   }
 
   // Finish producing output
@@ -1045,44 +1367,226 @@ bool TessBaseAPI::ProcessPagesMultipageTiff(const l_uint8 *data, size_t size, co
                                             const char *retry_config, int timeout_millisec,
                                             TessResultRenderer *renderer,
                                             int tessedit_page_number) {
-  Pix *pix = nullptr;
   int page = (tessedit_page_number >= 0) ? tessedit_page_number : 0;
   size_t offset = 0;
-  for (;; ++page) {
+  bool last_page = false;
+  // Reads the next page of the TIFF.
+  auto next_page = [&](int *page_index, std::string *page_filename) -> Pix * {
+    if (last_page) {
+      return nullptr;
+    }
+    Pix *pix;
     if (tessedit_page_number >= 0) {
-      page = tessedit_page_number;
       pix = (data) ? pixReadMemTiff(data, size, page) : pixReadTiff(filename, page);
+      last_page = true;
     } else {
       pix = (data) ? pixReadMemFromMultipageTiff(data, size, &offset)
                    : pixReadFromMultipageTiff(filename, &offset);
+      last_page = offset == 0;
     }
     if (pix == nullptr) {
-      break;
+      return nullptr;
     }
     tprintf("Page %d\n", page + 1);
+    *page_index = page++;
+    *page_filename = filename;
+    return pix;
+  };
+
+  auto workers = CreatePipelineWorkers(retry_config, tessedit_page_number);
+  if (!workers.empty()) {
+    return ProcessPagesPipelined(workers, next_page, true, timeout_millisec, renderer);
+  }
+  for (;;) {
+    int page_index;
+    std::string page_filename;
+    Pix *pix = next_page(&page_index, &page_filename);
+    if (pix == nullptr) {
+      break;
+    }
     char page_str[kMaxIntSize];
-    snprintf(page_str, kMaxIntSize - 1, "%d", page);
+    snprintf(page_str, kMaxIntSize - 1, "%d", page_index);
     SetVariable("applybox_page", page_str);
-    bool r = ProcessPage(pix, page, filename, retry_config, timeout_millisec, renderer);
+    bool r = ProcessPage(pix, page_index, filename, retry_config, timeout_millisec, renderer);
     pixDestroy(&pix);
     if (!r) {
       return false;
     }
-    if (tessedit_page_number >= 0) {
+  }
+  return true;
+}
+
+// All member parameters of this instance are passed to the workers as init
+// variables, so init-only and debug parameters which were set by configs or
+// on the command line are honoured, too.
+std::vector<std::unique_ptr<TessBaseAPI>> TessBaseAPI::CreatePipelineWorkers(
+    const char *retry_config, int tessedit_page_number) {
+  std::vector<std::unique_ptr<TessBaseAPI>> workers;
+  if (pipeline_workers <= 0 || tessedit_page_number >= 0 || tesseract_ == nullptr) {
+    return workers;
+  }
+  if (retry_config != nullptr && retry_config[0] != '\0') {
+    // The retry changes global variables which the workers share.
+    tprintf("Warning: retry_config is not supported by pipeline_workers,"
+            " processing the pages sequentially.\n");
+    return workers;
+  }
+#ifndef DISABLED_LEGACY_ENGINE
+  if (tesseract_->tessedit_train_from_boxes) {
+    // Training data is collected in this instance and written by ProcessPages.
+    return workers;
+  }
+#endif // ndef DISABLED_LEGACY_ENGINE
+
+  std::vector<std::string> names;
+  std::vector<std::string> values;
+  ParamsOverlay snapshot = ParamsOverlay::Capture(tesseract_->params());
+  for (auto &setting : snapshot.values()) {
+    names.push_back(setting.first);
+    values.push_back(setting.second);
+  }
+
+  for (int i = 0; i < pipeline_workers; ++i) {
+    std::unique_ptr<TessBaseAPI> worker(new TessBaseAPI);
+    worker->SetOutputName(output_file_.c_str());
+    worker->SetLogSink(log_sink_);
+    if (worker->Init(datapath_.c_str(), 0, language_.c_str(), last_oem_requested_, nullptr, 0,
+                     &names, &values, false, reader_) != 0) {
+      tprintf("Warning: failed to initialize pipeline worker %d,"
+              " processing the pages sequentially.\n", i);
+      workers.clear();
       break;
     }
-    if (!offset) {
-      break;
+    workers.push_back(std::move(worker));
+  }
+  return workers;
+}
+
+bool TessBaseAPI::ProcessPagesPipelined(const std::vector<std::unique_ptr<TessBaseAPI>> &workers,
+                                        const PageSource &next_page, bool set_applybox_page,
+                                        int timeout_millisec, TessResultRenderer *renderer) {
+  struct DecodedPage {
+    Pix *pix = nullptr;
+    int page_index = 0;
+    int sequence = 0; // Position in the output.
+    std::string filename;
+  };
+  const size_t max_queued = std::max(1, static_cast<int>(pipeline_lookahead));
+  std::mutex mutex;
+  std::condition_variable queue_changed;
+  std::condition_variable rendered;
+  std::deque<DecodedPage> queue;
+  bool input_done = false;
+  bool failed = false;
+  int next_to_render = 0;
+
+  // Decodes the pages ahead of the recognition, but never more than
+  // max_queued pages which are not yet taken by a worker.
+  std::thread decoder([&] {
+    for (int sequence = 0;; ++sequence) {
+      DecodedPage page;
+      page.pix = next_page(&page.page_index, &page.filename);
+      page.sequence = sequence;
+      std::unique_lock<std::mutex> lock(mutex);
+      if (page.pix != nullptr) {
+        queue_changed.wait(lock, [&] { return failed || queue.size() < max_queued; });
+      }
+      if (page.pix == nullptr || failed) {
+        pixDestroy(&page.pix);
+        input_done = true;
+        queue_changed.notify_all();
+        return;
+      }
+      queue.push_back(std::move(page));
+      queue_changed.notify_all();
+    }
+  });
+
+  // Recognizes pages until the input is exhausted. The results of a page
+  // are kept by its worker until all previous pages have been rendered,
+  // so pages are rendered in order and at most one page per worker waits.
+  auto recognize = [&](TessBaseAPI *api) {
+    for (;;) {
+      DecodedPage page;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        queue_changed.wait(lock, [&] { return failed || input_done || !queue.empty(); });
+        if (failed || queue.empty()) {
+          return;
+        }
+        page = std::move(queue.front());
+        queue.pop_front();
+        queue_changed.notify_all();
+      }
+      if (set_applybox_page) {
+        char page_str[kMaxIntSize];
+        snprintf(page_str, kMaxIntSize - 1, "%d", page.page_index);
+        api->SetVariable("applybox_page", page_str);
+      }
+      bool ok = api->ProcessPage(page.pix, page.page_index, page.filename.c_str(), nullptr,
+                                 timeout_millisec, nullptr);
+      pixDestroy(&page.pix);
+
+      std::unique_lock<std::mutex> lock(mutex);
+      rendered.wait(lock, [&] { return failed || next_to_render == page.sequence; });
+      if (failed) {
+        return;
+      }
+      if (ok && renderer != nullptr) {
+        // No other worker can render until next_to_render is incremented.
+        lock.unlock();
+        {
+          STAGE_RECORDER_SCOPE(api->stage_recorder_);
+          LogSinkScope log_sink_scope(api->log_sink_);
+          STAGE_TIMER(STAGE_RENDER);
+          ok = renderer->AddImage(api);
+        }
+        lock.lock();
+      }
+      if (!ok) {
+        failed = true;
+        queue_changed.notify_all();
+      }
+      ++next_to_render;
+      rendered.notify_all();
     }
+  };
+
+  std::vector<std::thread> threads;
+  for (auto &worker : workers) {
+    threads.emplace_back(recognize, worker.get());
   }
-  return true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  decoder.join();
+  for (auto &page : queue) {
+    pixDestroy(&page.pix);
+  }
+  for (auto &worker : workers) {
+    stage_recorder_->AddTotals(*worker->stage_recorder_);
+  }
+  return !failed;
 }
 
 // Master ProcessPages calls ProcessPagesInternal and then does any post-
 // processing required due to being in a training mode.
 bool TessBaseAPI::ProcessPages(const char *filename, const char *retry_config, int timeout_millisec,
                                TessResultRenderer *renderer) {
+#ifndef DISABLED_STAGE_STATS
+  bool profile = !profile_file.empty();
+  Profiler::Session session;
+  if (profile) {
+    session = Profiler::Start();
+  }
+#endif
   bool result = ProcessPagesInternal(filename, retry_config, timeout_millisec, renderer);
+#ifndef DISABLED_STAGE_STATS
+  if (profile && !Profiler::Stop(&session, profile_file.c_str())) {
+    tprintf("Error, could not write the profile to %s\n",
+            Profiler::SessionPath(profile_file.c_str(), session).c_str());
+  }
+#endif
 #ifndef DISABLED_LEGACY_ENGINE
   if (result) {
     if (tesseract_->tessedit_train_from_boxes && !tesseract_->WriteTRFile(output_file_.c_str())) {
@@ -1244,6 +1748,11 @@ bool TessBaseAPI::ProcessPagesInternal(const char *filename, const char *retry_c
 bool TessBaseAPI::ProcessPage(Pix *pix, int page_index, const char *filename,
                               const char *retry_config, int timeout_millisec,
                               TessResultRenderer *renderer) {
+  PROFILE_SCOPE("ProcessPage", page_index);
+  STAGE_RECORDER_SCOPE(stage_recorder_);
+  MEMORY_RECORDER_SCOPE(memory_recorder_);
+  LogSinkScope log_sink_scope(log_sink_);
+  auto start = std::chrono::steady_clock::now();
   SetInputName(filename);
   SetImage(pix);
   bool failed = false;
@@ -1279,29 +1788,221 @@ bool TessBaseAPI::ProcessPage(Pix *pix, int page_index, const char *filename,
   }
 
   if (failed && retry_config != nullptr && retry_config[0] != '\0') {
-    // Save current config variables before switching modes.
-    FILE *fp = fopen(kOldVarsFile, "wb");
-    if (fp == nullptr) {
-      tprintf("Error, failed to open file \"%s\"\n", kOldVarsFile);
-    } else {
-      PrintVariables(fp);
-      fclose(fp);
+    // The config is read once and then applied in memory for every retry.
+    if (retry_overlay_ == nullptr || retry_config_ != retry_config) {
+      delete retry_overlay_;
+      retry_overlay_ = new ParamsOverlay;
+      retry_overlay_->ReadFile(tesseract_->find_config_file(retry_config).c_str());
+      retry_config_ = retry_config;
     }
     // Switch to alternate mode for retry.
-    ReadConfigFile(retry_config);
+    retry_overlay_->Apply(SET_PARAM_CONSTRAINT_NON_INIT_ONLY, tesseract_->params());
     SetImage(pix);
     Recognize(nullptr);
-    // Restore saved config variables.
-    ReadConfigFile(kOldVarsFile);
+    // Restore the variables which the retry changed.
+    retry_overlay_->Revert();
   }
 
   if (renderer && !failed) {
+    STAGE_TIMER(STAGE_RENDER);
     failed = !renderer->AddImage(this);
   }
 
+#ifndef DISABLED_STAGE_STATS
+  if (!stage_stats_file.empty() &&
+      !stage_recorder_->AppendPageJSON(stage_stats_file.c_str(), filename, page_index)) {
+    tprintf("Error, could not write stage times to %s\n", stage_stats_file.c_str());
+  }
+#endif
+
+  if (!replay_dir.empty()) {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const char *reason = nullptr;
+    if (failed) {
+      reason = "failed";
+    } else if (elapsed.count() >= replay_min_seconds) {
+      reason = "seconds";
+    } else if (replay_min_mb > 0 && memory_recorder_->values().total_page_peak >=
+                                        static_cast<size_t>(replay_min_mb) << 20) {
+      reason = "memory";
+    }
+    if (reason != nullptr) {
+      WriteReplayBundle(pix, page_index, filename, elapsed.count(), reason);
+    }
+  }
+
   return !failed;
 }
 
+// The variables which only say where to write what is measured, so that
+// a replay does not write into the files of the run which it replays.
+static const char *const kReplayExcludedParams[] = {"replay_dir", "replay_min_seconds",
+                                                    "replay_min_mb", "stage_stats_file",
+                                                    "profile_file"};
+
+// Creates the empty manifest of a new bundle in dir, named base or, if that
+// exists, base-2, base-3 and so on, so that the bundles of inputs with the
+// same name or of concurrent workers do not overwrite each other.
+// Returns the name, or an empty string if no manifest could be created.
+static std::string CreateReplayManifest(const std::string &dir, const std::string &base) {
+  const int kMaxBundlesPerName = 10000;
+  for (int n = 1; n <= kMaxBundlesPerName; ++n) {
+    std::string name = n == 1 ? base : base + "-" + std::to_string(n);
+    // "x" fails if the file exists, so two workers never get the same name.
+    FILE *fp = fopen((dir + "/" + name + ".replay").c_str(), "wx");
+    if (fp != nullptr) {
+      fclose(fp);
+      return name;
+    }
+    if (errno != EEXIST) {
+      break;
+    }
+  }
+  return "";
+}
+
+void TessBaseAPI::WriteReplayBundle(Pix *pix, int page_index, const char *filename,
+                                    double seconds, const char *reason) {
+  // The bundle is named after the input file without its directory and
+  // extension, and the page.
+  std::string name = filename != nullptr ? filename : "page";
+  size_t slash = name.find_last_of("/\\");
+  if (slash != std::string::npos) {
+    name.erase(0, slash + 1);
+  }
+  size_t dot = name.find_last_of('.');
+  if (dot != std::string::npos && dot > 0) {
+    name.erase(dot);
+  }
+  name += "-" + std::to_string(page_index);
+  name = CreateReplayManifest(replay_dir.c_str(), name);
+  if (name.empty()) {
+    tprintf("Error, could not create a replay bundle in %s\n", replay_dir.c_str());
+    return;
+  }
+  std::string prefix = replay_dir.c_str();
+  prefix += "/" + name;
+
+  bool ok = pixWrite((prefix + ".png").c_str(), pix, IFF_PNG) == 0;
+  Pix *binary = GetThresholdedImage();
+  if (binary != nullptr) {
+    ok = pixWrite((prefix + ".bin.png").c_str(), binary, IFF_PNG) == 0 && ok;
+    pixDestroy(&binary);
+  }
+  ParamsOverlay changed = ParamsOverlay::Capture(tesseract_->params(), true);
+  ParamsOverlay config;
+  for (auto &setting : changed.values()) {
+    bool excluded = false;
+    for (auto *excluded_name : kReplayExcludedParams) {
+      excluded = excluded || setting.first == excluded_name;
+    }
+    if (!excluded) {
+      config.Add(setting.first.c_str(), setting.second.c_str());
+    }
+  }
+  ok = config.WriteFile((prefix + ".config").c_str()) && ok;
+
+  std::ofstream manifest(prefix + ".replay");
+  manifest.imbue(std::locale::classic());
+  manifest << "# Tesseract replay bundle, see tesseract --replay\n";
+  manifest << "version " << Version() << '\n';
+  manifest << "input " << (filename != nullptr ? filename : "") << '\n';
+  manifest << "page " << page_index << '\n';
+  manifest << "datapath " << datapath_ << '\n';
+  manifest << "language " << language_ << '\n';
+  manifest << "oem " << static_cast<int>(last_oem_requested_) << '\n';
+  manifest << "model " << tesseract_->lang << ' ' << tesseract_->model_version() << '\n';
+  for (int i = 0; i < tesseract_->num_sub_langs(); ++i) {
+    Tesseract *lang = tesseract_->get_sub_lang(i);
+    manifest << "model " << lang->lang << ' ' << lang->model_version() << '\n';
+  }
+  manifest << "reason " << reason << '\n';
+  manifest << "seconds " << seconds << '\n';
+  manifest << "memory_page_peak " << memory_recorder_->values().total_page_peak << '\n';
+  manifest << "image " << name << ".png\n";
+  manifest << "thresholded " << name << ".bin.png\n";
+  manifest << "config " << name << ".config\n";
+  manifest << "stages " << GetStageStatsJSON() << '\n';
+  manifest << "memory " << GetMemoryStatsJSON() << '\n';
+  manifest.close();
+  if (!ok || manifest.fail()) {
+    tprintf("Error, could not write the replay bundle %s.replay\n", prefix.c_str());
+  } else {
+    TLOG(TESS_LOG_DEBUG, "Wrote the replay bundle %s.replay (%s)\n", prefix.c_str(), reason);
+  }
+}
+
+bool TessBaseAPI::ReplayPage(const char *manifest, const char *datapath,
+                             const char *profile_file) {
+  std::ifstream file(manifest);
+  if (!file) {
+    tprintf("Error, could not read the replay bundle %s\n", manifest);
+    return false;
+  }
+  // The files of the bundle are next to the manifest.
+  std::string dir = manifest;
+  size_t slash = dir.find_last_of("/\\");
+  dir = slash != std::string::npos ? dir.substr(0, slash + 1) : "";
+  std::map<std::string, std::string> values;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    size_t space = line.find(' ');
+    std::string key = line.substr(0, space);
+    std::string value = space != std::string::npos ? line.substr(space + 1) : "";
+    if (key == "model") {
+      tprintf("Model %s\n", value.c_str());
+    } else {
+      values[key] = value;
+    }
+  }
+  if (values["image"].empty() || values["config"].empty()) {
+    tprintf("Error, %s is not a replay bundle\n", manifest);
+    return false;
+  }
+  std::string config = dir + values["config"];
+  char *configs[] = {&config[0]};
+  auto oem = static_cast<OcrEngineMode>(atoi(values["oem"].c_str()));
+  if (Init(datapath != nullptr ? datapath : values["datapath"].c_str(),
+           values["language"].c_str(), oem, configs, 1, nullptr, nullptr, false) != 0) {
+    return false;
+  }
+  Pix *pix = pixRead((dir + values["image"]).c_str());
+  if (pix == nullptr) {
+    tprintf("Error, could not read %s%s\n", dir.c_str(), values["image"].c_str());
+    return false;
+  }
+  int page_index = atoi(values["page"].c_str());
+  ResetStageStats();
+  ResetMemoryPeaks();
+#ifndef DISABLED_STAGE_STATS
+  bool profile = profile_file != nullptr;
+  Profiler::Session session;
+  if (profile) {
+    session = Profiler::Start();
+  }
+#endif
+  auto start = std::chrono::steady_clock::now();
+  bool ok = ProcessPage(pix, page_index, values["input"].c_str(), nullptr, 0, nullptr);
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+#ifndef DISABLED_STAGE_STATS
+  if (profile && !Profiler::Stop(&session, profile_file)) {
+    tprintf("Error, could not write the profile to %s\n",
+            Profiler::SessionPath(profile_file, session).c_str());
+  }
+#endif
+  pixDestroy(&pix);
+  tprintf("Replayed page %d of %s in %.3f s, recorded %s s (%s)\n", page_index,
+          values["input"].c_str(), elapsed.count(), values["seconds"].c_str(),
+          values["reason"].c_str());
+  return ok;
+}
+
 /**
  * Get a left-to-right iterator to the results of LayoutAnalysis and/or
  * Recognize. The returned iterator must be deleted after use.
@@ -1430,129 +2131,22 @@ std::vector<std::tuple<int,int,int,int> > TessBaseAPI::GetTableCols(unsigned i)
   return cols;
 }
 
-static void AddBoxToTSV(const PageIterator *it, PageIteratorLevel level, std::string &text) {
-  int left, top, right, bottom;
-  it->BoundingBox(level, &left, &top, &right, &bottom);
-  text += "\t" + std::to_string(left);
-  text += "\t" + std::to_string(top);
-  text += "\t" + std::to_string(right - left);
-  text += "\t" + std::to_string(bottom - top);
-}
-
 /**
  * Make a TSV-formatted string from the internal data structures.
  * page_number is 0-based but will appear in the output as 1-based.
  * Returned string must be freed with the delete [] operator.
  */
 char *TessBaseAPI::GetTSVText(int page_number) {
-  if (tesseract_ == nullptr || (page_res_ == nullptr && Recognize(nullptr) < 0)) {
-    return nullptr;
-  }
-
-  int lcnt = 1, bcnt = 1, pcnt = 1, wcnt = 1;
-  int page_id = page_number + 1; // we use 1-based page numbers.
-
-  int page_num = page_id;
-  int block_num = 0;
-  int par_num = 0;
-  int line_num = 0;
-  int word_num = 0;
-
-  std::string tsv_str;
-  tsv_str += "1\t" + std::to_string(page_num); // level 1 - page
-  tsv_str += "\t" + std::to_string(block_num);
-  tsv_str += "\t" + std::to_string(par_num);
-  tsv_str += "\t" + std::to_string(line_num);
-  tsv_str += "\t" + std::to_string(word_num);
-  tsv_str += "\t" + std::to_string(rect_left_);
-  tsv_str += "\t" + std::to_string(rect_top_);
-  tsv_str += "\t" + std::to_string(rect_width_);
-  tsv_str += "\t" + std::to_string(rect_height_);
-  tsv_str += "\t-1\t\n";
-
-  ResultIterator *res_it = GetIterator();
-  while (!res_it->Empty(RIL_BLOCK)) {
-    if (res_it->Empty(RIL_WORD)) {
-      res_it->Next(RIL_WORD);
-      continue;
-    }
-
-    // Add rows for any new block/paragraph/textline.
-    if (res_it->IsAtBeginningOf(RIL_BLOCK)) {
-      block_num++;
-      par_num = 0;
-      line_num = 0;
-      word_num = 0;
-      tsv_str += "2\t" + std::to_string(page_num); // level 2 - block
-      tsv_str += "\t" + std::to_string(block_num);
-      tsv_str += "\t" + std::to_string(par_num);
-      tsv_str += "\t" + std::to_string(line_num);
-      tsv_str += "\t" + std::to_string(word_num);
-      AddBoxToTSV(res_it, RIL_BLOCK, tsv_str);
-      tsv_str += "\t-1\t\n"; // end of row for block
-    }
-    if (res_it->IsAtBeginningOf(RIL_PARA)) {
-      par_num++;
-      line_num = 0;
-      word_num = 0;
-      tsv_str += "3\t" + std::to_string(page_num); // level 3 - paragraph
-      tsv_str += "\t" + std::to_string(block_num);
-      tsv_str += "\t" + std::to_string(par_num);
-      tsv_str += "\t" + std::to_string(line_num);
-      tsv_str += "\t" + std::to_string(word_num);
-      AddBoxToTSV(res_it, RIL_PARA, tsv_str);
-      tsv_str += "\t-1\t\n"; // end of row for para
-    }
-    if (res_it->IsAtBeginningOf(RIL_TEXTLINE)) {
-      line_num++;
-      word_num = 0;
-      tsv_str += "4\t" + std::to_string(page_num); // level 4 - line
-      tsv_str += "\t" + std::to_string(block_num);
-      tsv_str += "\t" + std::to_string(par_num);
-      tsv_str += "\t" + std::to_string(line_num);
-      tsv_str += "\t" + std::to_string(word_num);
-      AddBoxToTSV(res_it, RIL_TEXTLINE, tsv_str);
-      tsv_str += "\t-1\t\n"; // end of row for line
-    }
-
-    // Now, process the word...
-    int left, top, right, bottom;
-    res_it->BoundingBox(RIL_WORD, &left, &top, &right, &bottom);
-    word_num++;
-    tsv_str += "5\t" + std::to_string(page_num); // level 5 - word
-    tsv_str += "\t" + std::to_string(block_num);
-    tsv_str += "\t" + std::to_string(par_num);
-    tsv_str += "\t" + std::to_string(line_num);
-    tsv_str += "\t" + std::to_string(word_num);
-    tsv_str += "\t" + std::to_string(left);
-    tsv_str += "\t" + std::to_string(top);
-    tsv_str += "\t" + std::to_string(right - left);
-    tsv_str += "\t" + std::to_string(bottom - top);
-    tsv_str += "\t" + std::to_string(res_it->Confidence(RIL_WORD));
-    tsv_str += "\t";
-
-    // Increment counts if at end of block/paragraph/textline.
-    if (res_it->IsAtFinalElement(RIL_TEXTLINE, RIL_WORD)) {
-      lcnt++;
-    }
-    if (res_it->IsAtFinalElement(RIL_PARA, RIL_WORD)) {
-      pcnt++;
-    }
-    if (res_it->IsAtFinalElement(RIL_BLOCK, RIL_WORD)) {
-      bcnt++;
+  std::string text;
+  {
+    BufferedWriter writer(&text);
+    TsvFormatter formatter(&writer, page_number);
+    if (!RenderPage(nullptr, {&formatter})) {
+      return nullptr;
     }
-
-    do {
-      tsv_str += std::unique_ptr<const char[]>(res_it->GetUTF8Text(RIL_SYMBOL)).get();
-      res_it->Next(RIL_SYMBOL);
-    } while (!res_it->Empty(RIL_BLOCK) && !res_it->IsAtBeginningOf(RIL_WORD));
-    tsv_str += "\n"; // end of row
-    wcnt++;
   }
-
-  char *ret = new char[tsv_str.length() + 1];
-  strcpy(ret, tsv_str.c_str());
-  delete res_it;
+  char *ret = new char[text.length() + 1];
+  strcpy(ret, text.c_str());
   return ret;
 }
 
@@ -1842,16 +2436,7 @@ int *TessBaseAPI::AllWordConfidences() {
   n_word = 0;
   for (res_it.restart_page(); res_it.word() != nullptr; res_it.forward()) {
     WERD_RES *word = res_it.word();
-    WERD_CHOICE *choice = word->best_choice;
-    int w_conf = static_cast<int>(100 + 5 * choice->certainty());
-    // This is the eq for converting Tesseract confidence to 1..100
-    if (w_conf < 0) {
-      w_conf = 0;
-    }
-    if (w_conf > 100) {
-      w_conf = 100;
-    }
-    conf[n_word++] = w_conf;
+    conf[n_word++] = WordConfidence(*word->best_choice);
   }
   conf[n_word] = -1;
   return conf;
@@ -1946,6 +2531,132 @@ void TessBaseAPI::Clear() {
   }
 }
 
+// Returns the allocation counts of the given recycled class.
+template <typename T>
+static TessBaseAPI::AllocatorStats RecyclerAllocatorStats(const char *name) {
+  RecyclerStats stats = Recycler<T>::Stats();
+  TessBaseAPI::AllocatorStats result;
+  result.name = name;
+  result.object_size = sizeof(T);
+  result.allocated = stats.allocated;
+  result.reused = stats.reused;
+  result.recycled = stats.recycled;
+  result.released = stats.released;
+  result.cached = stats.cached;
+  result.peak_cached = stats.peak_cached;
+  return result;
+}
+
+/** Returns the allocation counts of the page result objects. */
+std::vector<TessBaseAPI::AllocatorStats> TessBaseAPI::GetAllocatorStats() {
+  return {RecyclerAllocatorStats<PAGE_RES>("PAGE_RES"),
+          RecyclerAllocatorStats<BLOCK_RES>("BLOCK_RES"),
+          RecyclerAllocatorStats<ROW_RES>("ROW_RES"),
+          RecyclerAllocatorStats<WERD_RES>("WERD_RES"),
+          RecyclerAllocatorStats<WERD_CHOICE>("WERD_CHOICE"),
+          RecyclerAllocatorStats<BLOB_CHOICE>("BLOB_CHOICE")};
+}
+
+/** Frees the storage of deleted page result objects kept for reuse. */
+void TessBaseAPI::ReleaseRecycledMemory() {
+  Recycler<PAGE_RES>::Trim();
+  Recycler<BLOCK_RES>::Trim();
+  Recycler<ROW_RES>::Trim();
+  Recycler<WERD_RES>::Trim();
+  Recycler<WERD_CHOICE>::Trim();
+  Recycler<BLOB_CHOICE>::Trim();
+}
+
+/** Returns the time spent in each stage and the counters. */
+std::vector<TessBaseAPI::StageStats> TessBaseAPI::GetStageStats() const {
+  std::vector<StageStats> stats;
+  const StageRecorder::Values &page = stage_recorder_->page();
+  const StageRecorder::Values &total = stage_recorder_->total();
+  for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+    stats.push_back({StageRecorder::StageName(stage), false, page.seconds[stage],
+                     total.seconds[stage], page.calls[stage], total.calls[stage]});
+  }
+  for (int counter = 0; counter < COUNTER_COUNT; ++counter) {
+    bool skipped = counter == COUNTER_SKIPPED_PASSES;
+    stats.push_back({StageRecorder::CounterName(counter), true,
+                     skipped ? page.saved_seconds : 0.0, skipped ? total.saved_seconds : 0.0,
+                     page.counts[counter], total.counts[counter]});
+  }
+  return stats;
+}
+
+/** Returns the values of GetStageStats as a JSON object. */
+std::string TessBaseAPI::GetStageStatsJSON() const {
+  return stage_recorder_->ToJSON();
+}
+
+/** Clears the times and counters. */
+void TessBaseAPI::ResetStageStats() {
+  stage_recorder_->Reset();
+}
+
+std::vector<TessBaseAPI::MemoryStats> TessBaseAPI::GetMemoryStats() const {
+  const MemoryRecorder::Values &values = memory_recorder_->values();
+  std::vector<MemoryStats> stats;
+  for (int subsystem = 0; subsystem < MEMORY_COUNT; ++subsystem) {
+    stats.push_back({MemoryRecorder::SubsystemName(subsystem), values.bytes[subsystem],
+                     values.page_peak[subsystem], values.peak[subsystem]});
+  }
+  stats.push_back({"total", values.total_bytes, values.total_page_peak, values.total_peak});
+  const size_t dawg_cache = Dict::GlobalDawgCache()->MemoryUsed();
+  stats.push_back({"dawg_cache", dawg_cache, dawg_cache, dawg_cache});
+  return stats;
+}
+
+std::string TessBaseAPI::GetMemoryStatsJSON() const {
+  std::ostringstream stream;
+  stream.imbue(std::locale::classic());
+  const char *separator = "{";
+  for (auto &stats : GetMemoryStats()) {
+    stream << separator << '"' << stats.name << "\":{\"bytes\":" << stats.bytes
+           << ",\"page_peak\":" << stats.page_peak << ",\"peak\":" << stats.peak << '}';
+    separator = ",";
+  }
+  stream << '}';
+  return stream.str();
+}
+
+void TessBaseAPI::ResetMemoryPeaks() {
+  memory_recorder_->ResetPeaks();
+}
+
+// Sets the bytes of the models, the images and the results of the page in
+// the memory recorder. The grids are charged as they are made.
+void TessBaseAPI::MeasureMemory() {
+  if (tesseract_ != nullptr) {
+    tesseract_->MeasureMemory(memory_recorder_);
+  }
+  memory_recorder_->Set(MEMORY_PAGE_RES, page_res_ != nullptr ? page_res_->MemoryUsed() : 0);
+}
+
+std::string TessBaseAPI::GetLSTMLayerProfile() const {
+  std::string report;
+  if (tesseract_ == nullptr) {
+    return report;
+  }
+  for (int i = -1; i < tesseract_->num_sub_langs(); ++i) {
+    const Tesseract *lang = i < 0 ? tesseract_ : tesseract_->get_sub_lang(i);
+    const LSTMRecognizer *recognizer = lang->lstm_recognizer();
+    if (recognizer == nullptr || recognizer->layer_profile() == nullptr) {
+      continue;
+    }
+    report += "Language: " + lang->lang + "\n";
+    report += recognizer->layer_profile()->Report();
+  }
+  return report;
+}
+
+void TessBaseAPI::SetLogSink(LogSink *sink) {
+  // The messages which are queued for the old sink are written first.
+  LogFlush();
+  log_sink_ = sink;
+}
+
 /**
  * Close down tesseract and free up all memory. End() is equivalent to
  * destructing and reconstructing your TessBaseAPI.
@@ -1976,10 +2687,20 @@ void TessBaseAPI::End() {
   osd_tesseract_ = nullptr;
   delete equ_detect_;
   equ_detect_ = nullptr;
+  // The grids released their memory as they were deleted.
+  for (int subsystem = 0; subsystem < MEMORY_GRIDS; ++subsystem) {
+    memory_recorder_->Set(static_cast<MemorySubsystem>(subsystem), 0);
+  }
+  memory_recorder_->Set(MEMORY_PAGE_RES, 0);
+  delete retry_overlay_;
+  retry_overlay_ = nullptr;
+  retry_config_.clear();
   input_file_.clear();
   output_file_.clear();
   datapath_.clear();
   language_.clear();
+  // The sink may be deleted once the api is done.
+  LogFlush();
 }
 
 // Clear any library-level memory caches.
@@ -2077,6 +2798,9 @@ bool TessBaseAPI::InternalSetImage() {
     thresholder_ = new ImageThresholder;
   }
   ClearResults();
+  stage_recorder_->StartPage();
+  MeasureMemory();
+  memory_recorder_->StartPage();
   return true;
 }
 
@@ -2088,6 +2812,10 @@ bool TessBaseAPI::InternalSetImage() {
  */
 bool TessBaseAPI::Threshold(Pix **pix) {
   ASSERT_HOST(pix != nullptr);
+  STAGE_RECORDER_SCOPE(stage_recorder_);
+  MEMORY_RECORDER_SCOPE(memory_recorder_);
+  LogSinkScope log_sink_scope(log_sink_);
+  STAGE_TIMER(STAGE_THRESHOLD);
   if (*pix != nullptr) {
     pixDestroy(pix);
   }
@@ -2121,6 +2849,9 @@ bool TessBaseAPI::Threshold(Pix **pix) {
   if (!thresholder_->IsBinary()) {
     tesseract_->set_pix_thresholds(thresholder_->GetPixRectThresholds());
     tesseract_->set_pix_grey(thresholder_->GetPixRectGrey());
+    if (thresholder_->IsBorrowed()) {
+      SetInputImage(thresholder_->GetBorrowedImageGrey());
+    }
   } else {
     tesseract_->set_pix_thresholds(nullptr);
     tesseract_->set_pix_grey(nullptr);
@@ -2159,12 +2890,26 @@ int TessBaseAPI::FindLines() {
     tesseract_->InitAdaptiveClassifier(nullptr);
 #endif
   }
+  STAGE_RECORDER_SCOPE(stage_recorder_);
+  MEMORY_RECORDER_SCOPE(memory_recorder_);
+  LogSinkScope log_sink_scope(log_sink_);
   if (tesseract_->pix_binary() == nullptr && !Threshold(tesseract_->mutable_pix_binary())) {
     return -1;
   }
+  STAGE_TIMER(STAGE_LAYOUT);
 
   tesseract_->PrepareForPageseg();
 
+  if (UseLineFastPath(*tesseract_)) {
+    // The LSTM recognizes the whole image as a single line, so the page is
+    // a single block, row and word, and Textord is not needed.
+    BLOCK_IT block_it(block_list_);
+    block_it.add_to_end(
+        MakeLineBlock(TBOX(0, 0, tesseract_->ImageWidth(), tesseract_->ImageHeight())));
+    tesseract_->PrepareForTessOCR(block_list_, nullptr, nullptr);
+    return 0;
+  }
+
 #ifndef DISABLED_LEGACY_ENGINE
   if (tesseract_->textord_equation_detect) {
     if (equ_detect_ == nullptr && !datapath_.empty()) {
@@ -2359,17 +3104,31 @@ void TessBaseAPI::GetBlockTextOrientations(int **block_orientation, bool **verti
 }
 
 void TessBaseAPI::DetectParagraphs(bool after_text_recognition) {
+  STAGE_RECORDER_SCOPE(stage_recorder_);
+  MEMORY_RECORDER_SCOPE(memory_recorder_);
+  LogSinkScope log_sink_scope(log_sink_);
+  bool detect = true;
+  GetBoolVariable("paragraph_detection", &detect);
+  // If the outputs do not need the paragraphs, the detection still runs
+  // now and then to measure the time it saves, but its paragraphs are
+  // discarded, so the output is the same on all pages.
+  const bool needed = tesseract_->OutputNeedsPass(PASS_PARAGRAPHS);
+  if (!detect || (!needed && !PASS_SAMPLED(PASS_PARAGRAPHS))) {
+    // The rows of a new page have no paragraph, so each block reads as a
+    // single paragraph.
+    PASS_SKIPPED(PASS_PARAGRAPHS);
+    return;
+  }
+  STAGE_TIMER(STAGE_PARAGRAPHS);
+  PASS_TIMER(PASS_PARAGRAPHS);
   int debug_level = 0;
   GetIntVariable("paragraph_debug_level", &debug_level);
   if (paragraph_models_ == nullptr) {
     paragraph_models_ = new std::vector<ParagraphModel *>;
   }
   MutableIterator *result_it = GetMutableIterator();
-  do { // Detect paragraphs for this block
-    std::vector<ParagraphModel *> models;
-    ::tesseract::DetectParagraphs(debug_level, after_text_recognition, result_it, &models);
-    paragraph_models_->insert(paragraph_models_->end(), models.begin(), models.end());
-  } while (result_it->Next(RIL_BLOCK));
+  ::tesseract::DetectPageParagraphs(debug_level, after_text_recognition, result_it,
+                                    paragraph_models_, needed);
   delete result_it;
 }
 
@@ -0,0 +1,263 @@
+///////////////////////////////////////////////////////////////////////
+// File:        batchapi.cpp
+// Description: Recognition of many images on a pool of worker threads.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// Include automatically generated configuration file if running autoconf.
+#ifdef HAVE_CONFIG_H
+#  include "config_auto.h"
+#endif
+
+#include <tesseract/baseapi.h> // for TessBaseAPI
+#include <tesseract/batchapi.h>
+#include "params.h"            // for ParamsOverlay, GlobalParams
+#include "tesseractclass.h"    // for Tesseract
+#include "tprintf.h"           // for tprintf
+
+#include <allheaders.h> // for pixClone, pixDestroy, pixGetWidth, pixReadMem
+
+#include <algorithm>          // for std::max
+#include <chrono>             // for std::chrono::steady_clock
+#include <condition_variable> // for std::condition_variable
+#include <deque>              // for std::deque
+#include <memory>             // for std::make_shared
+#include <mutex>              // for std::mutex
+#include <thread>             // for std::thread
+
+namespace tesseract {
+
+using Clock = std::chrono::steady_clock;
+
+static double SecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Returns true if name is a global parameter, which all workers share.
+static bool IsGlobalParam(const char *name) {
+  const ParamsVectors *globals = GlobalParams();
+  return globals->int_params.find(name) != nullptr ||
+         globals->bool_params.find(name) != nullptr ||
+         globals->string_params.find(name) != nullptr ||
+         globals->double_params.find(name) != nullptr;
+}
+
+struct TessBatchAPI::Internal {
+  // A submitted item waiting for a worker.
+  struct Task {
+    Item item;
+    Callback callback;
+    int id;
+    Clock::time_point submitted;
+  };
+
+  // Worker thread main loop.
+  void Run(TessBaseAPI *api);
+  // Recognizes one item with the given api and calls its callback.
+  static void Process(TessBaseAPI *api, Task *task);
+
+  std::vector<std::unique_ptr<TessBaseAPI>> apis;
+  std::vector<std::thread> threads;
+  std::mutex mutex;
+  std::condition_variable work_available;
+  std::condition_variable all_done;
+  std::deque<Task> queue;
+  int next_id = 0;
+  int pending = 0; // Submitted and not yet finished.
+  bool stopping = false;
+};
+
+void TessBatchAPI::Internal::Run(TessBaseAPI *api) {
+  for (;;) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      work_available.wait(lock, [this] { return stopping || !queue.empty(); });
+      if (queue.empty()) {
+        return;
+      }
+      task = std::move(queue.front());
+      queue.pop_front();
+    }
+    Process(api, &task);
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--pending == 0) {
+      all_done.notify_all();
+    }
+  }
+}
+
+void TessBatchAPI::Internal::Process(TessBaseAPI *api, Task *task) {
+  Item &item = task->item;
+  Result result;
+  result.id = task->id;
+  result.queue_seconds = SecondsSince(task->submitted);
+
+  auto start = Clock::now();
+  Pix *pix = item.pix;
+  if (pix == nullptr && !item.data.empty()) {
+    pix = pixReadMem(reinterpret_cast<const l_uint8 *>(item.data.data()), item.data.size());
+    result.decode_seconds = SecondsSince(start);
+    if (pix == nullptr) {
+      tprintf("Error: batch item %d: image data cannot be read\n", task->id);
+    }
+  }
+  if (pix == nullptr) {
+    if (task->callback) {
+      task->callback(result, nullptr);
+    }
+    return;
+  }
+
+  // Apply the settings of the item to the parameters of this worker only.
+  // Setting a global parameter would race with the other workers.
+  ParamsOverlay overlay;
+  for (auto &variable : item.variables) {
+    if (IsGlobalParam(variable.first.c_str())) {
+      tprintf("Warning: batch item %d: cannot set global variable %s\n", task->id,
+              variable.first.c_str());
+      continue;
+    }
+    overlay.Add(variable.first.c_str(), variable.second.c_str());
+  }
+  if (!overlay.Apply(SET_PARAM_CONSTRAINT_NON_INIT_ONLY, api->tesseract()->params())) {
+    tprintf("Warning: batch item %d: cannot set some of its variables\n", task->id);
+  }
+  PageSegMode old_psm = api->GetPageSegMode();
+  if (item.psm != PSM_COUNT) {
+    api->SetPageSegMode(item.psm);
+  }
+
+  start = Clock::now();
+  api->SetImage(pix);
+  result.ok = true;
+  if (item.rectangles.empty()) {
+    item.rectangles.push_back({0, 0, 0, 0});
+  }
+  int confidence_sum = 0;
+  for (auto &rect : item.rectangles) {
+    if (rect.width > 0 && rect.height > 0) {
+      api->SetRectangle(rect.left, rect.top, rect.width, rect.height);
+    } else {
+      api->SetRectangle(0, 0, pixGetWidth(pix), pixGetHeight(pix));
+    }
+    char *text = api->GetUTF8Text();
+    if (text == nullptr) {
+      result.ok = false;
+      break;
+    }
+    result.text += text;
+    delete[] text;
+    confidence_sum += api->MeanTextConf();
+  }
+  if (result.ok) {
+    result.mean_confidence = confidence_sum / static_cast<int>(item.rectangles.size());
+  }
+  result.recognize_seconds = SecondsSince(start);
+
+  if (task->callback) {
+    task->callback(result, api);
+  }
+
+  api->Clear();
+  api->SetPageSegMode(old_psm);
+  overlay.Revert();
+  // Both a clone of the given pix and a decoded image belong to the task.
+  pixDestroy(&pix);
+}
+
+TessBatchAPI::TessBatchAPI() : internal_(new Internal) {}
+
+TessBatchAPI::~TessBatchAPI() {
+  Wait();
+  {
+    std::lock_guard<std::mutex> lock(internal_->mutex);
+    internal_->stopping = true;
+  }
+  internal_->work_available.notify_all();
+  for (auto &thread : internal_->threads) {
+    thread.join();
+  }
+}
+
+int TessBatchAPI::Init(const char *datapath, const char *language, OcrEngineMode oem,
+                       int num_workers, const std::vector<std::string> *vars_vec,
+                       const std::vector<std::string> *vars_values) {
+  if (!internal_->apis.empty()) {
+    tprintf("Error: TessBatchAPI::Init must only be called once\n");
+    return -1;
+  }
+  if (num_workers <= 0) {
+    num_workers = std::max(1u, std::thread::hardware_concurrency());
+  }
+  // The workers are initialized one after another, because Init may also
+  // set global parameters.
+  for (int i = 0; i < num_workers; ++i) {
+    std::unique_ptr<TessBaseAPI> api(new TessBaseAPI);
+    if (api->Init(datapath, language, oem, nullptr, 0, vars_vec, vars_values, false) != 0) {
+      internal_->apis.clear();
+      return -1;
+    }
+    internal_->apis.push_back(std::move(api));
+  }
+  for (auto &api : internal_->apis) {
+    internal_->threads.emplace_back(&Internal::Run, internal_.get(), api.get());
+  }
+  return 0;
+}
+
+std::future<TessBatchAPI::Result> TessBatchAPI::Submit(const Item &item) {
+  auto promise = std::make_shared<std::promise<Result>>();
+  std::future<Result> future = promise->get_future();
+  int id = Submit(item, [promise](const Result &result, TessBaseAPI *) {
+    promise->set_value(result);
+  });
+  if (id < 0) {
+    promise->set_value(Result());
+  }
+  return future;
+}
+
+int TessBatchAPI::Submit(const Item &item, Callback callback) {
+  if (internal_->threads.empty()) {
+    tprintf("Error: TessBatchAPI::Submit called before a successful Init\n");
+    return -1;
+  }
+  Internal::Task task;
+  task.item = item;
+  if (item.pix != nullptr) {
+    task.item.pix = pixClone(item.pix);
+  }
+  task.callback = std::move(callback);
+  task.submitted = Clock::now();
+  int id;
+  {
+    std::lock_guard<std::mutex> lock(internal_->mutex);
+    id = task.id = internal_->next_id++;
+    ++internal_->pending;
+    internal_->queue.push_back(std::move(task));
+  }
+  internal_->work_available.notify_one();
+  return id;
+}
+
+void TessBatchAPI::Wait() {
+  std::unique_lock<std::mutex> lock(internal_->mutex);
+  internal_->all_done.wait(lock, [this] { return internal_->pending == 0; });
+}
+
+int TessBatchAPI::NumWorkers() const {
+  return internal_->threads.size();
+}
+
+} // namespace tesseract.
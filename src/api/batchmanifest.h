@@ -0,0 +1,102 @@
+///////////////////////////////////////////////////////////////////////
+// File:        batchmanifest.h
+// Description: Parsing of the manifest of a tesseract --batch run.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_API_BATCHMANIFEST_H_
+#define TESSERACT_API_BATCHMANIFEST_H_
+
+#include <istream> // for std::istream
+#include <string>  // for std::string, std::getline
+
+namespace tesseract {
+
+// One document of a --batch manifest.
+struct BatchJob {
+  std::string input;
+  std::string outputbase;
+};
+
+enum class BatchLine {
+  kSkip,    // Empty line or comment.
+  kJob,     // A document to process.
+  kInvalid, // Malformed line, which must be reported.
+};
+
+// Returns true if outputbase means the standard output, like for a single
+// document.
+inline bool IsStdoutName(const std::string &outputbase) {
+  return outputbase == "stdout" || outputbase == "-";
+}
+
+// Parses one line of a --batch manifest. The line holds the input image
+// (or image list) and its outputbase, separated by a tab. Only the tab
+// separates them, so both names may contain spaces. A line without a tab
+// is the input alone, and the input name without its extension is used as
+// outputbase. Empty lines and lines starting with '#' are skipped. A line
+// with an empty field or more than one tab is invalid.
+inline BatchLine ParseBatchLine(std::string line, BatchJob *job) {
+  if (!line.empty() && line.back() == '\r') {
+    line.pop_back();
+  }
+  if (line.empty() || line[0] == '#') {
+    return BatchLine::kSkip;
+  }
+  auto separator = line.find('\t');
+  if (separator == std::string::npos) {
+    job->input = line;
+    auto dot = line.rfind('.');
+    auto slash = line.find_last_of("/\\");
+    if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) {
+      job->outputbase = line.substr(0, dot);
+    } else {
+      job->outputbase = line;
+    }
+    return BatchLine::kJob;
+  }
+  if (line.find('\t', separator + 1) != std::string::npos) {
+    return BatchLine::kInvalid;
+  }
+  job->input = line.substr(0, separator);
+  job->outputbase = line.substr(separator + 1);
+  if (job->input.empty() || job->outputbase.empty()) {
+    return BatchLine::kInvalid;
+  }
+  return BatchLine::kJob;
+}
+
+// Reads the next document from a --batch manifest. *line_number counts the
+// lines read so far, and report(line_number, line) is called for every
+// invalid line. Returns false at the end of the manifest.
+template <typename Report>
+bool ReadBatchJob(std::istream &in, BatchJob *job, int *line_number, Report report) {
+  std::string line;
+  while (std::getline(in, line)) {
+    ++*line_number;
+    switch (ParseBatchLine(line, job)) {
+      case BatchLine::kJob:
+        return true;
+      case BatchLine::kInvalid:
+        report(*line_number, line);
+        break;
+      case BatchLine::kSkip:
+        break;
+    }
+  }
+  return false;
+}
+
+} // namespace tesseract
+
+#endif // TESSERACT_API_BATCHMANIFEST_H_
@@ -301,6 +301,11 @@ void TessBaseAPISetImage2(TessBaseAPI *handle, struct Pix *pix) {
   return handle->SetImage(pix);
 }
 
+void TessBaseAPISetImageBorrowed(TessBaseAPI *handle, const unsigned char *imagedata, int width,
+                                 int height, int bytes_per_pixel, int bytes_per_line) {
+  handle->SetImageBorrowed(imagedata, width, height, bytes_per_pixel, bytes_per_line);
+}
+
 void TessBaseAPISetSourceResolution(TessBaseAPI *handle, int ppi) {
   handle->SetSourceResolution(ppi);
 }
@@ -452,6 +457,17 @@ void TessBaseAPIEnd(TessBaseAPI *handle) {
   handle->End();
 }
 
+char *TessBaseAPIGetStageStatsJSON(TessBaseAPI *handle) {
+  const std::string json = handle->GetStageStatsJSON();
+  auto *text = new char[json.length() + 1];
+  strcpy(text, json.c_str());
+  return text;
+}
+
+void TessBaseAPIResetStageStats(TessBaseAPI *handle) {
+  handle->ResetStageStats();
+}
+
 int TessBaseAPIIsValidWord(TessBaseAPI *handle, const char *word) {
   return handle->IsValidWord(word);
 }
@@ -687,3 +703,149 @@ int TessMonitorGetProgress(ETEXT_DESC *monitor) {
 void TessMonitorSetDeadlineMSecs(ETEXT_DESC *monitor, int deadline) {
   monitor->set_deadline_msecs(deadline);
 }
+
+TessAsyncRecognition *TessBaseAPIRecognizeAsync(TessBaseAPI *handle, int timeout_millisec,
+                                                TessLineFunc callback, void *user_data) {
+  if (callback == nullptr) {
+    return new TessAsyncRecognition(handle, nullptr, timeout_millisec);
+  }
+  return new TessAsyncRecognition(
+      handle,
+      [callback, user_data](const tesseract::RecognizedLine &line) {
+        callback(line.block, line.line, line.left, line.top, line.right, line.bottom,
+                 line.confidence, line.text.c_str(), user_data);
+      },
+      timeout_millisec);
+}
+
+void TessAsyncRecognitionDelete(TessAsyncRecognition *handle) {
+  delete handle;
+}
+
+void TessAsyncRecognitionCancel(TessAsyncRecognition *handle) {
+  handle->Cancel();
+}
+
+BOOL TessAsyncRecognitionIsCancelled(const TessAsyncRecognition *handle) {
+  return static_cast<int>(handle->IsCancelled());
+}
+
+BOOL TessAsyncRecognitionIsDone(const TessAsyncRecognition *handle) {
+  return static_cast<int>(handle->IsDone());
+}
+
+int TessAsyncRecognitionProgress(const TessAsyncRecognition *handle) {
+  return handle->Progress();
+}
+
+int TessAsyncRecognitionWait(TessAsyncRecognition *handle) {
+  return handle->Wait();
+}
+
+char *TessAsyncRecognitionNextLine(TessAsyncRecognition *handle, BOOL wait, int *block, int *line,
+                                   int *left, int *top, int *right, int *bottom,
+                                   float *confidence) {
+  tesseract::RecognizedLine next;
+  if (!handle->NextLine(&next, wait != FALSE)) {
+    return nullptr;
+  }
+  *block = next.block;
+  *line = next.line;
+  *left = next.left;
+  *top = next.top;
+  *right = next.right;
+  *bottom = next.bottom;
+  *confidence = next.confidence;
+  auto *text = new char[next.text.length() + 1];
+  strcpy(text, next.text.c_str());
+  return text;
+}
+
+TessBatchAPI *TessBatchAPICreate() {
+  return new TessBatchAPI;
+}
+
+void TessBatchAPIDelete(TessBatchAPI *handle) {
+  delete handle;
+}
+
+int TessBatchAPIInit(TessBatchAPI *handle, const char *datapath, const char *language,
+                     TessOcrEngineMode oem, int num_workers) {
+  return handle->Init(datapath, language, oem, num_workers);
+}
+
+int TessBatchAPISubmit(TessBatchAPI *handle, const TessBatchItem *item,
+                       TessBatchCallback callback, void *user_data) {
+  if (callback == nullptr) {
+    return handle->Submit(*item, nullptr);
+  }
+  return handle->Submit(*item, [callback, user_data](const TessBatchResult &result,
+                                                     TessBaseAPI *api) {
+    callback(&result, api, user_data);
+  });
+}
+
+void TessBatchAPIWait(TessBatchAPI *handle) {
+  handle->Wait();
+}
+
+int TessBatchAPINumWorkers(const TessBatchAPI *handle) {
+  return handle->NumWorkers();
+}
+
+TessBatchItem *TessBatchItemCreate() {
+  return new TessBatchItem;
+}
+
+void TessBatchItemDelete(TessBatchItem *item) {
+  delete item;
+}
+
+void TessBatchItemSetImage(TessBatchItem *item, struct Pix *pix) {
+  item->pix = pix;
+}
+
+void TessBatchItemSetImageData(TessBatchItem *item, const unsigned char *data, size_t size) {
+  item->data.assign(reinterpret_cast<const char *>(data), size);
+}
+
+void TessBatchItemSetPageSegMode(TessBatchItem *item, TessPageSegMode mode) {
+  item->psm = mode;
+}
+
+void TessBatchItemAddRectangle(TessBatchItem *item, int left, int top, int width, int height) {
+  item->rectangles.push_back({left, top, width, height});
+}
+
+void TessBatchItemSetVariable(TessBatchItem *item, const char *name, const char *value) {
+  item->variables.emplace_back(name, value);
+}
+
+int TessBatchResultId(const TessBatchResult *result) {
+  return result->id;
+}
+
+BOOL TessBatchResultSucceeded(const TessBatchResult *result) {
+  return static_cast<int>(result->ok);
+}
+
+const char *TessBatchResultText(const TessBatchResult *result) {
+  return result->text.c_str();
+}
+
+int TessBatchResultMeanTextConf(const TessBatchResult *result) {
+  return result->mean_confidence;
+}
+
+void TessBatchResultTimes(const TessBatchResult *result, double *queue_seconds,
+                          double *decode_seconds, double *recognize_seconds) {
+  if (queue_seconds != nullptr) {
+    *queue_seconds = result->queue_seconds;
+  }
+  if (decode_seconds != nullptr) {
+    *decode_seconds = result->decode_seconds;
+  }
+  if (recognize_seconds != nullptr) {
+    *recognize_seconds = result->recognize_seconds;
+  }
+}
@@ -18,13 +18,11 @@
  **********************************************************************/
 
 #include <tesseract/baseapi.h> // for TessBaseAPI
-#include <locale>              // for std::locale::classic
+#include <cmath>               // for round
+#include <cstring>             // for strcmp, strcpy
 #include <memory>              // for std::unique_ptr
-#include <sstream>             // for std::stringstream
-#ifdef _WIN32
-#  include "host.h" // windows.h for MultiByteToWideChar, ...
-#endif
 #include <tesseract/renderer.h>
+#include "pagerenderer.h"   // for HOcrFormatter, BufferedWriter
 #include "tesseractclass.h" // for Tesseract
 
 namespace tesseract {
@@ -49,20 +47,19 @@ static tesseract::Orientation GetBlockTextOrientation(const PageIterator *it) {
  * method currently only inserts a 'textangle' property to indicate the rotation
  * direction and does not add any baseline information to the hocr string.
  */
-static void AddBaselineCoordsTohOCR(const PageIterator *it, PageIteratorLevel level,
-                                    std::stringstream &hocr_str) {
-  tesseract::Orientation orientation = GetBlockTextOrientation(it);
+void HOcrFormatter::AddBaselineCoords(const ResultIterator &it, PageIteratorLevel level) {
+  tesseract::Orientation orientation = GetBlockTextOrientation(&it);
   if (orientation != ORIENTATION_PAGE_UP) {
-    hocr_str << "; textangle " << 360 - orientation * 90;
+    *out_ << "; textangle " << 360 - orientation * 90;
     return;
   }
 
   int left, top, right, bottom;
-  it->BoundingBox(level, &left, &top, &right, &bottom);
+  it.BoundingBox(level, &left, &top, &right, &bottom);
 
   // Try to get the baseline coordinates at this level.
   int x1, y1, x2, y2;
-  if (!it->Baseline(level, &x1, &y1, &x2, &y2)) {
+  if (!it.Baseline(level, &x1, &y1, &x2, &y2)) {
     return;
   }
   // Following the description of this field of the hOCR spec, we convert the
@@ -82,348 +79,329 @@ static void AddBaselineCoordsTohOCR(const PageIterator *it, PageIteratorLevel le
   double p1 = (y2 - y1) / static_cast<double>(x2 - x1);
   double p0 = y1 - p1 * x1;
 
-  hocr_str << "; baseline " << round(p1 * 1000.0) / 1000.0 << " " << round(p0 * 1000.0) / 1000.0;
+  *out_ << "; baseline " << round(p1 * 1000.0) / 1000.0 << " " << round(p0 * 1000.0) / 1000.0;
 }
 
-static void AddBoxTohOCR(const ResultIterator *it, PageIteratorLevel level,
-                         std::stringstream &hocr_str) {
+void HOcrFormatter::AddBox(const ResultIterator &it, PageIteratorLevel level) {
   int left, top, right, bottom;
-  it->BoundingBox(level, &left, &top, &right, &bottom);
+  it.BoundingBox(level, &left, &top, &right, &bottom);
   // This is the only place we use double quotes instead of single quotes,
   // but it may too late to change for consistency
-  hocr_str << " title=\"bbox " << left << " " << top << " " << right << " " << bottom;
+  *out_ << " title=\"bbox " << left << " " << top << " " << right << " " << bottom;
   // Add baseline coordinates & heights for textlines only.
   if (level == RIL_TEXTLINE) {
-    AddBaselineCoordsTohOCR(it, level, hocr_str);
+    AddBaselineCoords(it, level);
     // add custom height measures
     float row_height, descenders, ascenders; // row attributes
-    it->RowAttributes(&row_height, &descenders, &ascenders);
+    it.RowAttributes(&row_height, &descenders, &ascenders);
     // TODO(rays): Do we want to limit these to a single decimal place?
-    hocr_str << "; x_size " << row_height << "; x_descenders " << -descenders << "; x_ascenders "
-             << ascenders;
+    *out_ << "; x_size " << row_height << "; x_descenders " << -descenders << "; x_ascenders "
+          << ascenders;
   }
-  hocr_str << "\">";
+  *out_ << "\">";
 }
 
-/**
- * Make a HTML-formatted string with hOCR markup from the internal
- * data structures.
- * page_number is 0-based but will appear in the output as 1-based.
- * Image name/input_file_ can be set by SetInputName before calling
- * GetHOCRText
- * STL removed from original patch submission and refactored by rays.
- * Returned string must be freed with the delete [] operator.
- */
-char *TessBaseAPI::GetHOCRText(int page_number) {
-  return GetHOCRText(nullptr, page_number);
-}
-
-/**
- * Make a HTML-formatted string with hOCR markup from the internal
- * data structures.
- * page_number is 0-based but will appear in the output as 1-based.
- * Image name/input_file_ can be set by SetInputName before calling
- * GetHOCRText
- * STL removed from original patch submission and refactored by rays.
- * Returned string must be freed with the delete [] operator.
- */
-char *TessBaseAPI::GetHOCRText(ETEXT_DESC *monitor, int page_number) {
-  if (tesseract_ == nullptr || (page_res_ == nullptr && Recognize(monitor) < 0)) {
-    return nullptr;
-  }
-
-  int lcnt = 1, bcnt = 1, pcnt = 1, wcnt = 1, scnt = 1, tcnt = 1, ccnt = 1;
-  int page_id = page_number + 1; // hOCR uses 1-based page numbers.
-  bool para_is_ltr = true;       // Default direction is LTR
-  const char *paragraph_lang = nullptr;
-  bool font_info = false;
-  bool hocr_boxes = false;
-  GetBoolVariable("hocr_font_info", &font_info);
-  GetBoolVariable("hocr_char_boxes", &hocr_boxes);
-
-  if (input_file_.empty()) {
-    SetInputName(nullptr);
-  }
+void HOcrFormatter::BeginPage(const PageInfo &page) {
+  page_id_ = page_number_ + 1; // hOCR uses 1-based page numbers.
+  page.api->GetBoolVariable("hocr_font_info", &font_info_);
+  page.api->GetBoolVariable("hocr_char_boxes", &hocr_boxes_);
+  lstm_choice_mode_ = page.api->tesseract()->lstm_choice_mode;
+  lstm_rating_coefficient_ = page.api->tesseract()->lstm_rating_coefficient;
 
-#ifdef _WIN32
-  // convert input name from ANSI encoding to utf-8
-  int str16_len = MultiByteToWideChar(CP_ACP, 0, input_file_.c_str(), -1, nullptr, 0);
-  wchar_t *uni16_str = new WCHAR[str16_len];
-  str16_len = MultiByteToWideChar(CP_ACP, 0, input_file_.c_str(), -1, uni16_str, str16_len);
-  int utf8_len =
-      WideCharToMultiByte(CP_UTF8, 0, uni16_str, str16_len, nullptr, 0, nullptr, nullptr);
-  char *utf8_str = new char[utf8_len];
-  WideCharToMultiByte(CP_UTF8, 0, uni16_str, str16_len, utf8_str, utf8_len, nullptr, nullptr);
-  input_file_ = utf8_str;
-  delete[] uni16_str;
-  delete[] utf8_str;
-#endif
-
-  std::stringstream hocr_str;
-  // Use "C" locale (needed for double values x_size and x_descenders).
-  hocr_str.imbue(std::locale::classic());
-  // Use 8 digits for double values.
-  hocr_str.precision(8);
-  hocr_str << "  <div class='ocr_page'";
-  hocr_str << " id='"
-           << "page_" << page_id << "'";
-  hocr_str << " title='image \"";
-  if (!input_file_.empty()) {
-    hocr_str << HOcrEscape(input_file_.c_str()).c_str();
+  *out_ << "  <div class='ocr_page'";
+  *out_ << " id='"
+        << "page_" << page_id_ << "'";
+  *out_ << " title='image \"";
+  if (!page.image_name.empty()) {
+    out_->WriteEscaped(page.image_name.c_str());
   } else {
-    hocr_str << "unknown";
+    *out_ << "unknown";
   }
-  hocr_str << "\"; bbox " << rect_left_ << " " << rect_top_ << " " << rect_width_ << " "
-           << rect_height_ << "; ppageno " << page_number << "'>\n";
-
-  std::unique_ptr<ResultIterator> res_it(GetIterator());
-  while (!res_it->Empty(RIL_BLOCK)) {
-    if (res_it->Empty(RIL_WORD)) {
-      res_it->Next(RIL_WORD);
-      continue;
-    }
+  *out_ << "\"; bbox " << page.left << " " << page.top << " " << page.width << " "
+        << page.height << "; ppageno " << page_number_ << "'>\n";
+}
 
-    // Open any new block/paragraph/textline.
-    if (res_it->IsAtBeginningOf(RIL_BLOCK)) {
-      para_is_ltr = true; // reset to default direction
-      hocr_str << "   <div class='ocr_carea'"
-               << " id='"
-               << "block_" << page_id << "_" << bcnt << "'";
-      AddBoxTohOCR(res_it.get(), RIL_BLOCK, hocr_str);
-    }
-    if (res_it->IsAtBeginningOf(RIL_PARA)) {
-      hocr_str << "\n    <p class='ocr_par'";
-      para_is_ltr = res_it->ParagraphIsLtr();
-      if (!para_is_ltr) {
-        hocr_str << " dir='rtl'";
+void HOcrFormatter::BeginElement(const ResultIterator &it, PageIteratorLevel level) {
+  switch (level) {
+    case RIL_BLOCK:
+      para_is_ltr_ = true; // reset to default direction
+      *out_ << "   <div class='ocr_carea'"
+            << " id='"
+            << "block_" << page_id_ << "_" << bcnt_ << "'";
+      AddBox(it, RIL_BLOCK);
+      break;
+    case RIL_PARA:
+      *out_ << "\n    <p class='ocr_par'";
+      para_is_ltr_ = it.ParagraphIsLtr();
+      if (!para_is_ltr_) {
+        *out_ << " dir='rtl'";
       }
-      hocr_str << " id='"
-               << "par_" << page_id << "_" << pcnt << "'";
-      paragraph_lang = res_it->WordRecognitionLanguage();
-      if (paragraph_lang) {
-        hocr_str << " lang='" << paragraph_lang << "'";
+      *out_ << " id='"
+            << "par_" << page_id_ << "_" << pcnt_ << "'";
+      paragraph_lang_ = it.WordRecognitionLanguage();
+      if (paragraph_lang_) {
+        *out_ << " lang='" << paragraph_lang_ << "'";
       }
-      AddBoxTohOCR(res_it.get(), RIL_PARA, hocr_str);
-    }
-    if (res_it->IsAtBeginningOf(RIL_TEXTLINE)) {
-      hocr_str << "\n     <span class='";
-      switch (res_it->BlockType()) {
+      AddBox(it, RIL_PARA);
+      break;
+    case RIL_TEXTLINE:
+      *out_ << "\n     <span class='";
+      switch (it.BlockType()) {
         case PT_HEADING_TEXT:
-          hocr_str << "ocr_header";
+          *out_ << "ocr_header";
           break;
         case PT_PULLOUT_TEXT:
-          hocr_str << "ocr_textfloat";
+          *out_ << "ocr_textfloat";
           break;
         case PT_CAPTION_TEXT:
-          hocr_str << "ocr_caption";
+          *out_ << "ocr_caption";
           break;
         default:
-          hocr_str << "ocr_line";
+          *out_ << "ocr_line";
       }
-      hocr_str << "' id='"
-               << "line_" << page_id << "_" << lcnt << "'";
-      AddBoxTohOCR(res_it.get(), RIL_TEXTLINE, hocr_str);
-    }
+      *out_ << "' id='"
+            << "line_" << page_id_ << "_" << lcnt_ << "'";
+      AddBox(it, RIL_TEXTLINE);
+      break;
+    default:
+      break;
+  }
+}
 
-    // Now, process the word...
-    int32_t lstm_choice_mode = tesseract_->lstm_choice_mode;
-    std::vector<std::vector<std::vector<std::pair<const char *, float>>>> *rawTimestepMap = nullptr;
-    std::vector<std::vector<std::pair<const char *, float>>> *CTCMap = nullptr;
-    if (lstm_choice_mode) {
-      CTCMap = res_it->GetBestLSTMSymbolChoices();
-      rawTimestepMap = res_it->GetRawLSTMTimesteps();
+void HOcrFormatter::BeginWord(const ResultIterator &it) {
+  raw_timestep_map_ = nullptr;
+  ctc_map_ = nullptr;
+  if (lstm_choice_mode_) {
+    ctc_map_ = it.GetBestLSTMSymbolChoices();
+    raw_timestep_map_ = it.GetRawLSTMTimesteps();
+  }
+  *out_ << "\n      <span class='ocrx_word'"
+        << " id='"
+        << "word_" << page_id_ << "_" << wcnt_ << "'";
+  int left, top, right, bottom;
+  bool underlined, monospace, serif, smallcaps;
+  int pointsize, font_id;
+  const char *font_name;
+  it.BoundingBox(RIL_WORD, &left, &top, &right, &bottom);
+  font_name = it.WordFontAttributes(&bold_, &italic_, &underlined, &monospace, &serif,
+                                    &smallcaps, &pointsize, &font_id);
+  *out_ << " title='bbox " << left << " " << top << " " << right << " " << bottom
+        << "; x_wconf " << static_cast<int>(it.Confidence(RIL_WORD));
+  if (font_info_) {
+    if (font_name) {
+      *out_ << "; x_font ";
+      out_->WriteEscaped(font_name);
     }
-    hocr_str << "\n      <span class='ocrx_word'"
-             << " id='"
-             << "word_" << page_id << "_" << wcnt << "'";
-    int left, top, right, bottom;
-    bool bold, italic, underlined, monospace, serif, smallcaps;
-    int pointsize, font_id;
-    const char *font_name;
-    res_it->BoundingBox(RIL_WORD, &left, &top, &right, &bottom);
-    font_name = res_it->WordFontAttributes(&bold, &italic, &underlined, &monospace, &serif,
-                                           &smallcaps, &pointsize, &font_id);
-    hocr_str << " title='bbox " << left << " " << top << " " << right << " " << bottom
-             << "; x_wconf " << static_cast<int>(res_it->Confidence(RIL_WORD));
-    if (font_info) {
-      if (font_name) {
-        hocr_str << "; x_font " << HOcrEscape(font_name).c_str();
+    *out_ << "; x_fsize " << pointsize;
+  }
+  *out_ << "'";
+  const char *lang = it.WordRecognitionLanguage();
+  if (lang && (!paragraph_lang_ || strcmp(lang, paragraph_lang_))) {
+    *out_ << " lang='" << lang << "'";
+  }
+  switch (it.WordDirection()) {
+    // Only emit direction if different from current paragraph direction
+    case DIR_LEFT_TO_RIGHT:
+      if (!para_is_ltr_) {
+        *out_ << " dir='ltr'";
       }
-      hocr_str << "; x_fsize " << pointsize;
-    }
-    hocr_str << "'";
-    const char *lang = res_it->WordRecognitionLanguage();
-    if (lang && (!paragraph_lang || strcmp(lang, paragraph_lang))) {
-      hocr_str << " lang='" << lang << "'";
-    }
-    switch (res_it->WordDirection()) {
-      // Only emit direction if different from current paragraph direction
-      case DIR_LEFT_TO_RIGHT:
-        if (!para_is_ltr) {
-          hocr_str << " dir='ltr'";
-        }
-        break;
-      case DIR_RIGHT_TO_LEFT:
-        if (para_is_ltr) {
-          hocr_str << " dir='rtl'";
-        }
-        break;
-      case DIR_MIX:
-      case DIR_NEUTRAL:
-      default: // Do nothing.
-        break;
-    }
-    hocr_str << ">";
-    bool last_word_in_line = res_it->IsAtFinalElement(RIL_TEXTLINE, RIL_WORD);
-    bool last_word_in_para = res_it->IsAtFinalElement(RIL_PARA, RIL_WORD);
-    bool last_word_in_block = res_it->IsAtFinalElement(RIL_BLOCK, RIL_WORD);
-    if (bold) {
-      hocr_str << "<strong>";
-    }
-    if (italic) {
-      hocr_str << "<em>";
+      break;
+    case DIR_RIGHT_TO_LEFT:
+      if (para_is_ltr_) {
+        *out_ << " dir='rtl'";
+      }
+      break;
+    case DIR_MIX:
+    case DIR_NEUTRAL:
+    default: // Do nothing.
+      break;
+  }
+  *out_ << ">";
+  if (bold_) {
+    *out_ << "<strong>";
+  }
+  if (italic_) {
+    *out_ << "<em>";
+  }
+}
+
+void HOcrFormatter::Symbol(const ResultIterator &it, const char *text) {
+  int left, top, right, bottom;
+  if (hocr_boxes_) {
+    it.BoundingBox(RIL_SYMBOL, &left, &top, &right, &bottom);
+    *out_ << "\n       <span class='ocrx_cinfo' title='x_bboxes " << left << " " << top << " "
+          << right << " " << bottom << "; x_conf " << it.Confidence(RIL_SYMBOL) << "'>";
+  }
+  out_->WriteEscaped(text);
+  if (!hocr_boxes_) {
+    return;
+  }
+  *out_ << "</span>";
+  tesseract::ChoiceIterator ci(it);
+  if (lstm_choice_mode_ == 1 && ci.Timesteps() != nullptr) {
+    std::vector<std::vector<std::pair<const char *, float>>> *symbol = ci.Timesteps();
+    *out_ << "\n        <span class='ocr_symbol'"
+          << " id='"
+          << "symbol_" << page_id_ << "_" << wcnt_ << "_" << scnt_ << "'>";
+    for (auto &timestep : *symbol) {
+      *out_ << "\n         <span class='ocrx_cinfo'"
+            << " id='"
+            << "timestep" << page_id_ << "_" << wcnt_ << "_" << tcnt_ << "'>";
+      for (auto &conf : timestep) {
+        *out_ << "\n          <span class='ocrx_cinfo'"
+              << " id='"
+              << "choice_" << page_id_ << "_" << wcnt_ << "_" << ccnt_ << "'"
+              << " title='x_confs " << int(conf.second * 100) << "'>";
+        out_->WriteEscaped(conf.first);
+        *out_ << "</span>";
+        ++ccnt_;
+      }
+      *out_ << "</span>";
+      ++tcnt_;
     }
+    *out_ << "\n        </span>";
+    ++scnt_;
+  } else if (lstm_choice_mode_ == 2) {
+    *out_ << "\n        <span class='ocrx_cinfo'"
+          << " id='"
+          << "lstm_choices_" << page_id_ << "_" << wcnt_ << "_" << tcnt_ << "'>";
     do {
-      const std::unique_ptr<const char[]> grapheme(res_it->GetUTF8Text(RIL_SYMBOL));
-      if (grapheme && grapheme[0] != 0) {
-        if (hocr_boxes) {
-          res_it->BoundingBox(RIL_SYMBOL, &left, &top, &right, &bottom);
-          hocr_str << "\n       <span class='ocrx_cinfo' title='x_bboxes " << left << " " << top
-                   << " " << right << " " << bottom << "; x_conf " << res_it->Confidence(RIL_SYMBOL)
-                   << "'>";
-        }
-        hocr_str << HOcrEscape(grapheme.get()).c_str();
-        if (hocr_boxes) {
-          hocr_str << "</span>";
-          tesseract::ChoiceIterator ci(*res_it);
-          if (lstm_choice_mode == 1 && ci.Timesteps() != nullptr) {
-            std::vector<std::vector<std::pair<const char *, float>>> *symbol = ci.Timesteps();
-            hocr_str << "\n        <span class='ocr_symbol'"
-                     << " id='"
-                     << "symbol_" << page_id << "_" << wcnt << "_" << scnt << "'>";
-            for (auto timestep : *symbol) {
-              hocr_str << "\n         <span class='ocrx_cinfo'"
-                       << " id='"
-                       << "timestep" << page_id << "_" << wcnt << "_" << tcnt << "'>";
-              for (auto conf : timestep) {
-                hocr_str << "\n          <span class='ocrx_cinfo'"
-                         << " id='"
-                         << "choice_" << page_id << "_" << wcnt << "_" << ccnt << "'"
-                         << " title='x_confs " << int(conf.second * 100) << "'>"
-                         << HOcrEscape(conf.first).c_str() << "</span>";
-                ++ccnt;
-              }
-              hocr_str << "</span>";
-              ++tcnt;
-            }
-            hocr_str << "\n        </span>";
-            ++scnt;
-          } else if (lstm_choice_mode == 2) {
-            tesseract::ChoiceIterator ci(*res_it);
-            hocr_str << "\n        <span class='ocrx_cinfo'"
-                     << " id='"
-                     << "lstm_choices_" << page_id << "_" << wcnt << "_" << tcnt << "'>";
-            do {
-              const char *choice = ci.GetUTF8Text();
-              float choiceconf = ci.Confidence();
-              if (choice != nullptr) {
-                hocr_str << "\n         <span class='ocrx_cinfo'"
-                         << " id='"
-                         << "choice_" << page_id << "_" << wcnt << "_" << ccnt << "'"
-                         << " title='x_confs " << choiceconf << "'>" << HOcrEscape(choice).c_str()
-                         << "</span>";
-                ccnt++;
-              }
-            } while (ci.Next());
-            hocr_str << "\n        </span>";
-            tcnt++;
-          }
+      const char *choice = ci.GetUTF8Text();
+      float choiceconf = ci.Confidence();
+      if (choice != nullptr) {
+        *out_ << "\n         <span class='ocrx_cinfo'"
+              << " id='"
+              << "choice_" << page_id_ << "_" << wcnt_ << "_" << ccnt_ << "'"
+              << " title='x_confs " << choiceconf << "'>";
+        out_->WriteEscaped(choice);
+        *out_ << "</span>";
+        ccnt_++;
+      }
+    } while (ci.Next());
+    *out_ << "\n        </span>";
+    tcnt_++;
+  }
+}
+
+void HOcrFormatter::EndWord(const ResultIterator &it, bool last_in_line, bool last_in_para,
+                            bool last_in_block) {
+  if (italic_) {
+    *out_ << "</em>";
+  }
+  if (bold_) {
+    *out_ << "</strong>";
+  }
+  // If the lstm choice mode is required it is added here
+  if (lstm_choice_mode_ == 1 && !hocr_boxes_ && raw_timestep_map_ != nullptr) {
+    for (auto &symbol : *raw_timestep_map_) {
+      *out_ << "\n       <span class='ocr_symbol'"
+            << " id='"
+            << "symbol_" << page_id_ << "_" << wcnt_ << "_" << scnt_ << "'>";
+      for (auto &timestep : symbol) {
+        *out_ << "\n        <span class='ocrx_cinfo'"
+              << " id='"
+              << "timestep" << page_id_ << "_" << wcnt_ << "_" << tcnt_ << "'>";
+        for (auto &conf : timestep) {
+          *out_ << "\n         <span class='ocrx_cinfo'"
+                << " id='"
+                << "choice_" << page_id_ << "_" << wcnt_ << "_" << ccnt_ << "'"
+                << " title='x_confs " << int(conf.second * 100) << "'>";
+          out_->WriteEscaped(conf.first);
+          *out_ << "</span>";
+          ++ccnt_;
         }
+        *out_ << "</span>";
+        ++tcnt_;
       }
-      res_it->Next(RIL_SYMBOL);
-    } while (!res_it->Empty(RIL_BLOCK) && !res_it->IsAtBeginningOf(RIL_WORD));
-    if (italic) {
-      hocr_str << "</em>";
+      *out_ << "</span>";
+      ++scnt_;
     }
-    if (bold) {
-      hocr_str << "</strong>";
-    }
-    // If the lstm choice mode is required it is added here
-    if (lstm_choice_mode == 1 && !hocr_boxes && rawTimestepMap != nullptr) {
-      for (auto symbol : *rawTimestepMap) {
-        hocr_str << "\n       <span class='ocr_symbol'"
-                 << " id='"
-                 << "symbol_" << page_id << "_" << wcnt << "_" << scnt << "'>";
-        for (auto timestep : symbol) {
-          hocr_str << "\n        <span class='ocrx_cinfo'"
-                   << " id='"
-                   << "timestep" << page_id << "_" << wcnt << "_" << tcnt << "'>";
-          for (auto conf : timestep) {
-            hocr_str << "\n         <span class='ocrx_cinfo'"
-                     << " id='"
-                     << "choice_" << page_id << "_" << wcnt << "_" << ccnt << "'"
-                     << " title='x_confs " << int(conf.second * 100) << "'>"
-                     << HOcrEscape(conf.first).c_str() << "</span>";
-            ++ccnt;
+  } else if (lstm_choice_mode_ == 2 && !hocr_boxes_ && ctc_map_ != nullptr) {
+    for (auto &timestep : *ctc_map_) {
+      if (timestep.size() > 0) {
+        *out_ << "\n       <span class='ocrx_cinfo'"
+              << " id='"
+              << "lstm_choices_" << page_id_ << "_" << wcnt_ << "_" << tcnt_ << "'>";
+        for (auto &j : timestep) {
+          float conf = 100 - lstm_rating_coefficient_ * j.second;
+          if (conf < 0.0f) {
+            conf = 0.0f;
           }
-          hocr_str << "</span>";
-          ++tcnt;
-        }
-        hocr_str << "</span>";
-        ++scnt;
-      }
-    } else if (lstm_choice_mode == 2 && !hocr_boxes && CTCMap != nullptr) {
-      for (auto timestep : *CTCMap) {
-        if (timestep.size() > 0) {
-          hocr_str << "\n       <span class='ocrx_cinfo'"
-                   << " id='"
-                   << "lstm_choices_" << page_id << "_" << wcnt << "_" << tcnt << "'>";
-          for (auto &j : timestep) {
-            float conf = 100 - tesseract_->lstm_rating_coefficient * j.second;
-            if (conf < 0.0f) {
-              conf = 0.0f;
-            }
-            if (conf > 100.0f) {
-              conf = 100.0f;
-            }
-            hocr_str << "\n        <span class='ocrx_cinfo'"
-                     << " id='"
-                     << "choice_" << page_id << "_" << wcnt << "_" << ccnt << "'"
-                     << " title='x_confs " << conf << "'>" << HOcrEscape(j.first).c_str()
-                     << "</span>";
-            ccnt++;
+          if (conf > 100.0f) {
+            conf = 100.0f;
           }
-          hocr_str << "</span>";
-          tcnt++;
+          *out_ << "\n        <span class='ocrx_cinfo'"
+                << " id='"
+                << "choice_" << page_id_ << "_" << wcnt_ << "_" << ccnt_ << "'"
+                << " title='x_confs " << conf << "'>";
+          out_->WriteEscaped(j.first);
+          *out_ << "</span>";
+          ccnt_++;
         }
+        *out_ << "</span>";
+        tcnt_++;
       }
     }
-    // Close ocrx_word.
-    if (hocr_boxes || lstm_choice_mode > 0) {
-      hocr_str << "\n      ";
-    }
-    hocr_str << "</span>";
-    tcnt = 1;
-    ccnt = 1;
-    wcnt++;
-    // Close any ending block/paragraph/textline.
-    if (last_word_in_line) {
-      hocr_str << "\n     </span>";
-      lcnt++;
-    }
-    if (last_word_in_para) {
-      hocr_str << "\n    </p>\n";
-      pcnt++;
-      para_is_ltr = true; // back to default direction
-    }
-    if (last_word_in_block) {
-      hocr_str << "   </div>\n";
-      bcnt++;
-    }
   }
-  hocr_str << "  </div>\n";
+  // Close ocrx_word.
+  if (hocr_boxes_ || lstm_choice_mode_ > 0) {
+    *out_ << "\n      ";
+  }
+  *out_ << "</span>";
+  tcnt_ = 1;
+  ccnt_ = 1;
+  wcnt_++;
+  // Close any ending block/paragraph/textline.
+  if (last_in_line) {
+    *out_ << "\n     </span>";
+    lcnt_++;
+  }
+  if (last_in_para) {
+    *out_ << "\n    </p>\n";
+    pcnt_++;
+    para_is_ltr_ = true; // back to default direction
+  }
+  if (last_in_block) {
+    *out_ << "   </div>\n";
+    bcnt_++;
+  }
+}
+
+void HOcrFormatter::EndPage() {
+  *out_ << "  </div>\n";
+}
+
+/**
+ * Make a HTML-formatted string with hOCR markup from the internal
+ * data structures.
+ * page_number is 0-based but will appear in the output as 1-based.
+ * Image name/input_file_ can be set by SetInputName before calling
+ * GetHOCRText
+ * STL removed from original patch submission and refactored by rays.
+ * Returned string must be freed with the delete [] operator.
+ */
+char *TessBaseAPI::GetHOCRText(int page_number) {
+  return GetHOCRText(nullptr, page_number);
+}
 
-  const std::string &text = hocr_str.str();
+/**
+ * Make a HTML-formatted string with hOCR markup from the internal
+ * data structures.
+ * page_number is 0-based but will appear in the output as 1-based.
+ * Image name/input_file_ can be set by SetInputName before calling
+ * GetHOCRText
+ * STL removed from original patch submission and refactored by rays.
+ * Returned string must be freed with the delete [] operator.
+ */
+char *TessBaseAPI::GetHOCRText(ETEXT_DESC *monitor, int page_number) {
+  std::string text;
+  {
+    BufferedWriter writer(&text);
+    HOcrFormatter formatter(&writer, page_number);
+    if (!RenderPage(monitor, {&formatter})) {
+      return nullptr;
+    }
+  }
   char *result = new char[text.length() + 1];
   strcpy(result, text.c_str());
   return result;
@@ -0,0 +1,241 @@
+///////////////////////////////////////////////////////////////////////
+// File:        pagerenderer.cpp
+// Description: Single pass rendering of the results of a page into
+//              several output formats.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// Include automatically generated configuration file if running autoconf.
+#ifdef HAVE_CONFIG_H
+#  include "config_auto.h"
+#endif
+
+#ifdef _WIN32
+#  include "host.h" // windows.h for MultiByteToWideChar, ...
+#endif
+
+#include "pagerenderer.h"
+
+#include <tesseract/baseapi.h>        // for TessBaseAPI
+#include <tesseract/resultiterator.h> // for ResultIterator
+
+#include <cstring> // for memcpy, strlen
+
+namespace tesseract {
+
+/**********************************************************************
+ * BufferedWriter
+ **********************************************************************/
+BufferedWriter::BufferedWriter(FILE *fp)
+    : fp_(fp), str_(nullptr), buffer_(new char[kBufferSize]) {}
+
+BufferedWriter::BufferedWriter(std::string *str) : fp_(nullptr), str_(str) {}
+
+BufferedWriter::~BufferedWriter() {
+  Flush();
+}
+
+void BufferedWriter::Write(const char *data, size_t size) {
+  if (str_ != nullptr) {
+    str_->append(data, size);
+    return;
+  }
+  if (size_ + size > kBufferSize) {
+    Flush();
+    if (size > kBufferSize) {
+      // Large blocks such as PDF images are written without a copy.
+      if (fp_ == nullptr || fwrite(data, 1, size, fp_) != size) {
+        ok_ = false;
+      }
+      return;
+    }
+  }
+  memcpy(buffer_.get() + size_, data, size);
+  size_ += size;
+}
+
+void BufferedWriter::WriteEscaped(const char *text) {
+  const char *start = text;
+  for (const char *ptr = text; *ptr; ptr++) {
+    const char *entity;
+    switch (*ptr) {
+      case '<':
+        entity = "&lt;";
+        break;
+      case '>':
+        entity = "&gt;";
+        break;
+      case '&':
+        entity = "&amp;";
+        break;
+      case '"':
+        entity = "&quot;";
+        break;
+      case '\'':
+        entity = "&#39;";
+        break;
+      default:
+        continue;
+    }
+    Write(start, ptr - start);
+    *this << entity;
+    start = ptr + 1;
+  }
+  *this << start;
+}
+
+// Replaces the decimal separator of the current locale by a point.
+static void UseDecimalPoint(char *number) {
+  for (; *number != '\0'; ++number) {
+    if (*number == ',') {
+      *number = '.';
+    }
+  }
+}
+
+void BufferedWriter::WriteFixed(double value) {
+  char number[64];
+  snprintf(number, sizeof(number), "%f", value);
+  UseDecimalPoint(number);
+  *this << number;
+}
+
+BufferedWriter &BufferedWriter::operator<<(const char *text) {
+  Write(text, strlen(text));
+  return *this;
+}
+
+BufferedWriter &BufferedWriter::operator<<(const std::string &text) {
+  Write(text.data(), text.size());
+  return *this;
+}
+
+BufferedWriter &BufferedWriter::operator<<(int value) {
+  char digits[16];
+  char *end = digits + sizeof(digits);
+  char *start = end;
+  // Negate in unsigned arithmetic so INT_MIN works too.
+  unsigned magnitude = value < 0 ? 0u - static_cast<unsigned>(value) : value;
+  do {
+    *--start = '0' + magnitude % 10;
+    magnitude /= 10;
+  } while (magnitude != 0);
+  if (value < 0) {
+    *--start = '-';
+  }
+  Write(start, end - start);
+  return *this;
+}
+
+BufferedWriter &BufferedWriter::operator<<(double value) {
+  char number[64];
+  snprintf(number, sizeof(number), "%.8g", value);
+  UseDecimalPoint(number);
+  return *this << number;
+}
+
+bool BufferedWriter::Flush() {
+  if (str_ != nullptr) {
+    return ok_;
+  }
+  if (size_ > 0) {
+    if (fp_ == nullptr || fwrite(buffer_.get(), 1, size_, fp_) != size_) {
+      ok_ = false;
+    }
+    size_ = 0;
+  }
+  if (fp_ == nullptr || fflush(fp_) != 0) {
+    ok_ = false;
+  }
+  return ok_;
+}
+
+/**********************************************************************
+ * TessBaseAPI::RenderPage
+ **********************************************************************/
+bool TessBaseAPI::RenderPage(ETEXT_DESC *monitor, const std::vector<PageFormatter *> &formatters) {
+  if (tesseract_ == nullptr || (page_res_ == nullptr && Recognize(monitor) < 0)) {
+    return false;
+  }
+
+  if (input_file_.empty()) {
+    SetInputName(nullptr);
+  }
+  PageInfo page;
+  page.api = this;
+  page.left = rect_left_;
+  page.top = rect_top_;
+  page.width = rect_width_;
+  page.height = rect_height_;
+#ifdef _WIN32
+  // convert input name from ANSI encoding to utf-8
+  int str16_len = MultiByteToWideChar(CP_ACP, 0, input_file_.c_str(), -1, nullptr, 0);
+  wchar_t *uni16_str = new WCHAR[str16_len];
+  str16_len = MultiByteToWideChar(CP_ACP, 0, input_file_.c_str(), -1, uni16_str, str16_len);
+  int utf8_len =
+      WideCharToMultiByte(CP_UTF8, 0, uni16_str, str16_len, nullptr, 0, nullptr, nullptr);
+  char *utf8_str = new char[utf8_len];
+  WideCharToMultiByte(CP_UTF8, 0, uni16_str, str16_len, utf8_str, utf8_len, nullptr, nullptr);
+  page.image_name = utf8_str;
+  delete[] uni16_str;
+  delete[] utf8_str;
+#else
+  page.image_name = input_file_;
+#endif
+
+  for (auto formatter : formatters) {
+    formatter->BeginPage(page);
+  }
+  std::unique_ptr<ResultIterator> res_it(GetIterator());
+  while (!res_it->Empty(RIL_BLOCK)) {
+    if (res_it->Empty(RIL_WORD)) {
+      res_it->Next(RIL_WORD);
+      continue;
+    }
+
+    // Open any new block/paragraph/textline.
+    for (auto level : {RIL_BLOCK, RIL_PARA, RIL_TEXTLINE}) {
+      if (res_it->IsAtBeginningOf(level)) {
+        for (auto formatter : formatters) {
+          formatter->BeginElement(*res_it, level);
+        }
+      }
+    }
+
+    // Now, process the word...
+    bool last_word_in_line = res_it->IsAtFinalElement(RIL_TEXTLINE, RIL_WORD);
+    bool last_word_in_para = res_it->IsAtFinalElement(RIL_PARA, RIL_WORD);
+    bool last_word_in_block = res_it->IsAtFinalElement(RIL_BLOCK, RIL_WORD);
+    for (auto formatter : formatters) {
+      formatter->BeginWord(*res_it);
+    }
+    do {
+      const std::unique_ptr<const char[]> grapheme(res_it->GetUTF8Text(RIL_SYMBOL));
+      if (grapheme && grapheme[0] != 0) {
+        for (auto formatter : formatters) {
+          formatter->Symbol(*res_it, grapheme.get());
+        }
+      }
+      res_it->Next(RIL_SYMBOL);
+    } while (!res_it->Empty(RIL_BLOCK) && !res_it->IsAtBeginningOf(RIL_WORD));
+    for (auto formatter : formatters) {
+      formatter->EndWord(*res_it, last_word_in_line, last_word_in_para, last_word_in_block);
+    }
+  }
+  for (auto formatter : formatters) {
+    formatter->EndPage();
+  }
+  return true;
+}
+
+} // namespace tesseract.
@@ -0,0 +1,191 @@
+///////////////////////////////////////////////////////////////////////
+// File:        pagerenderer.h
+// Description: Single pass rendering of the results of a page into
+//              several output formats.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_API_PAGERENDERER_H_
+#define TESSERACT_API_PAGERENDERER_H_
+
+#include <tesseract/publictypes.h> // for PageIteratorLevel
+
+#include <cstddef> // for size_t
+#include <cstdio>  // for FILE
+#include <memory>  // for std::unique_ptr
+#include <string>  // for std::string
+#include <utility> // for std::pair
+#include <vector>  // for std::vector
+
+namespace tesseract {
+
+class ResultIterator;
+class TessBaseAPI;
+
+// Collects output text in a fixed buffer and writes it to a file in large
+// chunks, or appends it to a string. Replaces the std::stringstream based
+// page building of the hOCR, ALTO and TSV output. Numbers are always
+// written in the "C" locale.
+class BufferedWriter {
+public:
+  // Writes to fp, which remains owned by the caller. fp may be nullptr,
+  // in which case every write fails.
+  explicit BufferedWriter(FILE *fp);
+  // Appends to *str.
+  explicit BufferedWriter(std::string *str);
+  ~BufferedWriter();
+
+  void Write(const char *data, size_t size);
+  // Writes text with the characters which are special in XML replaced
+  // by entities, like HOcrEscape.
+  void WriteEscaped(const char *text);
+  // Writes value like std::to_string.
+  void WriteFixed(double value);
+
+  BufferedWriter &operator<<(const char *text);
+  BufferedWriter &operator<<(const std::string &text);
+  BufferedWriter &operator<<(int value);
+  // Writes value like a std::ostream with precision 8.
+  BufferedWriter &operator<<(double value);
+
+  // Writes the buffered data to the file. Returns false if any write
+  // has failed since the writer was created.
+  bool Flush();
+
+private:
+  static const size_t kBufferSize = 64 * 1024;
+
+  FILE *fp_;
+  std::string *str_;
+  std::unique_ptr<char[]> buffer_;
+  size_t size_ = 0;
+  bool ok_ = true;
+};
+
+// The page data which the formatters need besides the ResultIterator.
+struct PageInfo {
+  TessBaseAPI *api;
+  int left, top;          // Rectangle of the image which was recognized.
+  int width, height;
+  std::string image_name; // UTF-8 name of the input image.
+};
+
+// Writes the results of a page in one output format. TessBaseAPI::RenderPage
+// walks the results once and calls all formatters of the page at each
+// position, so chained renderers share a single walk.
+class PageFormatter {
+public:
+  // page_number is the 0-based index of the page in the document.
+  PageFormatter(BufferedWriter *out, int page_number) : out_(out), page_number_(page_number) {}
+  virtual ~PageFormatter() = default;
+
+  virtual void BeginPage(const PageInfo &page) = 0;
+  // Called when it is at the beginning of a block, paragraph or text line,
+  // in that order, before the first word.
+  virtual void BeginElement(const ResultIterator &it, PageIteratorLevel level) = 0;
+  virtual void BeginWord(const ResultIterator &it) = 0;
+  // Called for each symbol of the current word which has non-empty text.
+  virtual void Symbol(const ResultIterator &it, const char *text) = 0;
+  // Called when the word is done, with it already at the next word.
+  virtual void EndWord(const ResultIterator &it, bool last_in_line, bool last_in_para,
+                       bool last_in_block) = 0;
+  virtual void EndPage() = 0;
+
+protected:
+  BufferedWriter *out_;
+  int page_number_;
+};
+
+// The hOCR of TessBaseAPI::GetHOCRText.
+class HOcrFormatter : public PageFormatter {
+public:
+  HOcrFormatter(BufferedWriter *out, int page_number) : PageFormatter(out, page_number) {}
+
+  void BeginPage(const PageInfo &page) override;
+  void BeginElement(const ResultIterator &it, PageIteratorLevel level) override;
+  void BeginWord(const ResultIterator &it) override;
+  void Symbol(const ResultIterator &it, const char *text) override;
+  void EndWord(const ResultIterator &it, bool last_in_line, bool last_in_para,
+               bool last_in_block) override;
+  void EndPage() override;
+
+private:
+  void AddBox(const ResultIterator &it, PageIteratorLevel level);
+  void AddBaselineCoords(const ResultIterator &it, PageIteratorLevel level);
+
+  int page_id_ = 0;
+  int lcnt_ = 1, bcnt_ = 1, pcnt_ = 1, wcnt_ = 1, scnt_ = 1, tcnt_ = 1, ccnt_ = 1;
+  bool para_is_ltr_ = true;
+  const char *paragraph_lang_ = nullptr;
+  bool font_info_ = false;
+  bool hocr_boxes_ = false;
+  int lstm_choice_mode_ = 0;
+  double lstm_rating_coefficient_ = 0.0;
+  // State of the current word.
+  bool bold_ = false;
+  bool italic_ = false;
+  std::vector<std::vector<std::vector<std::pair<const char *, float>>>> *raw_timestep_map_ =
+      nullptr;
+  std::vector<std::vector<std::pair<const char *, float>>> *ctc_map_ = nullptr;
+};
+
+// The ALTO of TessBaseAPI::GetAltoText.
+class AltoFormatter : public PageFormatter {
+public:
+  AltoFormatter(BufferedWriter *out, int page_number) : PageFormatter(out, page_number) {}
+
+  void BeginPage(const PageInfo &page) override;
+  void BeginElement(const ResultIterator &it, PageIteratorLevel level) override;
+  void BeginWord(const ResultIterator &it) override;
+  void Symbol(const ResultIterator &it, const char *text) override;
+  void EndWord(const ResultIterator &it, bool last_in_line, bool last_in_para,
+               bool last_in_block) override;
+  void EndPage() override;
+
+private:
+  void AddBox(const ResultIterator &it, PageIteratorLevel level);
+
+  int lcnt_ = 0, tcnt_ = 0, bcnt_ = 0, wcnt_ = 0;
+  // Right and top of the current word, for the following space.
+  int word_right_ = 0;
+  int word_top_ = 0;
+};
+
+// The TSV of TessBaseAPI::GetTSVText.
+class TsvFormatter : public PageFormatter {
+public:
+  TsvFormatter(BufferedWriter *out, int page_number) : PageFormatter(out, page_number) {}
+
+  void BeginPage(const PageInfo &page) override;
+  void BeginElement(const ResultIterator &it, PageIteratorLevel level) override;
+  void BeginWord(const ResultIterator &it) override;
+  void Symbol(const ResultIterator &it, const char *text) override;
+  void EndWord(const ResultIterator &it, bool last_in_line, bool last_in_para,
+               bool last_in_block) override;
+  void EndPage() override {}
+
+private:
+  // Writes the numbers which start each row.
+  void AddRowStart(int level);
+  void AddBox(const ResultIterator &it, PageIteratorLevel level);
+
+  int page_num_ = 0;
+  int block_num_ = 0;
+  int par_num_ = 0;
+  int line_num_ = 0;
+  int word_num_ = 0;
+};
+
+} // namespace tesseract.
+
+#endif // TESSERACT_API_PAGERENDERER_H_
@@ -20,19 +20,29 @@
 #  include "config_auto.h"
 #endif
 
+#include "errcode.h" // for ASSERT_HOST
+#include "params.h"  // for BOOL_VAR, INT_VAR
 #include "pdf_ttf.h"
 #include "tprintf.h"
 
 #include <allheaders.h>
 #include <tesseract/baseapi.h>
 #include <tesseract/renderer.h>
+#include <algorithm>          // for std::max
+#include <chrono>             // for std::chrono::steady_clock
 #include <cmath>
+#include <condition_variable> // for std::condition_variable
 #include <cstring>
-#include <fstream>   // for std::ifstream
-#include <locale>    // for std::locale::classic
-#include <memory>    // std::unique_ptr
-#include <sstream>   // for std::stringstream
-#include "helpers.h" // for Swap
+#include <deque>              // for std::deque
+#include <fstream>            // for std::ifstream
+#include <functional>         // for std::function
+#include <future>             // for std::future, std::packaged_task
+#include <locale>             // for std::locale::classic
+#include <memory>             // std::unique_ptr
+#include <mutex>              // for std::mutex
+#include <sstream>            // for std::stringstream
+#include <thread>             // for std::thread
+#include "helpers.h"          // for Swap
 
 /*
 
@@ -180,11 +190,121 @@ static const int kMaxBytesPerCodepoint = 20;
 /**********************************************************************
  * PDF Renderer interface implementation
  **********************************************************************/
+static BOOL_VAR(pdf_image_passthrough, true,
+                "Copy the compressed data of JPEG, JPEG 2000 and single page CCITT G4"
+                " TIFF input files into the PDF instead of encoding the image again");
+static INT_VAR(pdf_encode_threads, 1,
+               "Max number of page images of a PDF encoded in background threads while"
+               " the next pages are recognized, 0 to encode on the calling thread");
+static BOOL_VAR(pdf_report_timings, false,
+                "Print the time spent in the stages of the PDF rendering");
+
+using Clock = std::chrono::steady_clock;
+
+static double SecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// The image object of a page.
+struct PDFImage {
+  std::unique_ptr<char[]> object;
+  long int size = 0;
+  double seconds = 0.0; // Time for encoding.
+  bool ok = false;
+};
+
+// The objects of a page whose image is still being encoded.
+struct TessPDFRenderer::PendingPage {
+  int index = 0;        // Index of the page in the document.
+  long int objnum = 0;  // Number of the /Page object, the others follow it.
+  long int objects = 0; // Number of objects which the page writes.
+  std::string page;     // The /Page object.
+  std::string contents; // The /Contents object.
+  std::future<PDFImage> image;
+};
+
+// Runs the image encodings in at most max_threads background threads,
+// which are started as they are needed and kept for the next pages.
+class TessPDFRenderer::ImageEncoder {
+public:
+  explicit ImageEncoder(int max_threads) : max_threads_(max_threads) {}
+  // Finishes the queued encodings.
+  ~ImageEncoder() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_ = true;
+    }
+    wakeup_.notify_all();
+    for (auto &thread : threads_) {
+      thread.join();
+    }
+  }
+  ImageEncoder(const ImageEncoder &) = delete;
+  ImageEncoder &operator=(const ImageEncoder &) = delete;
+
+  std::future<PDFImage> Encode(std::function<PDFImage()> encode) {
+    std::packaged_task<PDFImage()> task(std::move(encode));
+    std::future<PDFImage> result = task.get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push_back(std::move(task));
+      if (static_cast<int>(tasks_.size()) > idle_ &&
+          static_cast<int>(threads_.size()) < max_threads_) {
+        threads_.emplace_back(&ImageEncoder::Work, this);
+      }
+    }
+    wakeup_.notify_one();
+    return result;
+  }
+
+private:
+  void Work() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      ++idle_;
+      wakeup_.wait(lock, [this] { return done_ || !tasks_.empty(); });
+      --idle_;
+      if (tasks_.empty()) {
+        return;
+      }
+      std::packaged_task<PDFImage()> task = std::move(tasks_.front());
+      tasks_.pop_front();
+      lock.unlock();
+      task();
+      lock.lock();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable wakeup_;
+  std::deque<std::packaged_task<PDFImage()>> tasks_;
+  std::vector<std::thread> threads_;
+  int max_threads_;
+  int idle_ = 0;     // Threads waiting for a task.
+  bool done_ = false;
+};
+
 TessPDFRenderer::TessPDFRenderer(const char *outputbase, const char *datadir, bool textonly)
     : TessResultRenderer(outputbase, "pdf"), datadir_(datadir) {
   obj_ = 0;
   textonly_ = textonly;
   offsets_.push_back(0);
+  text_seconds_ = 0.0;
+  image_seconds_ = 0.0;
+  wait_seconds_ = 0.0;
+  write_seconds_ = 0.0;
+  passthrough_images_ = 0;
+  failed_page_ = -1;
+}
+
+// Waits for the images which are still encoded in the background, before
+// the encoder stops its threads.
+TessPDFRenderer::~TessPDFRenderer() {
+  for (auto &page : pending_) {
+    if (page->image.valid()) {
+      page->image.wait();
+    }
+  }
 }
 
 void TessPDFRenderer::AppendPDFObjectDIY(size_t objectsize) {
@@ -655,33 +775,50 @@ bool TessPDFRenderer::BeginDocumentHandler() {
   return true;
 }
 
-bool TessPDFRenderer::imageToPDFObj(Pix *pix, const char *filename, long int objnum,
-                                    char **pdf_object, long int *pdf_object_size,
-                                    const int jpg_quality) {
-  if (!pdf_object_size || !pdf_object) {
-    return false;
+// Returns the compressed data of the input file if it can be copied into the
+// PDF without decoding and encoding the image again: a JPEG or JPEG 2000
+// file, or a single page TIFF with CCITT G4 compression, which holds an
+// image of the size of pix. Returns nullptr otherwise.
+static L_Compressed_Data *PassthroughImageData(Pix *pix, const char *filename) {
+  l_int32 format;
+  if (filename == nullptr || findFileFormat(filename, &format) != 0) {
+    return nullptr;
   }
-  *pdf_object = nullptr;
-  *pdf_object_size = 0;
-  if (!filename && !pix) {
-    return false;
-  }
-
   L_Compressed_Data *cid = nullptr;
-
-  int sad = 0;
-  if (pixGetInputFormat(pix) == IFF_PNG) {
-    sad = pixGenerateCIData(pix, L_FLATE_ENCODE, 0, 0, &cid);
-  }
-  if (!cid) {
-    sad = l_generateCIDataForPdf(filename, pix, jpg_quality, &cid);
+  switch (format) {
+    case IFF_JFIF_JPEG:
+      cid = l_generateJpegData(filename, 0);
+      break;
+    case IFF_JP2:
+      cid = l_generateJp2kData(filename);
+      break;
+    case IFF_TIFF_G4: {
+      // Only the strip of the first page can be extracted.
+      l_int32 pages = 0;
+      FILE *fp = fopenReadStream(filename);
+      if (fp != nullptr) {
+        tiffGetCount(fp, &pages);
+        fclose(fp);
+      }
+      if (pages == 1) {
+        cid = l_generateG4Data(filename, 0);
+      }
+      break;
+    }
+    default:
+      break;
   }
-
-  if (sad || !cid) {
+  if (cid != nullptr && (cid->w != static_cast<l_int32>(pixGetWidth(pix)) ||
+                         cid->h != static_cast<l_int32>(pixGetHeight(pix)) || cid->minisblack)) {
     l_CIDataDestroy(&cid);
-    return false;
   }
+  return cid;
+}
 
+// Turns compressed image data into a PDF image object and destroys it.
+// If decode_inverted is set, a 1 bpp image is shown with 0 as white.
+static bool CompressedDataToPDFObj(L_Compressed_Data *cid, bool decode_inverted, long int objnum,
+                                   char **pdf_object, long int *pdf_object_size) {
   const char *group4 = "";
   const char *filter;
   switch (cid->type) {
@@ -715,7 +852,7 @@ bool TessPDFRenderer::imageToPDFObj(Pix *pix, const char *filename, long int obj
   } else {
     switch (cid->spp) {
       case 1:
-        if (cid->bps == 1 && pixGetInputFormat(pix) == IFF_PNG) {
+        if (cid->bps == 1 && decode_inverted) {
           colorspace.str(
               "  /ColorSpace /DeviceGray\n"
               "  /Decode [1 0]\n");
@@ -802,6 +939,39 @@ bool TessPDFRenderer::imageToPDFObj(Pix *pix, const char *filename, long int obj
   return true;
 }
 
+bool TessPDFRenderer::imageToPDFObj(Pix *pix, const char *filename, long int objnum,
+                                    char **pdf_object, long int *pdf_object_size,
+                                    const int jpg_quality) {
+  if (!pdf_object_size || !pdf_object) {
+    return false;
+  }
+  *pdf_object = nullptr;
+  *pdf_object_size = 0;
+  if (!filename && !pix) {
+    return false;
+  }
+
+  L_Compressed_Data *cid = nullptr;
+
+  int sad = 0;
+  if (pixGetInputFormat(pix) == IFF_PNG) {
+    sad = pixGenerateCIData(pix, L_FLATE_ENCODE, 0, 0, &cid);
+  }
+  if (!cid && filename) {
+    cid = PassthroughImageData(pix, filename);
+  }
+  if (!cid) {
+    sad = l_generateCIDataForPdf(filename, pix, jpg_quality, &cid);
+  }
+
+  if (sad || !cid) {
+    l_CIDataDestroy(&cid);
+    return false;
+  }
+  return CompressedDataToPDFObj(cid, pixGetInputFormat(pix) == IFF_PNG, objnum, pdf_object,
+                                pdf_object_size);
+}
+
 bool TessPDFRenderer::AddImageHandler(TessBaseAPI *api) {
   Pix *pix = api->GetInputImage();
   const char *filename = api->GetInputName();
@@ -811,12 +981,20 @@ bool TessPDFRenderer::AddImageHandler(TessBaseAPI *api) {
   }
   double width = pixGetWidth(pix) * 72.0 / ppi;
   double height = pixGetHeight(pix) * 72.0 / ppi;
+  auto start = Clock::now();
+
+  // The objects of the page are numbered as if the pending pages had
+  // already been written, because they are written in page order.
+  std::unique_ptr<PendingPage> page(new PendingPage);
+  page->index = imagenum();
+  page->objnum = pending_.empty() ? obj_ : pending_.back()->objnum + pending_.back()->objects;
+  const long int objnum = page->objnum;
 
   std::stringstream xobject;
   // Use "C" locale (needed for int values larger than 999).
   xobject.imbue(std::locale::classic());
   if (!textonly_) {
-    xobject << "/XObject << /Im1 " << (obj_ + 2) << " 0 R >>\n";
+    xobject << "/XObject << /Im1 " << (objnum + 2) << " 0 R >>\n";
   }
 
   // PAGE
@@ -824,7 +1002,7 @@ bool TessPDFRenderer::AddImageHandler(TessBaseAPI *api) {
   // Use "C" locale (needed for double values width and height).
   stream.imbue(std::locale::classic());
   stream.precision(2);
-  stream << std::fixed << obj_
+  stream << std::fixed << objnum
          << " 0 obj\n"
             "<<\n"
             "  /Type /Page\n"
@@ -833,7 +1011,7 @@ bool TessPDFRenderer::AddImageHandler(TessBaseAPI *api) {
          << width << " " << height
          << "]\n"
             "  /Contents "
-         << (obj_ + 1)
+         << (objnum + 1)
          << " 0 R\n" // Contents object
             "  /Resources\n"
             "  <<\n"
@@ -844,8 +1022,9 @@ bool TessPDFRenderer::AddImageHandler(TessBaseAPI *api) {
       "  >>\n"
       ">>\n"
       "endobj\n";
-  pages_.push_back(obj_);
-  AppendPDFObject(stream.str().c_str());
+  pages_.push_back(objnum);
+  page->page = stream.str();
+  ++page->objects;
 
   // CONTENTS
   const std::unique_ptr<char[]> pdftext(GetPDFTextObjects(api, width, height));
@@ -855,7 +1034,7 @@ bool TessPDFRenderer::AddImageHandler(TessBaseAPI *api) {
       zlibCompress(reinterpret_cast<unsigned char *>(pdftext.get()), pdftext_len, &len);
   long comp_pdftext_len = len;
   stream.str("");
-  stream << obj_
+  stream << (objnum + 1)
          << " 0 obj\n"
             "<<\n"
             "  /Length "
@@ -863,33 +1042,123 @@ bool TessPDFRenderer::AddImageHandler(TessBaseAPI *api) {
          << " /Filter /FlateDecode\n"
             ">>\n"
             "stream\n";
-  AppendString(stream.str().c_str());
-  long objsize = stream.str().size();
-  AppendData(reinterpret_cast<char *>(comp_pdftext), comp_pdftext_len);
-  objsize += comp_pdftext_len;
+  page->contents = stream.str();
+  page->contents.append(reinterpret_cast<char *>(comp_pdftext), comp_pdftext_len);
   lept_free(comp_pdftext);
-  const char *b2 =
+  page->contents +=
       "endstream\n"
       "endobj\n";
-  AppendString(b2);
-  objsize += strlen(b2);
-  AppendPDFObjectDIY(objsize);
+  ++page->objects;
+  text_seconds_ += SecondsSince(start);
 
-  if (!textonly_) {
-    char *pdf_object = nullptr;
+  // IMAGE
+  std::promise<PDFImage> encoded;
+  if (textonly_) {
+    PDFImage image;
+    image.ok = true;
+    encoded.set_value(std::move(image));
+    page->image = encoded.get_future();
+  } else {
+    ++page->objects;
     int jpg_quality;
     api->GetIntVariable("jpg_quality", &jpg_quality);
-    if (!imageToPDFObj(pix, filename, obj_, &pdf_object, &objsize, jpg_quality)) {
-      return false;
+    L_Compressed_Data *cid = pdf_image_passthrough ? PassthroughImageData(pix, filename) : nullptr;
+    if (cid != nullptr || pdf_encode_threads <= 0) {
+      // Copying the compressed data of the input file needs no background thread.
+      PDFImage image;
+      char *pdf_object = nullptr;
+      start = Clock::now();
+      if (cid != nullptr) {
+        image.ok = CompressedDataToPDFObj(cid, false, objnum + 2, &pdf_object, &image.size);
+        ++passthrough_images_;
+      } else {
+        image.ok = imageToPDFObj(pix, pdf_image_passthrough ? filename : nullptr, objnum + 2,
+                                 &pdf_object, &image.size, jpg_quality);
+      }
+      image.object.reset(pdf_object);
+      image.seconds = SecondsSince(start);
+      encoded.set_value(std::move(image));
+      page->image = encoded.get_future();
+    } else {
+      // The api may replace its image and input name while the copies are
+      // encoded.
+      Pix *copy = pixCopy(nullptr, pix);
+      std::string name = pdf_image_passthrough && filename != nullptr ? filename : "";
+      if (encoder_ == nullptr) {
+        encoder_.reset(new ImageEncoder(pdf_encode_threads));
+      }
+      page->image = encoder_->Encode([copy, name, objnum, jpg_quality]() mutable {
+        PDFImage image;
+        char *pdf_object = nullptr;
+        auto start = Clock::now();
+        image.ok = imageToPDFObj(copy, name.empty() ? nullptr : name.c_str(), objnum + 2,
+                                 &pdf_object, &image.size, jpg_quality);
+        image.object.reset(pdf_object);
+        image.seconds = SecondsSince(start);
+        pixDestroy(&copy);
+        return image;
+      });
     }
-    AppendData(pdf_object, objsize);
-    AppendPDFObjectDIY(objsize);
-    delete[] pdf_object;
   }
+  pending_.push_back(std::move(page));
+
+  // Write the pages whose images are done, and wait for the oldest ones if
+  // too many are pending.
+  const size_t max_pending = std::max(0, static_cast<int>(pdf_encode_threads));
+  bool ok = true;
+  while (ok && !pending_.empty() &&
+         (pending_.size() > max_pending ||
+          pending_.front()->image.wait_for(std::chrono::seconds(0)) == std::future_status::ready)) {
+    ok = WritePendingPage();
+  }
+  return ok;
+}
+
+bool TessPDFRenderer::WritePendingPage() {
+  std::unique_ptr<PendingPage> page = std::move(pending_.front());
+  pending_.erase(pending_.begin());
+  auto start = Clock::now();
+  PDFImage image = page->image.get();
+  wait_seconds_ += SecondsSince(start);
+  ASSERT_HOST(obj_ == page->objnum);
+  image_seconds_ += image.seconds;
+  start = Clock::now();
+  AppendPDFObject(page->page.c_str());
+  AppendData(page->contents.data(), page->contents.size());
+  AppendPDFObjectDIY(page->contents.size());
+  if (!image.ok) {
+    // The page may be written after later pages were added, so the error
+    // names it.
+    tprintf("Error: could not encode the image of page %d of the PDF\n", page->index + 1);
+    if (failed_page_ < 0) {
+      failed_page_ = page->index;
+    }
+    return false;
+  }
+  if (!textonly_) {
+    AppendData(image.object.get(), image.size);
+    AppendPDFObjectDIY(image.size);
+  }
+  ASSERT_HOST(obj_ == page->objnum + page->objects);
+  write_seconds_ += SecondsSince(start);
   return true;
 }
 
 bool TessPDFRenderer::EndDocumentHandler() {
+  while (!pending_.empty()) {
+    if (!WritePendingPage()) {
+      return false;
+    }
+  }
+  if (pdf_report_timings) {
+    tprintf(
+        "PDF rendering of %zu pages: text %.3f s, image encoding %.3f s"
+        " (%d images copied from the input), waiting for encoding %.3f s,"
+        " writing %.3f s\n",
+        pages_.size(), text_seconds_, image_seconds_, passthrough_images_, wait_seconds_,
+        write_seconds_);
+  }
+
   // We reserved the /Pages object number early, so that the /Page
   // objects could refer to their parent. We finally have enough
   // information to go fill it in. Using lower level calls to manipulate
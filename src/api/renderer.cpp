@@ -20,10 +20,13 @@
 #endif
 #include <tesseract/baseapi.h>
 #include <tesseract/renderer.h>
+#include <tesseract/resultiterator.h>
 #include <cstring>
-#include <memory>     // std::unique_ptr
-#include <string>     // std::string
-#include "serialis.h" // Serialize
+#include <memory>         // std::unique_ptr
+#include <string>         // std::string
+#include <typeinfo>       // typeid
+#include "pagerenderer.h" // BufferedWriter, PageFormatter
+#include "serialis.h"     // Serialize
 
 namespace tesseract {
 
@@ -79,20 +82,99 @@ bool TessResultRenderer::BeginDocument(const char *title) {
   title_ = title;
   imagenum_ = -1;
   bool ok = BeginDocumentHandler();
+  if (fflush(fout_) != 0) {
+    happy_ = false;
+    ok = false;
+  }
   if (next_) {
     ok = next_->BeginDocument(title) && ok;
   }
   return ok;
 }
 
+// Returns true if TessBaseAPI::RenderPage can write the current page of
+// renderer while it walks the results. Only the renderers of exactly these
+// classes are streamed, so that a subclass which overrides AddImageHandler
+// still gets it called.
+static bool IsStreamed(const TessResultRenderer *renderer) {
+  const std::type_info &type = typeid(*renderer);
+  return type == typeid(TessHOcrRenderer) || type == typeid(TessAltoRenderer) ||
+         type == typeid(TessTsvRenderer);
+}
+
+// Returns a formatter which writes the current page of a streamed renderer
+// to out.
+static std::unique_ptr<PageFormatter> MakePageFormatter(const TessResultRenderer *renderer,
+                                                        BufferedWriter *out) {
+  const std::type_info &type = typeid(*renderer);
+  if (type == typeid(TessHOcrRenderer)) {
+    return std::make_unique<HOcrFormatter>(out, renderer->imagenum());
+  }
+  if (type == typeid(TessAltoRenderer)) {
+    return std::make_unique<AltoFormatter>(out, renderer->imagenum());
+  }
+  return std::make_unique<TsvFormatter>(out, renderer->imagenum());
+}
+
 bool TessResultRenderer::AddImage(TessBaseAPI *api) {
-  if (!happy_) {
-    return false;
+  // The renderers which can stream a page share a single walk of the
+  // results. A streamed renderer writes straight to its file, unless
+  // another renderer of the chain writes to the same file (like stdout).
+  // Then its page is kept in a string and written in the order of the
+  // chain, after the pages of the renderers before it.
+  struct ChainedPage {
+    TessResultRenderer *renderer;
+    std::string text;
+    std::unique_ptr<BufferedWriter> writer;
+    std::unique_ptr<PageFormatter> formatter;
+  };
+  std::vector<ChainedPage> pages;
+  bool ok = true;
+  for (TessResultRenderer *renderer = this; renderer != nullptr; renderer = renderer->next_) {
+    if (!renderer->happy_) {
+      ok = false;
+      break;
+    }
+    ++renderer->imagenum_;
+    pages.push_back({renderer, std::string(), nullptr, nullptr});
   }
-  ++imagenum_;
-  bool ok = AddImageHandler(api);
-  if (next_) {
-    ok = next_->AddImage(api) && ok;
+  std::vector<PageFormatter *> formatters;
+  for (auto &page : pages) {
+    if (!IsStreamed(page.renderer)) {
+      continue;
+    }
+    bool shared_file = false;
+    for (auto &other : pages) {
+      shared_file |= &other != &page && other.renderer->fout_ == page.renderer->fout_;
+    }
+    if (shared_file) {
+      page.writer = std::make_unique<BufferedWriter>(&page.text);
+    } else {
+      page.writer = std::make_unique<BufferedWriter>(page.renderer->fout_);
+    }
+    page.formatter = MakePageFormatter(page.renderer, page.writer.get());
+    formatters.push_back(page.formatter.get());
+  }
+  if (!formatters.empty()) {
+    ok = api->RenderPage(nullptr, formatters) && ok;
+  }
+  // Write the page of each renderer to its file in the order of the chain.
+  for (auto &page : pages) {
+    TessResultRenderer *renderer = page.renderer;
+    if (page.formatter == nullptr) {
+      ok = renderer->AddImageHandler(api) && ok;
+    } else {
+      if (!page.writer->Flush()) {
+        renderer->happy_ = false;
+      }
+      if (!page.text.empty()) {
+        renderer->AppendData(page.text.data(), page.text.size());
+      }
+    }
+    if (fflush(renderer->fout_) != 0) {
+      renderer->happy_ = false;
+    }
+    ok = renderer->happy_ && ok;
   }
   return ok;
 }
@@ -102,6 +184,10 @@ bool TessResultRenderer::EndDocument() {
     return false;
   }
   bool ok = EndDocumentHandler();
+  if (fflush(fout_) != 0) {
+    happy_ = false;
+    ok = false;
+  }
   if (next_) {
     ok = next_->EndDocument() && ok;
   }
@@ -112,11 +198,12 @@ void TessResultRenderer::AppendString(const char *s) {
   AppendData(s, strlen(s));
 }
 
+// The file is flushed once per page by AddImage and at the beginning and
+// the end of the document, not for every append.
 void TessResultRenderer::AppendData(const char *s, int len) {
   if (!tesseract::Serialize(fout_, s, len)) {
     happy_ = false;
   }
-  fflush(fout_);
 }
 
 bool TessResultRenderer::BeginDocumentHandler() {
@@ -184,6 +271,79 @@ bool TessTsvRenderer::AddImageHandler(TessBaseAPI *api) {
   return true;
 }
 
+void TsvFormatter::AddRowStart(int level) {
+  *out_ << level << "\t" << page_num_;
+  *out_ << "\t" << block_num_;
+  *out_ << "\t" << par_num_;
+  *out_ << "\t" << line_num_;
+  *out_ << "\t" << word_num_;
+}
+
+void TsvFormatter::AddBox(const ResultIterator &it, PageIteratorLevel level) {
+  int left, top, right, bottom;
+  it.BoundingBox(level, &left, &top, &right, &bottom);
+  *out_ << "\t" << left;
+  *out_ << "\t" << top;
+  *out_ << "\t" << right - left;
+  *out_ << "\t" << bottom - top;
+}
+
+void TsvFormatter::BeginPage(const PageInfo &page) {
+  page_num_ = page_number_ + 1; // we use 1-based page numbers.
+  AddRowStart(1); // level 1 - page
+  *out_ << "\t" << page.left;
+  *out_ << "\t" << page.top;
+  *out_ << "\t" << page.width;
+  *out_ << "\t" << page.height;
+  *out_ << "\t-1\t\n";
+}
+
+void TsvFormatter::BeginElement(const ResultIterator &it, PageIteratorLevel level) {
+  // Add rows for any new block/paragraph/textline.
+  switch (level) {
+    case RIL_BLOCK:
+      block_num_++;
+      par_num_ = 0;
+      line_num_ = 0;
+      word_num_ = 0;
+      AddRowStart(2); // level 2 - block
+      break;
+    case RIL_PARA:
+      par_num_++;
+      line_num_ = 0;
+      word_num_ = 0;
+      AddRowStart(3); // level 3 - paragraph
+      break;
+    case RIL_TEXTLINE:
+      line_num_++;
+      word_num_ = 0;
+      AddRowStart(4); // level 4 - line
+      break;
+    default:
+      return;
+  }
+  AddBox(it, level);
+  *out_ << "\t-1\t\n"; // end of row
+}
+
+void TsvFormatter::BeginWord(const ResultIterator &it) {
+  word_num_++;
+  AddRowStart(5); // level 5 - word
+  AddBox(it, RIL_WORD);
+  *out_ << "\t";
+  out_->WriteFixed(it.Confidence(RIL_WORD));
+  *out_ << "\t";
+}
+
+void TsvFormatter::Symbol(const ResultIterator &it, const char *text) {
+  *out_ << text;
+}
+
+void TsvFormatter::EndWord(const ResultIterator &it, bool last_in_line, bool last_in_para,
+                           bool last_in_block) {
+  *out_ << "\n"; // end of row
+}
+
 /**********************************************************************
  * UNLV Text Renderer interface implementation
  **********************************************************************/
@@ -21,15 +21,25 @@
 #  include "config_auto.h"
 #endif
 
-#include <cerrno> // for errno
+#include <algorithm> // for std::sort
+#include <cerrno>    // for errno
 #if defined(__USE_GNU)
 #  include <cfenv> // for feenableexcept
 #endif
-#include <cstdlib> // for std::getenv
+#include <chrono>             // for std::chrono
+#include <cmath>              // for std::ceil
+#include <condition_variable> // for std::condition_variable
+#include <cstdlib>            // for std::getenv
+#include <deque>              // for std::deque
+#include <fstream>            // for std::ifstream
+#include <functional>         // for std::function
 #include <iostream>
+#include <mutex>  // for std::mutex
+#include <thread> // for std::thread
 
 #include <allheaders.h>
 #include <tesseract/baseapi.h>
+#include "batchmanifest.h" // for BatchJob, ReadBatchJob
 #include "dict.h"
 #if defined(USE_OPENCL)
 #  include "openclwrapper.h" // for OpenclDevice
@@ -228,6 +238,8 @@ static void PrintHelpExtra(const char *program) {
       "  %s --print-parameters [options...] [configfile...]\n"
       "  %s imagename|imagelist|stdin outputbase|stdout [options...] "
       "[configfile...]\n"
+      "  %s --batch manifest|stdin [--jobs NUM] [options...] [configfile...]\n"
+      "  %s --replay bundle [--tessdata-dir PATH] [profile]\n"
       "\n"
       "OCR options:\n"
       "  --tessdata-dir PATH   Specify the location of tessdata path.\n"
@@ -241,9 +253,29 @@ static void PrintHelpExtra(const char *program) {
 #ifndef DISABLED_LEGACY_ENGINE
       "  --oem NUM             Specify OCR Engine mode.\n"
 #endif
+      "\n"
+      "Batch options:\n"
+      "  --batch FILE          Read lines of 'imagename<TAB>outputbase' from\n"
+      "                        FILE (or stdin for '-') and process them all\n"
+      "                        with the models loaded once. Only a tab\n"
+      "                        separates the names, which may contain spaces.\n"
+      "                        Without a tab the whole line is the imagename\n"
+      "                        and its name without extension is used.\n"
+      "                        An outputbase stdout needs --jobs 1.\n"
+      "  --jobs NUM            Number of documents processed in parallel\n"
+      "                        (default: number of CPU cores).\n"
       "NOTE: These options must occur before any configfile.\n"
+      "\n"
+      "Replay options:\n"
+      "  --replay FILE         Recognize the page of a replay bundle, which is\n"
+      "                        written for slow or failed pages with\n"
+      "                        -c replay_dir=DIR, again with its variables\n"
+      "                        and models under the profiler. The profile is\n"
+      "                        written to the profile argument, or next to the\n"
+      "                        bundle with the extension .trace.json. The stage\n"
+      "                        times are written to stdout.\n"
       "\n",
-      program, program, program, program);
+      program, program, program, program, program, program);
 
   PrintHelpForPSM();
 #ifndef DISABLED_LEGACY_ENGINE
@@ -359,10 +391,12 @@ static bool ParseArgs(int argc, char **argv, const char **lang, const char **ima
                       const char **outputbase, const char **datapath, l_int32 *dpi,
                       bool *list_langs, bool *print_parameters, std::vector<std::string> *vars_vec,
                       std::vector<std::string> *vars_values, l_int32 *arg_i,
-                      tesseract::PageSegMode *pagesegmode, tesseract::OcrEngineMode *enginemode) {
+                      tesseract::PageSegMode *pagesegmode, tesseract::OcrEngineMode *enginemode,
+                      const char **batch, int *batch_jobs, const char **replay) {
   bool noocr = false;
   int i;
-  for (i = 1; i < argc && (*outputbase == nullptr || argv[i][0] == '-'); i++) {
+  for (i = 1; i < argc && ((*outputbase == nullptr && *batch == nullptr) || argv[i][0] == '-');
+       i++) {
     if (*image != nullptr && *outputbase == nullptr) {
       // outputbase follows image, don't allow options at that position.
       *outputbase = argv[i];
@@ -418,12 +452,24 @@ static bool ParseArgs(int argc, char **argv, const char **lang, const char **ima
       *enginemode = static_cast<tesseract::OcrEngineMode>(oem);
 #endif
       ++i;
+    } else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+      *batch = argv[i + 1];
+      ++i;
+    } else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+      *batch_jobs = atoi(argv[i + 1]);
+      ++i;
+    } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+      *replay = argv[i + 1];
+      ++i;
     } else if (strcmp(argv[i], "--print-parameters") == 0) {
       noocr = true;
       *print_parameters = true;
     } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
       // handled properly after api init
       ++i;
+    } else if (*replay != nullptr && *outputbase == nullptr) {
+      // The name of the profile of the replay.
+      *outputbase = argv[i];
     } else if (*image == nullptr) {
       *image = argv[i];
     } else {
@@ -435,6 +481,22 @@ static bool ParseArgs(int argc, char **argv, const char **lang, const char **ima
 
   *arg_i = i;
 
+  if (*batch != nullptr) {
+    if (*image != nullptr) {
+      fprintf(stderr, "Error, no imagename is allowed with --batch\n");
+      return false;
+    }
+    if (*pagesegmode == tesseract::PSM_AUTO_ONLY) {
+      fprintf(stderr, "Error, --psm 2 is not supported with --batch\n");
+      return false;
+    }
+  }
+
+  if (*replay != nullptr && (*image != nullptr || *batch != nullptr)) {
+    fprintf(stderr, "Error, no imagename or --batch is allowed with --replay\n");
+    return false;
+  }
+
   if (*pagesegmode == tesseract::PSM_OSD_ONLY) {
     // OSD = orientation and script detection.
     if (*lang != nullptr && strcmp(*lang, "osd")) {
@@ -447,7 +509,7 @@ static bool ParseArgs(int argc, char **argv, const char **lang, const char **ima
     }
   }
 
-  if (*outputbase == nullptr && noocr == false) {
+  if (*outputbase == nullptr && *batch == nullptr && *replay == nullptr && noocr == false) {
     PrintHelpMessage(argv[0]);
     return false;
   }
@@ -586,11 +648,181 @@ static void PreloadRenderers(tesseract::TessBaseAPI &api,
   }
 }
 
+// Writes all outputs of one document of a --batch run.
+static bool ProcessBatchJob(tesseract::TessBaseAPI &api, const BatchJob &job,
+                            tesseract::PageSegMode pagesegmode, bool in_training_mode) {
+  std::vector<std::unique_ptr<TessResultRenderer>> renderers;
+  api.SetOutputName(job.outputbase.c_str());
+  if (in_training_mode) {
+    renderers.push_back(nullptr);
+  } else {
+    PreloadRenderers(api, renderers, pagesegmode, job.outputbase.c_str());
+  }
+  if (renderers.empty()) {
+    return false;
+  }
+  if (!api.ProcessPages(job.input.c_str(), nullptr, 0, renderers[0].get())) {
+    fprintf(stderr, "Error during processing of %s.\n", job.input.c_str());
+    return false;
+  }
+  return true;
+}
+
+// Returns the value below which the given fraction of the sorted values lie.
+static double Percentile(const std::vector<double> &sorted, double fraction) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  auto rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+  return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+// Processes all documents of a --batch manifest. api is the initialized api
+// of the first worker, init_worker initializes the api of each further one.
+// Every worker keeps its own copy of the models because the recognizers can
+// not be shared between threads; only the dictionaries come from the shared
+// DawgCache. The manifest is read while the workers run, so it may be a
+// stream which grows as documents arrive. Prints throughput and latency
+// percentiles to stderr when all documents are done.
+static int RunBatch(tesseract::TessBaseAPI &api, const char *manifest, int jobs,
+                    const std::function<bool(tesseract::TessBaseAPI &)> &init_worker,
+                    tesseract::PageSegMode pagesegmode, bool in_training_mode) {
+  std::ifstream file;
+  std::istream *in = &std::cin;
+  if (strcmp(manifest, "-") != 0 && strcmp(manifest, "stdin") != 0) {
+    file.open(manifest);
+    if (!file) {
+      fprintf(stderr, "Error, cannot read batch manifest %s\n", manifest);
+      return EXIT_FAILURE;
+    }
+    in = &file;
+  }
+  if (jobs <= 0) {
+    jobs = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  // Initialize the other workers one after the other, as Init changes
+  // global parameters.
+  std::vector<std::unique_ptr<tesseract::TessBaseAPI>> workers;
+  for (int w = 1; w < jobs; ++w) {
+    auto worker = std::make_unique<tesseract::TessBaseAPI>();
+    if (!init_worker(*worker)) {
+      fprintf(stderr, "Could not initialize tesseract worker %d, using %d.\n", w, w);
+      break;
+    }
+    workers.push_back(std::move(worker));
+  }
+  std::vector<tesseract::TessBaseAPI *> apis = {&api};
+  for (auto &worker : workers) {
+    apis.push_back(worker.get());
+  }
+
+  std::mutex mutex;
+  std::condition_variable job_added;
+  std::condition_variable job_taken;
+  std::deque<BatchJob> queue;
+  // Limits the documents read ahead of the workers.
+  const size_t max_queued = 2 * apis.size();
+  bool end_of_manifest = false;
+  std::vector<double> latencies;
+  int failures = 0;
+
+  auto work = [&](tesseract::TessBaseAPI *worker) {
+    for (;;) {
+      BatchJob job;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        job_added.wait(lock, [&] { return !queue.empty() || end_of_manifest; });
+        if (queue.empty()) {
+          return;
+        }
+        job = std::move(queue.front());
+        queue.pop_front();
+      }
+      job_taken.notify_one();
+      auto start = std::chrono::steady_clock::now();
+      bool ok = ProcessBatchJob(*worker, job, pagesegmode, in_training_mode);
+      std::chrono::duration<double> latency = std::chrono::steady_clock::now() - start;
+      std::lock_guard<std::mutex> lock(mutex);
+      latencies.push_back(latency.count());
+      if (!ok) {
+        ++failures;
+      }
+    }
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (auto worker : apis) {
+    threads.emplace_back(work, worker);
+  }
+  BatchJob job;
+  int line_number = 0;
+  int rejected = 0;
+  auto report = [&](int number, const std::string &line) {
+    fprintf(stderr, "Error, invalid line %d in batch manifest: %s\n", number, line.c_str());
+    ++rejected;
+  };
+  while (ReadBatchJob(*in, &job, &line_number, report)) {
+    if (apis.size() > 1 && IsStdoutName(job.outputbase)) {
+      // The outputs of parallel documents would be interleaved.
+      fprintf(stderr, "Error, outputbase stdout of %s needs --jobs 1\n", job.input.c_str());
+      ++rejected;
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    job_taken.wait(lock, [&] { return queue.size() < max_queued; });
+    queue.push_back(std::move(job));
+    lock.unlock();
+    job_added.notify_one();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    end_of_manifest = true;
+  }
+  job_added.notify_all();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  std::sort(latencies.begin(), latencies.end());
+  double seconds = elapsed.count();
+  failures += rejected;
+  fprintf(stderr, "Batch: %zu documents, %d failed, %zu workers, %.3f s, %.2f documents/s\n",
+          latencies.size() + rejected, failures, apis.size(), seconds,
+          seconds > 0.0 ? latencies.size() / seconds : 0.0);
+  fprintf(stderr, "Latency: p50 %.3f s, p90 %.3f s, p99 %.3f s, max %.3f s\n",
+          Percentile(latencies, 0.5), Percentile(latencies, 0.9), Percentile(latencies, 0.99),
+          Percentile(latencies, 1.0));
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
 /**********************************************************************
  *  main()
  *
  **********************************************************************/
 
+// Recognizes the page of a replay bundle again under the profiler and writes
+// its stage times to stdout.
+static int RunReplay(const char *manifest, const char *datapath, const char *profile) {
+  std::string profile_name;
+  if (profile == nullptr) {
+    profile_name = manifest;
+    size_t dot = profile_name.rfind(".replay");
+    if (dot != std::string::npos) {
+      profile_name.erase(dot);
+    }
+    profile_name += ".trace.json";
+    profile = profile_name.c_str();
+  }
+  tesseract::Dict::GlobalDawgCache();
+  tesseract::TessBaseAPI api;
+  bool ok = api.ReplayPage(manifest, datapath, profile);
+  printf("%s\n", api.GetStageStatsJSON().c_str());
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
 int main(int argc, char **argv) {
 #if defined(__USE_GNU)
   // Raise SIGFPE.
@@ -607,6 +839,9 @@ int main(int argc, char **argv) {
   const char *datapath = nullptr;
   bool list_langs = false;
   bool print_parameters = false;
+  const char *batch = nullptr;
+  int batch_jobs = 0;
+  const char *replay = nullptr;
   l_int32 dpi = 0;
   int arg_i = 1;
   tesseract::PageSegMode pagesegmode = tesseract::PSM_AUTO;
@@ -633,16 +868,21 @@ int main(int argc, char **argv) {
 #endif // HAVE_TIFFIO_H && _WIN32
 
   if (!ParseArgs(argc, argv, &lang, &image, &outputbase, &datapath, &dpi, &list_langs,
-                 &print_parameters, &vars_vec, &vars_values, &arg_i, &pagesegmode, &enginemode)) {
+                 &print_parameters, &vars_vec, &vars_values, &arg_i, &pagesegmode, &enginemode,
+                 &batch, &batch_jobs, &replay)) {
     return EXIT_FAILURE;
   }
 
+  if (replay != nullptr) {
+    return RunReplay(replay, datapath, outputbase);
+  }
+
   if (lang == nullptr) {
     // Set default language if none was given.
     lang = "eng";
   }
 
-  if (image == nullptr && !list_langs && !print_parameters) {
+  if (image == nullptr && batch == nullptr && !list_langs && !print_parameters) {
     return EXIT_SUCCESS;
   }
 
@@ -759,6 +999,28 @@ int main(int argc, char **argv) {
   }
 #endif // def DISABLED_LEGACY_ENGINE
 
+  if (batch != nullptr) {
+    PrintBanner();
+#ifdef DISABLED_LEGACY_ENGINE
+    if (!osd_warning.empty()) {
+      fprintf(stderr, "%s", osd_warning.c_str());
+    }
+#endif
+    auto init_worker = [&](tesseract::TessBaseAPI &worker) {
+      if (worker.Init(datapath, lang, enginemode, &(argv[arg_i]), argc - arg_i, &vars_vec,
+                      &vars_values, false) != 0 ||
+          !SetVariablesFromCLArgs(worker, argc, argv)) {
+        return false;
+      }
+      worker.SetPageSegMode(api.GetPageSegMode());
+      if (dpi) {
+        worker.SetVariable("user_defined_dpi", std::to_string(dpi).c_str());
+      }
+      return true;
+    };
+    return RunBatch(api, batch, batch_jobs, init_worker, pagesegmode, in_training_mode);
+  }
+
   std::vector<std::unique_ptr<TessResultRenderer>> renderers;
 
   if (in_training_mode) {
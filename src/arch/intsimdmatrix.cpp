@@ -18,11 +18,112 @@
 #include "intsimdmatrix.h"
 #include "matrix.h"     // for GENERIC_2D_ARRAY
 #include "simddetect.h" // for SIMDDetect
+#include "tprintf.h"    // for TLOG
+
+#include <algorithm> // for std::min
+#include <chrono>    // for std::chrono
+#include <map>       // for std::map
+#include <mutex>     // for std::mutex
+#include <tuple>     // for std::tuple
 
 namespace tesseract {
 
 const IntSimdMatrix *IntSimdMatrix::intSimdMatrix = nullptr;
 
+// Number of inputs multiplied by each timed call.
+const int kTimedRows = 8;
+// Number of timed runs, of which the fastest counts.
+const int kTimedRuns = 5;
+// Minimum duration of a timed run.
+const double kMinRunSeconds = 1e-3;
+// A variant must be this much faster to replace the default, so noise in
+// the times does not change the choice.
+const double kMinSpeedup = 1.05;
+
+// The variant chosen by Tune for each implementation, shape and batching.
+using TuneKey = std::tuple<const IntSimdMatrix *, int, int, bool>;
+static std::mutex tune_mutex;
+static std::map<TuneKey, const IntSimdMatrix *> tuned_variants;
+
+const IntSimdMatrix *IntSimdMatrix::Tune(const GENERIC_2D_ARRAY<int8_t> &w, bool batched) const {
+  if (variants_ == nullptr) {
+    return this;
+  }
+  // Timing the variants in parallel would make the times meaningless.
+  std::lock_guard<std::mutex> lock(tune_mutex);
+  TuneKey key(this, w.dim1(), w.dim2(), batched);
+  auto it = tuned_variants.find(key);
+  if (it != tuned_variants.end()) {
+    return it->second;
+  }
+  const IntSimdMatrix *best = this;
+  double base_seconds = TimeMatrixDotVector(w, batched);
+  double best_seconds = base_seconds / kMinSpeedup;
+  for (auto variant = variants_; *variant != nullptr; ++variant) {
+    double seconds = (*variant)->TimeMatrixDotVector(w, batched);
+    if (seconds < best_seconds) {
+      best = *variant;
+      best_seconds = seconds;
+    }
+  }
+  TLOG(TESS_LOG_DEBUG, "IntSimdMatrix %dx%d%s: %s, %.2fx as fast as %s\n", w.dim1(), w.dim2(),
+       batched ? " batched" : "", best->name_,
+       best == this ? 1.0 : base_seconds / best_seconds, name_);
+  tuned_variants[key] = best;
+  return best;
+}
+
+double IntSimdMatrix::TimeMatrixDotVector(const GENERIC_2D_ARRAY<int8_t> &w, bool batched) const {
+  const int num_in = w.dim2() - 1;
+  std::vector<int8_t> shaped_w;
+  int32_t rounded_num_out;
+  Init(w, shaped_w, rounded_num_out);
+  std::vector<double> scales(rounded_num_out, 1.0 / INT8_MAX);
+  // The values do not matter for the time, as long as they are not all 0.
+  const int rounded_num_in = RoundInputs(num_in);
+  std::vector<int8_t> inputs(kTimedRows * rounded_num_in);
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    inputs[i] = static_cast<int8_t>(i * 37 % 255 - 127);
+  }
+  std::vector<double> outputs(kTimedRows * rounded_num_out);
+  std::vector<const int8_t *> u(kTimedRows);
+  std::vector<double *> v(kTimedRows);
+  for (int r = 0; r < kTimedRows; ++r) {
+    u[r] = &inputs[r * rounded_num_in];
+    v[r] = &outputs[r * rounded_num_out];
+  }
+  batched = batched && matrixDotVectorsFunction != nullptr;
+  auto multiply = [&]() {
+    if (batched) {
+      matrixDotVectorsFunction(w.dim1(), w.dim2(), &shaped_w[0], &scales[0], kTimedRows, &u[0],
+                               &v[0]);
+    } else {
+      for (int r = 0; r < kTimedRows; ++r) {
+        matrixDotVectorFunction(w.dim1(), w.dim2(), &shaped_w[0], &scales[0], u[r], v[r]);
+      }
+    }
+  };
+  // Find the number of calls which take long enough to be timed.
+  multiply();
+  int calls = 1;
+  double best_seconds = 0.0;
+  for (int run = 0; run < kTimedRuns;) {
+    auto start = std::chrono::steady_clock::now();
+    for (int call = 0; call < calls; ++call) {
+      multiply();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double seconds = elapsed.count();
+    if (seconds < kMinRunSeconds && run == 0) {
+      calls *= 2;
+      continue;
+    }
+    best_seconds = run == 0 ? seconds : std::min(best_seconds, seconds);
+    ++run;
+  }
+  return best_seconds / calls / kTimedRows;
+}
+
 // Computes a reshaped copy of the weight matrix w.
 void IntSimdMatrix::Init(const GENERIC_2D_ARRAY<int8_t> &w, std::vector<int8_t> &shaped_w,
                          int32_t &rounded_num_out) const {
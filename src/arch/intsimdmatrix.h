@@ -99,6 +99,22 @@ struct TESS_API IntSimdMatrix {
                                            double *);
   MatrixDotVectorFunction matrixDotVectorFunction;
 
+  // Computes matrix.vector v[r] = Wu[r] for num_rows inputs u[r], with the
+  // weights shaped by Init. The weights are read once for several inputs.
+  // The inputs must be padded as for matrixDotVectorFunction.
+  using MatrixDotVectorsFunction = void (*)(int, int, const int8_t *, const double *, int,
+                                            const int8_t *const *, double *const *);
+
+  // Returns the fastest of this implementation and its variants for the
+  // shape of w, timed on its first use. If batched, the variants which have
+  // a matrixDotVectorsFunction are timed with it. The choice for each shape
+  // is kept for the rest of the process.
+  const IntSimdMatrix *Tune(const GENERIC_2D_ARRAY<int8_t> &w, bool batched) const;
+
+  // Returns the seconds per input that the product with w takes, using
+  // matrixDotVectorsFunction if batched and there is one.
+  double TimeMatrixDotVector(const GENERIC_2D_ARRAY<int8_t> &w, bool batched) const;
+
   // Number of 32 bit outputs held in each register.
   int num_outputs_per_register_;
   // Maximum number of registers that we will use to hold outputs.
@@ -110,6 +126,15 @@ struct TESS_API IntSimdMatrix {
   // Number of groups of inputs to be broadcast.
   // num_input_groups_ = num_inputs_per_register_ / num_inputs_per_group_
 
+  // Optional, for multiplying several inputs at once.
+  MatrixDotVectorsFunction matrixDotVectorsFunction;
+  // Name of the implementation, such as "avx2".
+  const char *name_;
+  // Alternatives with other blockings, ended by nullptr, or nullptr if there
+  // are none. They have the same register sizes, so the inputs and outputs
+  // are padded alike, but each must shape the weights with its own Init.
+  const IntSimdMatrix *const *variants_;
+
   static const IntSimdMatrix *intSimdMatrix;
   // Only available with NEON.
   static const IntSimdMatrix intSimdMatrixNEON;
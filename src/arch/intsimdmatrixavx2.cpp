@@ -331,6 +331,167 @@ static void matrixDotVector(int dim1, int dim2, const int8_t *wi, const double *
   }
 }
 
+// Computes one of the partial products above, with the given number of
+// output registers.
+static inline void PartialMatrixDotVector(int num_registers, const int8_t *wi,
+                                          const double *scales, const int8_t *u, int num_in,
+                                          double *v) {
+  switch (num_registers) {
+    case 8:
+      PartialMatrixDotVector64(wi, scales, u, num_in, v);
+      break;
+    case 4:
+      PartialMatrixDotVector32(wi, scales, u, num_in, v);
+      break;
+    case 2:
+      PartialMatrixDotVector16(wi, scales, u, num_in, v);
+      break;
+    default:
+      PartialMatrixDotVector8(wi, scales, u, num_in, v);
+      break;
+  }
+}
+
+// As matrixDotVector, but uses at most kMaxRegisters output registers in a
+// pass over the inputs. Fewer registers read the inputs more often, but
+// keep fewer weights in flight, which can be faster for some shapes.
+template <int kMaxRegisters>
+static void matrixDotVectorBlocked(int dim1, int dim2, const int8_t *wi, const double *scales,
+                                   const int8_t *u, double *v) {
+  const int num_out = dim1;
+  const int num_in = dim2 - 1;
+  const int rounded_num_in = IntSimdMatrix::Roundup(num_in, kNumInputsPerGroup);
+  const int rounded_num_out = IntSimdMatrix::Roundup(num_out, kNumOutputsPerRegister);
+  int output = 0;
+  // As in Init, use the most registers until they would produce too much
+  // output, then halve them.
+  for (int num_registers = kMaxRegisters; num_registers >= 1; num_registers /= 2) {
+    const int group_size = num_registers * kNumOutputsPerRegister;
+    const int w_step = (rounded_num_in + 1) * group_size;
+    for (; output + group_size <= rounded_num_out; output += group_size) {
+      PartialMatrixDotVector(num_registers, wi, scales, u, rounded_num_in, v);
+      wi += w_step;
+      scales += group_size;
+      v += group_size;
+    }
+  }
+}
+
+// Number of inputs that matrixDotVectorsBlocked multiplies at once.
+constexpr int kNumBatchRows = 2;
+
+// Computes part of matrix.vector v[r] = Wu[r] for kNumBatchRows inputs,
+// with kNumRegisters output registers for each. Each register of weights is
+// loaded and has its signs normalized once for all the inputs. The weights
+// are arranged as for PartialMatrixDotVector64 with N = 8 * kNumRegisters.
+// The results are written to v[r] + offset.
+template <int kNumRegisters>
+static void PartialMatrixDotVectors(const int8_t *wi, const double *scales,
+                                    const int8_t *const *u, int num_in, double *const *v,
+                                    int offset) {
+  // Register containing 16-bit ones for horizontal add with 16->32 bit
+  // conversion.
+  __m256i ones = _mm256_set_epi16(1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1);
+  __m256i shift_id = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+  __m256i results[kNumBatchRows][kNumRegisters];
+  for (auto &row_results : results) {
+    for (auto &result : row_results) {
+      result = _mm256_setzero_si256();
+    }
+  }
+  for (int j = 0; j < num_in;) {
+    __m256i inputs[kNumBatchRows];
+    for (int r = 0; r < kNumBatchRows; ++r) {
+      inputs[r] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(u[r] + j));
+    }
+    for (int ig = 0; ig < kNumInputGroups && j < num_in; ++ig, j += kNumInputsPerGroup) {
+      __m256i rep_inputs[kNumBatchRows];
+      for (int r = 0; r < kNumBatchRows; ++r) {
+        rep_inputs[r] = _mm256_broadcastd_epi32(_mm256_castsi256_si128(inputs[r]));
+        inputs[r] = _mm256_permutevar8x32_epi32(inputs[r], shift_id);
+      }
+      for (int k = 0; k < kNumRegisters; ++k) {
+        // As MultiplyGroup, with the weights shared by the inputs.
+        __m256i weights = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(wi));
+        wi += kNumInputsPerRegister;
+        __m256i positive_weights = _mm256_sign_epi8(weights, weights);
+        for (int r = 0; r < kNumBatchRows; ++r) {
+          __m256i reps = _mm256_sign_epi8(rep_inputs[r], weights);
+          __m256i products = _mm256_maddubs_epi16(positive_weights, reps);
+          products = _mm256_madd_epi16(products, ones);
+          results[r][k] = _mm256_add_epi32(results[r][k], products);
+        }
+      }
+    }
+  }
+  // All inputs share the bias weights and scales which follow.
+  for (int r = 0; r < kNumBatchRows; ++r) {
+    const int8_t *bias = wi;
+    const double *row_scales = scales;
+    double *row_v = v[r] + offset;
+    if constexpr (kNumRegisters == 1) {
+      ExtractResults8(results[r][0], bias, row_scales, row_v);
+    } else {
+      for (int k = 0; k + 1 < kNumRegisters; k += 2) {
+        ExtractResults16(results[r][k], results[r][k + 1], bias, row_scales, row_v);
+      }
+    }
+  }
+}
+
+// Computes matrix.vector v[r] = Wu[r] for num_rows inputs, with the weights
+// shaped as for matrixDotVectorBlocked<kMaxRegisters>. Each block of the
+// weights is read once for kNumBatchRows inputs.
+template <int kMaxRegisters>
+static void matrixDotVectorsBlocked(int dim1, int dim2, const int8_t *wi, const double *scales,
+                                    int num_rows, const int8_t *const *u, double *const *v) {
+  const int num_out = dim1;
+  const int num_in = dim2 - 1;
+  const int rounded_num_in = IntSimdMatrix::Roundup(num_in, kNumInputsPerGroup);
+  const int rounded_num_out = IntSimdMatrix::Roundup(num_out, kNumOutputsPerRegister);
+  int row = 0;
+  for (; row + kNumBatchRows <= num_rows; row += kNumBatchRows) {
+    const int8_t *w = wi;
+    const double *s = scales;
+    int output = 0;
+    for (int num_registers = kMaxRegisters; num_registers >= 1; num_registers /= 2) {
+      const int group_size = num_registers * kNumOutputsPerRegister;
+      const int w_step = (rounded_num_in + 1) * group_size;
+      for (; output + group_size <= rounded_num_out; output += group_size) {
+        switch (num_registers) {
+          case 4:
+            PartialMatrixDotVectors<4>(w, s, u + row, rounded_num_in, v + row, output);
+            break;
+          case 2:
+            PartialMatrixDotVectors<2>(w, s, u + row, rounded_num_in, v + row, output);
+            break;
+          default:
+            PartialMatrixDotVectors<1>(w, s, u + row, rounded_num_in, v + row, output);
+            break;
+        }
+        w += w_step;
+        s += group_size;
+      }
+    }
+  }
+  for (; row < num_rows; ++row) {
+    matrixDotVectorBlocked<kMaxRegisters>(dim1, dim2, wi, scales, u[row], v[row]);
+  }
+}
+
+// The variants with fewer output registers, which can also batch inputs.
+static const IntSimdMatrix intSimdMatrixAVX2R4 = {
+    matrixDotVectorBlocked<4>, kNumOutputsPerRegister, 4, kNumInputsPerRegister,
+    kNumInputsPerGroup,        matrixDotVectorsBlocked<4>, "avx2_r4", nullptr};
+static const IntSimdMatrix intSimdMatrixAVX2R2 = {
+    matrixDotVectorBlocked<2>, kNumOutputsPerRegister, 2, kNumInputsPerRegister,
+    kNumInputsPerGroup,        matrixDotVectorsBlocked<2>, "avx2_r2", nullptr};
+static const IntSimdMatrix intSimdMatrixAVX2R1 = {
+    matrixDotVectorBlocked<1>, kNumOutputsPerRegister, 1, kNumInputsPerRegister,
+    kNumInputsPerGroup,        matrixDotVectorsBlocked<1>, "avx2_r1", nullptr};
+static const IntSimdMatrix *const kVariantsAVX2[] = {&intSimdMatrixAVX2R4, &intSimdMatrixAVX2R2,
+                                                     &intSimdMatrixAVX2R1, nullptr};
+
 const IntSimdMatrix IntSimdMatrix::intSimdMatrixAVX2 = {
     // Function.
     matrixDotVector,
@@ -341,7 +502,13 @@ const IntSimdMatrix IntSimdMatrix::intSimdMatrixAVX2 = {
     // Number of 8 bit inputs in the inputs register.
     kNumInputsPerRegister,
     // Number of inputs in each weight group.
-    kNumInputsPerGroup};
+    kNumInputsPerGroup,
+    // Function for several inputs. 16 result registers would not fit.
+    nullptr,
+    // Name.
+    "avx2",
+    // Variants.
+    kVariantsAVX2};
 
 } // namespace tesseract.
 
@@ -196,7 +196,13 @@ const IntSimdMatrix IntSimdMatrix::intSimdMatrixNEON = {
     // Number of 8 bit inputs in the inputs register.
     kNumInputsPerRegister,
     // Number of inputs in each weight group.
-    kNumInputsPerGroup};
+    kNumInputsPerGroup,
+    // Function for several inputs.
+    nullptr,
+    // Name.
+    "neon",
+    // Variants.
+    nullptr};
 
 } // namespace tesseract.
 
@@ -99,7 +99,13 @@ const IntSimdMatrix IntSimdMatrix::intSimdMatrixSSE = {
     // Number of 8 bit inputs in the inputs register.
     1,
     // Number of inputs in each weight group.
-    1};
+    1,
+    // Function for several inputs.
+    nullptr,
+    // Name.
+    "sse",
+    // Variants.
+    nullptr};
 
 } // namespace tesseract.
 
@@ -40,6 +40,7 @@
 #  include "reject.h"
 #endif
 #include "sorthelper.h"
+#include "stagestats.h" // for STAGE_TIMER
 #include "tesseractclass.h"
 #include "tessvars.h"
 #include "werdit.h"
@@ -88,11 +89,11 @@ bool Tesseract::recog_interactive(PAGE_RES_IT *pr_it) {
     int16_t good_char_qual;
     WERD_RES *word_res = pr_it->word();
     word_char_quality(word_res, &char_qual, &good_char_qual);
-    tprintf(
-        "\n%d chars;  word_blob_quality: %d;  outline_errs: %d; "
-        "char_quality: %d; good_char_quality: %d\n",
-        word_res->reject_map.length(), word_blob_quality(word_res), word_outline_errs(word_res),
-        char_qual, good_char_qual);
+    TLOG(TESS_LOG_DEBUG,
+         "\n%d chars;  word_blob_quality: %d;  outline_errs: %d; "
+         "char_quality: %d; good_char_quality: %d\n",
+         word_res->reject_map.length(), word_blob_quality(word_res), word_outline_errs(word_res),
+         char_qual, good_char_qual);
   }
 #endif // ndef DISABLED_LEGACY_ENGINE
   return true;
@@ -201,6 +202,14 @@ bool Tesseract::RecogAllWordsPassN(int pass_n, ETEXT_DESC *monitor, PAGE_RES_IT
   // added. The results will be significantly different with adaption on, and
   // deterioration will need investigation.
   pr_it->restart_page();
+  if (pass_n == 1) {
+    STAGE_COUNT_EVENT(COUNTER_WORDS, words->size());
+  }
+  // The row (and its block) whose words are being recognized, if completed
+  // rows have to be reported.
+  const bool report_rows = pass_n == 1 && row_done_callback_;
+  BLOCK_RES *current_block = nullptr;
+  ROW_RES *current_row = nullptr;
   for (unsigned w = 0; w < words->size(); ++w) {
     WordData *word = &(*words)[w];
     if (w > 0) {
@@ -240,6 +249,13 @@ bool Tesseract::RecogAllWordsPassN(int pass_n, ETEXT_DESC *monitor, PAGE_RES_IT
       pr_it->forward();
     }
     ASSERT_HOST(pr_it->word() != nullptr);
+    if (report_rows && pr_it->row() != current_row) {
+      if (current_row != nullptr) {
+        row_done_callback_(current_block, current_row);
+      }
+      current_block = pr_it->block();
+      current_row = pr_it->row();
+    }
     bool make_next_word_fuzzy = false;
 #ifndef DISABLED_LEGACY_ENGINE
     if (!AnyLSTMLang() && ReassignDiacritics(pass_n, pr_it, &make_next_word_fuzzy)) {
@@ -250,14 +266,18 @@ bool Tesseract::RecogAllWordsPassN(int pass_n, ETEXT_DESC *monitor, PAGE_RES_IT
 
     classify_word_and_language(pass_n, pr_it, word);
     if (tessedit_dump_choices || debug_noise_removal) {
-      tprintf("Pass%d: %s [%s]\n", pass_n, word->word->best_choice->unichar_string().c_str(),
-              word->word->best_choice->debug_string().c_str());
+      TLOG(TESS_LOG_DEBUG, "Pass%d: %s [%s]\n", pass_n,
+           word->word->best_choice->unichar_string().c_str(),
+           word->word->best_choice->debug_string().c_str());
     }
     pr_it->forward();
     if (make_next_word_fuzzy && pr_it->word() != nullptr) {
       pr_it->MakeCurrentWordFuzzy();
     }
   }
+  if (current_row != nullptr) {
+    row_done_callback_(current_block, current_row);
+  }
   return true;
 }
 
@@ -385,6 +405,7 @@ bool Tesseract::recog_all_words(PAGE_RES *page_res, ETEXT_DESC *monitor,
 
   // The next passes are only required for Tess-only.
   if (AnyTessLang() && !AnyLSTMLang()) {
+    STAGE_TIMER(STAGE_POST_PASSES);
     // ****************** Pass 3 *******************
     // Fix fuzzy spaces.
 
@@ -401,16 +422,34 @@ bool Tesseract::recog_all_words(PAGE_RES *page_res, ETEXT_DESC *monitor,
       bigram_correction_pass(page_res);
     }
 
+    // The passes whose results the outputs in tessedit_output_profile do
+    // not need are skipped, except for the runs which measure the time
+    // that skipping saves (PASS_SAMPLED).
     // ****************** Pass 5,6 *******************
-    rejection_passes(page_res, monitor, target_word_box, word_config);
+    if (OutputNeedsPass(PASS_REJECTION) || PASS_SAMPLED(PASS_REJECTION)) {
+      PASS_TIMER(PASS_REJECTION);
+      rejection_passes(page_res, monitor, target_word_box, word_config);
+    } else {
+      PASS_SKIPPED(PASS_REJECTION);
+    }
 
     // ****************** Pass 8 *******************
-    font_recognition_pass(page_res);
+    if (OutputNeedsPass(PASS_FONTS) || PASS_SAMPLED(PASS_FONTS)) {
+      PASS_TIMER(PASS_FONTS);
+      font_recognition_pass(page_res);
+    } else {
+      PASS_SKIPPED(PASS_FONTS);
+    }
 
     // ****************** Pass 9 *******************
     // Check the correctness of the final results.
     blamer_pass(page_res);
-    script_pos_pass(page_res);
+    if (OutputNeedsPass(PASS_SCRIPT_POSITIONS) || PASS_SAMPLED(PASS_SCRIPT_POSITIONS)) {
+      PASS_TIMER(PASS_SCRIPT_POSITIONS);
+      script_pos_pass(page_res);
+    } else {
+      PASS_SKIPPED(PASS_SCRIPT_POSITIONS);
+    }
   }
 
 #endif // ndef DISABLED_LEGACY_ENGINE
@@ -470,7 +509,7 @@ void Tesseract::bigram_correction_pass(PAGE_RES *page_res) {
     }
     if (w_prev->word->flag(W_REP_CHAR) || w->word->flag(W_REP_CHAR)) {
       if (tessedit_bigram_debug) {
-        tprintf("Skipping because one of the words is W_REP_CHAR\n");
+        TLOG(TESS_LOG_DEBUG, "Skipping because one of the words is W_REP_CHAR\n");
       }
       continue;
     }
@@ -495,13 +534,14 @@ void Tesseract::bigram_correction_pass(PAGE_RES *page_res) {
 
     if (w->tesseract->getDict().valid_bigram(prev_best, this_best)) {
       if (tessedit_bigram_debug) {
-        tprintf("Top choice \"%s %s\" verified by bigram model.\n", orig_w1_str.c_str(),
-                orig_w2_str.c_str());
+        TLOG(TESS_LOG_DEBUG, "Top choice \"%s %s\" verified by bigram model.\n",
+             orig_w1_str.c_str(), orig_w2_str.c_str());
       }
       continue;
     }
     if (tessedit_bigram_debug > 2) {
-      tprintf("Examining alt choices for \"%s %s\".\n", orig_w1_str.c_str(), orig_w2_str.c_str());
+      TLOG(TESS_LOG_DEBUG, "Examining alt choices for \"%s %s\".\n", orig_w1_str.c_str(),
+           orig_w2_str.c_str());
     }
     if (tessedit_bigram_debug > 1) {
       if (!w_prev->best_choices.singleton()) {
@@ -546,10 +586,10 @@ void Tesseract::bigram_correction_pass(PAGE_RES *page_res) {
       if (EqualIgnoringCaseAndTerminalPunct(*w_prev->best_choice, *overrides_word1[best_idx]) &&
           EqualIgnoringCaseAndTerminalPunct(*w->best_choice, *overrides_word2[best_idx])) {
         if (tessedit_bigram_debug > 1) {
-          tprintf(
-              "Top choice \"%s %s\" verified (sans case) by bigram "
-              "model.\n",
-              orig_w1_str.c_str(), orig_w2_str.c_str());
+          TLOG(TESS_LOG_DEBUG,
+               "Top choice \"%s %s\" verified (sans case) by bigram "
+               "model.\n",
+               orig_w1_str.c_str(), orig_w2_str.c_str());
         }
         continue;
       }
@@ -586,9 +626,9 @@ void Tesseract::bigram_correction_pass(PAGE_RES *page_res) {
             choices_description += " compatible bigrams.";
           }
         }
-        tprintf("Replaced \"%s %s\" with \"%s %s\" with bigram model. %s\n", orig_w1_str.c_str(),
-                orig_w2_str.c_str(), new_w1_str.c_str(), new_w2_str.c_str(),
-                choices_description.c_str());
+        TLOG(TESS_LOG_DEBUG, "Replaced \"%s %s\" with \"%s %s\" with bigram model. %s\n",
+             orig_w1_str.c_str(), orig_w2_str.c_str(), new_w1_str.c_str(), new_w2_str.c_str(),
+             choices_description.c_str());
       }
     }
   }
@@ -650,18 +690,20 @@ void Tesseract::rejection_passes(PAGE_RES *page_res, ETEXT_DESC *monitor,
   }
 
   if (tessedit_debug_quality_metrics) {
-    tprintf(
-        "QUALITY: num_chs= %d  num_rejs= %d %5.3f blob_qual= %d %5.3f"
-        " outline_errs= %d %5.3f char_qual= %d %5.3f good_ch_qual= %d %5.3f\n",
-        page_res->char_count, page_res->rej_count,
-        page_res->rej_count / static_cast<float>(page_res->char_count), stats_.doc_blob_quality,
-        stats_.doc_blob_quality / static_cast<float>(page_res->char_count), stats_.doc_outline_errs,
-        stats_.doc_outline_errs / static_cast<float>(page_res->char_count), stats_.doc_char_quality,
-        stats_.doc_char_quality / static_cast<float>(page_res->char_count),
-        stats_.doc_good_char_quality,
-        (stats_.good_char_count > 0)
-            ? (stats_.doc_good_char_quality / static_cast<float>(stats_.good_char_count))
-            : 0.0);
+    TLOG(TESS_LOG_DEBUG,
+         "QUALITY: num_chs= %d  num_rejs= %d %5.3f blob_qual= %d %5.3f"
+         " outline_errs= %d %5.3f char_qual= %d %5.3f good_ch_qual= %d %5.3f\n",
+         page_res->char_count, page_res->rej_count,
+         page_res->rej_count / static_cast<float>(page_res->char_count), stats_.doc_blob_quality,
+         stats_.doc_blob_quality / static_cast<float>(page_res->char_count),
+         stats_.doc_outline_errs,
+         stats_.doc_outline_errs / static_cast<float>(page_res->char_count),
+         stats_.doc_char_quality,
+         stats_.doc_char_quality / static_cast<float>(page_res->char_count),
+         stats_.doc_good_char_quality,
+         (stats_.good_char_count > 0)
+             ? (stats_.doc_good_char_quality / static_cast<float>(stats_.good_char_count))
+             : 0.0);
   }
   bool good_quality_doc =
       ((page_res->rej_count / static_cast<float>(page_res->char_count)) <= quality_rej_pc) &&
@@ -847,11 +889,11 @@ static int SelectBestWords(double rating_ratio, double certainty_margin, bool de
       }
     }
     if (debug) {
-      tprintf(
-          "%d new words %s than %d old words: r: %g v %g c: %g v %g"
-          " valid dict: %d v %d\n",
-          end_n - start_n, new_better ? "better" : "worse", end_b - start_b, n_rating, b_rating,
-          n_certainty, b_certainty, n_valid_permuter, b_valid_permuter);
+      TLOG(TESS_LOG_DEBUG,
+           "%d new words %s than %d old words: r: %g v %g c: %g v %g"
+           " valid dict: %d v %d\n",
+           end_n - start_n, new_better ? "better" : "worse", end_b - start_b, n_rating, b_rating,
+           n_certainty, b_certainty, n_valid_permuter, b_valid_permuter);
     }
     // Move on to the next group.
     b = end_b;
@@ -871,8 +913,8 @@ static int SelectBestWords(double rating_ratio, double certainty_margin, bool de
 int Tesseract::RetryWithLanguage(const WordData &word_data, WordRecognizer recognizer, bool debug,
                                  WERD_RES **in_word, PointerVector<WERD_RES> *best_words) {
   if (debug) {
-    tprintf("Trying word using lang %s, oem %d\n", lang.c_str(),
-            static_cast<int>(tessedit_ocr_engine_mode));
+    TLOG(TESS_LOG_DEBUG, "Trying word using lang %s, oem %d\n", lang.c_str(),
+         static_cast<int>(tessedit_ocr_engine_mode));
   }
   // Run the recognizer on the word.
   PointerVector<WERD_RES> new_words;
@@ -910,6 +952,7 @@ static bool WordsAcceptable(const PointerVector<WERD_RES> &words) {
 // blob list on the current word. Returns true if anything was done, and
 // sets make_next_word_fuzzy if blob(s) were added to the end of the word.
 bool Tesseract::ReassignDiacritics(int pass, PAGE_RES_IT *pr_it, bool *make_next_word_fuzzy) {
+  STAGE_TIMER(STAGE_POST_PASSES);
   *make_next_word_fuzzy = false;
   WERD *real_word = pr_it->word()->word;
   if (real_word->rej_cblob_list()->empty() || real_word->cblob_list()->empty() ||
@@ -957,9 +1000,9 @@ bool Tesseract::ReassignDiacritics(int pass, PAGE_RES_IT *pr_it, bool *make_next
       ++non_overlapped_used;
     }
   }
-  if (debug_noise_removal) {
-    tprintf("Used %d/%d overlapped %d/%d non-overlaped diacritics on word:", num_overlapped_used,
-            num_overlapped, non_overlapped_used, non_overlapped);
+  if (debug_noise_removal && TLOG_ENABLED(TESS_LOG_DEBUG)) {
+    TLOG(TESS_LOG_DEBUG, "Used %d/%d overlapped %d/%d non-overlaped diacritics on word:",
+         num_overlapped_used, num_overlapped, non_overlapped_used, non_overlapped);
     real_word->bounding_box().print();
   }
   // Now we have decided which outlines we want, put them into the real_word.
@@ -1002,8 +1045,8 @@ void Tesseract::AssignDiacriticsToOverlappingBlobs(const std::vector<C_OUTLINE *
         ++num_blob_outlines;
       }
     }
-    if (debug_noise_removal) {
-      tprintf("%d noise outlines overlap blob at:", num_blob_outlines);
+    if (debug_noise_removal && TLOG_ENABLED(TESS_LOG_DEBUG)) {
+      TLOG(TESS_LOG_DEBUG, "%d noise outlines overlap blob at:", num_blob_outlines);
       blob_box.print();
     }
     // If any outlines overlap the blob, and not too many, classify the blob
@@ -1058,7 +1101,7 @@ void Tesseract::AssignDiacriticsToNewBlobs(const std::vector<C_OUTLINE *> &outli
     // Choose which combination of them we actually want and where to put
     // them.
     if (debug_noise_removal) {
-      tprintf("Num blobless outlines = %d\n", num_blob_outlines);
+      TLOG(TESS_LOG_DEBUG, "Num blobless outlines = %d\n", num_blob_outlines);
     }
     C_BLOB *left_blob = blob_it.data();
     TBOX left_box = left_blob->bounding_box();
@@ -1068,7 +1111,7 @@ void Tesseract::AssignDiacriticsToNewBlobs(const std::vector<C_OUTLINE *> &outli
         SelectGoodDiacriticOutlines(pass, noise_cert_disjoint, pr_it, left_blob, outlines,
                                     num_blob_outlines, &blob_wanted)) {
       if (debug_noise_removal) {
-        tprintf("Added to left blob\n");
+        TLOG(TESS_LOG_DEBUG, "Added to left blob\n");
       }
       for (unsigned j = 0; j < blob_wanted.size(); ++j) {
         if (blob_wanted[j]) {
@@ -1082,7 +1125,7 @@ void Tesseract::AssignDiacriticsToNewBlobs(const std::vector<C_OUTLINE *> &outli
                SelectGoodDiacriticOutlines(pass, noise_cert_disjoint, pr_it, right_blob, outlines,
                                            num_blob_outlines, &blob_wanted)) {
       if (debug_noise_removal) {
-        tprintf("Added to right blob\n");
+        TLOG(TESS_LOG_DEBUG, "Added to right blob\n");
       }
       for (unsigned j = 0; j < blob_wanted.size(); ++j) {
         if (blob_wanted[j]) {
@@ -1093,7 +1136,7 @@ void Tesseract::AssignDiacriticsToNewBlobs(const std::vector<C_OUTLINE *> &outli
     } else if (SelectGoodDiacriticOutlines(pass, noise_cert_punc, pr_it, nullptr, outlines,
                                            num_blob_outlines, &blob_wanted)) {
       if (debug_noise_removal) {
-        tprintf("Fitted between blobs\n");
+        TLOG(TESS_LOG_DEBUG, "Fitted between blobs\n");
       }
       for (unsigned j = 0; j < blob_wanted.size(); ++j) {
         if (blob_wanted[j]) {
@@ -1117,9 +1160,9 @@ bool Tesseract::SelectGoodDiacriticOutlines(int pass, float certainty_threshold,
   if (blob != nullptr) {
     float target_c2;
     target_cert = ClassifyBlobAsWord(pass, pr_it, blob, best_str, &target_c2);
-    if (debug_noise_removal) {
-      tprintf("No Noise blob classified as %s=%g(%g) at:", best_str.c_str(), target_cert,
-              target_c2);
+    if (debug_noise_removal && TLOG_ENABLED(TESS_LOG_DEBUG)) {
+      TLOG(TESS_LOG_DEBUG, "No Noise blob classified as %s=%g(%g) at:", best_str.c_str(),
+           target_cert, target_c2);
       blob->bounding_box().print();
     }
     target_cert -= (target_cert - certainty_threshold) * noise_cert_factor;
@@ -1129,15 +1172,15 @@ bool Tesseract::SelectGoodDiacriticOutlines(int pass, float certainty_threshold,
   std::string all_str;
   std::vector<bool> best_outlines = *ok_outlines;
   float best_cert = ClassifyBlobPlusOutlines(test_outlines, outlines, pass, pr_it, blob, all_str);
-  if (debug_noise_removal) {
+  if (debug_noise_removal && TLOG_ENABLED(TESS_LOG_DEBUG)) {
     TBOX ol_box;
     for (unsigned i = 0; i < test_outlines.size(); ++i) {
       if (test_outlines[i]) {
         ol_box += outlines[i]->bounding_box();
       }
     }
-    tprintf("All Noise blob classified as %s=%g, delta=%g at:", all_str.c_str(), best_cert,
-            best_cert - target_cert);
+    TLOG(TESS_LOG_DEBUG, "All Noise blob classified as %s=%g, delta=%g at:", all_str.c_str(),
+         best_cert, best_cert - target_cert);
     ol_box.print();
   }
   // Iteratively zero out the bit that improves the certainty the most, until
@@ -1152,16 +1195,16 @@ bool Tesseract::SelectGoodDiacriticOutlines(int pass, float certainty_threshold,
         test_outlines[i] = false;
         std::string str;
         float cert = ClassifyBlobPlusOutlines(test_outlines, outlines, pass, pr_it, blob, str);
-        if (debug_noise_removal) {
+        if (debug_noise_removal && TLOG_ENABLED(TESS_LOG_DEBUG)) {
           TBOX ol_box;
           for (unsigned j = 0; j < outlines.size(); ++j) {
             if (test_outlines[j]) {
               ol_box += outlines[j]->bounding_box();
             }
-            tprintf("%c", test_outlines[j] ? 'T' : 'F');
+            TLOG(TESS_LOG_DEBUG, "%c", test_outlines[j] ? 'T' : 'F');
           }
-          tprintf(" blob classified as %s=%g, delta=%g) at:", str.c_str(), cert,
-                  cert - target_cert);
+          TLOG(TESS_LOG_DEBUG, " blob classified as %s=%g, delta=%g) at:", str.c_str(), cert,
+               cert - target_cert);
           ol_box.print();
         }
         if (cert > best_cert) {
@@ -1181,11 +1224,11 @@ bool Tesseract::SelectGoodDiacriticOutlines(int pass, float certainty_threshold,
     // Save the best combination.
     *ok_outlines = best_outlines;
     if (debug_noise_removal) {
-      tprintf("%s noise combination ", blob ? "Adding" : "New");
+      TLOG(TESS_LOG_DEBUG, "%s noise combination ", blob ? "Adding" : "New");
       for (auto best_outline : best_outlines) {
-        tprintf("%c", best_outline ? 'T' : 'F');
+        TLOG(TESS_LOG_DEBUG, "%c", best_outline ? 'T' : 'F');
       }
-      tprintf(" yields certainty %g, beating target of %g\n", best_cert, target_cert);
+      TLOG(TESS_LOG_DEBUG, " yields certainty %g, beating target of %g\n", best_cert, target_cert);
     }
     return true;
   }
@@ -1258,11 +1301,12 @@ float Tesseract::ClassifyBlobAsWord(int pass_n, PAGE_RES_IT *pr_it, C_BLOB *blob
   classify_word_and_language(pass_n, &it, &wd);
   if (debug_noise_removal) {
     if (wd.word->raw_choice != nullptr) {
-      tprintf("word xheight=%g, row=%g, range=[%g,%g]\n", word_res->x_height, wd.row->x_height(),
-              wd.word->raw_choice->min_x_height(), wd.word->raw_choice->max_x_height());
+      TLOG(TESS_LOG_DEBUG, "word xheight=%g, row=%g, range=[%g,%g]\n", word_res->x_height,
+           wd.row->x_height(), wd.word->raw_choice->min_x_height(),
+           wd.word->raw_choice->max_x_height());
     } else {
-      tprintf("Got word with null raw choice xheight=%g, row=%g\n", word_res->x_height,
-              wd.row->x_height());
+      TLOG(TESS_LOG_DEBUG, "Got word with null raw choice xheight=%g, row=%g\n", word_res->x_height,
+           wd.row->x_height());
     }
   }
   float cert = 0.0f;
@@ -1304,9 +1348,9 @@ void Tesseract::classify_word_and_language(int pass_n, PAGE_RES_IT *pr_it, WordD
   const WERD_RES *word = word_data->word;
   clock_t start_t = clock();
   const bool debug = classify_debug_level > 0 || multilang_debug_level > 0;
-  if (debug) {
-    tprintf("%s word with lang %s at:", word->done ? "Already done" : "Processing",
-            most_recently_used_->lang.c_str());
+  if (debug && TLOG_ENABLED(TESS_LOG_DEBUG)) {
+    TLOG(TESS_LOG_DEBUG, "%s word with lang %s at:", word->done ? "Already done" : "Processing",
+         most_recently_used_->lang.c_str());
     word->word->bounding_box().print();
   }
   if (word->done) {
@@ -1356,8 +1400,9 @@ void Tesseract::classify_word_and_language(int pass_n, PAGE_RES_IT *pr_it, WordD
   }
   clock_t ocr_t = clock();
   if (tessedit_timing_debug) {
-    tprintf("%s (ocr took %.2f sec)\n", word_data->word->best_choice->unichar_string().c_str(),
-            static_cast<double>(ocr_t - start_t) / CLOCKS_PER_SEC);
+    TLOG(TESS_LOG_DEBUG, "%s (ocr took %.2f sec)\n",
+         word_data->word->best_choice->unichar_string().c_str(),
+         static_cast<double>(ocr_t - start_t) / CLOCKS_PER_SEC);
   }
 }
 
@@ -1494,11 +1539,11 @@ bool Tesseract::TestNewNormalization(int original_misfits, float baseline_shift,
   if (!new_x_ht_word.tess_failed) {
     int new_misfits = CountMisfitTops(&new_x_ht_word);
     if (debug_x_ht_level >= 1) {
-      tprintf("Old misfits=%d with x-height %f, new=%d with x-height %f\n", original_misfits,
-              word->x_height, new_misfits, new_x_ht);
-      tprintf("Old rating= %f, certainty=%f, new=%f, %f\n", word->best_choice->rating(),
-              word->best_choice->certainty(), new_x_ht_word.best_choice->rating(),
-              new_x_ht_word.best_choice->certainty());
+      TLOG(TESS_LOG_DEBUG, "Old misfits=%d with x-height %f, new=%d with x-height %f\n",
+           original_misfits, word->x_height, new_misfits, new_x_ht);
+      TLOG(TESS_LOG_DEBUG, "Old rating= %f, certainty=%f, new=%f, %f\n",
+           word->best_choice->rating(), word->best_choice->certainty(),
+           new_x_ht_word.best_choice->rating(), new_x_ht_word.best_choice->certainty());
     }
     // The misfits must improve and either the rating or certainty.
     accept_new_x_ht = new_misfits < original_misfits &&
@@ -1581,6 +1626,7 @@ void Tesseract::match_word_pass_n(int pass_n, WERD_RES *word, ROW *row, BLOCK *b
   if (word->tess_failed) {
     return;
   }
+  STAGE_TIMER(STAGE_LEGACY_CLASSIFY);
   tess_segment_pass_n(pass_n, word);
 
   if (!word->tess_failed) {
@@ -1930,7 +1976,7 @@ void Tesseract::set_word_fonts(WERD_RES *word) {
 
   // Compute the font scores for the word
   if (tessedit_debug_fonts) {
-    tprintf("Examining fonts in %s\n", word->best_choice->debug_string().c_str());
+    TLOG(TESS_LOG_DEBUG, "Examining fonts in %s\n", word->best_choice->debug_string().c_str());
   }
   for (int b = 0; b < word->best_choice->length(); ++b) {
     const BLOB_CHOICE *choice = word->GetBlobChoice(b);
@@ -1950,7 +1996,8 @@ void Tesseract::set_word_fonts(WERD_RES *word) {
   int16_t font_id1 = -1, font_id2 = -1;
   for (int f = 0; f < fontinfo_size; ++f) {
     if (tessedit_debug_fonts && font_total_score[f] > 0) {
-      tprintf("Font %s, total score = %d\n", fontinfo_table_.at(f).name, font_total_score[f]);
+      TLOG(TESS_LOG_DEBUG, "Font %s, total score = %d\n", fontinfo_table_.at(f).name,
+           font_total_score[f]);
     }
     if (font_total_score[f] > score1) {
       score2 = score1;
@@ -1972,11 +2019,11 @@ void Tesseract::set_word_fonts(WERD_RES *word) {
     const FontInfo fi = fontinfo_table_.at(font_id1);
     if (tessedit_debug_fonts) {
       if (word->fontinfo_id2_count > 0 && font_id2 >= 0) {
-        tprintf("Word modal font=%s, score=%d, 2nd choice %s/%d\n", fi.name,
-                word->fontinfo_id_count, fontinfo_table_.at(font_id2).name,
-                word->fontinfo_id2_count);
+        TLOG(TESS_LOG_DEBUG, "Word modal font=%s, score=%d, 2nd choice %s/%d\n", fi.name,
+             word->fontinfo_id_count, fontinfo_table_.at(font_id2).name, word->fontinfo_id2_count);
       } else {
-        tprintf("Word modal font=%s, score=%d. No 2nd choice\n", fi.name, word->fontinfo_id_count);
+        TLOG(TESS_LOG_DEBUG, "Word modal font=%s, score=%d. No 2nd choice\n", fi.name,
+             word->fontinfo_id_count);
       }
     }
   }
@@ -2061,8 +2108,8 @@ void Tesseract::dictionary_correction_pass(PAGE_RES *page_res) {
       if (word->tesseract->getDict().valid_word(*alternate)) {
         // The alternate choice is in the dictionary.
         if (tessedit_bigram_debug) {
-          tprintf("Dictionary correction replaces best choice '%s' with '%s'\n",
-                  best->unichar_string().c_str(), alternate->unichar_string().c_str());
+          TLOG(TESS_LOG_DEBUG, "Dictionary correction replaces best choice '%s' with '%s'\n",
+               best->unichar_string().c_str(), alternate->unichar_string().c_str());
         }
         // Replace the 'best' choice with a better choice.
         word->ReplaceBestChoice(alternate);
@@ -22,6 +22,7 @@
 #include "imagedata.h" // for ImageData
 #include "lstmrecognizer.h"
 #include "pageres.h"
+#include "profiler.h"
 #include "recodebeam.h"
 #include "tprintf.h"
 
@@ -230,6 +231,7 @@ ImageData *Tesseract::GetRectImage(const TBOX &box, const BLOCK &block, int padd
 // Analogous to classify_word_pass1, but can handle a group of words as well.
 void Tesseract::LSTMRecognizeWord(const BLOCK &block, ROW *row, WERD_RES *word,
                                   PointerVector<WERD_RES> *words) {
+  PROFILE_SCOPE("LSTMRecognizeWord", -1, &lang);
   TBOX word_box = word->word->bounding_box();
   // Get the word image - no frills.
   if (tessedit_pageseg_mode == PSM_SINGLE_WORD || tessedit_pageseg_mode == PSM_RAW_LINE) {
@@ -297,11 +299,11 @@ void Tesseract::SearchWords(PointerVector<WERD_RES> *words) {
       word->tesseract = this;
       float word_certainty = std::min(word->space_certainty, word->best_choice->certainty());
       word_certainty *= kCertaintyScale;
-      if (getDict().stopper_debug_level >= 1) {
-        tprintf("Best choice certainty=%g, space=%g, scaled=%g, final=%g\n",
-                word->best_choice->certainty(), word->space_certainty,
-                std::min(word->space_certainty, word->best_choice->certainty()) * kCertaintyScale,
-                word_certainty);
+      if (getDict().stopper_debug_level >= 1 && TLOG_ENABLED(TESS_LOG_DEBUG)) {
+        TLOG(TESS_LOG_DEBUG, "Best choice certainty=%g, space=%g, scaled=%g, final=%g\n",
+             word->best_choice->certainty(), word->space_certainty,
+             std::min(word->space_certainty, word->best_choice->certainty()) * kCertaintyScale,
+             word_certainty);
         word->best_choice->print();
       }
       word->best_choice->set_certainty(word_certainty);
@@ -2552,27 +2552,40 @@ static void InitializeRowInfo(bool after_recognition, const MutableIterator &it,
   }
 }
 
-// This is called after rows have been identified and words are recognized.
-// Much of this could be implemented before word recognition, but text helps
-// to identify bulleted lists and gives good signals for sentence boundaries.
-void DetectParagraphs(int debug_level, bool after_text_recognition,
-                      const MutableIterator *block_start, std::vector<ParagraphModel *> *models) {
+// The rows of a block, with the results of paragraph detection on them.
+struct BlockParagraphs {
+  explicit BlockParagraphs(const MutableIterator &start) : block_start(start) {}
+
+  MutableIterator block_start;
+  BLOCK *block = nullptr;
+  bool is_image_block = false;
+  std::vector<RowInfo> row_infos;
+  std::vector<PARA *> row_owners;
+  std::vector<ParagraphModel *> models;
+};
+
+// Clears the paragraphs of the block and fills in the RowInfos of its rows.
+// Returns false if the block has no text lines.
+static bool InitializeBlockRows(bool after_text_recognition, BlockParagraphs *block_paras) {
   // Clear out any preconceived notions.
-  if (block_start->Empty(RIL_TEXTLINE)) {
-    return;
+  const MutableIterator &block_start = block_paras->block_start;
+  if (block_start.Empty(RIL_TEXTLINE)) {
+    return false;
   }
-  BLOCK *block = block_start->PageResIt()->block()->block;
+  BLOCK *block = block_start.PageResIt()->block()->block;
   block->para_list()->clear();
-  bool is_image_block = block->pdblk.poly_block() && !block->pdblk.poly_block()->IsText();
+  block_paras->block = block;
+  block_paras->is_image_block =
+      block->pdblk.poly_block() && !block->pdblk.poly_block()->IsText();
 
   // Convert the Tesseract structures to RowInfos
   // for the paragraph detection algorithm.
-  MutableIterator row(*block_start);
+  MutableIterator row(block_start);
   if (row.Empty(RIL_TEXTLINE)) {
-    return; // end of input already.
+    return false; // end of input already.
   }
 
-  std::vector<RowInfo> row_infos;
+  std::vector<RowInfo> &row_infos = block_paras->row_infos;
   do {
     if (!row.PageResIt()->row()) {
       continue; // empty row.
@@ -2603,20 +2616,26 @@ void DetectParagraphs(int debug_level, bool after_text_recognition,
       }
     }
   }
+  return true;
+}
 
-  // Run the paragraph detection algorithm.
-  std::vector<PARA *> row_owners;
-  std::vector<PARA *> the_paragraphs;
-  if (!is_image_block) {
-    DetectParagraphs(debug_level, &row_infos, &row_owners, block->para_list(), models);
+// Runs the paragraph detection algorithm on the RowInfos of the block.
+// Only the block's own paragraphs and models are touched, so blocks can be
+// detected concurrently.
+static void DetectBlockParagraphs(int debug_level, BlockParagraphs *block_paras) {
+  if (!block_paras->is_image_block) {
+    DetectParagraphs(debug_level, &block_paras->row_infos, &block_paras->row_owners,
+                     block_paras->block->para_list(), &block_paras->models);
   } else {
-    row_owners.resize(row_infos.size());
-    CanonicalizeDetectionResults(&row_owners, block->para_list());
+    block_paras->row_owners.resize(block_paras->row_infos.size());
+    CanonicalizeDetectionResults(&block_paras->row_owners, block_paras->block->para_list());
   }
+}
 
-  // Now stitch in the row_owners into the rows.
-  row = *block_start;
-  for (auto &row_owner : row_owners) {
+// Stitches the row_owners of the block into its rows.
+static void CommitBlockParagraphs(const BlockParagraphs &block_paras) {
+  MutableIterator row(block_paras.block_start);
+  for (auto &row_owner : block_paras.row_owners) {
     while (!row.PageResIt()->row()) {
       row.Next(RIL_TEXTLINE);
     }
@@ -2625,4 +2644,53 @@ void DetectParagraphs(int debug_level, bool after_text_recognition,
   }
 }
 
+// This is called after rows have been identified and words are recognized.
+// Much of this could be implemented before word recognition, but text helps
+// to identify bulleted lists and gives good signals for sentence boundaries.
+void DetectParagraphs(int debug_level, bool after_text_recognition,
+                      const MutableIterator *block_start, std::vector<ParagraphModel *> *models) {
+  BlockParagraphs block_paras(*block_start);
+  if (!InitializeBlockRows(after_text_recognition, &block_paras)) {
+    return;
+  }
+  DetectBlockParagraphs(debug_level, &block_paras);
+  CommitBlockParagraphs(block_paras);
+  models->insert(models->end(), block_paras.models.begin(), block_paras.models.end());
+}
+
+void DetectPageParagraphs(int debug_level, bool after_text_recognition,
+                          MutableIterator *page_it, std::vector<ParagraphModel *> *models,
+                          bool commit) {
+  // The rows are read from the PAGE_RES by a single iterator, so their
+  // RowInfos are made first, in page order.
+  std::vector<std::unique_ptr<BlockParagraphs>> blocks;
+  do {
+    auto block_paras = std::make_unique<BlockParagraphs>(*page_it);
+    if (InitializeBlockRows(after_text_recognition, block_paras.get())) {
+      blocks.push_back(std::move(block_paras));
+    }
+  } while (page_it->Next(RIL_BLOCK));
+
+  int num_blocks = blocks.size();
+#ifdef _OPENMP
+#  pragma omp parallel for schedule(dynamic) if (debug_level == 0 && num_blocks > 1)
+#endif
+  for (int b = 0; b < num_blocks; ++b) {
+    DetectBlockParagraphs(debug_level, blocks[b].get());
+  }
+
+  for (auto &block_paras : blocks) {
+    if (commit) {
+      CommitBlockParagraphs(*block_paras);
+      models->insert(models->end(), block_paras->models.begin(), block_paras->models.end());
+    } else {
+      // No row refers to the paragraphs yet.
+      block_paras->block->para_list()->clear();
+      for (auto model : block_paras->models) {
+        delete model;
+      }
+    }
+  }
+}
+
 } // namespace tesseract
@@ -99,6 +99,17 @@ TESS_API
 void DetectParagraphs(int debug_level, bool after_text_recognition,
                       const MutableIterator *block_start, std::vector<ParagraphModel *> *models);
 
+// Runs DetectParagraphs on every block from page_it to the end of the page,
+// which leaves page_it at the end. The RowInfos of all blocks are made
+// first, then the blocks are detected in parallel if OpenMP is enabled and
+// debug_level is 0. The models are saved in block order.  Caller owns the
+// models. Without commit, the paragraphs are detected and discarded, which
+// leaves every block as a single paragraph, for measuring the detection.
+TESS_API
+void DetectPageParagraphs(int debug_level, bool after_text_recognition,
+                          MutableIterator *page_it, std::vector<ParagraphModel *> *models,
+                          bool commit = true);
+
 } // namespace tesseract
 
 #endif // TESSERACT_CCMAIN_PARAGRAPHS_H_
@@ -40,10 +40,7 @@
 
 namespace tesseract {
 
-// Read a "config" file containing a set of variable, value pairs.
-// Searches the standard places: tessdata/configs, tessdata/tessconfigs
-// and also accepts a relative or absolute path name.
-void Tesseract::read_config_file(const char *filename, SetParamConstraint constraint) {
+std::string Tesseract::find_config_file(const char *filename) const {
   std::string path = datadir;
   path += "configs/";
   path += filename;
@@ -60,6 +57,14 @@ void Tesseract::read_config_file(const char *filename, SetParamConstraint constr
       path = filename;
     }
   }
+  return path;
+}
+
+// Read a "config" file containing a set of variable, value pairs.
+// Searches the standard places: tessdata/configs, tessdata/tessconfigs
+// and also accepts a relative or absolute path name.
+void Tesseract::read_config_file(const char *filename, SetParamConstraint constraint) {
+  std::string path = find_config_file(filename);
   ParamUtils::ReadParamsFile(path.c_str(), constraint, this->params());
 }
 
@@ -97,6 +102,7 @@ bool Tesseract::init_tesseract_lang_data(const std::string &arg0, const std::str
         " to your \"tessdata\" directory.\n");
     return false;
   }
+  model_version_ = mgr->VersionString();
 #ifdef DISABLED_LEGACY_ENGINE
   tessedit_ocr_engine_mode.set_value(OEM_LSTM_ONLY);
 #else
@@ -174,6 +180,9 @@ bool Tesseract::init_tesseract_lang_data(const std::string &arg0, const std::str
     if (mgr->IsComponentAvailable(TESSDATA_LSTM)) {
       lstm_recognizer_ = new LSTMRecognizer(language_data_path_prefix.c_str());
       ASSERT_HOST(lstm_recognizer_->Load(this->params(), lstm_use_matrix ? language : "", mgr));
+      if (lstm_tune_int_simd) {
+        lstm_recognizer_->TuneIntSimd();
+      }
     } else {
       tprintf("Error: LSTM requested, but not present!! Loading tesseract.\n");
       tessedit_ocr_engine_mode.set_value(OEM_TESSERACT_ONLY);
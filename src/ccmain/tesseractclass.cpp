@@ -46,6 +46,11 @@
 #  include "equationdetect.h"
 #endif
 #include "lstmrecognizer.h"
+#include "memorystats.h"
+#include "tprintf.h"
+
+#include <cstring> // for strcmp
+#include <set>     // for std::set
 
 namespace tesseract {
 
@@ -184,6 +189,15 @@ Tesseract::Tesseract()
                   "Run paragraph detection on the post-text-recognition "
                   "(more accurate)",
                   this->params())
+    , BOOL_MEMBER(paragraph_detection, true,
+                  "Detect paragraphs. Can be turned off if the outputs do not "
+                  "need them, such as plain text without paragraph breaks",
+                  this->params())
+    , STRING_MEMBER(tessedit_output_profile, "",
+                    "The outputs which will be read, to skip the passes they do not "
+                    "need: text (plain text without paragraph breaks), words (word "
+                    "boxes with confidences), hocr (hOCR with fonts) or all",
+                    this->params())
     , BOOL_MEMBER(lstm_use_matrix, 1, "Use ratings matrix/beam search with lstm", this->params())
     , STRING_MEMBER(outlines_odd, "%| ", "Non standard number of outlines", this->params())
     , STRING_MEMBER(outlines_2, "ij!?%\":;", "Non standard number of outlines", this->params())
@@ -397,6 +411,14 @@ Tesseract::Tesseract()
                     "information is lost due to the cut off at 0. The standard value is "
                     "5",
                     this->params())
+    , BOOL_MEMBER(lstm_profile_layers, false,
+                  "Time each layer of the LSTM network, see "
+                  "TessBaseAPI::GetLSTMLayerProfile",
+                  this->params())
+    , BOOL_MEMBER(lstm_tune_int_simd, false,
+                  "Time the SIMD variants of the int matrix product for each "
+                  "shape of the LSTM weights on loading and use the fastest",
+                  this->params())
     , BOOL_MEMBER(pageseg_apply_music_mask, true,
                   "Detect music staff and remove intersecting components", this->params())
     ,
@@ -455,6 +477,50 @@ void Tesseract::Clear() {
   }
 }
 
+void Tesseract::MeasureMemory(MemoryRecorder *recorder) {
+  size_t bytes[MEMORY_COUNT] = {};
+  // The languages share clones of the images.
+  std::set<const Pix *> images;
+  for (int i = -1; i < num_sub_langs(); ++i) {
+    Tesseract *lang = i < 0 ? this : sub_langs_[i];
+    bytes[MEMORY_DICTIONARIES] += lang->Classify::getDict().MemoryUsed();
+#ifndef DISABLED_LEGACY_ENGINE
+    bytes[MEMORY_LEGACY_TEMPLATES] += lang->TemplatesMemoryUsed();
+#endif
+    const LSTMRecognizer *recognizer = lang->lstm_recognizer_;
+    if (recognizer != nullptr) {
+      bytes[MEMORY_LSTM_WEIGHTS] += recognizer->NetworkMemoryUsed();
+      bytes[MEMORY_LSTM_SCRATCH] += recognizer->ScratchMemoryUsed();
+      if (recognizer->GetDict() != nullptr) {
+        bytes[MEMORY_DICTIONARIES] += recognizer->GetDict()->MemoryUsed();
+      }
+    }
+    for (const Pix *pix : {lang->pix_binary_, lang->pix_grey_, lang->pix_original_,
+                           lang->pix_thresholds_, lang->scaled_color_}) {
+      if (pix != nullptr && images.insert(pix).second) {
+        Pix *image = const_cast<Pix *>(pix);
+        bytes[MEMORY_IMAGES] += sizeof(uint32_t) * pixGetWpl(image) * pixGetHeight(image);
+      }
+    }
+  }
+  for (auto subsystem : {MEMORY_LSTM_WEIGHTS, MEMORY_LSTM_SCRATCH, MEMORY_DICTIONARIES,
+                         MEMORY_LEGACY_TEMPLATES, MEMORY_IMAGES}) {
+    recorder->Set(subsystem, bytes[subsystem]);
+  }
+}
+
+size_t Tesseract::UnicharsetsMemoryUsed() const {
+  size_t bytes = 0;
+  for (int i = -1; i < num_sub_langs(); ++i) {
+    const Tesseract *lang = i < 0 ? this : sub_langs_[i];
+    bytes += lang->unicharset.MemoryUsed();
+    if (lang->lstm_recognizer_ != nullptr) {
+      bytes += lang->lstm_recognizer_->GetUnicharset().MemoryUsed();
+    }
+  }
+  return bytes;
+}
+
 #ifndef DISABLED_LEGACY_ENGINE
 
 void Tesseract::SetEquationDetect(EquationDetect *detector) {
@@ -505,6 +571,58 @@ void Tesseract::SetBlackAndWhitelist() {
   }
 }
 
+void Tesseract::SetLSTMLayerProfiling() {
+  if (lstm_recognizer_) {
+    lstm_recognizer_->SetLayerProfiling(lstm_profile_layers);
+  }
+  // Like the black and white lists, the setting of the main language applies.
+  for (auto &sub_lang : sub_langs_) {
+    if (sub_lang->lstm_recognizer_) {
+      sub_lang->lstm_recognizer_->SetLayerProfiling(lstm_profile_layers);
+    }
+  }
+}
+
+// The optional passes whose results each output profile needs, as bits
+// indexed by OptionalPass. The reject maps are only read by the UNLV
+// output, and the script positions only by the iterators, so only all
+// needs them.
+struct OutputProfile {
+  const char *name;
+  unsigned passes;
+};
+static const unsigned kAllPasses = (1u << PASS_COUNT) - 1;
+static const OutputProfile kOutputProfiles[] = {
+    {"", kAllPasses},
+    {"all", kAllPasses},
+    {"text", 0},
+    {"words", 0},
+    {"hocr", (1u << PASS_PARAGRAPHS) | (1u << PASS_FONTS)},
+};
+
+static const OutputProfile *FindOutputProfile(const char *name) {
+  for (const auto &profile : kOutputProfiles) {
+    if (strcmp(name, profile.name) == 0) {
+      return &profile;
+    }
+  }
+  return nullptr;
+}
+
+bool Tesseract::OutputNeedsPass(OptionalPass pass) const {
+  const OutputProfile *profile = FindOutputProfile(tessedit_output_profile.c_str());
+  return profile == nullptr || (profile->passes & (1u << pass)) != 0;
+}
+
+bool Tesseract::CheckOutputProfile() const {
+  if (FindOutputProfile(tessedit_output_profile.c_str()) != nullptr) {
+    return true;
+  }
+  tprintf("Warning: unknown tessedit_output_profile %s, running all passes\n",
+          tessedit_output_profile.c_str());
+  return false;
+}
+
 // Perform steps to prepare underlying binary image/other data structures for
 // page segmentation.
 void Tesseract::PrepareForPageseg() {
@@ -39,6 +39,7 @@
 #include "params.h"          // for BOOL_VAR_H, BoolParam, DoubleParam
 #include "points.h"          // for FCOORD
 #include "ratngs.h"          // for ScriptPos, WERD_CHOICE (ptr only)
+#include "stagestats.h"      // for OptionalPass
 #include "tessdatamanager.h" // for TessdataManager
 #include "textord.h"         // for Textord
 #include "wordrec.h"         // for Wordrec
@@ -49,8 +50,9 @@
 
 #include <allheaders.h> // for pixDestroy, pixGetWidth, pixGetHe...
 
-#include <cstdint> // for int16_t, int32_t, uint16_t
-#include <cstdio>  // for FILE
+#include <cstdint>    // for int16_t, int32_t, uint16_t
+#include <cstdio>     // for FILE
+#include <functional> // for std::function
 
 namespace tesseract {
 
@@ -72,6 +74,7 @@ class DocumentData;
 class EquationDetect;
 class ImageData;
 class LSTMRecognizer;
+class MemoryRecorder;
 class Tesseract;
 
 // Top-level class for all tesseract global instance data.
@@ -192,6 +195,13 @@ public:
   // Set the equation detector.
   void SetEquationDetect(EquationDetect *detector);
 
+  // Sets a function which RecogAllWordsPassN calls whenever pass 1 has
+  // recognized all the words of a text line, so results can be streamed
+  // before the page is complete. Cleared with nullptr.
+  void set_row_done_callback(std::function<void(BLOCK_RES *, ROW_RES *)> callback) {
+    row_done_callback_ = std::move(callback);
+  }
+
   // Simple accessors.
   const FCOORD &reskew() const {
     return reskew_;
@@ -282,6 +292,14 @@ public:
   Tesseract *get_sub_lang(int index) const {
     return sub_langs_[index];
   }
+  // Returns the LSTM recognizer of this language, or nullptr.
+  const LSTMRecognizer *lstm_recognizer() const {
+    return lstm_recognizer_;
+  }
+  // Returns the version string of the traineddata of this language.
+  const std::string &model_version() const {
+    return model_version_;
+  }
   // Returns true if any language uses Tesseract (as opposed to LSTM).
   bool AnyTessLang() const {
     if (tessedit_ocr_engine_mode != OEM_LSTM_ONLY) {
@@ -308,6 +326,21 @@ public:
   }
 
   void SetBlackAndWhitelist();
+  // Turns the layer profile of the LSTM recognizers of all languages on or
+  // off, as set by lstm_profile_layers.
+  void SetLSTMLayerProfiling();
+  // Returns whether the outputs named by tessedit_output_profile need the
+  // results of the pass. An unknown profile needs all passes.
+  bool OutputNeedsPass(OptionalPass pass) const;
+  // Prints a warning and returns false if tessedit_output_profile is not
+  // a known profile.
+  bool CheckOutputProfile() const;
+  // Sets the bytes of the models of all languages and of the images of the
+  // page in the recorder, except those of the unicharsets, which do not
+  // change while recognizing and take longer to measure.
+  void MeasureMemory(MemoryRecorder *recorder);
+  // Returns the bytes of the unicharsets of all languages and their LSTMs.
+  size_t UnicharsetsMemoryUsed() const;
 
   // Perform steps to prepare underlying binary image/other data structures for
   // page segmentation. Uses the strategy specified in the global variable
@@ -483,6 +516,9 @@ public:
   int16_t count_alphanums(const WERD_CHOICE &word);
   int16_t count_alphas(const WERD_CHOICE &word);
 
+  // Returns the path of a config file, which is looked up in
+  // tessdata/configs, tessdata/tessconfigs and the current directory.
+  std::string find_config_file(const char *filename) const;
   void read_config_file(const char *filename, SetParamConstraint constraint);
   // Initialize for potentially a set of languages defined by the language
   // string and recursively any additional languages required by any language
@@ -843,6 +879,13 @@ public:
   BOOL_VAR_H(paragraph_text_based, true,
              "Run paragraph detection on the post-text-recognition "
              "(more accurate)");
+  BOOL_VAR_H(paragraph_detection, true,
+             "Detect paragraphs. Can be turned off if the outputs do not "
+             "need them, such as plain text without paragraph breaks");
+  STRING_VAR_H(tessedit_output_profile, "",
+               "The outputs which will be read, to skip the passes they do not "
+               "need: text (plain text without paragraph breaks), words (word "
+               "boxes with confidences), hocr (hOCR with fonts) or all");
   BOOL_VAR_H(lstm_use_matrix, 1, "Use ratings matrix/beam searct with lstm");
   STRING_VAR_H(outlines_odd, "%| ", "Non standard number of outlines");
   STRING_VAR_H(outlines_2, "ij!?%\":;", "Non standard number of outlines");
@@ -1016,6 +1059,12 @@ public:
                "the coefficient, the better are the ratings for each choice "
                "and less information is lost due to the cut off at 0. The "
                "standard value is 5.");
+  BOOL_VAR_H(lstm_profile_layers, false,
+             "Time each layer of the LSTM network, see "
+             "TessBaseAPI::GetLSTMLayerProfile");
+  BOOL_VAR_H(lstm_tune_int_simd, false,
+             "Time the SIMD variants of the int matrix product for each "
+             "shape of the LSTM weights on loading and use the fastest");
   BOOL_VAR_H(pageseg_apply_music_mask, true,
              "Detect music staff and remove intersecting components");
 
@@ -1069,8 +1118,12 @@ private:
   EquationDetect *equ_detect_;
   // LSTM recognizer, if available.
   LSTMRecognizer *lstm_recognizer_;
+  // Version string of the traineddata, to identify the model.
+  std::string model_version_;
   // Output "page" number (actually line number) using TrainLineRecognizer.
   int train_line_page_num_;
+  // Called for each text line completed by pass 1, if set.
+  std::function<void(BLOCK_RES *, ROW_RES *)> row_done_callback_;
 };
 
 } // namespace tesseract
@@ -20,7 +20,8 @@
 
 #include <tesseract/thresholder.h>
 
-#include <cstdint> // for uint32_t
+#include <algorithm> // for std::min
+#include <cstdint>   // for uint32_t
 #include <cstring>
 
 #include "otsuthr.h"
@@ -40,7 +41,11 @@ ImageThresholder::ImageThresholder()
     , pix_wpl_(0)
     , scale_(1)
     , yres_(300)
-    , estimated_res_(300) {
+    , estimated_res_(300)
+    , borrowed_data_(nullptr)
+    , borrowed_bytes_per_pixel_(0)
+    , borrowed_bytes_per_line_(0)
+    , borrowed_grey_(nullptr) {
   SetRectangle(0, 0, 0, 0);
 }
 
@@ -51,11 +56,13 @@ ImageThresholder::~ImageThresholder() {
 // Destroy the Pix if there is one, freeing memory.
 void ImageThresholder::Clear() {
   pixDestroy(&pix_);
+  pixDestroy(&borrowed_grey_);
+  borrowed_data_ = nullptr;
 }
 
 // Return true if no image has been set.
 bool ImageThresholder::IsEmpty() const {
-  return pix_ == nullptr;
+  return pix_ == nullptr && borrowed_data_ == nullptr;
 }
 
 // SetImage makes a copy of all the image data, so it may be deleted
@@ -125,9 +132,41 @@ void ImageThresholder::SetImage(const unsigned char *imagedata, int width, int h
   pixDestroy(&pix);
 }
 
+// SetImageBorrowed uses the image data in place instead of copying it.
+// The data must remain valid and unchanged until the next SetImage,
+// SetImageBorrowed or Clear, or the destruction of the thresholder.
+// Greyscale of 8 bits (bytes_per_pixel=1) and color of 24 or 32 bits
+// per pixel in RGB(A) byte order may be given. Alpha is ignored.
+void ImageThresholder::SetImageBorrowed(const unsigned char *imagedata, int width, int height,
+                                        int bytes_per_pixel, int bytes_per_line) {
+  Clear();
+  if (bytes_per_pixel != 1 && bytes_per_pixel != 3 && bytes_per_pixel != 4) {
+    tprintf("Cannot use RAW image data with %d bytes per pixel in place\n", bytes_per_pixel);
+    return;
+  }
+  if (imagedata == nullptr || width <= 0 || height <= 0 ||
+      bytes_per_line < width * bytes_per_pixel) {
+    tprintf("Invalid RAW image: %dx%d with %d bytes per line\n", width, height, bytes_per_line);
+    return;
+  }
+  borrowed_data_ = imagedata;
+  borrowed_bytes_per_pixel_ = bytes_per_pixel;
+  borrowed_bytes_per_line_ = bytes_per_line;
+  image_width_ = width;
+  image_height_ = height;
+  pix_channels_ = bytes_per_pixel;
+  pix_wpl_ = 0;
+  scale_ = 1;
+  // Like a Pix made from RAW data, there is no resolution.
+  estimated_res_ = yres_ = 0;
+  Init();
+}
+
 // Store the coordinates of the rectangle to process for later use.
 // Doesn't actually do any thresholding.
 void ImageThresholder::SetRectangle(int left, int top, int width, int height) {
+  // The greyscale copy of a borrowed image only covers the rectangle.
+  pixDestroy(&borrowed_grey_);
   rect_left_ = left;
   rect_top_ = top;
   rect_width_ = width;
@@ -154,9 +193,7 @@ void ImageThresholder::GetImageSizes(int *left, int *top, int *width, int *heigh
 // immediately after, but may not go away until after the Thresholder has
 // finished with it.
 void ImageThresholder::SetImage(const Pix *pix) {
-  if (pix_ != nullptr) {
-    pixDestroy(&pix_);
-  }
+  Clear();
   Pix *src = const_cast<Pix *>(pix);
   int depth;
   pixGetDimensions(src, &image_width_, &image_height_, &depth);
@@ -200,6 +237,8 @@ bool ImageThresholder::ThresholdToPix(PageSegMode pageseg_mode, Pix **pix) {
     Pix *original = GetPixRect();
     *pix = pixCopy(nullptr, original);
     pixDestroy(&original);
+  } else if (borrowed_data_ != nullptr) {
+    ThresholdBorrowedToPix(pix);
   } else {
     OtsuThresholdRectToPix(pix_, pix);
   }
@@ -243,6 +282,14 @@ void ImageThresholder::Init() {
 // the layout analysis that uses it will only be available with Leptonica,
 // so there is no raw equivalent.
 Pix *ImageThresholder::GetPixRect() {
+  if (borrowed_data_ != nullptr) {
+    if (borrowed_grey_ == nullptr) {
+      int histogram[kHistogramSize];
+      borrowed_grey_ =
+          BorrowedRectToGrey(rect_left_, rect_top_, rect_width_, rect_height_, histogram);
+    }
+    return pixClone(borrowed_grey_);
+  }
   if (IsFullImage()) {
     // Just clone the whole thing.
     return pixClone(pix_);
@@ -333,4 +380,98 @@ void ImageThresholder::ThresholdRectToPix(Pix *src_pix, int num_channels, const
   }
 }
 
+// Otsu thresholds the rectangle of the borrowed image. The caller's data is
+// read only once: the greyscale conversion makes the histogram for the
+// threshold in the same pass, and the binary image is made from the
+// greyscale image, which is kept for GetPixRectGrey.
+void ImageThresholder::ThresholdBorrowedToPix(Pix **pix) {
+  int histogram[kHistogramSize];
+  pixDestroy(&borrowed_grey_);
+  borrowed_grey_ = BorrowedRectToGrey(rect_left_, rect_top_, rect_width_, rect_height_, histogram);
+  // The same choice as OtsuThreshold makes for a single channel.
+  int total;
+  int omega0;
+  int threshold = OtsuStats(histogram, &total, &omega0);
+  bool dark_foreground = true;
+  if (omega0 == 0 || omega0 == total) {
+    // There is no apparent foreground, so everything is background.
+    threshold = -1;
+  } else if (omega0 > total * 0.75) {
+    dark_foreground = false;
+  } else if (omega0 >= total * 0.25) {
+    dark_foreground = omega0 < total * 0.5;
+  }
+  *pix = pixCreate(rect_width_, rect_height_, 1);
+  pixSetXRes(*pix, pixGetXRes(borrowed_grey_));
+  pixSetYRes(*pix, pixGetYRes(borrowed_grey_));
+  uint32_t *pixdata = pixGetData(*pix);
+  int wpl = pixGetWpl(*pix);
+  const uint32_t *greydata = pixGetData(borrowed_grey_);
+  int grey_wpl = pixGetWpl(borrowed_grey_);
+  for (int y = 0; y < rect_height_; ++y) {
+    const uint32_t *greyline = greydata + y * grey_wpl;
+    uint32_t *pixline = pixdata + y * wpl;
+    for (int x = 0; x < rect_width_; ++x) {
+      if ((static_cast<int>(GET_DATA_BYTE(greyline, x)) > threshold) != dark_foreground) {
+        SET_DATA_BIT(pixline, x);
+      }
+    }
+  }
+}
+
+// Returns a greyscale version of the whole borrowed image. The greyscale
+// image of the rectangle is reused if the rectangle is the whole image.
+Pix *ImageThresholder::GetBorrowedImageGrey() {
+  if (borrowed_data_ == nullptr) {
+    return nullptr;
+  }
+  int histogram[kHistogramSize];
+  if (!IsFullImage()) {
+    return BorrowedRectToGrey(0, 0, image_width_, image_height_, histogram);
+  }
+  if (borrowed_grey_ == nullptr) {
+    borrowed_grey_ = BorrowedRectToGrey(0, 0, image_width_, image_height_, histogram);
+  }
+  return pixClone(borrowed_grey_);
+}
+
+// Converts a rectangle of the borrowed image data to a new greyscale
+// Pix, computing its histogram in the same pass. Color is converted with
+// the weights of pixConvertRGBToLuminance, so the result matches
+// GetPixRectGrey for a copied image.
+Pix *ImageThresholder::BorrowedRectToGrey(int left, int top, int width, int height,
+                                          int *histogram) const {
+  const float kRedWeight = L_RED_WEIGHT;
+  const float kGreenWeight = L_GREEN_WEIGHT;
+  const float kBlueWeight = L_BLUE_WEIGHT;
+  memset(histogram, 0, sizeof(*histogram) * kHistogramSize);
+  Pix *grey = pixCreate(width, height, 8);
+  pixSetXRes(grey, yres_);
+  pixSetYRes(grey, yres_);
+  uint32_t *greydata = pixGetData(grey);
+  int grey_wpl = pixGetWpl(grey);
+  const int bpp = borrowed_bytes_per_pixel_;
+  const unsigned char *srcline = borrowed_data_ + top * borrowed_bytes_per_line_ + left * bpp;
+  for (int y = 0; y < height; ++y, srcline += borrowed_bytes_per_line_) {
+    uint32_t *greyline = greydata + y * grey_wpl;
+    if (bpp == 1) {
+      for (int x = 0; x < width; ++x) {
+        int value = srcline[x];
+        SET_DATA_BYTE(greyline, x, value);
+        ++histogram[value];
+      }
+    } else {
+      const unsigned char *src = srcline;
+      for (int x = 0; x < width; ++x, src += bpp) {
+        int value = static_cast<int>(kRedWeight * src[0] + kGreenWeight * src[1] +
+                                     kBlueWeight * src[2] + 0.5);
+        value = std::min(value, 255);
+        SET_DATA_BYTE(greyline, x, value);
+        ++histogram[value];
+      }
+    }
+  }
+  return grey;
+}
+
 } // namespace tesseract.
@@ -248,6 +248,10 @@ public:
   virtual int num_elements() const {
     return dim1_ * dim2_;
   }
+  // Returns the number of bytes allocated for the elements.
+  size_t MemoryUsed() const {
+    return sizeof(T) * size_allocated_;
+  }
 
   // Expression to select a specific location in the matrix. The matrix is
   // stored COLUMN-major, so the left-most index is the most significant.
@@ -31,6 +31,7 @@
 #include "ocrrow.h"   // for ROW, ROW_IT
 #include "pdblock.h"  // for PDBLK
 #include "polyblk.h"  // for POLY_BLOCK
+#include "recycler.h" // for RECYCLE_OBJECTS
 #include "seam.h"     // for SEAM, start_seam_list
 #include "stepblob.h" // for C_BLOB_IT, C_BLOB, C_BLOB_LIST
 #include "tprintf.h"  // for tprintf
@@ -50,6 +51,11 @@ CLISTIZE(BLOCK_RES)
 ELISTIZE(ROW_RES)
 ELISTIZE(WERD_RES)
 
+RECYCLE_OBJECTS(PAGE_RES)
+RECYCLE_OBJECTS(BLOCK_RES)
+RECYCLE_OBJECTS(ROW_RES)
+RECYCLE_OBJECTS(WERD_RES)
+
 // Gain factor for computing thresholds that determine the ambiguity of a
 // word.
 static const double kStopperAmbiguityThresholdGain = 8.0;
@@ -73,6 +79,23 @@ static double StopperAmbigThreshold(double f1, double f2) {
   return (f2 - f1) * kStopperAmbiguityThresholdGain - kStopperAmbiguityThresholdOffset;
 }
 
+size_t PAGE_RES::MemoryUsed() const {
+  size_t bytes = sizeof(*this);
+  BLOCK_RES_IT block_it(const_cast<BLOCK_RES_LIST *>(&block_res_list));
+  for (block_it.mark_cycle_pt(); !block_it.cycled_list(); block_it.forward()) {
+    bytes += sizeof(BLOCK_RES);
+    ROW_RES_IT row_it(&block_it.data()->row_res_list);
+    for (row_it.mark_cycle_pt(); !row_it.cycled_list(); row_it.forward()) {
+      bytes += sizeof(ROW_RES);
+      WERD_RES_IT word_it(&row_it.data()->word_res_list);
+      for (word_it.mark_cycle_pt(); !word_it.cycled_list(); word_it.forward()) {
+        bytes += word_it.data()->MemoryUsed();
+      }
+    }
+  }
+  return bytes;
+}
+
 /*************************************************************************
  * PAGE_RES::PAGE_RES
  *
@@ -1101,6 +1124,36 @@ WERD_RES::~WERD_RES() {
   Clear();
 }
 
+size_t WERD_RES::MemoryUsed() const {
+  size_t bytes = sizeof(*this) + seam_array.capacity() * sizeof(seam_array[0]) +
+                 (blob_widths.capacity() + blob_gaps.capacity()) * sizeof(int) +
+                 best_state.capacity() * sizeof(best_state[0]);
+  for (auto twerd : {chopped_word, rebuild_word}) {
+    if (twerd != nullptr) {
+      bytes += sizeof(*twerd) + twerd->NumBlobs() * sizeof(TBLOB);
+    }
+  }
+  if (ratings != nullptr) {
+    bytes += sizeof(*ratings) + ratings->MemoryUsed();
+    for (int col = 0; col < ratings->dimension(); ++col) {
+      for (int row = col; row < ratings->dimension() && row < col + ratings->bandwidth(); ++row) {
+        BLOB_CHOICE_LIST *choices = ratings->get(col, row);
+        if (choices != NOT_CLASSIFIED) {
+          bytes += sizeof(*choices) + choices->length() * sizeof(BLOB_CHOICE);
+        }
+      }
+    }
+  }
+  if (raw_choice != nullptr) {
+    bytes += raw_choice->MemoryUsed();
+  }
+  WERD_CHOICE_IT it(const_cast<WERD_CHOICE_LIST *>(&best_choices));
+  for (it.mark_cycle_pt(); !it.cycled_list(); it.forward()) {
+    bytes += it.data()->MemoryUsed();
+  }
+  return bytes;
+}
+
 void WERD_RES::Clear() {
   if (combination) {
     delete word;
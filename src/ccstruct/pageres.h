@@ -107,6 +107,14 @@ public:
            WERD_CHOICE **prev_word_best_choice_ptr);
 
   ~PAGE_RES() = default;
+
+  // The results of a page are deleted and made again for each page, so the
+  // storage of the deleted objects is kept for reuse by a Recycler.
+  static void *operator new(size_t size);
+  static void operator delete(void *object, size_t size);
+
+  // Returns an estimate of the number of bytes of the results of all words.
+  size_t MemoryUsed() const;
 };
 
 /*************************************************************************
@@ -131,6 +139,9 @@ public:
   BLOCK_RES(bool merge_similar_words, BLOCK *the_block); // real block
 
   ~BLOCK_RES() = default;
+
+  static void *operator new(size_t size);
+  static void operator delete(void *object, size_t size);
 };
 
 /*************************************************************************
@@ -150,6 +161,9 @@ public:
   ROW_RES(bool merge_similar_words, ROW *the_row); // real row
 
   ~ROW_RES() = default;
+
+  static void *operator new(size_t size);
+  static void operator delete(void *object, size_t size);
 };
 
 /*************************************************************************
@@ -350,6 +364,14 @@ public:
 
   ~WERD_RES();
 
+  static void *operator new(size_t size);
+  static void operator delete(void *object, size_t size);
+
+  // Returns an estimate of the number of bytes of the results, including
+  // the choices, the ratings matrix and the blobs of the chopped and rebuilt
+  // words, but not their outlines.
+  size_t MemoryUsed() const;
+
   // Returns the UTF-8 string for the given blob index in the best_choice word,
   // given that we know whether we are in a right-to-left reading context.
   // This matters for mirrorable characters such as parentheses.  We recognize
@@ -25,6 +25,7 @@
 #include "blobs.h"
 #include "matrix.h"
 #include "normalis.h" // kBlnBaselineOffset.
+#include "recycler.h" // RECYCLE_OBJECTS
 #include "unicharset.h"
 
 #include <algorithm>
@@ -36,6 +37,9 @@ namespace tesseract {
 ELISTIZE(BLOB_CHOICE)
 ELISTIZE(WERD_CHOICE)
 
+RECYCLE_OBJECTS(BLOB_CHOICE)
+RECYCLE_OBJECTS(WERD_CHOICE)
+
 const float WERD_CHOICE::kBadRating = 100000.0;
 // Min offset in baseline-normalized coords to make a character a subscript.
 const int kMinSubscriptOffset = 20;
@@ -266,6 +270,12 @@ void WERD_CHOICE::init(const char *src_string, const char *src_lengths, float sr
  */
 WERD_CHOICE::~WERD_CHOICE() = default;
 
+size_t WERD_CHOICE::MemoryUsed() const {
+  return sizeof(*this) + unichar_ids_.capacity() * sizeof(unichar_ids_[0]) +
+         script_pos_.capacity() * sizeof(script_pos_[0]) + state_.capacity() * sizeof(state_[0]) +
+         certainties_.capacity() * sizeof(certainties_[0]);
+}
+
 const char *WERD_CHOICE::permuter_name() const {
   return kPermuterTypeNames[permuter_];
 }
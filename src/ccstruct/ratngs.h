@@ -78,6 +78,11 @@ public:
   BLOB_CHOICE(const BLOB_CHOICE &other);
   ~BLOB_CHOICE() = default;
 
+  // Many choices are made and deleted for each page, so the storage of
+  // deleted choices is kept for reuse by a Recycler.
+  static void *operator new(size_t size);
+  static void operator delete(void *object, size_t size);
+
   UNICHAR_ID unichar_id() const {
     return unichar_id_;
   }
@@ -274,6 +279,13 @@ public:
   }
   ~WERD_CHOICE();
 
+  // The storage of deleted choices is reused, as for BLOB_CHOICE.
+  static void *operator new(size_t size);
+  static void operator delete(void *object, size_t size);
+
+  // Returns the number of bytes of the choice and its arrays.
+  size_t MemoryUsed() const;
+
   const UNICHARSET *unicharset() const {
     return unicharset_;
   }
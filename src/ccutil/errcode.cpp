@@ -18,6 +18,8 @@
 
 #include "errcode.h"
 
+#include "tprintf.h" // for LogFlush
+
 #include <cstdarg>
 #include <cstdio>
 #include <cstdlib>
@@ -70,6 +72,8 @@ void ERRCODE::error(         // handle error
     msgptr += sprintf(msgptr, "\n");
   }
 
+  // Write the pending log messages first, in case the program aborts.
+  LogFlush();
   // %s is needed here so msg is printed correctly!
   fprintf(stderr, "%s", msg);
 
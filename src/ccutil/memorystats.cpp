@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////////////
+// File:        memorystats.cpp
+// Description: Memory used by the subsystems of the OCR pipeline.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "memorystats.h"
+
+#include <algorithm> // for std::max
+
+namespace tesseract {
+
+// Not a static member, because thread_local data can not be exported
+// from a DLL.
+static thread_local MemoryRecorder *current_memory_recorder = nullptr;
+
+MemoryRecorder::Scope::Scope(MemoryRecorder *recorder) : previous_(current_memory_recorder) {
+  current_memory_recorder = recorder;
+}
+
+MemoryRecorder::Scope::~Scope() {
+  current_memory_recorder = previous_;
+}
+
+MemoryRecorder *MemoryRecorder::Current() {
+  return current_memory_recorder;
+}
+
+MemoryRecorder::~MemoryRecorder() {
+  for (MemoryCharge *charge = charges_; charge != nullptr;) {
+    MemoryCharge *next = charge->next_;
+    charge->recorder_ = nullptr;
+    charge->bytes_ = 0;
+    charge->prev_ = charge->next_ = nullptr;
+    charge = next;
+  }
+  if (current_memory_recorder == this) {
+    current_memory_recorder = nullptr;
+  }
+}
+
+void MemoryRecorder::Add(MemorySubsystem subsystem, int64_t delta) {
+  // Frees which were charged before a reset can not go below zero.
+  if (delta < 0 && static_cast<size_t>(-delta) > values_.bytes[subsystem]) {
+    delta = -static_cast<int64_t>(values_.bytes[subsystem]);
+  }
+  values_.bytes[subsystem] += delta;
+  values_.total_bytes += delta;
+  values_.page_peak[subsystem] = std::max(values_.page_peak[subsystem], values_.bytes[subsystem]);
+  values_.peak[subsystem] = std::max(values_.peak[subsystem], values_.bytes[subsystem]);
+  values_.total_page_peak = std::max(values_.total_page_peak, values_.total_bytes);
+  values_.total_peak = std::max(values_.total_peak, values_.total_bytes);
+}
+
+void MemoryRecorder::StartPage() {
+  for (int subsystem = 0; subsystem < MEMORY_COUNT; ++subsystem) {
+    values_.page_peak[subsystem] = values_.bytes[subsystem];
+  }
+  values_.total_page_peak = values_.total_bytes;
+}
+
+void MemoryRecorder::ResetPeaks() {
+  StartPage();
+  for (int subsystem = 0; subsystem < MEMORY_COUNT; ++subsystem) {
+    values_.peak[subsystem] = values_.bytes[subsystem];
+  }
+  values_.total_peak = values_.total_bytes;
+}
+
+const char *MemoryRecorder::SubsystemName(int subsystem) {
+  static const char *const kNames[MEMORY_COUNT] = {
+      "lstm_weights", "lstm_scratch", "unicharsets", "dictionaries",
+      "legacy_templates", "images", "grids", "page_res"};
+  return subsystem >= 0 && subsystem < MEMORY_COUNT ? kNames[subsystem] : "unknown";
+}
+
+void MemoryCharge::Set(MemorySubsystem subsystem, size_t bytes) {
+  Release();
+  recorder_ = MemoryRecorder::Current();
+  if (recorder_ != nullptr) {
+    subsystem_ = subsystem;
+    bytes_ = bytes;
+    recorder_->Add(subsystem, static_cast<int64_t>(bytes));
+    next_ = recorder_->charges_;
+    if (next_ != nullptr) {
+      next_->prev_ = this;
+    }
+    recorder_->charges_ = this;
+  }
+}
+
+void MemoryCharge::Release() {
+  if (recorder_ != nullptr) {
+    recorder_->Add(subsystem_, -static_cast<int64_t>(bytes_));
+    if (prev_ != nullptr) {
+      prev_->next_ = next_;
+    } else {
+      recorder_->charges_ = next_;
+    }
+    if (next_ != nullptr) {
+      next_->prev_ = prev_;
+    }
+    prev_ = next_ = nullptr;
+    recorder_ = nullptr;
+    bytes_ = 0;
+  }
+}
+
+} // namespace tesseract.
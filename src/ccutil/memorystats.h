@@ -0,0 +1,155 @@
+///////////////////////////////////////////////////////////////////////
+// File:        memorystats.h
+// Description: Memory used by the subsystems of the OCR pipeline.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CCUTIL_MEMORYSTATS_H_
+#define TESSERACT_CCUTIL_MEMORYSTATS_H_
+
+#ifdef HAVE_CONFIG_H
+#  include "config_auto.h" // DISABLED_STAGE_STATS
+#endif
+
+#include <tesseract/export.h> // for TESS_API
+
+#include <cstddef> // for size_t
+#include <cstdint> // for int64_t
+
+namespace tesseract {
+
+// The subsystems whose memory is accounted for. The models are measured
+// when they are asked for, the others also while a page is recognized, to
+// know their peak.
+enum MemorySubsystem {
+  MEMORY_LSTM_WEIGHTS,      // The LSTM networks with their kept buffers
+  MEMORY_LSTM_SCRATCH,      // The scratch buffers of the LSTM networks
+  MEMORY_UNICHARSETS,       // The unicharsets of the languages and the LSTMs
+  MEMORY_DICTIONARIES,      // Dawgs which are not shared, such as user words
+  MEMORY_LEGACY_TEMPLATES,  // Pre-trained and adapted legacy templates
+  MEMORY_IMAGES,            // The original, grey, binary and threshold images
+  MEMORY_GRIDS,             // The cells of the BBGrids of the layout analysis
+  MEMORY_PAGE_RES,          // The recognition results of the page
+  MEMORY_COUNT
+};
+
+class MemoryCharge;
+
+// Collects the bytes used by the subsystems for one TessBaseAPI, with their
+// peak on the current page and since the recorder was made or reset. The
+// total is the sum of all subsystems, and its peaks are those of the sum.
+// As with StageRecorder, the engine reports to the recorder which is
+// current in the calling thread. The recorder is not thread safe, so work
+// in other threads, such as that of OpenMP, is not accounted for.
+// The charges which are set to a recorder are detached when it is
+// destroyed, so they may outlive it.
+class TESS_API MemoryRecorder {
+public:
+  MemoryRecorder() = default;
+  ~MemoryRecorder();
+  MemoryRecorder(const MemoryRecorder &) = delete;
+  MemoryRecorder &operator=(const MemoryRecorder &) = delete;
+
+  struct Values {
+    size_t bytes[MEMORY_COUNT] = {};
+    size_t page_peak[MEMORY_COUNT] = {};
+    size_t peak[MEMORY_COUNT] = {};
+    size_t total_bytes = 0;
+    size_t total_page_peak = 0;
+    size_t total_peak = 0;
+  };
+
+  // Makes a recorder current in the calling thread for the lifetime of the
+  // object and restores the previous one afterwards.
+  class Scope {
+  public:
+    explicit Scope(MemoryRecorder *recorder);
+    ~Scope();
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    MemoryRecorder *previous_;
+  };
+
+  // Returns the recorder of the calling thread, or nullptr.
+  static MemoryRecorder *Current();
+
+  // Changes the bytes of a subsystem by delta, which is negative for freed
+  // memory, and updates the peaks.
+  void Add(MemorySubsystem subsystem, int64_t delta);
+  // Sets the bytes of a subsystem which was measured as a whole.
+  void Set(MemorySubsystem subsystem, size_t bytes) {
+    Add(subsystem, static_cast<int64_t>(bytes) - static_cast<int64_t>(values_.bytes[subsystem]));
+  }
+
+  // Starts a new page, whose peaks begin at the current bytes.
+  void StartPage();
+  // Sets the peaks to the current bytes.
+  void ResetPeaks();
+
+  const Values &values() const {
+    return values_;
+  }
+
+  static const char *SubsystemName(int subsystem);
+
+private:
+  friend class MemoryCharge;
+
+  Values values_;
+  // The charges which are set to this recorder, linked through them.
+  MemoryCharge *charges_ = nullptr;
+};
+
+// Charges a number of bytes to a subsystem of the recorder which is current
+// when it is set, until it is set again or destroyed, or the recorder is
+// destroyed. Copies are not charged.
+class TESS_API MemoryCharge {
+public:
+  MemoryCharge() = default;
+  MemoryCharge(const MemoryCharge &) {}
+  MemoryCharge &operator=(const MemoryCharge &) {
+    return *this;
+  }
+  ~MemoryCharge() {
+    Release();
+  }
+
+  void Set(MemorySubsystem subsystem, size_t bytes);
+  void Release();
+
+private:
+  friend class MemoryRecorder;
+
+  MemoryRecorder *recorder_ = nullptr;
+  MemorySubsystem subsystem_ = MEMORY_COUNT;
+  size_t bytes_ = 0;
+  // Neighbours in the list of the charges of recorder_.
+  MemoryCharge *prev_ = nullptr;
+  MemoryCharge *next_ = nullptr;
+};
+
+// MEMORY_RECORDER_SCOPE makes a recorder current for the rest of the
+// enclosing scope. It compiles to nothing if DISABLED_STAGE_STATS is
+// defined, so nothing is charged, but the models can still be measured.
+#ifndef DISABLED_STAGE_STATS
+#  define MEMORY_RECORDER_SCOPE(recorder) \
+    ::tesseract::MemoryRecorder::Scope memory_recorder_scope_(recorder)
+#else
+#  define MEMORY_RECORDER_SCOPE(recorder)
+#endif
+
+} // namespace tesseract.
+
+#endif // TESSERACT_CCUTIL_MEMORYSTATS_H_
@@ -93,6 +93,30 @@ public:
     return false;
   }
 
+  // Returns whether we know about the given pointer.
+  bool Contains(const T *t) const {
+    std::lock_guard<std::mutex> guard(mu_);
+    for (auto &it : cache_) {
+      if (it.object == t) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Returns the sum of size(object) over the loaded objects.
+  template <typename Size>
+  size_t Sum(Size size) const {
+    std::lock_guard<std::mutex> guard(mu_);
+    size_t sum = 0;
+    for (auto &it : cache_) {
+      if (it.object != nullptr) {
+        sum += size(*it.object);
+      }
+    }
+    return sum;
+  }
+
   void DeleteUnusedObjects() {
     std::lock_guard<std::mutex> guard(mu_);
     for (int i = cache_.size() - 1; i >= 0; i--) {
@@ -110,7 +134,7 @@ private:
     int count;      // A count of the number of active users of this object.
   };
 
-  std::mutex mu_;
+  mutable std::mutex mu_;
   std::vector<ReferenceCount> cache_;
 };
 
@@ -48,6 +48,27 @@ bool ParamUtils::ReadParamsFile(const char *file, SetParamConstraint constraint,
   return ReadParamsFromFp(constraint, &fp, member_params);
 }
 
+// Splits a line of a params file into the name, which is terminated in
+// place, and the value, which is returned. Returns nullptr for blank lines
+// and comments.
+static char *SplitParamsLine(char *line) {
+  if (line[0] == '\r' || line[0] == '\n' || line[0] == '#') {
+    return nullptr;
+  }
+  chomp_string(line); // remove newline
+  char *valptr;       // value field
+  for (valptr = line; *valptr && *valptr != ' ' && *valptr != '\t'; valptr++) {
+    ;
+  }
+  if (*valptr) {    // found blank
+    *valptr = '\0'; // make name a string
+    do {
+      valptr++; // find end of blanks
+    } while (*valptr == ' ' || *valptr == '\t');
+  }
+  return valptr;
+}
+
 bool ParamUtils::ReadParamsFromFp(SetParamConstraint constraint, TFile *fp,
                                   ParamsVectors *member_params) {
   char line[MAX_PATH]; // input line
@@ -56,17 +77,8 @@ bool ParamUtils::ReadParamsFromFp(SetParamConstraint constraint, TFile *fp,
   char *valptr;        // value field
 
   while (fp->FGets(line, MAX_PATH) != nullptr) {
-    if (line[0] != '\r' && line[0] != '\n' && line[0] != '#') {
-      chomp_string(line); // remove newline
-      for (valptr = line; *valptr && *valptr != ' ' && *valptr != '\t'; valptr++) {
-        ;
-      }
-      if (*valptr) {    // found blank
-        *valptr = '\0'; // make name a string
-        do {
-          valptr++; // find end of blanks
-        } while (*valptr == ' ' || *valptr == '\t');
-      }
+    valptr = SplitParamsLine(line);
+    if (valptr != nullptr) {
       foundit = SetParam(line, valptr, constraint, member_params);
 
       if (!foundit) {
@@ -210,4 +222,126 @@ void ParamUtils::ResetToDefaults(ParamsVectors *member_params) {
   }
 }
 
+ParamsOverlay ParamsOverlay::Capture(const ParamsVectors *member_params, bool changed_only) {
+  ParamsOverlay overlay;
+  std::ostringstream stream;
+  stream.imbue(std::locale::classic());
+  // Enough digits to restore the doubles exactly.
+  stream.precision(17);
+  for (int v = 0; v < 2; ++v) {
+    const ParamsVectors *vec = (v == 0) ? GlobalParams() : member_params;
+    for (auto *param : vec->int_params) {
+      if (changed_only && param->is_default()) {
+        continue;
+      }
+      overlay.Add(param->name_str(), std::to_string(int32_t(*param)).c_str());
+    }
+    for (auto *param : vec->bool_params) {
+      if (changed_only && param->is_default()) {
+        continue;
+      }
+      overlay.Add(param->name_str(), bool(*param) ? "1" : "0");
+    }
+    for (auto *param : vec->string_params) {
+      if (changed_only && param->is_default()) {
+        continue;
+      }
+      overlay.Add(param->name_str(), param->c_str());
+    }
+    for (auto *param : vec->double_params) {
+      if (changed_only && param->is_default()) {
+        continue;
+      }
+      stream.str("");
+      stream << double(*param);
+      overlay.Add(param->name_str(), stream.str().c_str());
+    }
+  }
+  return overlay;
+}
+
+void ParamsOverlay::Add(const char *name, const char *value) {
+  values_.emplace_back(name, value);
+}
+
+bool ParamsOverlay::ReadFile(const char *file) {
+  TFile fp;
+  if (!fp.Open(file, nullptr)) {
+    tprintf("read_params_file: Can't open %s\n", file);
+    return false;
+  }
+  char line[MAX_PATH];
+  while (fp.FGets(line, MAX_PATH) != nullptr) {
+    char *valptr = SplitParamsLine(line);
+    if (valptr != nullptr) {
+      Add(line, valptr);
+    }
+  }
+  return true;
+}
+
+bool ParamsOverlay::WriteFile(const char *file) const {
+  FILE *fp = fopen(file, "wb");
+  if (fp == nullptr) {
+    return false;
+  }
+  for (auto &setting : values_) {
+    fprintf(fp, "%s %s\n", setting.first.c_str(), setting.second.c_str());
+  }
+  return fclose(fp) == 0;
+}
+
+bool ParamsOverlay::Apply(SetParamConstraint constraint, ParamsVectors *member_params) {
+  bool all_found = true;
+  for (auto &setting : values_) {
+    const char *name = setting.first.c_str();
+    // Save exactly the params which SetParam may change.
+    auto *ip = ParamUtils::FindParam<IntParam>(name, GlobalParams()->int_params,
+                                               member_params->int_params);
+    if (ip != nullptr && ip->constraint_ok(constraint)) {
+      saved_ints_.emplace_back(ip, *ip);
+    }
+    auto *bp = ParamUtils::FindParam<BoolParam>(name, GlobalParams()->bool_params,
+                                                member_params->bool_params);
+    if (bp != nullptr && bp->constraint_ok(constraint)) {
+      saved_bools_.emplace_back(bp, *bp);
+    }
+    auto *sp = ParamUtils::FindParam<StringParam>(name, GlobalParams()->string_params,
+                                                  member_params->string_params);
+    if (sp != nullptr && sp->constraint_ok(constraint)) {
+      saved_strings_.emplace_back(sp, sp->c_str());
+    }
+    auto *dp = ParamUtils::FindParam<DoubleParam>(name, GlobalParams()->double_params,
+                                                  member_params->double_params);
+    if (dp != nullptr && dp->constraint_ok(constraint)) {
+      saved_doubles_.emplace_back(dp, *dp);
+    }
+    if (!ParamUtils::SetParam(name, setting.second.c_str(), constraint, member_params)) {
+      tprintf("Warning: Parameter not found: %s\n", name);
+      all_found = false;
+    }
+  }
+  return all_found;
+}
+
+void ParamsOverlay::Revert() {
+  // Backwards, so a param set twice gets the value from before the first.
+  for (auto it = saved_ints_.rbegin(); it != saved_ints_.rend(); ++it) {
+    it->first->set_value(it->second);
+  }
+  for (auto it = saved_bools_.rbegin(); it != saved_bools_.rend(); ++it) {
+    it->first->set_value(it->second);
+  }
+  for (auto it = saved_strings_.rbegin(); it != saved_strings_.rend(); ++it) {
+    it->first->set_value(it->second);
+  }
+  for (auto it = saved_doubles_.rbegin(); it != saved_doubles_.rend(); ++it) {
+    it->first->set_value(it->second);
+  }
+  saved_ints_.clear();
+  saved_bools_.clear();
+  saved_strings_.clear();
+  saved_doubles_.clear();
+}
+
 } // namespace tesseract
@@ -24,6 +24,9 @@
 #include <cstdio>
 #include <cstring>
 #include <string>
+#include <string_view>   // for std::string_view
+#include <unordered_map> // for std::unordered_map
+#include <utility>       // for std::pair
 #include <vector>
 
 namespace tesseract {
@@ -42,11 +45,70 @@ enum SetParamConstraint {
   SET_PARAM_CONSTRAINT_NON_INIT_ONLY,
 };
 
+// The params of one type in the order of their construction, with a hash
+// index by name. The params add and remove themselves.
+template <class T>
+class ParamsList {
+public:
+  using const_iterator = typename std::vector<T *>::const_iterator;
+
+  const_iterator begin() const {
+    return params_.begin();
+  }
+  const_iterator end() const {
+    return params_.end();
+  }
+  size_t size() const {
+    return params_.size();
+  }
+  bool empty() const {
+    return params_.empty();
+  }
+  T *operator[](size_t index) const {
+    return params_[index];
+  }
+
+  // Returns the first added param with the given name or nullptr.
+  T *find(const char *name) const {
+    auto it = index_.find(name);
+    return it != index_.end() ? it->second : nullptr;
+  }
+
+  void push_back(T *param) {
+    params_.push_back(param);
+    // The name is kept by the param, which outlives its entry.
+    index_.emplace(param->name_str(), param);
+  }
+  void remove(T *param) {
+    for (auto it = params_.begin(); it != params_.end(); ++it) {
+      if (*it == param) {
+        params_.erase(it);
+        break;
+      }
+    }
+    auto entry = index_.find(param->name_str());
+    if (entry != index_.end() && entry->second == param) {
+      index_.erase(entry);
+      // Another param of the same name takes its place.
+      for (auto *other : params_) {
+        if (strcmp(other->name_str(), param->name_str()) == 0) {
+          index_.emplace(other->name_str(), other);
+          break;
+        }
+      }
+    }
+  }
+
+private:
+  std::vector<T *> params_;
+  std::unordered_map<std::string_view, T *> index_;
+};
+
 struct ParamsVectors {
-  std::vector<IntParam *> int_params;
-  std::vector<BoolParam *> bool_params;
-  std::vector<StringParam *> string_params;
-  std::vector<DoubleParam *> double_params;
+  ParamsList<IntParam> int_params;
+  ParamsList<BoolParam> bool_params;
+  ParamsList<StringParam> string_params;
+  ParamsList<DoubleParam> double_params;
 };
 
 // Utility functions for working with Tesseract parameters.
@@ -69,32 +131,18 @@ public:
                        ParamsVectors *member_params);
 
   // Returns the pointer to the parameter with the given name (of the
-  // appropriate type) if it was found in the vector obtained from
+  // appropriate type) if it was found in the list obtained from
   // GlobalParams() or in the given member_params.
   template <class T>
-  static T *FindParam(const char *name, const std::vector<T *> &global_vec,
-                      const std::vector<T *> &member_vec) {
-    for (auto *param : global_vec) {
-      if (strcmp(param->name_str(), name) == 0) {
-        return param;
-      }
-    }
-    for (auto *param : member_vec) {
-      if (strcmp(param->name_str(), name) == 0) {
-        return param;
-      }
-    }
-    return nullptr;
+  static T *FindParam(const char *name, const ParamsList<T> &global_vec,
+                      const ParamsList<T> &member_vec) {
+    T *param = global_vec.find(name);
+    return param != nullptr ? param : member_vec.find(name);
   }
-  // Removes the given pointer to the param from the given vector.
+  // Removes the given pointer to the param from the given list.
   template <class T>
-  static void RemoveParam(T *param_ptr, std::vector<T *> *vec) {
-    for (auto it = vec->begin(); it != vec->end(); ++it) {
-      if (*it == param_ptr) {
-        vec->erase(it);
-        break;
-      }
-    }
+  static void RemoveParam(T *param_ptr, ParamsList<T> *vec) {
+    vec->remove(param_ptr);
   }
   // Fetches the value of the named param as a string. Returns false if not
   // found.
@@ -165,25 +213,26 @@ public:
   void set_value(int32_t value) {
     value_ = value;
   }
+  bool is_default() const {
+    return value_ == default_;
+  }
   void ResetToDefault() {
     value_ = default_;
   }
   void ResetFrom(const ParamsVectors *vec) {
-    for (auto *param : vec->int_params) {
-      if (strcmp(param->name_str(), name_) == 0) {
-        // printf("overriding param %s=%d by =%d\n", name_, value_,
-        // param);
-        value_ = *param;
-        break;
-      }
+    auto *param = vec->int_params.find(name_);
+    if (param != nullptr) {
+      // printf("overriding param %s=%d by =%d\n", name_, value_,
+      // param);
+      value_ = *param;
     }
   }
 
 private:
   int32_t value_;
   int32_t default_;
-  // Pointer to the vector that contains this param (not owned by this class).
-  std::vector<IntParam *> *params_vec_;
+  // Pointer to the list that contains this param (not owned by this class).
+  ParamsList<IntParam> *params_vec_;
 };
 
 class BoolParam : public Param {
@@ -207,25 +256,26 @@ public:
   void set_value(bool value) {
     value_ = value;
   }
+  bool is_default() const {
+    return value_ == default_;
+  }
   void ResetToDefault() {
     value_ = default_;
   }
   void ResetFrom(const ParamsVectors *vec) {
-    for (auto *param : vec->bool_params) {
-      if (strcmp(param->name_str(), name_) == 0) {
-        // printf("overriding param %s=%s by =%s\n", name_, value_ ? "true" :
-        // "false", *param ? "true" : "false");
-        value_ = *param;
-        break;
-      }
+    auto *param = vec->bool_params.find(name_);
+    if (param != nullptr) {
+      // printf("overriding param %s=%s by =%s\n", name_, value_ ? "true" :
+      // "false", *param ? "true" : "false");
+      value_ = *param;
     }
   }
 
 private:
   bool value_;
   bool default_;
-  // Pointer to the vector that contains this param (not owned by this class).
-  std::vector<BoolParam *> *params_vec_;
+  // Pointer to the list that contains this param (not owned by this class).
+  ParamsList<BoolParam> *params_vec_;
 };
 
 class StringParam : public Param {
@@ -262,25 +312,26 @@ public:
   void set_value(const std::string &value) {
     value_ = value;
   }
+  bool is_default() const {
+    return value_ == default_;
+  }
   void ResetToDefault() {
     value_ = default_;
   }
   void ResetFrom(const ParamsVectors *vec) {
-    for (auto *param : vec->string_params) {
-      if (strcmp(param->name_str(), name_) == 0) {
-        // printf("overriding param %s=%s by =%s\n", name_, value_,
-        // param->c_str());
-        value_ = *param;
-        break;
-      }
+    auto *param = vec->string_params.find(name_);
+    if (param != nullptr) {
+      // printf("overriding param %s=%s by =%s\n", name_, value_,
+      // param->c_str());
+      value_ = *param;
     }
   }
 
 private:
   std::string value_;
   std::string default_;
-  // Pointer to the vector that contains this param (not owned by this class).
-  std::vector<StringParam *> *params_vec_;
+  // Pointer to the list that contains this param (not owned by this class).
+  ParamsList<StringParam> *params_vec_;
 };
 
 class DoubleParam : public Param {
@@ -304,25 +355,69 @@ public:
   void set_value(double value) {
     value_ = value;
   }
+  bool is_default() const {
+    return value_ == default_;
+  }
   void ResetToDefault() {
     value_ = default_;
   }
   void ResetFrom(const ParamsVectors *vec) {
-    for (auto *param : vec->double_params) {
-      if (strcmp(param->name_str(), name_) == 0) {
-        // printf("overriding param %s=%f by =%f\n", name_, value_,
-        // *param);
-        value_ = *param;
-        break;
-      }
+    auto *param = vec->double_params.find(name_);
+    if (param != nullptr) {
+      // printf("overriding param %s=%f by =%f\n", name_, value_,
+      // *param);
+      value_ = *param;
     }
   }
 
 private:
   double value_;
   double default_;
-  // Pointer to the vector that contains this param (not owned by this class).
-  std::vector<DoubleParam *> *params_vec_;
+  // Pointer to the list that contains this param (not owned by this class).
+  ParamsList<DoubleParam> *params_vec_;
+};
+
+// A set of parameter values which is applied on top of the current values
+// and reverted later, for example to retry a page in another mode.
+// Apply and Revert only touch the params named in the overlay, so their
+// cost does not depend on the total number of params.
+class TESS_API ParamsOverlay {
+public:
+  // Returns an overlay with the current values of all params of
+  // GlobalParams() and member_params, which restores them when applied.
+  // If changed_only, the params which have their default value are left out.
+  static ParamsOverlay Capture(const ParamsVectors *member_params, bool changed_only = false);
+
+  // Adds a value to be set by Apply. Later values override earlier ones.
+  void Add(const char *name, const char *value);
+  // Adds the values of a file in the format of ReadParamsFile.
+  // Returns false if the file could not be read.
+  bool ReadFile(const char *file);
+  // Writes the values to a file in the format of ReadParamsFile, so that it
+  // can be used as a config file. Returns false if it cannot be written.
+  bool WriteFile(const char *file) const;
+
+  // Sets the values, saving the previous ones for Revert.
+  // Returns false if any of the params was not found.
+  bool Apply(SetParamConstraint constraint, ParamsVectors *member_params);
+  // Restores the values from before the last Apply.
+  void Revert();
+
+  // The name and value of each setting in the order of Add.
+  const std::vector<std::pair<std::string, std::string>> &values() const {
+    return values_;
+  }
+  bool empty() const {
+    return values_.empty();
+  }
+
+private:
+  std::vector<std::pair<std::string, std::string>> values_;
+  // The values replaced by Apply, in the order of their change.
+  std::vector<std::pair<IntParam *, int32_t>> saved_ints_;
+  std::vector<std::pair<BoolParam *, bool>> saved_bools_;
+  std::vector<std::pair<StringParam *, std::string>> saved_strings_;
+  std::vector<std::pair<DoubleParam *, double>> saved_doubles_;
 };
 
 // Global parameter lists.
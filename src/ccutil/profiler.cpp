@@ -0,0 +1,392 @@
+///////////////////////////////////////////////////////////////////////
+// File:        profiler.cpp
+// Description: Scoped markers for profiling the hot paths of the engine.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "profiler.h"
+
+#include <algorithm> // for std::max, std::remove_if
+#include <chrono>    // for std::chrono
+#include <cstdio>    // for fopen, fwrite
+#include <cstring>   // for strlen, strcmp
+#include <locale>    // for std::locale::classic
+#include <map>       // for std::map
+#include <memory>    // for std::unique_ptr
+#include <mutex>     // for std::mutex, std::lock_guard
+#include <set>       // for std::set
+#include <sstream>   // for std::ostringstream
+#include <vector>    // for std::vector
+
+namespace tesseract {
+
+std::atomic<bool> Profiler::running_(false);
+
+namespace {
+
+// Begin of a scope, or its end if name is nullptr.
+struct ProfileEvent {
+  const char *name;
+  const std::string *detail;
+  int64_t arg;
+  int64_t nanos;
+};
+
+// Number of events kept per thread, a power of 2.
+const uint64_t kRingSize = 1 << 16;
+
+// A ProfileEvent in the ring. The fields are atomics, so a session may copy
+// a slot while the thread overwrites it. Relaxed atomics compile to plain
+// loads and stores.
+struct ProfileSlot {
+  std::atomic<const char *> name;
+  std::atomic<const std::string *> detail;
+  std::atomic<int64_t> arg;
+  std::atomic<int64_t> nanos;
+};
+
+// The events of one thread, which only that thread writes, without a lock.
+// written counts the events, and event i is in slot i % kRingSize. Like a
+// seqlock, a reader reads written again after copying the slots, and drops
+// the slots which the thread may have overwritten in the meantime.
+struct ThreadEvents {
+  explicit ThreadEvents(uint32_t id) : thread(id), events(new ProfileSlot[kRingSize]) {}
+  uint32_t thread;
+  std::unique_ptr<ProfileSlot[]> events;
+  std::atomic<uint64_t> written{0};
+  // The thread has exited, so the buffer is freed once no session is open.
+  bool exited = false;
+};
+
+// The buffers of the threads which have used a marker, and the distinct
+// details, which are never freed as the threads keep pointers to them.
+struct ProfileRegistry {
+  std::mutex mutex;
+  std::vector<std::unique_ptr<ThreadEvents>> threads;
+  std::set<std::string> details;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  uint32_t num_threads = 0;
+  int num_sessions = 0;
+  int open_sessions = 0;
+};
+
+} // namespace
+
+static ProfileRegistry &Registry() {
+  // Leaked, as markers may still run in detached threads at exit.
+  static auto *registry = new ProfileRegistry;
+  return *registry;
+}
+
+// The buffer of the thread, and the last detail of the thread, to avoid the
+// lock if it repeats. Both are trivially destructible, so they can be used
+// until the thread is gone.
+static thread_local ThreadEvents *thread_events = nullptr;
+static thread_local bool thread_exited = false;
+static thread_local const std::string *thread_detail = nullptr;
+
+// Frees the buffers of the exited threads. The registry must be locked.
+static void FreeExitedBuffers(ProfileRegistry &registry) {
+  auto &threads = registry.threads;
+  threads.erase(std::remove_if(threads.begin(), threads.end(),
+                               [](const std::unique_ptr<ThreadEvents> &thread) {
+                                 return thread->exited;
+                               }),
+                threads.end());
+}
+
+namespace {
+
+// Gives the buffer of the thread back to the registry when the thread
+// exits. Markers which run later in the exit of the thread are not recorded.
+struct ThreadExit {
+  ~ThreadExit() {
+    thread_exited = true;
+    if (thread_events != nullptr) {
+      ProfileRegistry &registry = Registry();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      thread_events->exited = true;
+      thread_events = nullptr;
+      if (registry.open_sessions == 0) {
+        FreeExitedBuffers(registry);
+      }
+    }
+  }
+};
+
+} // namespace
+
+static thread_local ThreadExit thread_exit;
+
+static int64_t NanosSinceStart() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                              Registry().start)
+      .count();
+}
+
+static void Push(const ProfileEvent &event) {
+  if (thread_events == nullptr) {
+    if (thread_exited) {
+      return;
+    }
+    // Constructs thread_exit, whose destructor then runs at the exit.
+    (void)&thread_exit;
+    ProfileRegistry &registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.threads.emplace_back(new ThreadEvents(registry.num_threads++));
+    thread_events = registry.threads.back().get();
+  }
+  const uint64_t index = thread_events->written.load(std::memory_order_relaxed);
+  // A reader which copies a part of this event then also sees a written
+  // count which shows that the slot was reused.
+  std::atomic_thread_fence(std::memory_order_release);
+  ProfileSlot &slot = thread_events->events[index & (kRingSize - 1)];
+  slot.name.store(event.name, std::memory_order_relaxed);
+  slot.detail.store(event.detail, std::memory_order_relaxed);
+  slot.arg.store(event.arg, std::memory_order_relaxed);
+  slot.nanos.store(event.nanos, std::memory_order_relaxed);
+  thread_events->written.store(index + 1, std::memory_order_release);
+}
+
+Profiler::Session Profiler::Start() {
+  ProfileRegistry &registry = Registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  Session session;
+  session.serial = ++registry.num_sessions;
+  session.start_nanos = NanosSinceStart();
+  ++registry.open_sessions;
+  running_.store(true, std::memory_order_release);
+  return session;
+}
+
+bool Profiler::Stop(Session *session, const char *path) {
+  session->stop_nanos = NanosSinceStart();
+  // The session stays open while it is written, so the buffers of the
+  // threads which exited during it are kept.
+  bool ok = Write(SessionPath(path, *session).c_str(), *session);
+  ProfileRegistry &registry = Registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  if (--registry.open_sessions == 0) {
+    running_.store(false, std::memory_order_release);
+    FreeExitedBuffers(registry);
+  }
+  return ok;
+}
+
+std::string Profiler::SessionPath(const char *path, const Session &session) {
+  std::string result = path;
+  if (session.serial <= 1) {
+    return result;
+  }
+  size_t dot = result.find_last_of('.');
+  size_t slash = result.find_last_of("/\\");
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+    dot = result.size();
+  }
+  result.insert(dot, "." + std::to_string(session.serial));
+  return result;
+}
+
+void Profiler::Begin(const char *name, int64_t arg, const std::string *detail) {
+  if (detail != nullptr) {
+    if (thread_detail == nullptr || *thread_detail != *detail) {
+      ProfileRegistry &registry = Registry();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      thread_detail = &*registry.details.insert(*detail).first;
+    }
+    detail = thread_detail;
+  }
+  Push({name, detail, arg, NanosSinceStart()});
+}
+
+void Profiler::End() {
+  Push({nullptr, nullptr, -1, NanosSinceStart()});
+}
+
+namespace {
+
+// A scope with its begin and end.
+struct ProfileScope {
+  const ProfileEvent *begin;
+  int64_t end_nanos;
+};
+
+// The events of a thread, oldest first.
+struct ThreadProfile {
+  uint32_t thread;
+  std::vector<ProfileEvent> events;
+};
+
+} // namespace
+
+// Copies the events of all threads in the session.
+static std::vector<ThreadProfile> CollectEvents(const Profiler::Session &session) {
+  ProfileRegistry &registry = Registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  std::vector<ThreadProfile> profiles;
+  for (auto &thread : registry.threads) {
+    ThreadProfile profile;
+    profile.thread = thread->thread;
+    const uint64_t written = thread->written.load(std::memory_order_acquire);
+    const uint64_t first = written > kRingSize ? written - kRingSize : 0;
+    std::vector<ProfileEvent> events;
+    events.reserve(written - first);
+    for (uint64_t i = first; i < written; ++i) {
+      const ProfileSlot &slot = thread->events[i & (kRingSize - 1)];
+      events.push_back({slot.name.load(std::memory_order_relaxed),
+                        slot.detail.load(std::memory_order_relaxed),
+                        slot.arg.load(std::memory_order_relaxed),
+                        slot.nanos.load(std::memory_order_relaxed)});
+    }
+    // The thread may have reused the slots of the oldest events, up to the
+    // one it is writing now.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t rewritten = thread->written.load(std::memory_order_relaxed);
+    const uint64_t valid = rewritten >= kRingSize ? rewritten - kRingSize + 1 : 0;
+    for (uint64_t i = std::max(first, valid); i < written; ++i) {
+      const ProfileEvent &event = events[i - first];
+      if (event.nanos >= session.start_nanos && event.nanos <= session.stop_nanos) {
+        profile.events.push_back(event);
+      }
+    }
+    if (!profile.events.empty()) {
+      profiles.push_back(std::move(profile));
+    }
+  }
+  return profiles;
+}
+
+// Pairs the begin and end events of a thread. Ends whose begin was
+// overwritten or precedes the session are dropped, and scopes which are
+// still open end at stop.
+static std::vector<ProfileScope> MatchScopes(const std::vector<ProfileEvent> &events,
+                                             int64_t stop_nanos) {
+  std::vector<ProfileScope> scopes;
+  std::vector<size_t> open;
+  for (auto &event : events) {
+    if (event.name != nullptr) {
+      open.push_back(scopes.size());
+      scopes.push_back({&event, stop_nanos});
+    } else if (!open.empty()) {
+      scopes[open.back()].end_nanos = event.nanos;
+      open.pop_back();
+    }
+  }
+  return scopes;
+}
+
+static void WriteJSONString(std::ostringstream &stream, const char *text) {
+  stream << '"';
+  for (const char *c = text; *c != '\0'; ++c) {
+    if (*c == '"' || *c == '\\') {
+      stream << '\\' << *c;
+    } else if (static_cast<unsigned char>(*c) < 0x20) {
+      stream << ' ';
+    } else {
+      stream << *c;
+    }
+  }
+  stream << '"';
+}
+
+static bool WriteFile(const char *path, const std::string &text) {
+  FILE *fp = fopen(path, "wb");
+  if (fp == nullptr) {
+    return false;
+  }
+  bool ok = fwrite(text.data(), 1, text.size(), fp) == text.size();
+  return fclose(fp) == 0 && ok;
+}
+
+bool Profiler::WriteChromeTrace(const char *path, const Session &session) {
+  std::ostringstream stream;
+  stream.imbue(std::locale::classic());
+  stream.setf(std::ios::fixed);
+  stream.precision(3);
+  stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  const char *separator = "\n";
+  for (auto &profile : CollectEvents(session)) {
+    for (auto &scope : MatchScopes(profile.events, session.stop_nanos)) {
+      const ProfileEvent &event = *scope.begin;
+      stream << separator << "{\"name\":";
+      WriteJSONString(stream, event.name);
+      stream << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << profile.thread
+             << ",\"ts\":" << (event.nanos - session.start_nanos) / 1e3
+             << ",\"dur\":" << (scope.end_nanos - event.nanos) / 1e3;
+      if (event.arg >= 0 || event.detail != nullptr) {
+        stream << ",\"args\":{";
+        if (event.arg >= 0) {
+          stream << "\"arg\":" << event.arg << (event.detail != nullptr ? "," : "");
+        }
+        if (event.detail != nullptr) {
+          stream << "\"detail\":";
+          WriteJSONString(stream, event.detail->c_str());
+        }
+        stream << '}';
+      }
+      stream << '}';
+      separator = ",\n";
+    }
+  }
+  stream << "\n]}\n";
+  return WriteFile(path, stream.str());
+}
+
+bool Profiler::WriteFoldedStacks(const char *path, const Session &session) {
+  // Self time in nanoseconds by stack.
+  std::map<std::string, int64_t> stacks;
+  for (auto &profile : CollectEvents(session)) {
+    std::vector<std::string> stack;
+    int64_t last_nanos = 0;
+    for (auto &event : profile.events) {
+      if (!stack.empty()) {
+        stacks[stack.back()] += event.nanos - last_nanos;
+      }
+      last_nanos = event.nanos;
+      if (event.name != nullptr) {
+        std::string frame = stack.empty() ? "" : stack.back() + ';';
+        frame += event.name;
+        if (event.detail != nullptr) {
+          frame += " (" + *event.detail + ')';
+        }
+        stack.push_back(frame);
+      } else if (!stack.empty()) {
+        stack.pop_back();
+      }
+    }
+    if (!stack.empty()) {
+      stacks[stack.back()] += session.stop_nanos - last_nanos;
+    }
+  }
+  std::ostringstream stream;
+  stream.imbue(std::locale::classic());
+  for (auto &stack : stacks) {
+    int64_t micros = stack.second / 1000;
+    if (micros > 0) {
+      stream << stack.first << ' ' << micros << '\n';
+    }
+  }
+  return WriteFile(path, stream.str());
+}
+
+bool Profiler::Write(const char *path, const Session &session) {
+  const char *kSuffix = ".folded";
+  size_t length = strlen(path);
+  size_t suffix_length = strlen(kSuffix);
+  if (length >= suffix_length && strcmp(path + length - suffix_length, kSuffix) == 0) {
+    return WriteFoldedStacks(path, session);
+  }
+  return WriteChromeTrace(path, session);
+}
+
+} // namespace tesseract.
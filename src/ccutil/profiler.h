@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////////////
+// File:        profiler.h
+// Description: Scoped markers for profiling the hot paths of the engine.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CCUTIL_PROFILER_H_
+#define TESSERACT_CCUTIL_PROFILER_H_
+
+#ifdef HAVE_CONFIG_H
+#  include "config_auto.h" // DISABLED_STAGE_STATS
+#endif
+
+#include <tesseract/export.h> // for TESS_API
+
+#include <atomic>  // for std::atomic
+#include <cstdint> // for int64_t
+#include <string>  // for std::string
+
+namespace tesseract {
+
+// Records the begin and end of the marked scopes of all threads while
+// profiling is on. Each thread writes its events into a ring buffer of its
+// own without a lock, so the newest events are kept if it overflows.
+// Unlike StageRecorder, the profile is global to the process and keeps the
+// nesting of the scopes, for a timeline or a flame graph.
+// Profiling is on while any session is open. Sessions of several threads
+// or APIs may overlap, and each one gets the events of all threads between
+// its start and its stop.
+class TESS_API Profiler {
+public:
+  struct Session {
+    int serial = 0;          // 1 for the first session of the process.
+    int64_t start_nanos = 0; // Times since the first use of the profiler.
+    int64_t stop_nanos = 0;
+  };
+
+  // Opens a session and starts recording if it is not on already.
+  static Session Start();
+  // Closes the session and writes its events to SessionPath(path, *session)
+  // with Write. Recording stops when no session is open. Returns false if
+  // the profile cannot be written.
+  static bool Stop(Session *session, const char *path);
+  static bool IsRunning() {
+    return running_.load(std::memory_order_relaxed);
+  }
+
+  // Returns path for the first session of the process. The later sessions,
+  // such as those of the documents of a batch, insert their serial number
+  // before the extension so that they do not overwrite each other:
+  // "trace.json" becomes "trace.2.json".
+  static std::string SessionPath(const char *path, const Session &session);
+
+  // Records the begin of a scope in the calling thread. name must be a
+  // string constant. detail, such as the language, is copied once per
+  // distinct value. arg, such as a page index, is omitted if negative.
+  static void Begin(const char *name, int64_t arg, const std::string *detail);
+  // Records the end of the innermost scope of the calling thread.
+  static void End();
+
+  // Writes the events of the stopped session in the Chrome trace event
+  // format, which can be loaded by chrome://tracing or
+  // https://ui.perfetto.dev. Returns false if it cannot be written.
+  static bool WriteChromeTrace(const char *path, const Session &session);
+  // Writes the time spent in each stack of scopes, summed over all threads,
+  // in the folded format of flamegraph.pl: "outer;inner microseconds".
+  static bool WriteFoldedStacks(const char *path, const Session &session);
+  // Calls WriteFoldedStacks for paths ending in ".folded", else
+  // WriteChromeTrace.
+  static bool Write(const char *path, const Session &session);
+
+private:
+  static std::atomic<bool> running_;
+};
+
+// Records its lifetime as a scope if profiling is on.
+class ProfileMarker {
+public:
+  explicit ProfileMarker(const char *name, int64_t arg = -1,
+                         const std::string *detail = nullptr)
+      : active_(Profiler::IsRunning()) {
+    if (active_) {
+      Profiler::Begin(name, arg, detail);
+    }
+  }
+  ~ProfileMarker() {
+    if (active_) {
+      Profiler::End();
+    }
+  }
+  ProfileMarker(const ProfileMarker &) = delete;
+  ProfileMarker &operator=(const ProfileMarker &) = delete;
+
+private:
+  bool active_;
+};
+
+// The markers compile to nothing if DISABLED_STAGE_STATS is defined.
+// PROFILE_SCOPE marks the rest of the enclosing scope, so there can only be
+// one in a scope. The arguments are those of ProfileMarker.
+#ifndef DISABLED_STAGE_STATS
+#  define PROFILE_SCOPE(...) ::tesseract::ProfileMarker profile_marker_(__VA_ARGS__)
+#else
+#  define PROFILE_SCOPE(...)
+#endif
+
+} // namespace tesseract.
+
+#endif // TESSERACT_CCUTIL_PROFILER_H_
@@ -0,0 +1,24 @@
+///////////////////////////////////////////////////////////////////////
+// File:        recycler.cpp
+// Description: Per thread reuse of the storage of deleted objects.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "recycler.h"
+
+namespace tesseract {
+
+INT_VAR(recycler_max_objects, 1000,
+        "Max deleted page objects of each kind kept for reuse per thread");
+
+} // namespace tesseract.
@@ -0,0 +1,174 @@
+///////////////////////////////////////////////////////////////////////
+// File:        recycler.h
+// Description: Per thread reuse of the storage of deleted objects.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CCUTIL_RECYCLER_H_
+#define TESSERACT_CCUTIL_RECYCLER_H_
+
+#include "params.h" // for INT_VAR_H
+
+#include <cstddef> // for size_t, std::max_align_t
+#include <cstdint> // for uint64_t
+#include <new>     // for ::operator new
+
+namespace tesseract {
+
+// Maximum number of deleted objects of each recycled class whose storage
+// each thread keeps for reuse.
+extern TESS_API INT_VAR_H(recycler_max_objects, 1000,
+                          "Max deleted page objects of each kind kept for reuse per thread");
+
+// Allocation counts of a recycled class in one thread.
+struct RecyclerStats {
+  uint64_t allocated = 0; // Objects made in new storage from the heap.
+  uint64_t reused = 0;    // Objects made in recycled storage.
+  uint64_t recycled = 0;  // Deleted objects whose storage was kept.
+  uint64_t released = 0;  // Deleted objects whose storage went to the heap.
+  size_t cached = 0;      // Storage blocks kept at the moment.
+  size_t peak_cached = 0; // Most storage blocks kept at any time.
+};
+
+// Keeps the storage of deleted objects of class T in a free list of the
+// thread which made them and reuses it for the next objects made in that
+// thread. The words and choices which are made and deleted for every page
+// then need few heap operations once the first page is done, and deleting
+// the results of a page is mostly running the destructors.
+// A class T uses it by declaring a class specific operator new and sized
+// operator delete which call Allocate and Release. Objects of derived
+// classes of another size use the heap as usual.
+// Each object is preceded by a header with the pool of the thread which
+// made it. Objects deleted by another thread, or after the pool of the
+// thread was destroyed at its exit, go back to the heap.
+template <typename T>
+class Recycler {
+public:
+  static void *Allocate(size_t size) {
+    Pool *pool = LivePool();
+    void *block;
+    if (size == sizeof(T) && pool != nullptr && pool->head != nullptr) {
+      FreeBlock *free_block = pool->head;
+      pool->head = free_block->next;
+      --pool->stats.cached;
+      ++pool->stats.reused;
+      block = free_block;
+    } else {
+      if (pool != nullptr) {
+        ++pool->stats.allocated;
+      }
+      block = ::operator new(kHeaderSize + size);
+    }
+    static_cast<Header *>(block)->owner = pool;
+    return static_cast<char *>(block) + kHeaderSize;
+  }
+
+  static void Release(void *object, size_t size) {
+    if (object == nullptr) {
+      return;
+    }
+    void *block = static_cast<char *>(object) - kHeaderSize;
+    Pool *pool = LivePool();
+    if (pool != nullptr) {
+      if (size == sizeof(T) && static_cast<Header *>(block)->owner == pool &&
+          pool->stats.cached < static_cast<size_t>(static_cast<int>(recycler_max_objects))) {
+        auto *free_block = static_cast<FreeBlock *>(block);
+        free_block->next = pool->head;
+        pool->head = free_block;
+        ++pool->stats.recycled;
+        if (++pool->stats.cached > pool->stats.peak_cached) {
+          pool->stats.peak_cached = pool->stats.cached;
+        }
+        return;
+      }
+      ++pool->stats.released;
+    }
+    ::operator delete(block);
+  }
+
+  // Returns the statistics of the calling thread.
+  static RecyclerStats Stats() {
+    Pool *pool = LivePool();
+    return pool != nullptr ? pool->stats : RecyclerStats();
+  }
+
+  // Gives the storage kept by the calling thread back to the heap.
+  static void Trim() {
+    Pool *pool = LivePool();
+    if (pool != nullptr) {
+      pool->Trim();
+    }
+  }
+
+private:
+  // Precedes each object. The size keeps the objects aligned as the heap
+  // would.
+  struct Header {
+    void *owner;
+  };
+  static constexpr size_t kHeaderSize = alignof(std::max_align_t);
+  static_assert(sizeof(Header) <= kHeaderSize, "Recycler header is too big");
+  // A kept block, linked through its header.
+  struct FreeBlock {
+    FreeBlock *next;
+  };
+
+  struct Pool {
+    ~Pool() {
+      Trim();
+      // Objects deleted later in the exit of the thread go to the heap.
+      pool_destroyed_ = true;
+    }
+    void Trim() {
+      while (head != nullptr) {
+        FreeBlock *block = head;
+        head = block->next;
+        ::operator delete(block);
+      }
+      stats.cached = 0;
+    }
+
+    FreeBlock *head = nullptr;
+    RecyclerStats stats;
+  };
+
+  // Returns the pool of the calling thread, or nullptr once it is destroyed.
+  // The flag is trivially destructible, so it can still be read then.
+  static Pool *LivePool() {
+    return pool_destroyed_ ? nullptr : &pool_;
+  }
+
+  static thread_local Pool pool_;
+  static thread_local bool pool_destroyed_;
+};
+
+template <typename T>
+thread_local typename Recycler<T>::Pool Recycler<T>::pool_;
+template <typename T>
+thread_local bool Recycler<T>::pool_destroyed_ = false;
+
+// Defines the class specific operator new and operator delete, declared as
+//   static void *operator new(size_t size);
+//   static void operator delete(void *object, size_t size);
+// in CLASSNAME, to use a Recycler.
+#define RECYCLE_OBJECTS(CLASSNAME)                                  \
+  void *CLASSNAME::operator new(size_t size) {                      \
+    return ::tesseract::Recycler<CLASSNAME>::Allocate(size);        \
+  }                                                                 \
+  void CLASSNAME::operator delete(void *object, size_t size) {      \
+    ::tesseract::Recycler<CLASSNAME>::Release(object, size);        \
+  }
+
+} // namespace tesseract.
+
+#endif // TESSERACT_CCUTIL_RECYCLER_H_
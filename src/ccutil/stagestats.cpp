@@ -0,0 +1,168 @@
+///////////////////////////////////////////////////////////////////////
+// File:        stagestats.cpp
+// Description: Time and counts of the stages of the OCR pipeline.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "stagestats.h"
+
+#include <algorithm> // for std::max
+#include <cstdio>    // for fopen, fprintf
+#include <locale>    // for std::locale::classic
+#include <sstream>   // for std::ostringstream
+
+namespace tesseract {
+
+// Not a static member, because thread_local data can not be exported
+// from a DLL.
+static thread_local StageRecorder *current_recorder = nullptr;
+
+StageRecorder::Scope::Scope(StageRecorder *recorder) : previous_(current_recorder) {
+  current_recorder = recorder;
+}
+
+StageRecorder::Scope::~Scope() {
+  current_recorder = previous_;
+}
+
+StageRecorder *StageRecorder::Current() {
+  return current_recorder;
+}
+
+// The innermost running StageTimer of the thread.
+static thread_local StageTimer *current_timer = nullptr;
+
+StageTimer::StageTimer(PipelineStage stage) : recorder_(StageRecorder::Current()), stage_(stage) {
+  if (recorder_ != nullptr) {
+    start_ = std::chrono::steady_clock::now();
+    outer_ = current_timer;
+    if (outer_ != nullptr) {
+      std::chrono::duration<double> elapsed = start_ - outer_->start_;
+      outer_->seconds_ += elapsed.count();
+    }
+    current_timer = this;
+  }
+}
+
+StageTimer::~StageTimer() {
+  if (recorder_ != nullptr) {
+    auto now = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed = now - start_;
+    recorder_->AddTime(stage_, seconds_ + elapsed.count());
+    current_timer = outer_;
+    if (outer_ != nullptr) {
+      outer_->start_ = now;
+    }
+  }
+}
+
+// Adds seconds to a time saved, where a negative value means unknown. An
+// unknown time only remains if there is no estimate at all.
+static void AddSavedSeconds(double *saved, double seconds) {
+  if (seconds >= 0.0) {
+    *saved = std::max(*saved, 0.0) + seconds;
+  } else if (*saved == 0.0) {
+    *saved = -1.0;
+  }
+}
+
+void StageRecorder::AddSkippedPass(OptionalPass pass) {
+  // A pass which never ran gives no estimate of the time it saves.
+  double seconds = pass_runs_[pass] > 0 ? pass_seconds_[pass] / pass_runs_[pass] : -1.0;
+  ++pass_skips_[pass];
+  AddCount(COUNTER_SKIPPED_PASSES, 1);
+  AddSavedSeconds(&page_.saved_seconds, seconds);
+  AddSavedSeconds(&total_.saved_seconds, seconds);
+}
+
+void StageRecorder::AddTotals(const StageRecorder &other) {
+  for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+    total_.seconds[stage] += other.total_.seconds[stage];
+    total_.calls[stage] += other.total_.calls[stage];
+  }
+  for (int counter = 0; counter < COUNTER_COUNT; ++counter) {
+    total_.counts[counter] += other.total_.counts[counter];
+  }
+  AddSavedSeconds(&total_.saved_seconds, other.total_.saved_seconds);
+}
+
+const char *StageRecorder::StageName(int stage) {
+  static const char *const kNames[STAGE_COUNT] = {
+      "threshold",       "layout",      "lstm_forward", "beam_search",
+      "legacy_classify", "post_passes", "paragraphs",   "render"};
+  return stage >= 0 && stage < STAGE_COUNT ? kNames[stage] : "unknown";
+}
+
+const char *StageRecorder::CounterName(int counter) {
+  static const char *const kNames[COUNTER_COUNT] = {
+      "pages", "lstm_lines", "lstm_timesteps", "words", "partition_passes", "partition_visits",
+      "merge_candidates", "skipped_passes"};
+  return counter >= 0 && counter < COUNTER_COUNT ? kNames[counter] : "unknown";
+}
+
+static void WriteValues(const StageRecorder::Values &values, std::ostringstream &stream) {
+  stream << '{';
+  for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+    stream << '"' << StageRecorder::StageName(stage) << "\":{\"seconds\":"
+           << values.seconds[stage] << ",\"calls\":" << values.calls[stage] << "},";
+  }
+  for (int counter = 0; counter < COUNTER_COUNT; ++counter) {
+    if (counter > 0) {
+      stream << ',';
+    }
+    stream << '"' << StageRecorder::CounterName(counter) << "\":" << values.counts[counter];
+  }
+  stream << ",\"saved_seconds\":" << values.saved_seconds << '}';
+}
+
+std::string StageRecorder::ToJSON() const {
+  std::ostringstream stream;
+  // Use "C" locale for the decimal point of the numbers.
+  stream.imbue(std::locale::classic());
+  stream.precision(6);
+  stream << "{\"page\":";
+  WriteValues(page_, stream);
+  stream << ",\"total\":";
+  WriteValues(total_, stream);
+  stream << '}';
+  return stream.str();
+}
+
+bool StageRecorder::AppendPageJSON(const char *path, const char *input_name,
+                                   int page_index) const {
+  std::ostringstream stream;
+  stream.imbue(std::locale::classic());
+  stream.precision(6);
+  stream << "{\"input\":\"";
+  for (const char *c = input_name != nullptr ? input_name : ""; *c != '\0'; ++c) {
+    if (*c == '"' || *c == '\\') {
+      stream << '\\' << *c;
+    } else if (static_cast<unsigned char>(*c) < 0x20) {
+      stream << ' ';
+    } else {
+      stream << *c;
+    }
+  }
+  stream << "\",\"page_index\":" << page_index << ",\"stages\":";
+  WriteValues(page_, stream);
+  stream << "}\n";
+  FILE *fp = fopen(path, "a");
+  if (fp == nullptr) {
+    return false;
+  }
+  const std::string line = stream.str();
+  bool ok = fwrite(line.data(), 1, line.size(), fp) == line.size();
+  return fclose(fp) == 0 && ok;
+}
+
+} // namespace tesseract.
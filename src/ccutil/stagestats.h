@@ -0,0 +1,269 @@
+///////////////////////////////////////////////////////////////////////
+// File:        stagestats.h
+// Description: Time and counts of the stages of the OCR pipeline.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CCUTIL_STAGESTATS_H_
+#define TESSERACT_CCUTIL_STAGESTATS_H_
+
+#ifdef HAVE_CONFIG_H
+#  include "config_auto.h" // DISABLED_STAGE_STATS
+#endif
+
+#include <tesseract/export.h> // for TESS_API
+
+#include <chrono>  // for std::chrono
+#include <cstdint> // for uint64_t
+#include <string>  // for std::string
+
+namespace tesseract {
+
+// The stages of the pipeline which are timed. Some run inside others, like
+// STAGE_LEGACY_CLASSIFY in STAGE_POST_PASSES, or the recognition in
+// STAGE_RENDER if a renderer starts it, but the time of an inner stage is
+// not counted in the outer one (see StageTimer). So the sum of their times
+// is the time which is accounted for.
+enum PipelineStage {
+  STAGE_THRESHOLD,       // TessBaseAPI::Threshold
+  STAGE_LAYOUT,          // The rest of TessBaseAPI::FindLines
+  STAGE_LSTM_FORWARD,    // Input scaling and forward pass of the network
+  STAGE_BEAM_SEARCH,     // Decoding the network outputs into words
+  STAGE_LEGACY_CLASSIFY, // Word recognition by the legacy engine
+  STAGE_POST_PASSES,     // Diacritics, fuzzy spaces and the later passes
+  STAGE_PARAGRAPHS,      // Paragraph detection
+  STAGE_RENDER,          // Output of the page by the renderers
+  STAGE_COUNT
+};
+
+// Events which are counted.
+enum PipelineCounter {
+  COUNTER_PAGES,            // Pages recognized
+  COUNTER_LSTM_LINES,       // Text lines recognized by the LSTM
+  COUNTER_LSTM_TIMESTEPS,   // Network outputs decoded by the beam search
+  COUNTER_WORDS,            // Words recognized in the first pass
+  COUNTER_PARTITION_PASSES, // Sweeps over the ColPartitionGrid to split or merge
+  COUNTER_PARTITION_VISITS, // Partitions examined by those sweeps
+  COUNTER_MERGE_CANDIDATES, // Neighbours weighed as merge candidates
+  COUNTER_SKIPPED_PASSES,   // Optional passes which the outputs do not need
+  COUNTER_COUNT
+};
+
+// The passes after recognition which are only needed for some outputs, so
+// an output profile can skip them.
+enum OptionalPass {
+  PASS_PARAGRAPHS,       // Paragraph detection
+  PASS_FONTS,            // Smoothing of the fonts over the page
+  PASS_SCRIPT_POSITIONS, // Superscripts, subscripts and small caps
+  PASS_REJECTION,        // Reject maps and the document quality
+  PASS_COUNT
+};
+
+// Collects the time spent in the stages of the pipeline and the counters
+// for one TessBaseAPI, both for the current page and in total.
+// The instrumentation in the pipeline reports to the recorder which is
+// current in the calling thread, so the classes of the engine need not know
+// about it. A TessBaseAPI makes its recorder current while it works.
+class TESS_API StageRecorder {
+public:
+  struct Values {
+    double seconds[STAGE_COUNT] = {};
+    uint64_t calls[STAGE_COUNT] = {};
+    uint64_t counts[COUNTER_COUNT] = {};
+    // Time which the skipped passes would have taken, estimated from
+    // their mean time on the pages on which they ran. Passes which have
+    // not run yet are left out, and if none of them has run the time is
+    // unknown and -1.
+    double saved_seconds = 0.0;
+  };
+
+  // Makes a recorder current in the calling thread for the lifetime of the
+  // object and restores the previous one afterwards.
+  class Scope {
+  public:
+    explicit Scope(StageRecorder *recorder);
+    ~Scope();
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    StageRecorder *previous_;
+  };
+
+  // Returns the recorder of the calling thread, or nullptr.
+  static StageRecorder *Current();
+
+  void AddTime(PipelineStage stage, double seconds) {
+    page_.seconds[stage] += seconds;
+    ++page_.calls[stage];
+    total_.seconds[stage] += seconds;
+    ++total_.calls[stage];
+  }
+  void AddCount(PipelineCounter counter, uint64_t count) {
+    page_.counts[counter] += count;
+    total_.counts[counter] += count;
+  }
+  // Records the time of an optional pass which ran.
+  void AddPassTime(OptionalPass pass, double seconds) {
+    pass_seconds_[pass] += seconds;
+    ++pass_runs_[pass];
+    pass_skips_[pass] = 0;
+  }
+  // Returns true if a pass which the outputs do not need should run anyway
+  // to measure the time it saves: if it has not run yet, and then after
+  // every kPassSampleInterval skips, so the estimate follows the pages.
+  bool SamplePass(OptionalPass pass) const {
+    return pass_runs_[pass] == 0 || pass_skips_[pass] >= kPassSampleInterval;
+  }
+  // Counts an optional pass which was skipped, with the time it saved if
+  // that can be estimated.
+  void AddSkippedPass(OptionalPass pass);
+  // Adds the totals of another recorder, for example of a worker.
+  void AddTotals(const StageRecorder &other);
+
+  // Starts a new page.
+  void StartPage() {
+    page_ = Values();
+  }
+  // Clears the page, the totals and the times of the optional passes.
+  void Reset() {
+    page_ = Values();
+    total_ = Values();
+    for (int pass = 0; pass < PASS_COUNT; ++pass) {
+      pass_seconds_[pass] = 0.0;
+      pass_runs_[pass] = 0;
+      pass_skips_[pass] = 0;
+    }
+  }
+
+  const Values &page() const {
+    return page_;
+  }
+  const Values &total() const {
+    return total_;
+  }
+
+  static const char *StageName(int stage);
+  static const char *CounterName(int counter);
+
+  // Returns the page and total values as a JSON object:
+  // {"page":{"threshold":{"seconds":0.012,"calls":1},...,"pages":1,...,
+  //  "saved_seconds":0.004},"total":{...}}
+  std::string ToJSON() const;
+  // Appends a line with the JSON object of the page to the file at path.
+  // Returns false if it cannot be written.
+  bool AppendPageJSON(const char *path, const char *input_name, int page_index) const;
+
+private:
+  static const int kPassSampleInterval = 100;
+
+  Values page_;
+  Values total_;
+  // Time and runs of each optional pass, for estimating the time saved,
+  // and its skips since it last ran.
+  double pass_seconds_[PASS_COUNT] = {};
+  uint64_t pass_runs_[PASS_COUNT] = {};
+  uint64_t pass_skips_[PASS_COUNT] = {};
+};
+
+// Adds the time of its lifetime to a stage of the current recorder.
+// Stages nest, for example the legacy classifier runs inside the post
+// passes and a renderer may start the recognition. A timer which starts
+// inside another one of the same thread suspends it until it stops, so
+// each stage gets only its own time and no time is counted twice.
+class TESS_API StageTimer {
+public:
+  explicit StageTimer(PipelineStage stage);
+  ~StageTimer();
+  StageTimer(const StageTimer &) = delete;
+  StageTimer &operator=(const StageTimer &) = delete;
+
+private:
+  StageRecorder *recorder_;
+  PipelineStage stage_;
+  // The timer which this one suspends, or nullptr.
+  StageTimer *outer_ = nullptr;
+  // Time counted before the last suspension, and start of the running part.
+  double seconds_ = 0.0;
+  std::chrono::steady_clock::time_point start_;
+};
+
+// Adds the time of its lifetime to an optional pass of the current
+// recorder.
+class PassTimer {
+public:
+  explicit PassTimer(OptionalPass pass) : recorder_(StageRecorder::Current()), pass_(pass) {
+    if (recorder_ != nullptr) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+  ~PassTimer() {
+    if (recorder_ != nullptr) {
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_;
+      recorder_->AddPassTime(pass_, elapsed.count());
+    }
+  }
+  PassTimer(const PassTimer &) = delete;
+  PassTimer &operator=(const PassTimer &) = delete;
+
+private:
+  StageRecorder *recorder_;
+  OptionalPass pass_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+inline void CountSkippedPass(OptionalPass pass) {
+  StageRecorder *recorder = StageRecorder::Current();
+  if (recorder != nullptr) {
+    recorder->AddSkippedPass(pass);
+  }
+}
+
+// Returns true if a pass which the outputs do not need runs anyway, see
+// StageRecorder::SamplePass.
+inline bool SampleSkippedPass(OptionalPass pass) {
+  StageRecorder *recorder = StageRecorder::Current();
+  return recorder != nullptr && recorder->SamplePass(pass);
+}
+
+inline void CountStageEvent(PipelineCounter counter, uint64_t count) {
+  StageRecorder *recorder = StageRecorder::Current();
+  if (recorder != nullptr) {
+    recorder->AddCount(counter, count);
+  }
+}
+
+// The instrumentation, which compiles to nothing if DISABLED_STAGE_STATS
+// is defined. STAGE_TIMER times the rest of the enclosing scope, so there
+// can only be one in a scope, and likewise PASS_TIMER.
+#ifndef DISABLED_STAGE_STATS
+#  define STAGE_RECORDER_SCOPE(recorder) \
+    ::tesseract::StageRecorder::Scope stage_recorder_scope_(recorder)
+#  define STAGE_TIMER(stage) ::tesseract::StageTimer stage_timer_(::tesseract::stage)
+#  define STAGE_COUNT_EVENT(counter, count) \
+    ::tesseract::CountStageEvent(::tesseract::counter, count)
+#  define PASS_TIMER(pass) ::tesseract::PassTimer pass_timer_(::tesseract::pass)
+#  define PASS_SKIPPED(pass) ::tesseract::CountSkippedPass(::tesseract::pass)
+#  define PASS_SAMPLED(pass) ::tesseract::SampleSkippedPass(::tesseract::pass)
+#else
+#  define STAGE_RECORDER_SCOPE(recorder)
+#  define STAGE_TIMER(stage)
+#  define STAGE_COUNT_EVENT(counter, count)
+#  define PASS_TIMER(pass)
+#  define PASS_SKIPPED(pass)
+#  define PASS_SAMPLED(pass) false
+#endif
+
+} // namespace tesseract.
+
+#endif // TESSERACT_CCUTIL_STAGESTATS_H_
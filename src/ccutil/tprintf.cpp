@@ -25,48 +25,352 @@
 
 #include "params.h"
 
+#include <atomic>             // for std::atomic
+#include <chrono>             // for std::chrono
+#include <condition_variable> // for std::condition_variable
 #include <cstdarg>
 #include <cstdio>
+#include <cstdlib>            // for std::atexit
+#include <cstring>            // for strcmp, strncmp
+#include <mutex>              // for std::mutex
+#include <set>                // for std::set
+#include <string>             // for std::string
+#include <thread>             // for std::thread
 
 namespace tesseract {
 
-#define MAX_MSG_LEN 2048
-
 static STRING_VAR(debug_file, "", "File to send tprintf output to");
+static INT_VAR(log_level, TESS_LOG_DEBUG,
+               "Most verbose level of log messages: 0=error, 1=warning, 2=info, 3=debug");
+// Off by default: the writer thread is not copied into a child process
+// made by fork, so a child which logged asynchronously would wait forever
+// for a free slot of the queue.
+static BOOL_VAR(log_async, false, "Write log messages in a background thread");
+static BOOL_VAR(log_prefix, false, "Start log messages with level, thread and time");
 
-// Trace printf
-void tprintf(const char *format, ...) {
-  const char *debug_file_name = debug_file.c_str();
-  static FILE *debugfp = nullptr; // debug file
+LogSink::~LogSink() = default;
 
-  if (debug_file_name == nullptr) {
-    // This should not happen.
-    return;
-  }
+// The sink of the messages of the calling thread. nullptr is the default
+// sink.
+static thread_local LogSink *current_sink = nullptr;
 
-#ifdef _WIN32
-  // Replace /dev/null by nul for Windows.
-  if (strcmp(debug_file_name, "/dev/null") == 0) {
-    debug_file_name = "nul";
-    debug_file.set_value(debug_file_name);
+LogSinkScope::LogSinkScope(LogSink *sink) : previous_(current_sink) {
+  current_sink = sink;
+}
+
+LogSinkScope::~LogSinkScope() {
+  current_sink = previous_;
+}
+
+// Writes to the file which debug_file named when the message was logged,
+// or to stderr.
+class DefaultLogSink : public LogSink {
+public:
+  void Write(const LogRecord &record) override {
+    Write(record, debug_file.c_str());
   }
+  void Write(const LogRecord &record, const char *debug_file_name) {
+#ifdef _WIN32
+    // Replace /dev/null by nul for Windows.
+    if (strcmp(debug_file_name, "/dev/null") == 0) {
+      debug_file_name = "nul";
+    }
 #endif
+    if (file_name_ != debug_file_name) {
+      if (fp_ != nullptr) {
+        fclose(fp_);
+        fp_ = nullptr;
+      }
+      file_name_ = debug_file_name;
+      if (!file_name_.empty()) {
+        fp_ = fopen(file_name_.c_str(), "wb");
+      }
+    }
+    FILE *fp = fp_ != nullptr ? fp_ : stderr;
+    if (log_prefix) {
+      static const char kLevels[] = "EWID";
+      fprintf(fp, "[%c t%u %.3f] ", kLevels[record.level], record.thread, record.seconds);
+    }
+    fwrite(record.text, 1, record.length, fp);
+  }
+  void Flush() override {
+    if (fp_ != nullptr) {
+      fflush(fp_);
+    }
+  }
+
+private:
+  std::string file_name_;
+  FILE *fp_ = nullptr;
+};
+
+namespace {
 
-  if (debugfp == nullptr && debug_file_name[0] != '\0') {
-    debugfp = fopen(debug_file_name, "wb");
-  } else if (debugfp != nullptr && debug_file_name[0] == '\0') {
-    fclose(debugfp);
-    debugfp = nullptr;
+struct LogMessage {
+  LogSink *sink = nullptr;
+  // The value of debug_file when the message was logged, for the default
+  // sink, so the writer thread does not read the variable.
+  std::string debug_file;
+  TessLogLevel level = TESS_LOG_INFO;
+  uint32_t thread = 0;
+  double seconds = 0.0;
+  std::string text;
+};
+
+// Bounded queue of messages for many producers and one consumer. Producers
+// claim a slot with a compare and swap and never wait for each other; the
+// sequence number of a slot tells whether it is free or full.
+class LogQueue {
+public:
+  LogQueue() {
+    for (size_t i = 0; i < kCapacity; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  // Returns false if the queue is full.
+  bool TryPush(LogMessage *message) {
+    size_t pos = push_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      Slot &slot = slots_[pos % kCapacity];
+      size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      if (sequence == pos) {
+        if (push_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          slot.message = std::move(*message);
+          slot.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (sequence < pos) {
+        return false;
+      } else {
+        pos = push_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Returns false if the queue is empty. Only called by the consumer.
+  bool TryPop(LogMessage *message) {
+    Slot &slot = slots_[pop_pos_ % kCapacity];
+    if (slot.sequence.load(std::memory_order_acquire) != pop_pos_ + 1) {
+      return false;
+    }
+    *message = std::move(slot.message);
+    slot.sequence.store(pop_pos_ + kCapacity, std::memory_order_release);
+    ++pop_pos_;
+    return true;
   }
 
+private:
+  static const size_t kCapacity = 1024;
+
+  struct Slot {
+    std::atomic<size_t> sequence;
+    LogMessage message;
+  };
+  Slot slots_[kCapacity];
+  std::atomic<size_t> push_pos_{0};
+  size_t pop_pos_ = 0;
+};
+
+} // namespace
+
+// Writes the messages to their sinks, either in the calling thread or in a
+// background thread. Sinks are only called with write_mutex_ held, so the
+// messages of different threads never interleave.
+class LogWriter {
+public:
+  static LogWriter &Instance() {
+    // Never deleted, so messages from destructors of static objects work.
+    static LogWriter *writer = new LogWriter;
+    return *writer;
+  }
+
+  void Log(TessLogLevel level, std::string &&text) {
+    static std::atomic<uint32_t> thread_count{0};
+    static thread_local uint32_t thread = ++thread_count;
+    static const auto start = std::chrono::steady_clock::now();
+    LogMessage message;
+    message.sink = current_sink;
+    if (message.sink == nullptr) {
+      message.debug_file = debug_file.c_str();
+    }
+    message.level = level;
+    message.thread = thread;
+    message.seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    message.text = std::move(text);
+    // Errors are written at once, so they are not lost if the program
+    // aborts.
+    if (log_async && level != TESS_LOG_ERROR && StartThread()) {
+      while (!queue_.TryPush(&message)) {
+        // The writer is behind: wake it up and wait for a free slot.
+        wakeup_.notify_one();
+        std::this_thread::yield();
+      }
+      ++pushed_;
+      if (sleeping_.load(std::memory_order_acquire)) {
+        wakeup_.notify_one();
+      }
+      return;
+    }
+    Flush();
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    Write(message);
+    if (level == TESS_LOG_ERROR) {
+      SinkOf(message)->Flush();
+    }
+  }
+
+  void Flush() {
+    std::unique_lock<std::mutex> lock(state_mutex_);
+    if (!started_) {
+      return;
+    }
+    uint64_t target = pushed_.load();
+    wakeup_.notify_one();
+    written_changed_.wait(lock, [&] { return stopped_ || written_.load() >= target; });
+  }
+
+private:
+  LogWriter() = default;
+
+  LogSink *SinkOf(const LogMessage &message) {
+    return message.sink != nullptr ? message.sink : &default_sink_;
+  }
+
+  void Write(const LogMessage &message) {
+    LogRecord record = {message.level, message.thread, message.seconds, message.text.c_str(),
+                        message.text.size()};
+    if (message.sink != nullptr) {
+      message.sink->Write(record);
+    } else {
+      default_sink_.Write(record, message.debug_file.c_str());
+    }
+  }
+
+  // Returns false if messages must be written in the calling thread.
+  bool StartThread() {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    if (!started_ && !stopped_) {
+      started_ = true;
+      thread_ = std::thread(&LogWriter::Run, this);
+      std::atexit([] { Instance().Stop(); });
+    }
+    return !stopped_;
+  }
+
+  // Writes the remaining messages and ends the background thread at exit.
+  void Stop() {
+    std::unique_lock<std::mutex> lock(state_mutex_);
+    stopped_ = true;
+    wakeup_.notify_one();
+    // Give up after a while: on some systems, other threads are already
+    // gone when the exit handlers run.
+    written_changed_.wait_for(lock, std::chrono::seconds(2), [&] { return finished_; });
+    thread_.detach();
+  }
+
+  void Run() {
+    std::set<LogSink *> sinks;
+    LogMessage message;
+    for (;;) {
+      bool any = false;
+      {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        while (queue_.TryPop(&message)) {
+          Write(message);
+          sinks.insert(SinkOf(message));
+          ++written_;
+          any = true;
+        }
+        // The queue is empty for now, so push the output out.
+        for (auto *sink : sinks) {
+          sink->Flush();
+        }
+        sinks.clear();
+      }
+      std::unique_lock<std::mutex> lock(state_mutex_);
+      written_changed_.notify_all();
+      if (stopped_ && written_.load() >= pushed_.load()) {
+        finished_ = true;
+        written_changed_.notify_all();
+        return;
+      }
+      if (!any) {
+        sleeping_.store(true, std::memory_order_release);
+        wakeup_.wait_for(lock, std::chrono::milliseconds(50));
+        sleeping_.store(false, std::memory_order_release);
+      }
+    }
+  }
+
+  LogQueue queue_;
+  DefaultLogSink default_sink_;
+  std::atomic<uint64_t> pushed_{0};
+  std::atomic<uint64_t> written_{0};
+  std::atomic<bool> sleeping_{false};
+  std::mutex write_mutex_;
+  std::mutex state_mutex_;
+  std::condition_variable wakeup_;
+  std::condition_variable written_changed_;
+  std::thread thread_;
+  bool started_ = false;
+  bool stopped_ = false;
+  bool finished_ = false;
+};
+
+// Formats the message like vsnprintf, without a limit on its length.
+static std::string FormatMessage(const char *format, va_list args) {
+  char buffer[1024];
+  va_list copy;
+  va_copy(copy, args);
+  int size = vsnprintf(buffer, sizeof(buffer), format, args);
+  std::string text;
+  if (size > 0 && static_cast<size_t>(size) < sizeof(buffer)) {
+    text.assign(buffer, size);
+  } else if (size > 0) {
+    text.resize(size);
+    vsnprintf(&text[0], size + 1, format, copy);
+  }
+  va_end(copy);
+  return text;
+}
+
+bool LogLevelEnabled(TessLogLevel level) {
+  return level <= log_level;
+}
+
+void tlog(TessLogLevel level, const char *format, ...) {
+  if (!LogLevelEnabled(level)) {
+    return;
+  }
+  va_list args;
+  va_start(args, format);
+  std::string text = FormatMessage(format, args);
+  va_end(args);
+  LogWriter::Instance().Log(level, std::move(text));
+}
+
+void LogFlush() {
+  LogWriter::Instance().Flush();
+}
+
+// Trace printf
+void tprintf(const char *format, ...) {
+  TessLogLevel level = TESS_LOG_INFO;
+  if (strncmp(format, "Error", 5) == 0 || strncmp(format, "ERROR", 5) == 0) {
+    level = TESS_LOG_ERROR;
+  } else if (strncmp(format, "Warning", 7) == 0 || strncmp(format, "WARNING", 7) == 0) {
+    level = TESS_LOG_WARNING;
+  }
+  if (!LogLevelEnabled(level)) {
+    return;
+  }
   va_list args;           // variable args
   va_start(args, format); // variable list
-  if (debugfp != nullptr) {
-    vfprintf(debugfp, format, args);
-  } else {
-    vfprintf(stderr, format, args);
-  }
+  std::string text = FormatMessage(format, args);
   va_end(args);
+  LogWriter::Instance().Log(level, std::move(text));
 }
 
 } // namespace tesseract
@@ -20,14 +20,62 @@
 #ifndef TESSERACT_CCUTIL_TPRINTF_H
 #define TESSERACT_CCUTIL_TPRINTF_H
 
-#include <tesseract/export.h> // for TESS_API
+#include <tesseract/export.h>  // for TESS_API
+#include <tesseract/logsink.h> // for TessLogLevel, LogSink
+
+// The most verbose level which is compiled in. Messages of TLOG with a
+// higher level are removed by the compiler, for example all debug output
+// with -DTESS_LOG_MAX_LEVEL=2.
+#ifndef TESS_LOG_MAX_LEVEL
+#  define TESS_LOG_MAX_LEVEL 3
+#endif
 
 namespace tesseract {
 
-// Main logging function.
+// Main logging function. Logs at TESS_LOG_INFO level, or at error or
+// warning level if the message starts with "Error" or "Warning".
 extern TESS_API void tprintf( // Trace printf
     const char *format, ...); // Message
 
+// Logs a message at the given level to the log sink of the calling
+// thread. Messages above the level of the variable log_level are dropped.
+extern TESS_API void tlog(TessLogLevel level, const char *format, ...);
+
+// Returns true if messages of the level would be logged.
+extern TESS_API bool LogLevelEnabled(TessLogLevel level);
+
+// Waits until all messages have been written to their sinks.
+extern TESS_API void LogFlush();
+
+// Makes a sink current in the calling thread for the lifetime of the
+// object, so the messages of that thread go to it. nullptr stands for the
+// default sink. TessBaseAPI makes its sink current while it works.
+class TESS_API LogSinkScope {
+public:
+  explicit LogSinkScope(LogSink *sink);
+  ~LogSinkScope();
+  LogSinkScope(const LogSinkScope &) = delete;
+  LogSinkScope &operator=(const LogSinkScope &) = delete;
+
+private:
+  LogSink *previous_;
+};
+
+// True if messages of the level are logged. Levels above
+// TESS_LOG_MAX_LEVEL are never logged, so the code they guard compiles to
+// nothing.
+#define TLOG_ENABLED(level)                                                        \
+  (::tesseract::level <= TESS_LOG_MAX_LEVEL && ::tesseract::LogLevelEnabled(::tesseract::level))
+
+// Logs at a level, without evaluating the arguments if the level is not
+// enabled.
+#define TLOG(level, ...)                                                           \
+  do {                                                                             \
+    if (TLOG_ENABLED(level)) {                                                     \
+      ::tesseract::tlog(::tesseract::level, __VA_ARGS__);                          \
+    }                                                                              \
+  } while (0)
+
 } // namespace tesseract
 
 #endif // define TESSERACT_CCUTIL_TPRINTF_H
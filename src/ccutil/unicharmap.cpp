@@ -125,6 +125,17 @@ void UNICHARMAP::clear() {
   nodes = nullptr;
 }
 
+size_t UNICHARMAP::MemoryUsed() const {
+  if (nodes == nullptr) {
+    return 0;
+  }
+  size_t bytes = 256 * sizeof(UNICHARMAP_NODE);
+  for (int i = 0; i < 256; ++i) {
+    bytes += nodes[i].MemoryUsed();
+  }
+  return bytes;
+}
+
 UNICHARMAP::UNICHARMAP_NODE::UNICHARMAP_NODE() : children(nullptr), id(-1) {}
 
 // Recursively delete the children
@@ -132,4 +143,15 @@ UNICHARMAP::UNICHARMAP_NODE::~UNICHARMAP_NODE() {
   delete[] children;
 }
 
+size_t UNICHARMAP::UNICHARMAP_NODE::MemoryUsed() const {
+  if (children == nullptr) {
+    return 0;
+  }
+  size_t bytes = 256 * sizeof(UNICHARMAP_NODE);
+  for (int i = 0; i < 256; ++i) {
+    bytes += children[i].MemoryUsed();
+  }
+  return bytes;
+}
+
 } // namespace tesseract
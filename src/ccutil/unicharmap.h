@@ -55,6 +55,9 @@ public:
   // Clear the UNICHARMAP. All previous data is lost.
   void clear();
 
+  // Returns the number of bytes of the nodes of the tree.
+  size_t MemoryUsed() const;
+
 private:
   // The UNICHARMAP is represented as a tree whose nodes are of type
   // UNICHARMAP_NODE.
@@ -62,6 +65,9 @@ private:
     UNICHARMAP_NODE();
     ~UNICHARMAP_NODE();
 
+    // Returns the number of bytes of the nodes below this one.
+    size_t MemoryUsed() const;
+
     UNICHARMAP_NODE *children;
     UNICHAR_ID id;
   };
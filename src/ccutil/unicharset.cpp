@@ -692,6 +692,26 @@ bool UNICHARSET::eq(UNICHAR_ID unichar_id, const char *const unichar_repr) const
   return strcmp(this->id_to_unichar(unichar_id), unichar_repr) == 0;
 }
 
+size_t UNICHARSET::MemoryUsed() const {
+  size_t bytes = unichars.capacity() * sizeof(UNICHAR_SLOT) + ids.MemoryUsed();
+  for (auto &slot : unichars) {
+    bytes += slot.properties.normed_ids.capacity() * sizeof(UNICHAR_ID);
+    // Short strings are stored in the string object itself.
+    const std::string &normed = slot.properties.normed;
+    auto *object = reinterpret_cast<const char *>(&normed);
+    if (normed.data() < object || normed.data() >= object + sizeof(normed)) {
+      bytes += normed.capacity() + 1;
+    }
+    if (slot.properties.fragment != nullptr) {
+      bytes += sizeof(CHAR_FRAGMENT);
+    }
+  }
+  for (int i = 0; i < script_table_size_used; ++i) {
+    bytes += strlen(script_table[i]) + 1;
+  }
+  return bytes + script_table_size_reserved * sizeof(script_table[0]);
+}
+
 bool UNICHARSET::save_to_string(std::string &str) const {
   const int kFileBufSize = 1024;
   char buffer[kFileBufSize + 1];
@@ -349,6 +349,10 @@ public:
     return unichars.size();
   }
 
+  // Returns the number of bytes of the unichars, their properties and the
+  // map from their strings to their ids.
+  size_t MemoryUsed() const;
+
   // Opens the file indicated by filename and saves unicharset to that file.
   // Returns true if the operation is successful.
   bool save_to_file(const char *const filename) const {
@@ -193,6 +193,24 @@ bool Classify::LargeSpeckle(const TBLOB &blob) {
   return bbox.width() < speckle_size && bbox.height() < speckle_size;
 }
 
+size_t Classify::TemplatesMemoryUsed() const {
+  size_t bytes = 0;
+  if (PreTrainedTemplates != nullptr) {
+    bytes += IntTemplatesMemoryUsed(PreTrainedTemplates);
+  }
+  for (auto templates : {AdaptedTemplates, BackupAdaptedTemplates}) {
+    if (templates != nullptr) {
+      bytes += sizeof(*templates) + IntTemplatesMemoryUsed(templates->Templates);
+      for (int i = 0; i < templates->Templates->NumClasses; ++i) {
+        if (templates->Class[i] != nullptr) {
+          bytes += sizeof(*templates->Class[i]);
+        }
+      }
+    }
+  }
+  return bytes;
+}
+
 } // namespace tesseract
 
 #endif // def DISABLED_LEGACY_ENGINE
@@ -118,6 +118,9 @@ public:
   // Returns true if the blob is small enough to be a large speckle.
   bool LargeSpeckle(const TBLOB &blob);
 
+  // Returns the number of bytes of the pre-trained and adapted templates.
+  size_t TemplatesMemoryUsed() const;
+
   /* adaptive.cpp ************************************************************/
   ADAPT_TEMPLATES NewAdaptedTemplates(bool InitFromUnicharset);
   int GetFontinfoId(ADAPT_CLASS Class, uint8_t ConfigId);
@@ -676,6 +676,18 @@ void free_int_templates(INT_TEMPLATES templates) {
   free(templates);
 }
 
+size_t IntTemplatesMemoryUsed(const INT_TEMPLATES_STRUCT *templates) {
+  size_t bytes = sizeof(*templates);
+  for (int i = 0; i < templates->NumClasses; i++) {
+    const INT_CLASS_STRUCT *int_class = templates->Class[i];
+    if (int_class != nullptr) {
+      bytes += sizeof(*int_class) + int_class->NumProtoSets * sizeof(PROTO_SET_STRUCT) +
+               MaxNumIntProtosIn(int_class) * sizeof(int_class->ProtoLengths[0]);
+    }
+  }
+  return bytes + templates->NumClassPruners * sizeof(CLASS_PRUNER_STRUCT);
+}
+
 /**
  * This routine reads a set of integer templates from
  * File.  File must already be open and must be in the
@@ -211,6 +211,9 @@ INT_TEMPLATES NewIntTemplates();
 TESS_API
 void free_int_templates(INT_TEMPLATES templates);
 
+// Returns the number of bytes of the classes and class pruners.
+size_t IntTemplatesMemoryUsed(const INT_TEMPLATES_STRUCT *templates);
+
 void ShowMatchDisplay();
 
 // Clears the given window and draws the featurespace guides for the
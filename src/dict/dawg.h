@@ -182,6 +182,11 @@ public:
     (void)vec;
   }
 
+  /// Returns the number of bytes of the edges.
+  virtual size_t MemoryUsed() const {
+    return 0;
+  }
+
   /// Returns the given EDGE_REF if the EDGE_RECORD that it points to has
   /// a self loop and the given unichar_id matches the unichar_id stored in the
   /// EDGE_RECORD, returns NO_EDGE otherwise.
@@ -423,6 +428,10 @@ public:
     return num_edges_;
   }
 
+  size_t MemoryUsed() const override {
+    return num_edges_ * sizeof(EDGE_RECORD);
+  }
+
   /// Returns the edge that corresponds to the letter out of this node.
   EDGE_REF edge_char_of(NODE_REF node, UNICHAR_ID unichar_id, bool word_end) const override;
 
@@ -43,6 +43,16 @@ public:
     dawgs_.DeleteUnusedObjects();
   }
 
+  // Returns whether we manage the given dawg.
+  bool Contains(const Dawg *dawg) const {
+    return dawgs_.Contains(dawg);
+  }
+
+  // Returns the number of bytes of the edges of the loaded dawgs.
+  size_t MemoryUsed() const {
+    return dawgs_.Sum([](const Dawg &dawg) { return dawg.MemoryUsed(); });
+  }
+
 private:
   ObjectCache<Dawg> dawgs_;
 };
@@ -400,6 +400,25 @@ void Dict::End() {
   pending_words_ = nullptr;
 }
 
+size_t Dict::MemoryUsed() const {
+  size_t bytes = 0;
+  for (auto dawg : dawgs_) {
+    if (dawg_cache_is_ours_ || !dawg_cache_->Contains(dawg)) {
+      bytes += dawg->MemoryUsed();
+    }
+  }
+  if (bigram_dawg_ != nullptr && dawg_cache_ != nullptr && dawg_cache_is_ours_) {
+    bytes += bigram_dawg_->MemoryUsed();
+  }
+  if (pending_words_ != nullptr) {
+    bytes += pending_words_->MemoryUsed();
+  }
+  for (auto successor : successors_) {
+    bytes += sizeof(*successor) + successor->capacity() * sizeof(int);
+  }
+  return bytes;
+}
+
 // Returns true if in light of the current state unichar_id is allowed
 // according to at least one of the dawgs in the dawgs_ vector.
 // See more extensive comments in dict.h where this function is declared.
@@ -293,6 +293,11 @@ public:
   bool FinishLoad();
   void End();
 
+  // Returns the number of bytes of the dawgs which are not shared through
+  // the global DawgCache, such as the document and user dictionaries, and
+  // of the successor lists.
+  size_t MemoryUsed() const;
+
   // Resets the document dictionary analogous to ResetAdaptiveClassifier.
   void ResetDocumentDictionary() {
     if (pending_words_ != nullptr) {
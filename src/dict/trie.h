@@ -94,6 +94,15 @@ public:
   // Reset the Trie to empty.
   void clear();
 
+  size_t MemoryUsed() const override {
+    size_t bytes = nodes_.capacity() * sizeof(nodes_[0]);
+    for (auto node : nodes_) {
+      bytes += sizeof(*node) + node->forward_edges.capacity() * sizeof(EDGE_RECORD) +
+               node->backward_edges.capacity() * sizeof(EDGE_RECORD);
+    }
+    return bytes;
+  }
+
   /** Returns the edge that corresponds to the letter out of this node. */
   EDGE_REF edge_char_of(NODE_REF node_ref, UNICHAR_ID unichar_id, bool word_end) const override {
     EDGE_RECORD *edge_ptr;
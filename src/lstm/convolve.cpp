@@ -23,6 +23,7 @@
 
 #include "convolve.h"
 
+#include "networkprofile.h"
 #include "networkscratch.h"
 #include "serialis.h"
 
@@ -54,6 +55,7 @@ bool Convolve::DeSerialize(TFile *fp) {
 // See NetworkCpp for a detailed discussion of the arguments.
 void Convolve::Forward(bool debug, const NetworkIO &input, const TransposedArray *input_transpose,
                        NetworkScratch *scratch, NetworkIO *output) {
+  NETWORK_FORWARD_SCOPE(input, output);
   output->Resize(input, no_);
   int y_scale = 2 * half_y_ + 1;
   StrideMap::Index dest_index(output->stride_map());
@@ -24,10 +24,12 @@
 #ifdef _OPENMP
 #  include <omp.h>
 #endif
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 
 #include "functions.h"
+#include "networkprofile.h"
 #include "networkscratch.h"
 
 // Number of threads to use for parallel calculation of Forward and Backward.
@@ -36,6 +38,8 @@ const int kNumThreads = 4;
 #else
 const int kNumThreads = 1;
 #endif
+// Number of int timesteps which Forward multiplies by the weights at once.
+const int kNumBatchRows = 4;
 
 namespace tesseract {
 
@@ -103,6 +107,15 @@ void FullyConnected::ConvertToInt() {
   weights_.ConvertToInt();
 }
 
+void FullyConnected::TuneIntSimd() {
+  // Forward multiplies kNumBatchRows timesteps at a time.
+  weights_.TuneIntSimd(true);
+}
+
+size_t FullyConnected::MemoryUsed() const {
+  return weights_.MemoryUsed() + source_t_.MemoryUsed() + acts_.MemoryUsed();
+}
+
 // Provides debug output on the weights.
 void FullyConnected::DebugWeights() {
   weights_.Debug2D(name_.c_str());
@@ -129,6 +142,7 @@ bool FullyConnected::DeSerialize(TFile *fp) {
 void FullyConnected::Forward(bool debug, const NetworkIO &input,
                              const TransposedArray *input_transpose, NetworkScratch *scratch,
                              NetworkIO *output) {
+  NETWORK_FORWARD_SCOPE(input, output);
   int width = input.Width();
   if (type_ == NT_SOFTMAX) {
     output->ResizeFloat(input, no_);
@@ -142,30 +156,37 @@ void FullyConnected::Forward(bool debug, const NetworkIO &input,
   if (IntSimdMatrix::intSimdMatrix) {
     ro = IntSimdMatrix::intSimdMatrix->RoundOutputs(ro);
   }
+  // Int timesteps are multiplied in batches, with a temp line for each.
+  int batch_rows = input.int_mode() ? kNumBatchRows : 1;
   for (int i = 0; i < kNumThreads; ++i) {
-    temp_lines[i].Init(no_, ro, scratch);
+    temp_lines[i].Init(no_ + (batch_rows - 1) * ro, ro * batch_rows, scratch);
     curr_input[i].Init(ni_, scratch);
   }
+  int num_batches = (width + batch_rows - 1) / batch_rows;
 #ifdef _OPENMP
 #  pragma omp parallel for num_threads(kNumThreads)
-  for (int t = 0; t < width; ++t) {
+  for (int b = 0; b < num_batches; ++b) {
     // Thread-local pointer to temporary storage.
     int thread_id = omp_get_thread_num();
 #else
-  for (int t = 0; t < width; ++t) {
+  for (int b = 0; b < num_batches; ++b) {
     // Thread-local pointer to temporary storage.
     int thread_id = 0;
 #endif
     double *temp_line = temp_lines[thread_id];
+    int t = b * batch_rows;
+    int num_rows = std::min(batch_rows, width - t);
     if (input.int_mode()) {
-      ForwardTimeStep(input.i(t), t, temp_line);
+      ForwardTimeSteps(input, t, num_rows, temp_line, ro);
     } else {
       input.ReadTimeStep(t, curr_input[thread_id]);
       ForwardTimeStep(curr_input[thread_id], t, temp_line);
     }
-    output->WriteTimeStep(t, temp_line);
-    if (IsTraining() && type_ != NT_SOFTMAX) {
-      acts_.CopyTimeStepFrom(t, *output, t);
+    for (int r = 0; r < num_rows; ++r) {
+      output->WriteTimeStep(t + r, temp_line + r * ro);
+      if (IsTraining() && type_ != NT_SOFTMAX) {
+        acts_.CopyTimeStepFrom(t + r, *output, t + r);
+      }
     }
   }
   // Zero all the elements that are in the padding around images that allows
@@ -233,6 +254,20 @@ void FullyConnected::ForwardTimeStep(const int8_t *i_input, int t, double *outpu
   ForwardTimeStep(t, output_line);
 }
 
+void FullyConnected::ForwardTimeSteps(const NetworkIO &input, int t, int num_rows,
+                                      double *output_lines, int stride) {
+  const int8_t *inputs[kNumBatchRows];
+  double *outputs[kNumBatchRows];
+  for (int r = 0; r < num_rows; ++r) {
+    inputs[r] = input.i(t + r);
+    outputs[r] = output_lines + r * stride;
+  }
+  weights_.MatrixDotVectors(num_rows, inputs, outputs);
+  for (int r = 0; r < num_rows; ++r) {
+    ForwardTimeStep(t + r, outputs[r]);
+  }
+}
+
 // Runs backward propagation of errors on the deltas line.
 // See NetworkCpp for a detailed discussion of the arguments.
 bool FullyConnected::Backward(bool debug, const NetworkIO &fwd_deltas, NetworkScratch *scratch,
@@ -76,6 +76,12 @@ public:
   // Converts a float network to an int network.
   void ConvertToInt() override;
 
+  // Chooses the fastest SIMD implementation for each int weight matrix.
+  void TuneIntSimd() override;
+
+  // Returns the number of bytes of the weights and of the kept buffers.
+  size_t MemoryUsed() const override;
+
   // Provides debug output on the weights.
   void DebugWeights() override;
 
@@ -93,6 +99,10 @@ public:
   void ForwardTimeStep(int t, double *output_line);
   void ForwardTimeStep(const double *d_input, int t, double *output_line);
   void ForwardTimeStep(const int8_t *i_input, int t, double *output_line);
+  // As ForwardTimeStep for num_rows int timesteps of input from t, at most
+  // kNumBatchRows, with the output lines stride apart.
+  void ForwardTimeSteps(const NetworkIO &input, int t, int num_rows, double *output_lines,
+                        int stride);
 
   // Runs backward propagation of errors on the deltas line.
   // See Network for a detailed discussion of the arguments.
@@ -20,6 +20,7 @@
 #include <allheaders.h>
 #include "imagedata.h"
 #include "pageres.h"
+#include "networkprofile.h"
 #include "scrollview.h"
 
 namespace tesseract {
@@ -63,6 +64,7 @@ void Input::CacheXScaleFactor(int factor) {
 // See Network for a detailed discussion of the arguments.
 void Input::Forward(bool debug, const NetworkIO &input, const TransposedArray *input_transpose,
                     NetworkScratch *scratch, NetworkIO *output) {
+  NETWORK_FORWARD_SCOPE(input, output);
   *output = input;
 }
 
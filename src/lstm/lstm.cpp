@@ -34,6 +34,7 @@
 
 #include "fullyconnected.h"
 #include "functions.h"
+#include "networkprofile.h"
 #include "networkscratch.h"
 #include "tprintf.h"
 
@@ -211,6 +212,28 @@ void LSTM::ConvertToInt() {
   }
 }
 
+void LSTM::TuneIntSimd() {
+  // The gates are computed one timestep at a time. The softmax is too, but
+  // it is rare, so it keeps the default.
+  for (int w = 0; w < WT_COUNT; ++w) {
+    if (w == GFS && !Is2D()) {
+      continue;
+    }
+    gate_weights_[w].TuneIntSimd(false);
+  }
+}
+
+size_t LSTM::MemoryUsed() const {
+  size_t bytes = source_.MemoryUsed() + state_.MemoryUsed() + which_fg_.MemoryUsed();
+  for (int w = 0; w < WT_COUNT; ++w) {
+    bytes += gate_weights_[w].MemoryUsed() + node_values_[w].MemoryUsed();
+  }
+  if (softmax_ != nullptr) {
+    bytes += softmax_->MemoryUsed();
+  }
+  return bytes;
+}
+
 // Sets up the network for training using the given weight_range.
 void LSTM::DebugWeights() {
   for (int w = 0; w < WT_COUNT; ++w) {
@@ -290,6 +313,7 @@ bool LSTM::DeSerialize(TFile *fp) {
 // See NetworkCpp for a detailed discussion of the arguments.
 void LSTM::Forward(bool debug, const NetworkIO &input, const TransposedArray *input_transpose,
                    NetworkScratch *scratch, NetworkIO *output) {
+  NETWORK_FORWARD_SCOPE(input, output);
   input_map_ = input.stride_map();
   input_width_ = input.Width();
   if (softmax_ != nullptr) {
@@ -86,6 +86,12 @@ public:
   // Converts a float network to an int network.
   void ConvertToInt() override;
 
+  // Chooses the fastest SIMD implementation for each int weight matrix.
+  void TuneIntSimd() override;
+
+  // Returns the number of bytes of the weights and of the kept buffers.
+  size_t MemoryUsed() const override;
+
   // Provides debug output on the weights.
   void DebugWeights() override;
 
@@ -30,10 +30,13 @@
 #include "input.h"
 #include "lstm.h"
 #include "normalis.h"
+#include "networkprofile.h" // for NetworkProfile
 #include "pageres.h"
+#include "profiler.h" // for PROFILE_SCOPE
 #include "ratngs.h"
 #include "recodebeam.h"
 #include "scrollview.h"
+#include "stagestats.h" // for STAGE_TIMER
 #include "statistc.h"
 #include "tprintf.h"
 
@@ -63,12 +66,15 @@ LSTMRecognizer::LSTMRecognizer()
     , adam_beta_(0.0f)
     , dict_(nullptr)
     , search_(nullptr)
+    , layer_profile_(nullptr)
+    , profile_layers_(false)
     , debug_win_(nullptr) {}
 
 LSTMRecognizer::~LSTMRecognizer() {
   delete network_;
   delete dict_;
   delete search_;
+  delete layer_profile_;
 }
 
 // Loads a model from mgr, including the dictionary only if lang is not null.
@@ -131,6 +137,8 @@ bool LSTMRecognizer::Serialize(const TessdataManager *mgr, TFile *fp) const {
 
 // Reads from the given file. Returns false in case of error.
 bool LSTMRecognizer::DeSerialize(const TessdataManager *mgr, TFile *fp) {
+  delete layer_profile_;
+  layer_profile_ = nullptr;
   delete network_;
   network_ = Network::CreateFromFile(fp);
   if (network_ == nullptr) {
@@ -246,12 +254,16 @@ void LSTMRecognizer::RecognizeLine(const ImageData &image_data, bool invert, boo
                                    double worst_dict_cert, const TBOX &line_box,
                                    PointerVector<WERD_RES> *words, int lstm_choice_mode,
                                    int lstm_choice_amount) {
+  PROFILE_SCOPE("RecognizeLine");
   NetworkIO outputs;
   float scale_factor;
   NetworkIO inputs;
   if (!RecognizeLine(image_data, invert, debug, false, false, &scale_factor, &inputs, &outputs)) {
     return;
   }
+  STAGE_TIMER(STAGE_BEAM_SEARCH);
+  STAGE_COUNT_EVENT(COUNTER_LSTM_LINES, 1);
+  STAGE_COUNT_EVENT(COUNTER_LSTM_TIMESTEPS, outputs.Width());
   if (search_ == nullptr) {
     search_ = new RecodeBeamSearch(recoder_, null_char_, SimpleTextOutput(), dict_);
   }
@@ -313,11 +325,25 @@ void LSTMRecognizer::OutputStats(const NetworkIO &outputs, float *min_output, fl
   }
 }
 
+const NetworkProfile *LSTMRecognizer::layer_profile() const {
+  if (layer_profile_ == nullptr || layer_profile_->layers().empty() ||
+      layer_profile_->layers()[0].network != network_) {
+    return nullptr;
+  }
+  return layer_profile_;
+}
+
 // Recognizes the image_data, returning the labels,
 // scores, and corresponding pairs of start, end x-coords in coords.
 bool LSTMRecognizer::RecognizeLine(const ImageData &image_data, bool invert, bool debug,
                                    bool re_invert, bool upside_down, float *scale_factor,
                                    NetworkIO *inputs, NetworkIO *outputs) {
+  STAGE_TIMER(STAGE_LSTM_FORWARD);
+  if (profile_layers_ && layer_profile() == nullptr) {
+    delete layer_profile_;
+    layer_profile_ = new NetworkProfile(network_);
+  }
+  NetworkProfile::Scope layer_profile_scope(profile_layers_ ? layer_profile_ : nullptr);
   // This ensures consistent recognition results.
   SetRandomSeed();
   int min_width = network_->XScaleFactor();
@@ -358,8 +384,8 @@ bool LSTMRecognizer::RecognizeLine(const ImageData &image_data, bool invert, boo
     if (inv_mean > pos_mean) {
       // Inverted did better. Use inverted data.
       if (debug) {
-        tprintf("Inverting image: old min=%g, mean=%g, sd=%g, inv %g,%g,%g\n", pos_min, pos_mean,
-                pos_sd, inv_min, inv_mean, inv_sd);
+        TLOG(TESS_LOG_DEBUG, "Inverting image: old min=%g, mean=%g, sd=%g, inv %g,%g,%g\n",
+             pos_min, pos_mean, pos_sd, inv_min, inv_mean, inv_sd);
       }
       *outputs = inv_outputs;
       *inputs = inv_inputs;
@@ -468,7 +494,7 @@ void LSTMRecognizer::DebugActivationPath(const NetworkIO &outputs, const std::ve
 // of positions.
 void LSTMRecognizer::DebugActivationRange(const NetworkIO &outputs, const char *label,
                                           int best_choice, int x_start, int x_end) {
-  tprintf("%s=%d On [%d, %d), scores=", label, best_choice, x_start, x_end);
+  TLOG(TESS_LOG_DEBUG, "%s=%d On [%d, %d), scores=", label, best_choice, x_start, x_end);
   double max_score = 0.0;
   double mean_score = 0.0;
   const int width = x_end - x_start;
@@ -487,9 +513,10 @@ void LSTMRecognizer::DebugActivationRange(const NetworkIO &outputs, const char *
         best_score = line[c];
       }
     }
-    tprintf(" %.3g(%s=%d=%.3g)", score, DecodeSingleLabel(best_c), best_c, best_score * 100.0);
+    TLOG(TESS_LOG_DEBUG, " %.3g(%s=%d=%.3g)", score, DecodeSingleLabel(best_c), best_c,
+         best_score * 100.0);
   }
-  tprintf(", Mean=%g, max=%g\n", mean_score, max_score);
+  TLOG(TESS_LOG_DEBUG, ", Mean=%g, max=%g\n", mean_score, max_score);
 }
 
 // Helper returns true if the null_char is the winner at t, and it beats the
@@ -39,6 +39,7 @@ namespace tesseract {
 
 class Dict;
 class ImageData;
+class NetworkProfile;
 
 // Enum indicating training mode control flags.
 enum TrainingFlags {
@@ -95,6 +96,19 @@ public:
   bool IsTensorFlow() const {
     return network_->type() == NT_TENSORFLOW;
   }
+  // Returns the network, for inspecting its layers.
+  const Network *network() const {
+    return network_;
+  }
+  // Returns the number of bytes of the weights and the kept buffers of the
+  // network.
+  size_t NetworkMemoryUsed() const {
+    return network_ != nullptr ? network_->MemoryUsed() : 0;
+  }
+  // Returns the number of bytes of the scratch buffers of the network.
+  size_t ScratchMemoryUsed() const {
+    return scratch_space_.MemoryUsed();
+  }
   // Returns a vector of layer ids that can be passed to other layer functions
   // to access a specific layer.
   std::vector<std::string> EnumerateLayers() const {
@@ -232,6 +246,23 @@ public:
                      const TBOX &line_box, PointerVector<WERD_RES> *words, int lstm_choice_mode = 0,
                      int lstm_choice_amount = 5);
 
+  // Chooses the fastest SIMD implementation for each weight matrix of an
+  // int network, see IntSimdMatrix::Tune.
+  void TuneIntSimd() {
+    if (network_ != nullptr && IsIntMode()) {
+      network_->TuneIntSimd();
+    }
+  }
+
+  // Turns the timing of the layers of the network in RecognizeLine on or
+  // off. The times collected so far are kept.
+  void SetLayerProfiling(bool on) {
+    profile_layers_ = on;
+  }
+  // Returns the times of the layers, or nullptr if none were collected for
+  // the current network.
+  const NetworkProfile *layer_profile() const;
+
   // Helper computes min and mean best results in the output.
   void OutputStats(const NetworkIO &outputs, float *min_output, float *mean_output, float *sd);
   // Recognizes the image_data, returning the labels,
@@ -339,6 +370,9 @@ protected:
   Dict *dict_;
   // Beam search held between uses to optimize memory allocation/use.
   RecodeBeamSearch *search_;
+  // Times of the layers of network_ while profile_layers_ is set.
+  NetworkProfile *layer_profile_;
+  bool profile_layers_;
 
   // == Debugging parameters.==
   // Recognition debug display window.
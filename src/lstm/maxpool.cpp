@@ -17,6 +17,8 @@
 
 #include "maxpool.h"
 
+#include "networkprofile.h"
+
 namespace tesseract {
 
 Maxpool::Maxpool(const char *name, int ni, int x_scale, int y_scale)
@@ -36,6 +38,7 @@ bool Maxpool::DeSerialize(TFile *fp) {
 // See NetworkCpp for a detailed discussion of the arguments.
 void Maxpool::Forward(bool debug, const NetworkIO &input, const TransposedArray *input_transpose,
                       NetworkScratch *scratch, NetworkIO *output) {
+  NETWORK_FORWARD_SCOPE(input, output);
   output->ResizeScaled(input, x_scale_, y_scale_, no_);
   maxes_.ResizeNoInit(output->Width(), ni_);
   back_map_ = input.stride_map();
@@ -73,6 +73,24 @@ static char const *const kTypeNames[NT_COUNT] = {
     "TensorFlow",
 };
 
+// Names of the profiling markers of Forward, in the order of NetworkType.
+static char const *const kForwardMarkerNames[NT_COUNT] = {
+    "Forward Invalid",     "Forward Input",
+    "Forward Convolve",    "Forward Maxpool",
+    "Forward Parallel",    "Forward Replicated",
+    "Forward ParBidiLSTM", "Forward DepParUDLSTM",
+    "Forward Par2dLSTM",   "Forward Series",
+    "Forward Reconfig",    "Forward RTLReversed",
+    "Forward TTBReversed", "Forward XYTranspose",
+    "Forward LSTM",        "Forward SummLSTM",
+    "Forward Logistic",    "Forward LinLogistic",
+    "Forward LinTanh",     "Forward Tanh",
+    "Forward Relu",        "Forward Linear",
+    "Forward Softmax",     "Forward SoftmaxNoCTC",
+    "Forward LSTMSoftmax", "Forward LSTMBinarySoftmax",
+    "Forward TensorFlow",
+};
+
 Network::Network()
     : type_(NT_NONE)
     , training_(TS_ENABLED)
@@ -150,6 +168,14 @@ bool Network::SetupNeedsBackprop(bool needs_backprop) {
   return needs_backprop || num_weights_ > 0;
 }
 
+const char *Network::TypeName() const {
+  return kTypeNames[type_];
+}
+
+const char *Network::ForwardMarkerName() const {
+  return kForwardMarkerNames[type_];
+}
+
 // Writes to the given file. Returns false in case of error.
 bool Network::Serialize(TFile *fp) const {
   int8_t data = NT_NONE;
@@ -110,6 +110,10 @@ public:
   NetworkType type() const {
     return type_;
   }
+  // Returns the name of the type, as in the serialized network.
+  const char *TypeName() const;
+  // Returns the name of the profiling marker of Forward for the type.
+  const char *ForwardMarkerName() const;
   bool IsTraining() const {
     return training_ == TS_ENABLED;
   }
@@ -194,6 +198,15 @@ public:
   // Converts a float network to an int network.
   virtual void ConvertToInt() {}
 
+  // Chooses the fastest SIMD implementation for each int weight matrix.
+  virtual void TuneIntSimd() {}
+
+  // Returns the number of bytes of the weights and of the buffers which are
+  // kept between calls.
+  virtual size_t MemoryUsed() const {
+    return 0;
+  }
+
   // Provides a pointer to a TRand for any networks that care to use it.
   // Note that randomizer is a borrowed pointer that should outlive the network
   // and should not be deleted by any of the networks.
@@ -321,6 +321,11 @@ public:
     }
   }
 
+  // Returns the number of bytes allocated for the data.
+  size_t MemoryUsed() const {
+    return f_.MemoryUsed() + i_.MemoryUsed();
+  }
+
 private:
   // Returns the padding required for the given number of features in order
   // for the SIMD operations to be safe.
@@ -0,0 +1,134 @@
+///////////////////////////////////////////////////////////////////////
+// File:        networkprofile.cpp
+// Description: Time and work of each layer of a network in Forward.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "networkprofile.h"
+
+#include "plumbing.h" // for Plumbing
+
+#include <cstdio> // for snprintf
+
+namespace tesseract {
+
+// Not a static member, because thread_local data can not be exported
+// from a DLL.
+static thread_local NetworkProfile *current_profile = nullptr;
+
+NetworkProfile::Scope::Scope(NetworkProfile *profile) : previous_(current_profile) {
+  current_profile = profile;
+}
+
+NetworkProfile::Scope::~Scope() {
+  current_profile = previous_;
+}
+
+NetworkProfile *NetworkProfile::Current() {
+  return current_profile;
+}
+
+NetworkProfile::NetworkProfile(const Network *network) {
+  if (network != nullptr) {
+    AddLayers(network, "", 0);
+  }
+}
+
+// Adds the network and the layers below it in depth first order.
+void NetworkProfile::AddLayers(const Network *network, const std::string &id, int depth) {
+  index_[network] = layers_.size();
+  Layer layer;
+  layer.network = network;
+  layer.id = id;
+  layer.depth = depth;
+  layer.leaf = !network->IsPlumbingType();
+  layers_.push_back(layer);
+  if (!layer.leaf) {
+    auto *plumbing = static_cast<const Plumbing *>(network);
+    for (size_t i = 0; i < plumbing->stack().size(); ++i) {
+      AddLayers(plumbing->stack()[i], id + ":" + std::to_string(i), depth + 1);
+    }
+  }
+}
+
+void NetworkProfile::AddForward(const Network *network, double seconds, const NetworkIO &input,
+                                const NetworkIO &output) {
+  auto it = index_.find(network);
+  if (it == index_.end()) {
+    return;
+  }
+  Layer &layer = layers_[it->second];
+  ++layer.calls;
+  layer.timesteps += output.Width();
+  layer.seconds += seconds;
+  if (layer.leaf) {
+    layer.flops += 2.0 * network->num_weights() * output.Width();
+    double io_size = input.int_mode() ? sizeof(int8_t) : sizeof(float);
+    double weight_size = input.int_mode() ? sizeof(int8_t) : sizeof(double);
+    layer.bytes += io_size * network->NumInputs() * input.Width() +
+                   io_size * network->NumOutputs() * output.Width() +
+                   weight_size * network->num_weights();
+  }
+}
+
+void NetworkProfile::Clear() {
+  for (auto &layer : layers_) {
+    layer.calls = 0;
+    layer.timesteps = 0;
+    layer.seconds = 0.0;
+    layer.flops = 0.0;
+    layer.bytes = 0.0;
+  }
+}
+
+std::string NetworkProfile::Report() const {
+  bool timed = !layers_.empty() && layers_[0].calls > 0;
+  double total_seconds = timed ? layers_[0].seconds : 0.0;
+  std::string report;
+  char line[256];
+  snprintf(line, sizeof(line), "%-28s %-14s %6s %6s %9s %9s", "Layer", "Type", "In", "Out",
+           "Weights", "MFLOP/ts");
+  report += line;
+  if (timed) {
+    snprintf(line, sizeof(line), " %8s %10s %10s %6s %8s %10s", "Calls", "Timesteps", "ms", "%",
+             "GFLOP/s", "MB");
+    report += line;
+  }
+  report += '\n';
+  for (auto &layer : layers_) {
+    const Network *network = layer.network;
+    std::string name = std::string(2 * layer.depth, ' ');
+    if (!layer.id.empty()) {
+      name += layer.id + ' ';
+    }
+    name += network->name();
+    double step_flops = layer.leaf ? 2.0 * network->num_weights() : 0.0;
+    snprintf(line, sizeof(line), "%-28s %-14s %6d %6d %9d %9.3f", name.c_str(),
+             network->TypeName(), network->NumInputs(), network->NumOutputs(),
+             network->num_weights(), step_flops / 1e6);
+    report += line;
+    if (timed) {
+      double percent = total_seconds > 0.0 ? 100.0 * layer.seconds / total_seconds : 0.0;
+      double gflops = layer.seconds > 0.0 ? layer.flops / layer.seconds / 1e9 : 0.0;
+      snprintf(line, sizeof(line), " %8llu %10llu %10.3f %6.1f %8.3f %10.3f",
+               static_cast<unsigned long long>(layer.calls),
+               static_cast<unsigned long long>(layer.timesteps), layer.seconds * 1e3, percent,
+               gflops, layer.bytes / 1e6);
+      report += line;
+    }
+    report += '\n';
+  }
+  return report;
+}
+
+} // namespace tesseract.
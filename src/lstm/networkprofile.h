@@ -0,0 +1,138 @@
+///////////////////////////////////////////////////////////////////////
+// File:        networkprofile.h
+// Description: Time and work of each layer of a network in Forward.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_LSTM_NETWORKPROFILE_H_
+#define TESSERACT_LSTM_NETWORKPROFILE_H_
+
+#ifdef HAVE_CONFIG_H
+#  include "config_auto.h" // DISABLED_STAGE_STATS
+#endif
+
+#include "network.h"   // for Network, NetworkType
+#include "networkio.h" // for NetworkIO
+#include "profiler.h"  // for PROFILE_SCOPE
+
+#include <chrono>        // for std::chrono
+#include <cstdint>       // for uint64_t
+#include <string>        // for std::string
+#include <unordered_map> // for std::unordered_map
+#include <vector>        // for std::vector
+
+namespace tesseract {
+
+// Collects the time spent in the Forward of each layer of a network, with
+// estimates of the arithmetic and the memory traffic, to compare models and
+// VGSL specs. The work of a layer is estimated from its weights, its number
+// of inputs and outputs and the widths of the lines it processed:
+// every weight is one multiply-add per output timestep, and the inputs,
+// outputs and weights are each moved once per call.
+// Like StageRecorder, the profile which is current in the calling thread
+// is used, so the layers need not know about it.
+class TESS_API NetworkProfile {
+public:
+  struct Layer {
+    const Network *network = nullptr;
+    std::string id;    // As in Plumbing::EnumerateLayers, empty for the network.
+    int depth = 0;     // Number of plumbing layers which contain it.
+    bool leaf = true;  // Not a plumbing layer, so it does the work itself.
+    uint64_t calls = 0;
+    uint64_t timesteps = 0; // Sum of the output widths.
+    double seconds = 0.0;   // Includes the contained layers.
+    double flops = 0.0;     // Of leaves only, 2 per multiply-add.
+    double bytes = 0.0;     // Of leaves only.
+  };
+
+  // Makes a profile current in the calling thread for the lifetime of the
+  // object and restores the previous one afterwards.
+  class Scope {
+  public:
+    explicit Scope(NetworkProfile *profile);
+    ~Scope();
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    NetworkProfile *previous_;
+  };
+
+  // Returns the profile of the calling thread, or nullptr.
+  static NetworkProfile *Current();
+
+  // Lists all layers of the network, which must outlive the profile.
+  explicit NetworkProfile(const Network *network);
+
+  void AddForward(const Network *network, double seconds, const NetworkIO &input,
+                  const NetworkIO &output);
+  // Clears the times and counts.
+  void Clear();
+
+  const std::vector<Layer> &layers() const {
+    return layers_;
+  }
+
+  // Returns a table with a line per layer, indented by depth. The static
+  // columns are the number of inputs and outputs, the weights and the
+  // estimated MFLOP per timestep. Once lines were recognized, the calls,
+  // timesteps, time in ms and % of the whole network, GFLOP/s and MB moved
+  // follow.
+  std::string Report() const;
+
+private:
+  void AddLayers(const Network *network, const std::string &id, int depth);
+
+  std::vector<Layer> layers_;
+  std::unordered_map<const Network *, size_t> index_;
+};
+
+// Adds the time of its lifetime to the layer in the current profile.
+class LayerTimer {
+public:
+  LayerTimer(const Network *network, const NetworkIO &input, const NetworkIO *output)
+      : profile_(NetworkProfile::Current()), network_(network), input_(input), output_(output) {
+    if (profile_ != nullptr) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+  ~LayerTimer() {
+    if (profile_ != nullptr) {
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_;
+      profile_->AddForward(network_, elapsed.count(), input_, *output_);
+    }
+  }
+  LayerTimer(const LayerTimer &) = delete;
+  LayerTimer &operator=(const LayerTimer &) = delete;
+
+private:
+  NetworkProfile *profile_;
+  const Network *network_;
+  const NetworkIO &input_;
+  const NetworkIO *output_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+// Instruments the Forward of a layer, for the process wide Profiler and the
+// NetworkProfile. Compiles to nothing if DISABLED_STAGE_STATS is defined.
+#ifndef DISABLED_STAGE_STATS
+#  define NETWORK_FORWARD_SCOPE(input, output)  \
+    PROFILE_SCOPE(ForwardMarkerName());         \
+    ::tesseract::LayerTimer layer_timer_(this, input, output)
+#else
+#  define NETWORK_FORWARD_SCOPE(input, output)
+#endif
+
+} // namespace tesseract.
+
+#endif // TESSERACT_LSTM_NETWORKPROFILE_H_
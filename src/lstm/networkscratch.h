@@ -44,6 +44,16 @@ public:
     int_mode_ = int_mode;
   }
 
+  // Returns the number of bytes allocated for the buffers of all stacks.
+  size_t MemoryUsed() const {
+    return int_stack_.Sum([](const NetworkIO &io) { return io.MemoryUsed(); }) +
+           float_stack_.Sum([](const NetworkIO &io) { return io.MemoryUsed(); }) +
+           vec_stack_.Sum([](const std::vector<double> &vec) {
+             return vec.capacity() * sizeof(double);
+           }) +
+           array_stack_.Sum([](const TransposedArray &array) { return array.MemoryUsed(); });
+  }
+
   // Class that acts like a NetworkIO (by having an implicit cast operator),
   // yet actually holds a pointer to NetworkIOs in the source NetworkScratch,
   // and knows how to unstack the borrowed pointers on destruction.
@@ -255,12 +265,22 @@ public:
         --stack_top_;
       }
     }
+    // Returns the sum of size(item) over all items, lent out or not.
+    template <typename Size>
+    size_t Sum(Size size) const {
+      std::lock_guard<std::mutex> lock(mutex_);
+      size_t sum = 0;
+      for (auto data : stack_) {
+        sum += size(*data);
+      }
+      return sum;
+    }
 
   private:
     std::vector<T *> stack_;
     std::vector<bool> flags_;
     unsigned stack_top_ = 0;
-    std::mutex mutex_;
+    mutable std::mutex mutex_;
   }; // class Stack.
 
 private:
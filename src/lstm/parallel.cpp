@@ -26,6 +26,7 @@
 #endif
 
 #include "functions.h" // For conditional undef of _OPENMP.
+#include "networkprofile.h"
 #include "networkscratch.h"
 
 namespace tesseract {
@@ -51,6 +52,7 @@ StaticShape Parallel::OutputShape(const StaticShape &input_shape) const {
 // See NetworkCpp for a detailed discussion of the arguments.
 void Parallel::Forward(bool debug, const NetworkIO &input, const TransposedArray *input_transpose,
                        NetworkScratch *scratch, NetworkIO *output) {
+  NETWORK_FORWARD_SCOPE(input, output);
   bool parallel_debug = false;
   // If this parallel is a replicator of convolvers, or holds a 1-d LSTM pair,
   // or a 2-d LSTM quad, do debug locally, and don't pass the flag on.
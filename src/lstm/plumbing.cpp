@@ -71,6 +71,20 @@ void Plumbing::ConvertToInt() {
   }
 }
 
+void Plumbing::TuneIntSimd() {
+  for (auto &i : stack_) {
+    i->TuneIntSimd();
+  }
+}
+
+size_t Plumbing::MemoryUsed() const {
+  size_t bytes = 0;
+  for (auto &i : stack_) {
+    bytes += i->MemoryUsed();
+  }
+  return bytes;
+}
+
 // Provides a pointer to a TRand for any networks that care to use it.
 // Note that randomizer is a borrowed pointer that should outlive the network
 // and should not be deleted by any of the networks.
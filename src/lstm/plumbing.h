@@ -70,6 +70,12 @@ public:
   // Converts a float network to an int network.
   void ConvertToInt() override;
 
+  // Chooses the fastest SIMD implementation for each int weight matrix.
+  void TuneIntSimd() override;
+
+  // Returns the number of bytes of the weights and of the kept buffers.
+  size_t MemoryUsed() const override;
+
   // Provides a pointer to a TRand for any networks that care to use it.
   // Note that randomizer is a borrowed pointer that should outlive the network
   // and should not be deleted by any of the networks.
@@ -21,6 +21,7 @@
 
 #include "networkio.h"
 #include "pageres.h"
+#include "profiler.h"
 #include "unicharcompress.h"
 
 #include <algorithm> // for std::reverse
@@ -87,6 +88,7 @@ RecodeBeamSearch::~RecodeBeamSearch() {
 void RecodeBeamSearch::Decode(const NetworkIO &output, double dict_ratio, double cert_offset,
                               double worst_dict_cert, const UNICHARSET *charset,
                               int lstm_choice_mode) {
+  PROFILE_SCOPE("RecodeBeamSearch::Decode");
   beam_size_ = 0;
   int width = output.Width();
   if (lstm_choice_mode) {
@@ -103,6 +105,7 @@ void RecodeBeamSearch::Decode(const NetworkIO &output, double dict_ratio, double
 void RecodeBeamSearch::Decode(const GENERIC_2D_ARRAY<float> &output, double dict_ratio,
                               double cert_offset, double worst_dict_cert,
                               const UNICHARSET *charset) {
+  PROFILE_SCOPE("RecodeBeamSearch::Decode");
   beam_size_ = 0;
   int width = output.dim1();
   for (int t = 0; t < width; ++t) {
@@ -243,10 +246,10 @@ void RecodeBeamSearch::ExtractBestPathAsWords(const TBOX &line_box, float scale_
   std::vector<const RecodeNode *> second_nodes;
   character_boundaries_.clear();
   ExtractBestPaths(&best_nodes, &second_nodes);
-  if (debug) {
+  if (debug && TLOG_ENABLED(TESS_LOG_DEBUG)) {
     DebugPath(unicharset, best_nodes);
     ExtractPathAsUnicharIds(second_nodes, &unichar_ids, &certs, &ratings, &xcoords);
-    tprintf("\nSecond choice path:\n");
+    TLOG(TESS_LOG_DEBUG, "\nSecond choice path:\n");
     DebugUnicharPath(unicharset, second_nodes, unichar_ids, certs, ratings, xcoords);
   }
   // If lstm choice mode is required in granularity level 2, it stores the x
@@ -728,19 +731,19 @@ void RecodeBeamSearch::DecodeStep(const float *outputs, int t, double dict_ratio
     }
   } else {
     RecodeBeam *prev = beam_[t - 1];
-    if (debug) {
+    if (debug && TLOG_ENABLED(TESS_LOG_DEBUG)) {
       int beam_index = BeamIndex(true, NC_ANYTHING, 0);
       for (int i = prev->beams_[beam_index].size() - 1; i >= 0; --i) {
         std::vector<const RecodeNode *> path;
         ExtractPath(&prev->beams_[beam_index].get(i).data(), &path);
-        tprintf("Step %d: Dawg beam %d:\n", t, i);
+        TLOG(TESS_LOG_DEBUG, "Step %d: Dawg beam %d:\n", t, i);
         DebugPath(charset, path);
       }
       beam_index = BeamIndex(false, NC_ANYTHING, 0);
       for (int i = prev->beams_[beam_index].size() - 1; i >= 0; --i) {
         std::vector<const RecodeNode *> path;
         ExtractPath(&prev->beams_[beam_index].get(i).data(), &path);
-        tprintf("Step %d: Non-Dawg beam %d:\n", t, i);
+        TLOG(TESS_LOG_DEBUG, "Step %d: Non-Dawg beam %d:\n", t, i);
         DebugPath(charset, path);
       }
     }
@@ -796,19 +799,19 @@ void RecodeBeamSearch::DecodeSecondaryStep(const float *outputs, int t, double d
     }
   } else {
     RecodeBeam *prev = secondary_beam_[t - 1];
-    if (debug) {
+    if (debug && TLOG_ENABLED(TESS_LOG_DEBUG)) {
       int beam_index = BeamIndex(true, NC_ANYTHING, 0);
       for (int i = prev->beams_[beam_index].size() - 1; i >= 0; --i) {
         std::vector<const RecodeNode *> path;
         ExtractPath(&prev->beams_[beam_index].get(i).data(), &path);
-        tprintf("Step %d: Dawg beam %d:\n", t, i);
+        TLOG(TESS_LOG_DEBUG, "Step %d: Dawg beam %d:\n", t, i);
         DebugPath(charset, path);
       }
       beam_index = BeamIndex(false, NC_ANYTHING, 0);
       for (int i = prev->beams_[beam_index].size() - 1; i >= 0; --i) {
         std::vector<const RecodeNode *> path;
         ExtractPath(&prev->beams_[beam_index].get(i).data(), &path);
-        tprintf("Step %d: Non-Dawg beam %d:\n", t, i);
+        TLOG(TESS_LOG_DEBUG, "Step %d: Non-Dawg beam %d:\n", t, i);
         DebugPath(charset, path);
       }
     }
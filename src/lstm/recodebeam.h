@@ -28,6 +28,7 @@
 #include "dawg.h"
 #include "dict.h"
 #include "genericheap.h"
+#include "genericvector.h"
 #include "kdpair.h"
 #include "networkio.h"
 #include "ratngs.h"
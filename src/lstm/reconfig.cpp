@@ -18,6 +18,8 @@
 
 #include "reconfig.h"
 
+#include "networkprofile.h"
+
 namespace tesseract {
 
 Reconfig::Reconfig(const char *name, int ni, int x_scale, int y_scale)
@@ -68,6 +70,7 @@ bool Reconfig::DeSerialize(TFile *fp) {
 // See NetworkCpp for a detailed discussion of the arguments.
 void Reconfig::Forward(bool debug, const NetworkIO &input, const TransposedArray *input_transpose,
                        NetworkScratch *scratch, NetworkIO *output) {
+  NETWORK_FORWARD_SCOPE(input, output);
   output->ResizeScaled(input, x_scale_, y_scale_, no_);
   back_map_ = input.stride_map();
   StrideMap::Index dest_index(output->stride_map());
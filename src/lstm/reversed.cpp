@@ -19,6 +19,7 @@
 
 #include <cstdio>
 
+#include "networkprofile.h"
 #include "networkscratch.h"
 
 namespace tesseract {
@@ -51,6 +52,7 @@ void Reversed::SetNetwork(Network *network) {
 // See NetworkCpp for a detailed discussion of the arguments.
 void Reversed::Forward(bool debug, const NetworkIO &input, const TransposedArray *input_transpose,
                        NetworkScratch *scratch, NetworkIO *output) {
+  NETWORK_FORWARD_SCOPE(input, output);
   NetworkScratch::IO rev_input(input, scratch);
   ReverseData(input, rev_input);
   NetworkScratch::IO rev_output(input, scratch);
@@ -18,6 +18,7 @@
 #include "series.h"
 
 #include "fullyconnected.h"
+#include "networkprofile.h"
 #include "networkscratch.h"
 #include "scrollview.h"
 #include "tprintf.h"
@@ -105,6 +106,7 @@ void Series::CacheXScaleFactor(int factor) {
 // See NetworkCpp for a detailed discussion of the arguments.
 void Series::Forward(bool debug, const NetworkIO &input, const TransposedArray *input_transpose,
                      NetworkScratch *scratch, NetworkIO *output) {
+  NETWORK_FORWARD_SCOPE(input, output);
   int stack_size = stack_.size();
   ASSERT_HOST(stack_size > 1);
   // Revolving intermediate buffers.
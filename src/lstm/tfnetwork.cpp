@@ -21,6 +21,7 @@
 
 #  include <allheaders.h>
 #  include "input.h"
+#  include "networkprofile.h"
 #  include "networkscratch.h"
 
 using tensorflow::Status;
@@ -68,6 +69,7 @@ bool TFNetwork::DeSerialize(TFile *fp) {
 // See Network for a detailed discussion of the arguments.
 void TFNetwork::Forward(bool debug, const NetworkIO &input, const TransposedArray *input_transpose,
                         NetworkScratch *scratch, NetworkIO *output) {
+  NETWORK_FORWARD_SCOPE(input, output);
   std::vector<std::pair<std::string, Tensor>> tf_inputs;
   int depth = input_shape_.depth();
   ASSERT_HOST(depth == input.NumFeatures());
@@ -126,6 +126,12 @@ int WeightMatrix::RemapOutputs(const std::vector<int> &code_map) {
 // Compute the max absolute value of the weight set.
 // Scale so the max absolute value becomes INT8_MAX.
 // Round to integer.
+size_t WeightMatrix::MemoryUsed() const {
+  return wf_.MemoryUsed() + wi_.MemoryUsed() + wf_t_.MemoryUsed() +
+         scales_.capacity() * sizeof(scales_[0]) + dw_.MemoryUsed() + updates_.MemoryUsed() +
+         dw_sq_sum_.MemoryUsed();
+}
+
 // Store a multiplicative scale factor (as a double) that will reproduce
 // the original value, subject to rounding errors.
 void WeightMatrix::ConvertToInt() {
@@ -154,8 +160,22 @@ void WeightMatrix::ConvertToInt() {
   wf_.Resize(1, 1, 0.0);
   int_mode_ = true;
   if (IntSimdMatrix::intSimdMatrix) {
+    int_simd_ = IntSimdMatrix::intSimdMatrix;
+    int32_t rounded_num_out;
+    int_simd_->Init(wi_, shaped_w_, rounded_num_out);
+    scales_.resize(rounded_num_out);
+  }
+}
+
+void WeightMatrix::TuneIntSimd(bool batched) {
+  if (!int_mode_ || int_simd_ == nullptr || IntSimdMatrix::intSimdMatrix == nullptr) {
+    return;
+  }
+  const IntSimdMatrix *tuned = IntSimdMatrix::intSimdMatrix->Tune(wi_, batched);
+  if (tuned != int_simd_) {
+    int_simd_ = tuned;
     int32_t rounded_num_out;
-    IntSimdMatrix::intSimdMatrix->Init(wi_, shaped_w_, rounded_num_out);
+    int_simd_->Init(wi_, shaped_w_, rounded_num_out);
     scales_.resize(rounded_num_out);
   }
 }
@@ -250,8 +270,9 @@ bool WeightMatrix::DeSerialize(bool training, TFile *fp) {
       scale /= INT8_MAX;
     }
     if (IntSimdMatrix::intSimdMatrix) {
+      int_simd_ = IntSimdMatrix::intSimdMatrix;
       int32_t rounded_num_out;
-      IntSimdMatrix::intSimdMatrix->Init(wi_, shaped_w_, rounded_num_out);
+      int_simd_->Init(wi_, shaped_w_, rounded_num_out);
       scales_.resize(rounded_num_out);
     }
   } else {
@@ -319,14 +340,27 @@ void WeightMatrix::MatrixDotVector(const double *u, double *v) const {
 
 void WeightMatrix::MatrixDotVector(const int8_t *u, double *v) const {
   assert(int_mode_);
-  if (IntSimdMatrix::intSimdMatrix) {
-    IntSimdMatrix::intSimdMatrix->matrixDotVectorFunction(wi_.dim1(), wi_.dim2(), &shaped_w_[0],
-                                                          &scales_[0], u, v);
+  if (IntSimdMatrix::intSimdMatrix && int_simd_ != nullptr) {
+    int_simd_->matrixDotVectorFunction(wi_.dim1(), wi_.dim2(), &shaped_w_[0], &scales_[0], u, v);
   } else {
     IntSimdMatrix::MatrixDotVector(wi_, scales_, u, v);
   }
 }
 
+void WeightMatrix::MatrixDotVectors(int num_rows, const int8_t *const *u,
+                                    double *const *v) const {
+  assert(int_mode_);
+  if (IntSimdMatrix::intSimdMatrix && int_simd_ != nullptr &&
+      int_simd_->matrixDotVectorsFunction != nullptr) {
+    int_simd_->matrixDotVectorsFunction(wi_.dim1(), wi_.dim2(), &shaped_w_[0], &scales_[0],
+                                        num_rows, u, v);
+  } else {
+    for (int r = 0; r < num_rows; ++r) {
+      MatrixDotVector(u[r], v[r]);
+    }
+  }
+}
+
 // MatrixDotVector for peep weights, MultiplyAccumulate adds the
 // component-wise products of *this[0] and v to inout.
 void WeightMatrix::MultiplyAccumulate(const double *v, double *inout) {
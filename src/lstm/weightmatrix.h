@@ -68,7 +68,7 @@ public:
 // backward steps with the matrix and updates to the weights.
 class WeightMatrix {
 public:
-  WeightMatrix() : int_mode_(false), use_adam_(false) {}
+  WeightMatrix() : int_mode_(false), use_adam_(false), int_simd_(nullptr) {}
   // Sets up the network for training. Initializes weights using weights of
   // scale `range` picked according to the random number generator `randomizer`.
   // Note the order is outputs, inputs, as this is the order of indices to
@@ -90,6 +90,10 @@ public:
   // Store a multiplicative scale factor (as a float) that will reproduce
   // the original value, subject to rounding errors.
   void ConvertToInt();
+  // Times the variants of the SIMD implementation for the shape of the int
+  // weights and reshapes them for the fastest. batched is true if the
+  // weights are mostly used by MatrixDotVectors.
+  void TuneIntSimd(bool batched);
   // Returns the size rounded up to an internal factor used by the SIMD
   // implementation for its input.
   int RoundInputs(int size) const {
@@ -106,6 +110,8 @@ public:
   int NumOutputs() const {
     return int_mode_ ? wi_.dim1() : wf_.dim1();
   }
+  // Returns the number of bytes of the weights and of the training state.
+  size_t MemoryUsed() const;
   // Provides one set of weights. Only used by peep weight maxpool.
   const double *GetWeights(int index) const {
     return wf_[index];
@@ -134,6 +140,10 @@ public:
   // Asserts that the call matches what we have.
   void MatrixDotVector(const double *u, double *v) const;
   void MatrixDotVector(const int8_t *u, double *v) const;
+  // As MatrixDotVector for each of num_rows inputs u[r] and outputs v[r],
+  // but reads the weights once for several inputs if the SIMD
+  // implementation can.
+  void MatrixDotVectors(int num_rows, const int8_t *const *u, double *const *v) const;
   // MatrixDotVector for peep weights, MultiplyAccumulate adds the
   // component-wise products of *this[0] and v to inout.
   void MultiplyAccumulate(const double *v, double *inout);
@@ -185,6 +195,8 @@ private:
   GENERIC_2D_ARRAY<double> dw_sq_sum_;
   // The weights matrix reorganized in whatever way suits this instance.
   std::vector<int8_t> shaped_w_;
+  // The SIMD implementation which shaped_w_ was made for.
+  const IntSimdMatrix *int_simd_;
 };
 
 } // namespace tesseract.
@@ -832,14 +832,26 @@ BaselineDetect::BaselineDetect(int debug_level, const FCOORD &page_skew, TO_BLOC
 // Finds the initial baselines for each TO_ROW in each TO_BLOCK, gathers
 // block-wise and page-wise data to smooth small blocks/rows, and applies
 // smoothing based on block/page-level skew and block-level linespacing.
+// The blocks are fitted in parallel if OpenMP is available and there is no
+// debug output. Only the page skew depends on other blocks, and it is the
+// median of the block skews in block order, so the result does not depend
+// on the number of threads.
 void BaselineDetect::ComputeStraightBaselines(bool use_box_bottoms) {
-  std::vector<double> block_skew_angles;
-  for (auto bl_block : blocks_) {
+  int num_blocks = blocks_.size();
+  std::vector<char> good_skews(num_blocks);
+#ifdef _OPENMP
+#  pragma omp parallel for schedule(dynamic) if (debug_level_ == 0 && num_blocks > 1)
+#endif
+  for (int b = 0; b < num_blocks; ++b) {
     if (debug_level_ > 0) {
       tprintf("Fitting initial baselines...\n");
     }
-    if (bl_block->FitBaselinesAndFindSkew(use_box_bottoms)) {
-      block_skew_angles.push_back(bl_block->skew_angle());
+    good_skews[b] = blocks_[b]->FitBaselinesAndFindSkew(use_box_bottoms);
+  }
+  std::vector<double> block_skew_angles;
+  for (int b = 0; b < num_blocks; ++b) {
+    if (good_skews[b]) {
+      block_skew_angles.push_back(blocks_[b]->skew_angle());
     }
   }
   // Compute a page-wide default skew for blocks with too little information.
@@ -852,21 +864,32 @@ void BaselineDetect::ComputeStraightBaselines(bool use_box_bottoms) {
   }
   // Set bad lines in each block to the default block skew and then force fit
   // a linespacing model where it makes sense to do so.
-  for (auto bl_block : blocks_) {
-    bl_block->ParallelizeBaselines(default_block_skew);
-    bl_block->SetupBlockParameters(); // This replaced compute_row_stats.
+#ifdef _OPENMP
+#  pragma omp parallel for schedule(dynamic) if (debug_level_ == 0 && num_blocks > 1)
+#endif
+  for (int b = 0; b < num_blocks; ++b) {
+    blocks_[b]->ParallelizeBaselines(default_block_skew);
+    blocks_[b]->SetupBlockParameters(); // This replaced compute_row_stats.
   }
 }
 
 // Computes the baseline splines for each TO_ROW in each TO_BLOCK and
 // other associated side-effects, including pre-associating blobs, computing
 // x-heights and displaying debug information.
+// The blocks are independent, so they are processed in parallel as in
+// ComputeStraightBaselines unless anything is displayed.
 // NOTE that ComputeStraightBaselines must have been called first as this
 // sets up data in the TO_ROWs upon which this function depends.
 void BaselineDetect::ComputeBaselineSplinesAndXheights(const ICOORD &page_tr, bool enable_splines,
                                                        bool remove_noise, bool show_final_rows,
                                                        Textord *textord) {
-  for (auto bl_block : blocks_) {
+  int num_blocks = blocks_.size();
+#ifdef _OPENMP
+#  pragma omp parallel for schedule(dynamic) if (debug_level_ == 0 && !show_final_rows && \
+                                                 !textord_show_final_blobs && num_blocks > 1)
+#endif
+  for (int b = 0; b < num_blocks; ++b) {
+    BaselineBlock *bl_block = blocks_[b];
     if (enable_splines) {
       bl_block->PrepareForSplineFitting(page_tr, remove_noise);
     }
@@ -24,6 +24,7 @@
 
 #include "clst.h"
 #include "coutln.h"
+#include "memorystats.h"
 #include "rect.h"
 #include "scrollview.h"
 
@@ -222,6 +223,8 @@ protected:
   BBC_CLIST *grid_; // 2-d array of CLISTS of BBC elements.
 
 private:
+  // The cells of grid_, charged to MEMORY_GRIDS.
+  MemoryCharge memory_charge_;
 };
 
 // Hash functor for generic pointers.
@@ -494,6 +497,7 @@ void BBGrid<BBC, BBC_CLIST, BBC_C_IT>::Init(int gridsize, const ICOORD &bleft,
   GridBase::Init(gridsize, bleft, tright);
   delete[] grid_;
   grid_ = new BBC_CLIST[gridbuckets_];
+  memory_charge_.Set(MEMORY_GRIDS, gridbuckets_ * sizeof(BBC_CLIST));
 }
 
 // Clear all lists, but leave the array of lists present.
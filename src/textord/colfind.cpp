@@ -34,7 +34,9 @@
 #include "linefind.h"
 #include "normalis.h"
 #include "params.h"
+#include "profiler.h"
 #include "scrollview.h"
+#include "stagestats.h" // for STAGE_COUNT_EVENT
 #include "strokewidth.h"
 #include "tablefind.h"
 #include "workingpartset.h"
@@ -287,6 +289,7 @@ int ColumnFinder::FindBlocks(PageSegMode pageseg_mode, Pix *scaled_color, int sc
                              TO_BLOCK *input_block, Pix *photo_mask_pix, Pix *thresholds_pix,
                              Pix *grey_pix, DebugPixa *pixa_debug, BLOCK_LIST *blocks,
                              BLOBNBOX_LIST *diacritic_blobs, TO_BLOCK_LIST *to_blocks) {
+  PROFILE_SCOPE("ColumnFinder::FindBlocks");
   pixOr(photo_mask_pix, photo_mask_pix, nontext_map_);
   stroke_width_->FindLeaderPartitions(input_block, &part_grid_);
   stroke_width_->RemoveLineResidue(&big_parts_);
@@ -971,12 +974,15 @@ void ColumnFinder::ReleaseBlobsAndCleanupUnused(TO_BLOCK *block) {
 
 // Splits partitions that cross columns where they have nothing in the gap.
 void ColumnFinder::GridSplitPartitions() {
+  PROFILE_SCOPE("ColumnFinder::GridSplitPartitions");
+  STAGE_COUNT_EVENT(COUNTER_PARTITION_PASSES, 1);
   // Iterate the ColPartitions in the grid.
   GridSearch<ColPartition, ColPartition_CLIST, ColPartition_C_IT> gsearch(&part_grid_);
   gsearch.StartFullSearch();
   ColPartition *dont_repeat = nullptr;
   ColPartition *part;
   while ((part = gsearch.NextFullSearch()) != nullptr) {
+    STAGE_COUNT_EVENT(COUNTER_PARTITION_VISITS, 1);
     if (part->blob_type() < BRT_UNKNOWN || part == dont_repeat) {
       continue; // Only applies to text partitions.
     }
@@ -1067,11 +1073,14 @@ void ColumnFinder::GridSplitPartitions() {
 // Merges partitions where there is vertical overlap, within a single column,
 // and the horizontal gap is small enough.
 void ColumnFinder::GridMergePartitions() {
+  PROFILE_SCOPE("ColumnFinder::GridMergePartitions");
+  STAGE_COUNT_EVENT(COUNTER_PARTITION_PASSES, 1);
   // Iterate the ColPartitions in the grid.
   GridSearch<ColPartition, ColPartition_CLIST, ColPartition_C_IT> gsearch(&part_grid_);
   gsearch.StartFullSearch();
   ColPartition *part;
   while ((part = gsearch.NextFullSearch()) != nullptr) {
+    STAGE_COUNT_EVENT(COUNTER_PARTITION_VISITS, 1);
     if (part->IsUnMergeableType()) {
       continue;
     }
@@ -1105,6 +1114,7 @@ void ColumnFinder::GridMergePartitions() {
       if (neighbour == part || neighbour->IsUnMergeableType()) {
         continue;
       }
+      STAGE_COUNT_EVENT(COUNTER_MERGE_CANDIDATES, 1);
       const TBOX &neighbour_box = neighbour->bounding_box();
       if (debug) {
         tprintf("Considering merge with neighbour at:");
@@ -1362,11 +1372,14 @@ void ColumnFinder::SetPartitionTypes() {
 // Only images remain with multiple types in a run of partners.
 // Sets the type of all in the group to the maximum of the group.
 void ColumnFinder::SmoothPartnerRuns() {
+  PROFILE_SCOPE("ColumnFinder::SmoothPartnerRuns");
+  STAGE_COUNT_EVENT(COUNTER_PARTITION_PASSES, 1);
   // Iterate the ColPartitions in the grid.
   GridSearch<ColPartition, ColPartition_CLIST, ColPartition_C_IT> gsearch(&part_grid_);
   gsearch.StartFullSearch();
   ColPartition *part;
   while ((part = gsearch.NextFullSearch()) != nullptr) {
+    STAGE_COUNT_EVENT(COUNTER_PARTITION_VISITS, 1);
     ColPartition *partner = part->SingletonPartner(true);
     if (partner != nullptr) {
       if (partner->SingletonPartner(false) != part) {
@@ -23,6 +23,8 @@
 #include "colpartitiongrid.h"
 #include "colpartitionset.h"
 #include "imagefind.h"
+#include "profiler.h"   // for PROFILE_SCOPE
+#include "stagestats.h" // for STAGE_COUNT_EVENT
 
 #include <algorithm>
 
@@ -95,11 +97,14 @@ void ColPartitionGrid::HandleClick(int x, int y) {
 void ColPartitionGrid::Merges(
     std::function<bool(ColPartition *, TBOX *)> box_cb,
     std::function<bool(const ColPartition *, const ColPartition *)> confirm_cb) {
+  PROFILE_SCOPE("ColPartitionGrid::Merges");
+  STAGE_COUNT_EVENT(COUNTER_PARTITION_PASSES, 1);
   // Iterate the ColPartitions in the grid.
   ColPartitionGridSearch gsearch(this);
   gsearch.StartFullSearch();
   ColPartition *part;
   while ((part = gsearch.NextFullSearch()) != nullptr) {
+    STAGE_COUNT_EVENT(COUNTER_PARTITION_VISITS, 1);
     if (MergePart(box_cb, confirm_cb, part)) {
       gsearch.RepositionIterator();
     }
@@ -221,15 +226,19 @@ static bool OKMergeCandidate(const ColPartition *part, const ColPartition *candi
 // the overlap with them uncombined.
 // An overlap is not counted if passes the OKMergeOverlap test with ok_overlap
 // as the pixel overlap limit. merge1 and merge2 must both be non-nullptr.
+// The increase over the parts which are not flagged in is_candidate is
+// returned in non_candidate_increase, which saves a second pass over the
+// parts for the non-candidate neighbours.
 static int IncreaseInOverlap(const ColPartition *merge1, const ColPartition *merge2, int ok_overlap,
-                             ColPartition_CLIST *parts) {
+                             const std::vector<ColPartition *> &parts,
+                             const std::vector<bool> &is_candidate, int *non_candidate_increase) {
   ASSERT_HOST(merge1 != nullptr && merge2 != nullptr);
   int total_area = 0;
-  ColPartition_C_IT it(parts);
+  *non_candidate_increase = 0;
   TBOX merged_box(merge1->bounding_box());
   merged_box += merge2->bounding_box();
-  for (it.mark_cycle_pt(); !it.cycled_list(); it.forward()) {
-    ColPartition *part = it.data();
+  for (size_t i = 0; i < parts.size(); ++i) {
+    ColPartition *part = parts[i];
     if (part == merge1 || part == merge2) {
       continue;
     }
@@ -237,28 +246,55 @@ static int IncreaseInOverlap(const ColPartition *merge1, const ColPartition *mer
     // Compute the overlap of the merged box with part.
     int overlap_area = part_box.intersection(merged_box).area();
     if (overlap_area > 0 && !part->OKMergeOverlap(*merge1, *merge2, ok_overlap, false)) {
-      total_area += overlap_area;
+      int part_area = overlap_area;
       // Subtract the overlap of merge1 and merge2 individually.
       overlap_area = part_box.intersection(merge1->bounding_box()).area();
       if (overlap_area > 0) {
-        total_area -= overlap_area;
+        part_area -= overlap_area;
       }
       TBOX intersection_box = part_box.intersection(merge2->bounding_box());
       overlap_area = intersection_box.area();
       if (overlap_area > 0) {
-        total_area -= overlap_area;
+        part_area -= overlap_area;
         // Add back the 3-way area.
         intersection_box &= merge1->bounding_box(); // In-place intersection.
         overlap_area = intersection_box.area();
         if (overlap_area > 0) {
-          total_area += overlap_area;
+          part_area += overlap_area;
         }
       }
+      total_area += part_area;
+      if (!is_candidate[i]) {
+        *non_candidate_increase += part_area;
+      }
     }
   }
   return total_area;
 }
 
+// Copies the sorted parts list to a vector and flags the parts which
+// CLIST::set_subtract would remove for the sorted candidates list.
+static void FlagCandidates(ColPartition_CLIST *parts, ColPartition_CLIST *candidates,
+                           std::vector<ColPartition *> *part_vector,
+                           std::vector<bool> *is_candidate) {
+  ColPartition_C_IT p_it(parts);
+  ColPartition_C_IT c_it(candidates);
+  for (p_it.mark_cycle_pt(); !p_it.cycled_list(); p_it.forward()) {
+    ColPartition *part = p_it.data();
+    ColPartition *candidate = nullptr;
+    if (!c_it.empty()) {
+      candidate = c_it.data();
+      while (!c_it.at_last() && SortByBoxLeft<ColPartition>(&candidate, &part) < 0) {
+        c_it.forward();
+        candidate = c_it.data();
+      }
+    }
+    part_vector->push_back(part);
+    is_candidate->push_back(candidate != nullptr &&
+                            SortByBoxLeft<ColPartition>(&candidate, &part) == 0);
+  }
+}
+
 // Helper function to test that each partition in candidates is either a
 // good diacritic merge with part or an OK merge candidate with all others
 // in the candidates list.
@@ -433,8 +469,9 @@ ColPartition *ColPartitionGrid::BestMergeCandidate(
   // candidates that overlap each other when merged. If the worst
   // non-candidate overlap is better than the best overlap, then return
   // the worst non-candidate overlap instead.
-  ColPartition_CLIST non_candidate_neighbours;
-  non_candidate_neighbours.set_subtract(SortByBoxLeft<ColPartition>, true, &neighbours, candidates);
+  std::vector<ColPartition *> neighbour_vector;
+  std::vector<bool> is_candidate;
+  FlagCandidates(&neighbours, candidates, &neighbour_vector, &is_candidate);
   int worst_nc_increase = 0;
   int best_increase = INT32_MAX;
   int best_area = 0;
@@ -447,7 +484,10 @@ ColPartition *ColPartitionGrid::BestMergeCandidate(
       }
       continue;
     }
-    int increase = IncreaseInOverlap(part, candidate, ok_overlap, &neighbours);
+    STAGE_COUNT_EVENT(COUNTER_MERGE_CANDIDATES, 1);
+    int nc_increase;
+    int increase = IncreaseInOverlap(part, candidate, ok_overlap, neighbour_vector, is_candidate,
+                                     &nc_increase);
     const TBOX &cand_box = candidate->bounding_box();
     if (best_candidate == nullptr || increase < best_increase) {
       best_candidate = candidate;
@@ -466,9 +506,8 @@ ColPartition *ColPartitionGrid::BestMergeCandidate(
         best_candidate = candidate;
       }
     }
-    increase = IncreaseInOverlap(part, candidate, ok_overlap, &non_candidate_neighbours);
-    if (increase > worst_nc_increase) {
-      worst_nc_increase = increase;
+    if (nc_increase > worst_nc_increase) {
+      worst_nc_increase = nc_increase;
     }
   }
   if (best_increase > 0) {
@@ -231,17 +231,29 @@ float make_rows(ICOORD page_tr, TO_BLOCK_LIST *port_blocks) {
   float port_err;       // global noise
   TO_BLOCK_IT block_it; // iterator
 
+  // The rows of the blocks are made in parallel unless they are displayed.
+  // Only the global skew depends on all blocks.
+  std::vector<TO_BLOCK *> blocks;
   block_it.set_to_list(port_blocks);
   for (block_it.mark_cycle_pt(); !block_it.cycled_list(); block_it.forward()) {
-    make_initial_textrows(page_tr, block_it.data(), FCOORD(1.0f, 0.0f), !textord_test_landscape);
+    blocks.push_back(block_it.data());
+  }
+  int num_blocks = blocks.size();
+#ifdef _OPENMP
+#  pragma omp parallel for schedule(dynamic) if (!textord_show_initial_rows && num_blocks > 1)
+#endif
+  for (int b = 0; b < num_blocks; ++b) {
+    make_initial_textrows(page_tr, blocks[b], FCOORD(1.0f, 0.0f), !textord_test_landscape);
   }
   // compute globally
   compute_page_skew(port_blocks, port_m, port_err);
-  block_it.set_to_list(port_blocks);
-  for (block_it.mark_cycle_pt(); !block_it.cycled_list(); block_it.forward()) {
-    cleanup_rows_making(page_tr, block_it.data(), port_m, FCOORD(1.0f, 0.0f),
-                        block_it.data()->block->pdblk.bounding_box().left(),
-                        !textord_test_landscape);
+#ifdef _OPENMP
+#  pragma omp parallel for schedule(dynamic) if (!textord_show_parallel_rows && \
+                                                 !textord_show_expanded_rows && num_blocks > 1)
+#endif
+  for (int b = 0; b < num_blocks; ++b) {
+    cleanup_rows_making(page_tr, blocks[b], port_m, FCOORD(1.0f, 0.0f),
+                        blocks[b]->block->pdblk.bounding_box().left(), !textord_test_landscape);
   }
   return port_m; // global skew
 }
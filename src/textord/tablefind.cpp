@@ -22,11 +22,13 @@
 
 #include <algorithm>
 #include <cmath>
+#include <vector>
 #include "tablefind.h"
 
 #include <allheaders.h>
 
 #include "colpartitionset.h"
+#include "profiler.h"
 #include "tablerecog.h"
 #include "tabletransfer.h"
 
@@ -140,6 +142,10 @@ const double kMaxXProjectionGapFactor = 2.0;
 const double kStrokeWidthFractionalTolerance = 0.25;
 const double kStrokeWidthConstantTolerance = 2.0;
 
+// Minimum number of rows of candidate table cells for the pre-screen to
+// consider a table plausible. A table column needs at least two cells.
+const int kMinPlausibleTableRows = 2;
+
 #ifndef GRAPHICS_DISABLED
 static BOOL_VAR(textord_show_tables, false, "Show table regions (ScrollView)");
 static BOOL_VAR(textord_tablefind_show_mark, false,
@@ -149,6 +155,9 @@ static BOOL_VAR(textord_tablefind_show_stats, false,
 #endif
 static BOOL_VAR(textord_tablefind_recognize_tables, false,
                 "Enables the table recognizer for table layout and filtering.");
+static BOOL_VAR(textord_tablefind_prescreen, true,
+                "Skip table detection on pages without leaders, vertical rulings"
+                " or rows of candidate table cells.");
 
 ELISTIZE(ColSegment)
 CLISTIZE(ColSegment)
@@ -261,6 +270,24 @@ void TableFinder::InsertCleanPartitions(ColPartitionGrid *grid, TO_BLOCK *block)
 // High level function to perform table detection
 void TableFinder::LocateTables(ColPartitionGrid *grid, ColPartitionSet **all_columns,
                                WidthCallback width_cb, const FCOORD &reskew) {
+  PROFILE_SCOPE("TableFinder::LocateTables");
+  bool show_steps = false;
+#ifndef GRAPHICS_DISABLED
+  show_steps = textord_show_tables || textord_tablefind_show_mark;
+#endif
+  // Most pages are prose, so skip the neighbours, spacings and columns
+  // if no table is plausible. The pre-screen compares the partitions with
+  // the median x-height and blob width of the clean partitions, so those
+  // are set first. MakeTableBlocks with an empty table_grid_ only reverts
+  // the table types in grid.
+  if (textord_tablefind_prescreen && !show_steps) {
+    SetGlobalSpacings(&clean_part_grid_);
+    if (!TablesArePlausible()) {
+      MakeTableBlocks(grid, all_columns, width_cb);
+      return;
+    }
+  }
+
   // initialize spacing, neighbors, and columns
   InitializePartitions(all_columns);
 
@@ -279,6 +306,11 @@ void TableFinder::LocateTables(ColPartitionGrid *grid, ColPartitionSet **all_col
 
   // mark, filter, and smooth candidate table partitions
   MarkTablePartitions();
+  // Without table partitions there are no table columns, so no regions.
+  if (!show_steps && !HasTablePartitions()) {
+    MakeTableBlocks(grid, all_columns, width_cb);
+    return;
+  }
 
   // Make single-column blocks from good_columns_ partitions. col_segments are
   // moved to a grid later which takes the ownership
@@ -820,6 +852,64 @@ void TableFinder::MarkTablePartitions() {
 #endif
 }
 
+// Only partitions marked in MarkPartitionsUsingLocalInformation can seed a
+// table, and a table column needs two of them, which are rows of a table or
+// cells side by side. Rows with a wide gap and rows with several candidates
+// are counted with the same tests as there, but without the neighbours and
+// spacings, which are the expensive part. Leaders mark partitions next to
+// them, and vertical rulings are kept as a sign of a lined table, so either
+// makes a table plausible.
+bool TableFinder::TablesArePlausible() {
+  ColPartitionGridSearch lsearch(&leader_and_ruling_grid_);
+  lsearch.StartFullSearch();
+  ColPartition *part = nullptr;
+  while ((part = lsearch.NextFullSearch()) != nullptr) {
+    if (part->flow() == BTFT_LEADER || part->IsVerticalLine()) {
+      return true;
+    }
+  }
+  // Number of candidate cells whose middle is in each row of the grid.
+  std::vector<int> row_candidates(gridheight());
+  int table_rows = 0;
+  ColPartitionGridSearch gsearch(&clean_part_grid_);
+  gsearch.StartFullSearch();
+  while ((part = gsearch.NextFullSearch()) != nullptr) {
+    if (!part->IsTextType() ||
+        part->median_height() > kMaxTableCellXheight * global_median_xheight_) {
+      continue;
+    }
+    if (part->flow() == BTFT_LEADER) {
+      return true;
+    }
+    bool wide_gap = false;
+    if (!HasWideOrNoInterWordGap(part, &wide_gap)) {
+      continue;
+    }
+    int grid_x, grid_y;
+    clean_part_grid_.GridCoords(part->bounding_box().left(), part->MidY(), &grid_x, &grid_y);
+    int candidates = ++row_candidates[grid_y];
+    if (wide_gap || candidates == 2) {
+      ++table_rows;
+    }
+    if (table_rows >= kMinPlausibleTableRows) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool TableFinder::HasTablePartitions() {
+  ColPartitionGridSearch gsearch(&clean_part_grid_);
+  gsearch.StartFullSearch();
+  ColPartition *part = nullptr;
+  while ((part = gsearch.NextFullSearch()) != nullptr) {
+    if (part->type() == PT_TABLE) {
+      return true;
+    }
+  }
+  return false;
+}
+
 // These types of partitions are marked as table partitions:
 //  1- Partitions that have at lease one large gap between words
 //  2- Partitions that consist of only one word (no significant gap
@@ -857,9 +947,12 @@ void TableFinder::MarkPartitionsUsingLocalInformation() {
 
 // Check if the partition has at least one large gap between words or no
 // significant gap at all
-bool TableFinder::HasWideOrNoInterWordGap(ColPartition *part) const {
+bool TableFinder::HasWideOrNoInterWordGap(ColPartition *part, bool *wide_gap) const {
   // Should only get text partitions.
   ASSERT_HOST(part->IsTextType());
+  if (wide_gap != nullptr) {
+    *wide_gap = false;
+  }
   // Blob access
   BLOBNBOX_CLIST *part_boxes = part->boxes();
   BLOBNBOX_C_IT it(part_boxes);
@@ -911,6 +1004,9 @@ bool TableFinder::HasWideOrNoInterWordGap(ColPartition *part) const {
 
       // If a large enough gap is found, mark it as a table cell (return true)
       if (gap > max_gap) {
+        if (wide_gap != nullptr) {
+          *wide_gap = true;
+        }
         return true;
       }
       if (gap > largest_partition_gap_found) {
@@ -1858,22 +1954,32 @@ void TableFinder::RecognizeTables() {
   recognizer.set_text_grid(&fragmented_text_grid_);
   recognizer.set_max_text_height(global_median_xheight_ * 2.0);
   recognizer.set_min_height(1.5 * gridheight());
-  // Loop over all of the tables and try to fit them.
-  // Store the good tables here.
-  ColSegment_CLIST good_tables;
-  ColSegment_C_IT good_it(&good_tables);
-
+  // Take all of the tables out of the grid. The structure of each is found
+  // on its own, reading only the line and text grids, so they can be
+  // searched in parallel. The results are kept in the order of the grid.
+  std::vector<ColSegment *> found_tables;
   ColSegmentGridSearch gsearch(&table_grid_);
   gsearch.StartFullSearch();
   ColSegment *found_table = nullptr;
   while ((found_table = gsearch.NextFullSearch()) != nullptr) {
     gsearch.RemoveBBox();
+    found_tables.push_back(found_table);
+  }
+  int num_tables = found_tables.size();
+  std::vector<StructuredTable *> structures(num_tables);
+#ifdef _OPENMP
+#  pragma omp parallel for schedule(dynamic) if (table_win == nullptr && num_tables > 1)
+#endif
+  for (int t = 0; t < num_tables; ++t) {
+    structures[t] = recognizer.RecognizeTable(found_tables[t]->bounding_box());
+  }
 
-    // The goal is to make the tables persistent in a list.
-    // When that happens, this will move into the search loop.
-    const TBOX &found_box = found_table->bounding_box();
-    StructuredTable *table_structure = recognizer.RecognizeTable(found_box);
-
+  // Store the good tables here.
+  ColSegment_CLIST good_tables;
+  ColSegment_C_IT good_it(&good_tables);
+  for (int t = 0; t < num_tables; ++t) {
+    found_table = found_tables[t];
+    StructuredTable *table_structure = structures[t];
     // Process a table. Good tables are inserted into the grid again later on
     // We can't change boxes in the grid while it is running a search.
     if (table_structure != nullptr) {
@@ -226,6 +226,14 @@ protected:
   ////////   Table Detection in Heterogeneous Documents (2010, Shafait & Smith)
   ////////
 
+  // Cheap test, before the partitions are initialized, whether the page may
+  // contain a table at all. It looks for leaders and vertical rulings, and
+  // for rows of candidate table cells: partitions with a wide gap between
+  // words, or several candidates side by side at the same height.
+  bool TablesArePlausible();
+  // Returns true if a partition in clean_part_grid_ is marked as table.
+  bool HasTablePartitions();
+
   // High level function to mark partitions as table rows/cells.
   // When this function is done, the column partitions in clean_part_grid_
   // should mostly be marked as tables.
@@ -234,9 +242,10 @@ protected:
   void MarkPartitionsUsingLocalInformation();
   /////// Heuristics for local marking
   // Check if the partition has at least one large gap between words or no
-  // significant gap at all
+  // significant gap at all. If wide_gap is not null, it is set to whether
+  // a large gap was found.
   // TODO(nbeato): Make const, prevented because blobnbox array access
-  bool HasWideOrNoInterWordGap(ColPartition *part) const;
+  bool HasWideOrNoInterWordGap(ColPartition *part, bool *wide_gap = nullptr) const;
   // Checks if a partition is adjacent to leaders on the page
   bool HasLeaderAdjacent(const ColPartition &part);
   // Filter individual text partitions marked as table partitions
@@ -19,6 +19,7 @@
 
 #include "commontraining.h" // CheckSharedLibraryVersion
 #include "lstmrecognizer.h"
+#include "networkprofile.h" // NetworkProfile
 #include "tessdatamanager.h"
 
 #include <cerrno>
@@ -173,6 +174,19 @@ int main(int argc, char **argv) {
   } else if (argc == 3 && strcmp(argv[1], "-d") == 0) {
     // Initialize TessdataManager with the data in the given traineddata file.
     tm.Init(argv[2]);
+    tm.Directory();
+    // List the layers of the LSTM network with their estimated work.
+    tesseract::TFile fp;
+    if (tm.GetComponent(tesseract::TESSDATA_LSTM, &fp)) {
+      tesseract::LSTMRecognizer recognizer;
+      if (!recognizer.DeSerialize(&tm, &fp)) {
+        tprintf("Failed to deserialize LSTM in %s!\n", argv[2]);
+        return EXIT_FAILURE;
+      }
+      tesseract::NetworkProfile profile(recognizer.network());
+      tprintf("LSTM network %s:\n%s", recognizer.GetNetwork(), profile.Report().c_str());
+    }
+    return EXIT_SUCCESS;
   } else if (argc == 3 && strcmp(argv[1], "-l") == 0) {
     if (!tm.Init(argv[2])) {
       tprintf("Failed to read %s\n", argv[2]);
@@ -223,7 +237,8 @@ int main(int argc, char **argv) {
         "  (e.g. %s -l eng.traineddata)\n\n",
         argv[0], argv[0]);
     printf(
-        "Usage for listing directory of components:\n"
+        "Usage for listing directory of components and the layers of the\n"
+        "LSTM network:\n"
         "  %s -d traineddata_file\n\n",
         argv[0]);
     printf(
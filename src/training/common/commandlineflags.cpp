@@ -21,7 +21,7 @@ namespace tesseract {
 static bool IntFlagExists(const char *flag_name, int32_t *value) {
   std::string full_flag_name("FLAGS_");
   full_flag_name += flag_name;
-  std::vector<IntParam *> empty;
+  ParamsList<IntParam> empty;
   auto *p =
       ParamUtils::FindParam<IntParam>(full_flag_name.c_str(), GlobalParams()->int_params, empty);
   if (p == nullptr) {
@@ -34,7 +34,7 @@ static bool IntFlagExists(const char *flag_name, int32_t *value) {
 static bool DoubleFlagExists(const char *flag_name, double *value) {
   std::string full_flag_name("FLAGS_");
   full_flag_name += flag_name;
-  std::vector<DoubleParam *> empty;
+  ParamsList<DoubleParam> empty;
   auto *p = ParamUtils::FindParam<DoubleParam>(full_flag_name.c_str(),
                                                GlobalParams()->double_params, empty);
   if (p == nullptr) {
@@ -47,7 +47,7 @@ static bool DoubleFlagExists(const char *flag_name, double *value) {
 static bool BoolFlagExists(const char *flag_name, bool *value) {
   std::string full_flag_name("FLAGS_");
   full_flag_name += flag_name;
-  std::vector<BoolParam *> empty;
+  ParamsList<BoolParam> empty;
   auto *p =
       ParamUtils::FindParam<BoolParam>(full_flag_name.c_str(), GlobalParams()->bool_params, empty);
   if (p == nullptr) {
@@ -60,7 +60,7 @@ static bool BoolFlagExists(const char *flag_name, bool *value) {
 static bool StringFlagExists(const char *flag_name, const char **value) {
   std::string full_flag_name("FLAGS_");
   full_flag_name += flag_name;
-  std::vector<StringParam *> empty;
+  ParamsList<StringParam> empty;
   auto *p = ParamUtils::FindParam<StringParam>(full_flag_name.c_str(),
                                                GlobalParams()->string_params, empty);
   *value = (p != nullptr) ? p->c_str() : nullptr;
@@ -70,7 +70,7 @@ static bool StringFlagExists(const char *flag_name, const char **value) {
 static void SetIntFlagValue(const char *flag_name, const int32_t new_val) {
   std::string full_flag_name("FLAGS_");
   full_flag_name += flag_name;
-  std::vector<IntParam *> empty;
+  ParamsList<IntParam> empty;
   auto *p =
       ParamUtils::FindParam<IntParam>(full_flag_name.c_str(), GlobalParams()->int_params, empty);
   ASSERT_HOST(p != nullptr);
@@ -80,7 +80,7 @@ static void SetIntFlagValue(const char *flag_name, const int32_t new_val) {
 static void SetDoubleFlagValue(const char *flag_name, const double new_val) {
   std::string full_flag_name("FLAGS_");
   full_flag_name += flag_name;
-  std::vector<DoubleParam *> empty;
+  ParamsList<DoubleParam> empty;
   auto *p = ParamUtils::FindParam<DoubleParam>(full_flag_name.c_str(),
                                                GlobalParams()->double_params, empty);
   ASSERT_HOST(p != nullptr);
@@ -90,7 +90,7 @@ static void SetDoubleFlagValue(const char *flag_name, const double new_val) {
 static void SetBoolFlagValue(const char *flag_name, const bool new_val) {
   std::string full_flag_name("FLAGS_");
   full_flag_name += flag_name;
-  std::vector<BoolParam *> empty;
+  ParamsList<BoolParam> empty;
   auto *p =
       ParamUtils::FindParam<BoolParam>(full_flag_name.c_str(), GlobalParams()->bool_params, empty);
   ASSERT_HOST(p != nullptr);
@@ -100,7 +100,7 @@ static void SetBoolFlagValue(const char *flag_name, const bool new_val) {
 static void SetStringFlagValue(const char *flag_name, const char *new_val) {
   std::string full_flag_name("FLAGS_");
   full_flag_name += flag_name;
-  std::vector<StringParam *> empty;
+  ParamsList<StringParam> empty;
   auto *p = ParamUtils::FindParam<StringParam>(full_flag_name.c_str(),
                                                GlobalParams()->string_params, empty);
   ASSERT_HOST(p != nullptr);
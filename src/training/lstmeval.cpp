@@ -28,6 +28,8 @@ static STRING_PARAM_FLAG(traineddata, "",
 static STRING_PARAM_FLAG(eval_listfile, "", "File listing sample files in lstmf training format.");
 static INT_PARAM_FLAG(max_image_MB, 2000, "Max memory to use for images.");
 static INT_PARAM_FLAG(verbosity, 1, "Amount of diagnosting information to output (0-2).");
+static BOOL_PARAM_FLAG(profile_layers, false,
+                       "Output the time and estimated work of each layer of the network.");
 
 int main(int argc, char **argv) {
   tesseract::CheckSharedLibraryVersion();
@@ -64,8 +66,14 @@ int main(int argc, char **argv) {
     return 1;
   }
   double errs = 0.0;
-  std::string result = tester.RunEvalSync(0, &errs, mgr,
-                                          /*training_stage (irrelevant)*/ 0, FLAGS_verbosity);
+  std::string layer_profile;
+  std::string result =
+      tester.RunEvalSync(0, &errs, mgr,
+                         /*training_stage (irrelevant)*/ 0, FLAGS_verbosity,
+                         FLAGS_profile_layers ? &layer_profile : nullptr);
   tprintf("%s\n", result.c_str());
+  if (!layer_profile.empty()) {
+    tprintf("%s", layer_profile.c_str());
+  }
   return 0;
 } /* main */
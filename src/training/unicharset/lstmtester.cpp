@@ -16,8 +16,9 @@
 ///////////////////////////////////////////////////////////////////////
 
 #include "lstmtester.h"
-#include <thread>   // for std::thread
-#include "fileio.h" // for LoadFileLinesToStrings
+#include <thread>           // for std::thread
+#include "fileio.h"         // for LoadFileLinesToStrings
+#include "networkprofile.h" // for NetworkProfile
 
 namespace tesseract {
 
@@ -78,13 +79,14 @@ std::string LSTMTester::RunEvalAsync(int iteration, const double *training_error
 // describing the results.
 std::string LSTMTester::RunEvalSync(int iteration, const double *training_errors,
                                     const TessdataManager &model_mgr, int training_stage,
-                                    int verbosity) {
+                                    int verbosity, std::string *layer_profile) {
   LSTMTrainer trainer;
   trainer.InitCharSet(model_mgr);
   TFile fp;
   if (!model_mgr.GetComponent(TESSDATA_LSTM, &fp) || !trainer.DeSerialize(&model_mgr, &fp)) {
     return "Deserialize failed";
   }
+  trainer.SetLayerProfiling(layer_profile != nullptr);
   int eval_iteration = 0;
   double char_error = 0.0;
   double word_error = 0.0;
@@ -110,6 +112,9 @@ std::string LSTMTester::RunEvalSync(int iteration, const double *training_errors
   }
   char_error *= 100.0 / total_pages_;
   word_error *= 100.0 / total_pages_;
+  if (layer_profile != nullptr && trainer.layer_profile() != nullptr) {
+    *layer_profile = trainer.layer_profile()->Report();
+  }
   std::string result;
   result += "At iteration " + std::to_string(iteration);
   result += ", stage " + std::to_string(training_stage);
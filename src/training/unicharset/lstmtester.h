@@ -58,9 +58,11 @@ public:
                            const TessdataManager &model_mgr, int training_stage);
   // Runs an evaluation synchronously on the stored eval data and returns a
   // string describing the results. Args as RunEvalAsync, except verbosity,
-  // which outputs errors, if 1, or all results if 2.
+  // which outputs errors, if 1, or all results if 2, and layer_profile,
+  // which if not null receives the NetworkProfile report of the model.
   std::string RunEvalSync(int iteration, const double *training_errors, const TessdataManager &model_mgr,
-                          int training_stage, int verbosity);
+                          int training_stage, int verbosity,
+                          std::string *layer_profile = nullptr);
 
 private:
   // Helper thread function for RunEvalAsync.
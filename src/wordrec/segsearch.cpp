@@ -24,6 +24,7 @@
 #include "matrix.h"         // for MATRIX_COORD, MATRIX
 #include "pageres.h"        // for WERD_RES
 #include "params.h"         // for BoolParam, IntParam, DoubleParam
+#include "profiler.h"       // for PROFILE_SCOPE
 #include "ratngs.h"         // for BLOB_CHOICE_LIST, BLOB_CHOICE_IT
 #include "tprintf.h"        // for tprintf
 #include "wordrec.h"        // for Wordrec, SegSearchPending (ptr only)
@@ -38,6 +39,7 @@ void Wordrec::DoSegSearch(WERD_RES *word_res) {
 
 void Wordrec::SegSearch(WERD_RES *word_res, BestChoiceBundle *best_choice_bundle,
                         BlamerBundle *blamer_bundle) {
+  PROFILE_SCOPE("SegSearch");
   LMPainPoints pain_points(segsearch_max_pain_points, segsearch_max_char_wh_ratio,
                            assume_fixed_pitch_char_segment, &getDict(), segsearch_debug_level);
   // Compute scaling factor that will help us recover blob outline length
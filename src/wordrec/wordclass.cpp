@@ -20,10 +20,11 @@
           I N C L U D E S
 ----------------------------------------------------------------------*/
 
-#include "blamer.h"  // for blamer_bundle
-#include "params.h"  // for BoolParam
-#include "render.h"  // for display_blob, blob_window, wordrec_blob_pause
-#include "wordrec.h" // for Wordrec
+#include "blamer.h"   // for blamer_bundle
+#include "params.h"   // for BoolParam
+#include "profiler.h" // for PROFILE_SCOPE
+#include "render.h"   // for display_blob, blob_window, wordrec_blob_pause
+#include "wordrec.h"  // for Wordrec
 
 class BLOB_CHOICE_LIST;
 
@@ -51,6 +52,7 @@ namespace tesseract {
  */
 BLOB_CHOICE_LIST *Wordrec::classify_blob(TBLOB *blob, const char *string, ScrollView::Color color,
                                          BlamerBundle *blamer_bundle) {
+  PROFILE_SCOPE("classify_blob");
 #ifndef GRAPHICS_DISABLED
   if (wordrec_display_all_blobs) {
     display_blob(blob, color);
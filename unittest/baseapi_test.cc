@@ -16,22 +16,36 @@
 #include "ocrblock.h"   // for class BLOCK
 #include "pageres.h"
 
+#include <tesseract/asyncapi.h>
 #include <tesseract/baseapi.h>
+#include <tesseract/logsink.h>
+#include <tesseract/renderer.h>
 
 #include <allheaders.h>
 #include "absl/strings/ascii.h"
 #include "absl/strings/str_cat.h"
 #include "gmock/gmock-matchers.h"
 
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
 #include <memory>
 #include <regex>
+#include <set>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace tesseract {
 
 using ::testing::ContainsRegex;
+using ::testing::EndsWith;
 using ::testing::HasSubstr;
+using ::testing::Not;
+using ::testing::StartsWith;
 
 static const char *langs[] = {"eng", "vie", "hin", "ara", nullptr};
 static const char *image_files[] = {"HelloGoogle.tif", "viet.tif", "raaj.tif", "arabic.tif",
@@ -53,6 +67,16 @@ std::string GetCleanedTextResult(tesseract::TessBaseAPI *tess, Pix *pix) {
   return ocr_result;
 }
 
+// Returns the text of GetCleanedTextResult without any whitespace, for
+// comparing the words of results whose layout may differ.
+static std::string GetTextWithoutSpaces(tesseract::TessBaseAPI *tess, Pix *pix) {
+  std::string text = GetCleanedTextResult(tess, pix);
+  text.erase(std::remove_if(text.begin(), text.end(),
+                            [](char c) { return isspace(static_cast<unsigned char>(c)); }),
+             text.end());
+  return text;
+}
+
 // The fixture for testing Tesseract.
 class TesseractTest : public testing::Test {
 protected:
@@ -300,6 +324,818 @@ TEST_F(TesseractTest, InitConfigOnlyTest) {
   }
 }
 
+// Tests that pipelined processing of a file list renders the same text, in the
+// same page order, as the sequential processing.
+TEST_F(TesseractTest, PipelinedProcessPagesMatchesSequential) {
+  file::MakeTmpdir();
+  const std::string filelist = file::JoinPath(FLAGS_test_tmpdir, "pipeline_filelist.txt");
+  const std::string pages = TestDataNameToPath("phototest.tif") + "\n" +
+                            TestDataNameToPath("HelloGoogle.tif") + "\n" +
+                            TestDataNameToPath("phototest.tif") + "\n";
+  CHECK_OK(file::SetContents(filelist, pages, file::Defaults()));
+  std::string text[2];
+  for (int workers = 0; workers < 2; ++workers) {
+    tesseract::TessBaseAPI api;
+    if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+      // eng.traineddata not found.
+      GTEST_SKIP();
+      return;
+    }
+    api.SetVariable("pipeline_workers", workers == 0 ? "0" : "2");
+    const std::string outputbase =
+        file::JoinPath(FLAGS_test_tmpdir, absl::StrCat("pipeline", workers));
+    {
+      tesseract::TessTextRenderer renderer(outputbase.c_str());
+      EXPECT_TRUE(api.ProcessPages(filelist.c_str(), nullptr, 0, &renderer));
+    }
+    // pipeline_workers is a global parameter.
+    api.SetVariable("pipeline_workers", "0");
+    CHECK_OK(file::GetContents(outputbase + ".txt", &text[workers], file::Defaults()));
+  }
+  EXPECT_THAT(text[0], HasSubstr("Hello"));
+  EXPECT_EQ(text[0], text[1]);
+}
+
+// Tests that the lines streamed by TessAsyncRecognition match the text lines
+// of the finished page.
+TEST_F(TesseractTest, AsyncRecognitionStreamsLines) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+    return;
+  }
+  Pix *src_pix = pixRead(TestDataNameToPath("phototest.tif").c_str());
+  CHECK(src_pix);
+  api.SetImage(src_pix);
+  std::vector<tesseract::RecognizedLine> lines;
+  {
+    tesseract::TessAsyncRecognition recognition(&api);
+    tesseract::RecognizedLine line;
+    while (recognition.NextLine(&line, true)) {
+      lines.push_back(line);
+    }
+    EXPECT_TRUE(recognition.IsDone());
+    EXPECT_EQ(0, recognition.Wait());
+    EXPECT_FALSE(recognition.IsCancelled());
+  }
+  std::unique_ptr<tesseract::ResultIterator> it(api.GetIterator());
+  ASSERT_TRUE(it != nullptr);
+  size_t i = 0;
+  do {
+    ASSERT_LT(i, lines.size());
+    std::unique_ptr<char[]> text(it->GetUTF8Text(tesseract::RIL_TEXTLINE));
+    std::string expected = text.get();
+    absl::StripAsciiWhitespace(&expected);
+    EXPECT_EQ(expected, lines[i].text);
+    int left, top, right, bottom;
+    it->BoundingBox(tesseract::RIL_TEXTLINE, &left, &top, &right, &bottom);
+    EXPECT_EQ(left, lines[i].left);
+    EXPECT_EQ(top, lines[i].top);
+    ++i;
+  } while (it->Next(tesseract::RIL_TEXTLINE));
+  EXPECT_EQ(i, lines.size());
+  pixDestroy(&src_pix);
+}
+
+// Tests that a cancelled TessAsyncRecognition stops and reports failure.
+TEST_F(TesseractTest, AsyncRecognitionCancel) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+    return;
+  }
+  Pix *src_pix = pixRead(TestDataNameToPath("phototest.tif").c_str());
+  CHECK(src_pix);
+  api.SetImage(src_pix);
+  tesseract::TessAsyncRecognition recognition(&api);
+  // Layout analysis alone takes much longer than this.
+  recognition.Cancel();
+  EXPECT_EQ(-1, recognition.Wait());
+  EXPECT_TRUE(recognition.IsCancelled());
+  tesseract::RecognizedLine line;
+  EXPECT_FALSE(recognition.NextLine(&line, true));
+  pixDestroy(&src_pix);
+}
+
+// Returns the words of text, with the XML entities of the renderers replaced.
+static std::vector<std::string> SplitWords(const std::string &text) {
+  static const std::pair<const char *, const char *> kEntities[] = {
+      {"&lt;", "<"}, {"&gt;", ">"}, {"&quot;", "\""}, {"&#39;", "'"}, {"&apos;", "'"},
+      {"&amp;", "&"}};
+  std::string plain = text;
+  for (auto &entity : kEntities) {
+    plain = std::regex_replace(plain, std::regex(entity.first), entity.second);
+  }
+  std::istringstream stream(plain);
+  std::vector<std::string> words;
+  std::string word;
+  while (stream >> word) {
+    words.push_back(word);
+  }
+  return words;
+}
+
+// Tests that chained hOCR, ALTO and TSV renderers, which share a single walk
+// of the results, write complete documents with the words of the golden
+// text on each page.
+TEST_F(TesseractTest, ChainedRenderersMatchGoldenText) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+    return;
+  }
+  std::string truth_text;
+  CHECK_OK(
+      file::GetContents(TestDataNameToPath("phototest.gold.txt"), &truth_text, file::Defaults()));
+  std::vector<std::string> expected_words = SplitWords(truth_text);
+  // The document has the page twice.
+  expected_words.insert(expected_words.end(), expected_words.begin(), expected_words.end());
+  Pix *src_pix = pixRead(TestDataNameToPath("phototest_2.tif").c_str());
+  CHECK(src_pix);
+  api.SetImage(src_pix);
+  api.SetVariable("hocr_char_boxes", "1");
+  ASSERT_EQ(0, api.Recognize(nullptr));
+  file::MakeTmpdir();
+  const std::string outputbase = file::JoinPath(FLAGS_test_tmpdir, "chained");
+  {
+    tesseract::TessHOcrRenderer renderer(outputbase.c_str());
+    renderer.insert(new tesseract::TessAltoRenderer(outputbase.c_str()));
+    renderer.insert(new tesseract::TessTsvRenderer(outputbase.c_str()));
+    EXPECT_TRUE(renderer.BeginDocument("chained"));
+    EXPECT_TRUE(renderer.AddImage(&api));
+    EXPECT_TRUE(renderer.AddImage(&api));
+    EXPECT_TRUE(renderer.EndDocument());
+  }
+
+  std::string hocr;
+  CHECK_OK(file::GetContents(outputbase + ".hocr", &hocr, file::Defaults()));
+  EXPECT_THAT(hocr, StartsWith("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"));
+  EXPECT_THAT(hocr, EndsWith("  </div>\n </body>\n</html>\n"));
+  EXPECT_THAT(hocr, HasSubstr("<div class='ocr_page' id='page_2'"));
+  EXPECT_THAT(hocr, HasSubstr("ocrx_cinfo"));
+  const size_t body = hocr.find("<body>");
+  ASSERT_NE(std::string::npos, body);
+  EXPECT_EQ(expected_words,
+            SplitWords(std::regex_replace(hocr.substr(body), std::regex("<[^>]*>"), " ")));
+
+  std::string alto;
+  CHECK_OK(file::GetContents(outputbase + ".xml", &alto, file::Defaults()));
+  EXPECT_THAT(alto, EndsWith("\t\t</Page>\n\t</Layout>\n</alto>\n"));
+  std::string alto_text;
+  const std::regex content("CONTENT=\"([^\"]*)\"");
+  for (std::sregex_iterator it(alto.begin(), alto.end(), content), end; it != end; ++it) {
+    alto_text += (*it)[1].str() + " ";
+  }
+  EXPECT_EQ(expected_words, SplitWords(alto_text));
+
+  std::string tsv;
+  CHECK_OK(file::GetContents(outputbase + ".tsv", &tsv, file::Defaults()));
+  std::istringstream rows(tsv);
+  std::string row;
+  ASSERT_TRUE(std::getline(rows, row));
+  EXPECT_EQ(
+      "level\tpage_num\tblock_num\tpar_num\tline_num\tword_num\tleft\ttop\twidth\theight\tconf"
+      "\ttext",
+      row);
+  std::string tsv_text;
+  std::set<std::string> pages;
+  while (std::getline(rows, row)) {
+    std::vector<std::string> fields;
+    std::istringstream columns(row);
+    std::string field;
+    while (std::getline(columns, field, '\t')) {
+      fields.push_back(field);
+    }
+    ASSERT_GE(fields.size(), 11u) << row;
+    pages.insert(fields[1]);
+    if (fields[0] == "5" && fields.size() == 12) {
+      tsv_text += fields[11] + " ";
+    }
+  }
+  EXPECT_EQ(2u, pages.size());
+  EXPECT_EQ(expected_words, SplitWords(tsv_text));
+  pixDestroy(&src_pix);
+}
+
+// Tests that chained renderers which all write to stdout write their pages
+// one after another, in the order of the chain.
+TEST_F(TesseractTest, ChainedRenderersShareStdout) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+    return;
+  }
+  Pix *src_pix = pixRead(TestDataNameToPath("phototest.tif").c_str());
+  CHECK(src_pix);
+  api.SetImage(src_pix);
+  ASSERT_EQ(0, api.Recognize(nullptr));
+  std::unique_ptr<char[]> hocr(api.GetHOCRText(0));
+  std::unique_ptr<char[]> text(api.GetUTF8Text());
+  std::unique_ptr<char[]> tsv(api.GetTSVText(0));
+  ::testing::internal::CaptureStdout();
+  {
+    tesseract::TessHOcrRenderer renderer("stdout");
+    renderer.insert(new tesseract::TessTextRenderer("stdout"));
+    renderer.insert(new tesseract::TessTsvRenderer("stdout"));
+    EXPECT_TRUE(renderer.BeginDocument("shared"));
+    EXPECT_TRUE(renderer.AddImage(&api));
+    EXPECT_TRUE(renderer.EndDocument());
+  }
+  const std::string output = ::testing::internal::GetCapturedStdout();
+  const size_t hocr_page = output.find(hocr.get());
+  const size_t text_page = output.find(text.get());
+  const size_t tsv_page = output.find(tsv.get());
+  ASSERT_NE(std::string::npos, hocr_page);
+  ASSERT_NE(std::string::npos, text_page);
+  ASSERT_NE(std::string::npos, tsv_page);
+  EXPECT_LT(hocr_page, text_page);
+  EXPECT_LT(text_page, tsv_page);
+  pixDestroy(&src_pix);
+}
+
+// Tests that encoding the page images of a PDF in background threads writes
+// the same document as encoding them on the calling thread.
+TEST_F(TesseractTest, PDFBackgroundImageEncoding) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+    return;
+  }
+  Pix *src_pix = pixRead(TestDataNameToPath("phototest.tif").c_str());
+  CHECK(src_pix);
+  api.SetImage(src_pix);
+  api.SetSourceResolution(300);
+  ASSERT_EQ(0, api.Recognize(nullptr));
+  api.SetVariable("pdf_image_passthrough", "0");
+  file::MakeTmpdir();
+  std::string pdf[2];
+  for (int threads = 0; threads < 2; ++threads) {
+    api.SetVariable("pdf_encode_threads", threads == 0 ? "0" : "2");
+    const std::string outputbase =
+        file::JoinPath(FLAGS_test_tmpdir, absl::StrCat("encode", threads));
+    {
+      tesseract::TessPDFRenderer renderer(outputbase.c_str(), TessdataPath().c_str());
+      EXPECT_TRUE(renderer.BeginDocument("encode"));
+      for (int page = 0; page < 3; ++page) {
+        EXPECT_TRUE(renderer.AddImage(&api));
+      }
+      EXPECT_TRUE(renderer.EndDocument());
+    }
+    CHECK_OK(file::GetContents(outputbase + ".pdf", &pdf[threads], file::Defaults()));
+    // The documents only differ in their creation date.
+    pdf[threads] = std::regex_replace(pdf[threads], std::regex("/CreationDate \\([^)]*\\)"), "");
+  }
+  // These are global parameters.
+  api.SetVariable("pdf_encode_threads", "1");
+  api.SetVariable("pdf_image_passthrough", "1");
+  EXPECT_THAT(pdf[0], HasSubstr("/Subtype /Image"));
+  EXPECT_EQ(pdf[0], pdf[1]);
+  pixDestroy(&src_pix);
+}
+
+// Copies an 8 or 32 bit pix to a buffer in the format of the raw SetImage,
+// with each line padded to a multiple of 4 bytes.
+static std::vector<unsigned char> RawImageData(Pix *pix, int bytes_per_pixel,
+                                               int *bytes_per_line) {
+  const int width = pixGetWidth(pix);
+  const int height = pixGetHeight(pix);
+  *bytes_per_line = (width * bytes_per_pixel + 3) & ~3;
+  std::vector<unsigned char> data(*bytes_per_line * height);
+  for (int y = 0; y < height; ++y) {
+    const l_uint32 *line = pixGetData(pix) + y * pixGetWpl(pix);
+    unsigned char *raw = &data[y * *bytes_per_line];
+    for (int x = 0; x < width * bytes_per_pixel; ++x) {
+      raw[x] = GET_DATA_BYTE(line, x);
+    }
+  }
+  return data;
+}
+
+// Tests that recognizing borrowed grey and RGBA frames gives the same results
+// as recognizing copies of them.
+TEST_F(TesseractTest, BorrowedImageMatchesCopiedImage) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+    return;
+  }
+  Pix *src_pix = pixRead(TestDataNameToPath("phototest.tif").c_str());
+  CHECK(src_pix);
+  const int width = pixGetWidth(src_pix);
+  const int height = pixGetHeight(src_pix);
+  for (int bytes_per_pixel : {1, 4}) {
+    Pix *pix = bytes_per_pixel == 1 ? pixConvertTo8(src_pix, false) : pixConvertTo32(src_pix);
+    int bytes_per_line;
+    std::vector<unsigned char> frame = RawImageData(pix, bytes_per_pixel, &bytes_per_line);
+    pixDestroy(&pix);
+
+    api.SetImage(frame.data(), width, height, bytes_per_pixel, bytes_per_line);
+    std::unique_ptr<char[]> copied_text(api.GetUTF8Text());
+    Pix *copied_binary = api.GetThresholdedImage();
+    Pix *copied_grey = pixConvertTo8(api.GetInputImage(), false);
+
+    api.SetImageBorrowed(frame.data(), width, height, bytes_per_pixel, bytes_per_line);
+    std::unique_ptr<char[]> borrowed_text(api.GetUTF8Text());
+    Pix *borrowed_binary = api.GetThresholdedImage();
+    Pix *borrowed_grey = api.GetInputImage();
+    EXPECT_STREQ(copied_text.get(), borrowed_text.get());
+    int same = 0;
+    pixEqual(copied_grey, borrowed_grey, &same);
+    EXPECT_TRUE(same);
+    if (bytes_per_pixel == 1) {
+      // Greyscale is thresholded the same way.
+      pixEqual(copied_binary, borrowed_binary, &same);
+      EXPECT_TRUE(same);
+    }
+    pixDestroy(&borrowed_binary);
+
+    // The binary image of a rectangle has the source resolution, and the
+    // input image is the whole image, as for a copied image.
+    api.SetImageBorrowed(frame.data(), width, height, bytes_per_pixel, bytes_per_line);
+    api.SetSourceResolution(300);
+    api.SetRectangle(width / 4, height / 4, width / 2, height / 2);
+    borrowed_binary = api.GetThresholdedImage();
+    ASSERT_TRUE(borrowed_binary != nullptr);
+    EXPECT_EQ(width / 2, pixGetWidth(borrowed_binary));
+    EXPECT_EQ(300, pixGetXRes(borrowed_binary));
+    EXPECT_EQ(300, pixGetYRes(borrowed_binary));
+    pixEqual(copied_grey, api.GetInputImage(), &same);
+    EXPECT_TRUE(same);
+    pixDestroy(&copied_binary);
+    pixDestroy(&copied_grey);
+    pixDestroy(&borrowed_binary);
+    api.Clear();
+  }
+  pixDestroy(&src_pix);
+}
+
+// Tests that recognizing the text lines of a page as regions gives the text
+// of the lines, with per region settings.
+TEST_F(TesseractTest, RecognizeRegionsMatchesLines) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+    return;
+  }
+  Pix *src_pix = pixRead(TestDataNameToPath("phototest.tif").c_str());
+  CHECK(src_pix);
+  api.SetImage(src_pix);
+  std::vector<tesseract::TessBaseAPI::Region> regions;
+  std::vector<std::string> line_texts;
+  std::unique_ptr<tesseract::ResultIterator> it(api.GetIterator());
+  ASSERT_TRUE(it != nullptr);
+  do {
+    std::unique_ptr<char[]> text(it->GetUTF8Text(tesseract::RIL_TEXTLINE));
+    line_texts.emplace_back(text.get());
+    absl::StripAsciiWhitespace(&line_texts.back());
+    int left, top, right, bottom;
+    it->BoundingBox(tesseract::RIL_TEXTLINE, &left, &top, &right, &bottom);
+    tesseract::TessBaseAPI::Region region;
+    region.left = left;
+    region.top = top;
+    region.width = right - left;
+    region.height = bottom - top;
+    regions.push_back(region);
+  } while (it->Next(tesseract::RIL_TEXTLINE));
+  it.reset();
+  const size_t num_lines = regions.size();
+  ASSERT_GT(num_lines, 1);
+
+  // A whitelisted copy of the first line and the whole page as a block.
+  tesseract::TessBaseAPI::Region digits = regions[0];
+  digits.whitelist = "0123456789";
+  regions.push_back(digits);
+  tesseract::TessBaseAPI::Region page;
+  page.width = pixGetWidth(src_pix);
+  page.height = pixGetHeight(src_pix);
+  page.psm = tesseract::PSM_AUTO;
+  regions.push_back(page);
+
+  std::vector<tesseract::TessBaseAPI::RegionResult> results;
+  EXPECT_EQ(0, api.RecognizeRegions(regions, &results));
+  ASSERT_EQ(regions.size(), results.size());
+  for (size_t i = 0; i < num_lines; ++i) {
+    EXPECT_TRUE(results[i].ok);
+    EXPECT_EQ(line_texts[i], results[i].text);
+    EXPECT_GT(results[i].mean_confidence, 0);
+  }
+  EXPECT_TRUE(results[num_lines].ok);
+  EXPECT_THAT(results[num_lines].text, ::testing::MatchesRegex("[0-9 ]*"));
+  EXPECT_TRUE(results[num_lines + 1].ok);
+  EXPECT_THAT(results[num_lines + 1].text, HasSubstr(line_texts[0]));
+  EXPECT_THAT(results[num_lines + 1].text, HasSubstr("\n"));
+  // The settings of the api are restored.
+  EXPECT_EQ(tesseract::PSM_SINGLE_BLOCK, api.GetPageSegMode());
+  EXPECT_STREQ("", api.GetStringVariable("tessedit_char_whitelist"));
+  // The confidence of a region is that of MeanTextConf for the same words.
+  api.SetPageSegMode(tesseract::PSM_AUTO);
+  api.SetRectangle(page.left, page.top, page.width, page.height);
+  EXPECT_EQ(api.MeanTextConf(), results[num_lines + 1].mean_confidence);
+  pixDestroy(&src_pix);
+}
+
+// Tests that the page result objects of a page are made in the storage of
+// those of the previous page.
+TEST_F(TesseractTest, PageObjectsAreRecycled) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+    return;
+  }
+  Pix *src_pix = pixRead(TestDataNameToPath("phototest.tif").c_str());
+  CHECK(src_pix);
+  tesseract::TessBaseAPI::ReleaseRecycledMemory();
+  const std::string first_text = GetCleanedTextResult(&api, src_pix);
+  api.Clear();
+  const auto first = tesseract::TessBaseAPI::GetAllocatorStats();
+  EXPECT_EQ(first_text, GetCleanedTextResult(&api, src_pix));
+  api.Clear();
+  const auto second = tesseract::TessBaseAPI::GetAllocatorStats();
+  ASSERT_EQ(first.size(), second.size());
+  for (size_t i = 0; i < first.size(); ++i) {
+    EXPECT_STREQ(first[i].name, second[i].name);
+    EXPECT_GT(first[i].recycled, 0u);
+  }
+  // The second page has the same words, so it mostly reuses storage.
+  const auto &words = second[3];
+  EXPECT_STREQ("WERD_RES", words.name);
+  EXPECT_GT(words.reused - first[3].reused, words.allocated - first[3].allocated);
+  tesseract::TessBaseAPI::ReleaseRecycledMemory();
+  for (auto &stats : tesseract::TessBaseAPI::GetAllocatorStats()) {
+    EXPECT_EQ(0u, stats.cached);
+  }
+  pixDestroy(&src_pix);
+}
+
+// Tests that the single line fast path, which skips layout analysis, gives
+// the same text as the full path for line crops.
+TEST_F(TesseractTest, LineFastPathMatchesLayoutAnalysis) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+    return;
+  }
+  Pix *src_pix = pixRead(TestDataNameToPath("phototest.tif").c_str());
+  CHECK(src_pix);
+  api.SetImage(src_pix);
+  Boxa *boxes = api.GetComponentImages(tesseract::RIL_TEXTLINE, true, nullptr, nullptr);
+  ASSERT_TRUE(boxes != nullptr);
+  std::vector<Pix *> crops;
+  for (int i = 0; i < boxaGetCount(boxes); ++i) {
+    Box *box = boxaGetBox(boxes, i, L_CLONE);
+    crops.push_back(pixClipRectangle(src_pix, box, nullptr));
+    boxDestroy(&box);
+  }
+  boxaDestroy(&boxes);
+  ASSERT_FALSE(crops.empty());
+
+  for (auto psm : {tesseract::PSM_RAW_LINE, tesseract::PSM_SINGLE_WORD}) {
+    api.SetPageSegMode(psm);
+    std::vector<std::string> texts[2];
+    for (int fast_path : {0, 1}) {
+      api.SetVariable("line_fast_path", fast_path ? "1" : "0");
+      for (auto crop : crops) {
+        texts[fast_path].push_back(GetCleanedTextResult(&api, crop));
+      }
+    }
+    EXPECT_EQ(texts[0], texts[1]);
+  }
+
+  // The results of the fast path can be iterated as usual.
+  api.SetPageSegMode(tesseract::PSM_SINGLE_LINE);
+  api.SetVariable("line_fast_path", "2");
+  api.SetImage(crops[0]);
+  ASSERT_EQ(0, api.Recognize(nullptr));
+  std::unique_ptr<tesseract::ResultIterator> it(api.GetIterator());
+  ASSERT_TRUE(it != nullptr);
+  int words = 0;
+  do {
+    int left, top, right, bottom;
+    EXPECT_TRUE(it->BoundingBox(tesseract::RIL_WORD, &left, &top, &right, &bottom));
+    EXPECT_LE(right, pixGetWidth(crops[0]));
+    ++words;
+  } while (it->Next(tesseract::RIL_WORD));
+  EXPECT_GT(words, 1);
+  it.reset();
+  api.SetVariable("line_fast_path", "0");
+  for (auto crop : crops) {
+    pixDestroy(&crop);
+  }
+  pixDestroy(&src_pix);
+}
+
+// Tests that without paragraph detection each block is one paragraph and
+// the words are the same.
+TEST_F(TesseractTest, ParagraphDetectionCanBeSkipped) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+    return;
+  }
+  Pix *src_pix = pixRead(TestDataNameToPath("phototest.tif").c_str());
+  CHECK(src_pix);
+  std::string texts[2];
+  int paragraphs[2];
+  int blocks[2];
+  for (int detect : {1, 0}) {
+    api.SetVariable("paragraph_detection", detect ? "1" : "0");
+    texts[detect] = GetTextWithoutSpaces(&api, src_pix);
+    Boxa *para_boxes = api.GetComponentImages(tesseract::RIL_PARA, true, nullptr, nullptr);
+    Boxa *block_boxes = api.GetComponentImages(tesseract::RIL_BLOCK, true, nullptr, nullptr);
+    ASSERT_TRUE(para_boxes != nullptr);
+    ASSERT_TRUE(block_boxes != nullptr);
+    paragraphs[detect] = boxaGetCount(para_boxes);
+    blocks[detect] = boxaGetCount(block_boxes);
+    boxaDestroy(&para_boxes);
+    boxaDestroy(&block_boxes);
+  }
+  EXPECT_EQ(texts[1], texts[0]);
+  EXPECT_GE(paragraphs[1], blocks[1]);
+  EXPECT_EQ(paragraphs[0], blocks[0]);
+  api.SetVariable("paragraph_detection", "1");
+  pixDestroy(&src_pix);
+}
+
+// Tests that the stage times and counters cover the recognition of a page
+// and add up over pages.
+TEST_F(TesseractTest, StageStatsCoverRecognition) {
+#ifdef DISABLED_STAGE_STATS
+  GTEST_SKIP();
+#endif
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+    return;
+  }
+  Pix *src_pix = pixRead(TestDataNameToPath("phototest.tif").c_str());
+  CHECK(src_pix);
+  const auto start = std::chrono::steady_clock::now();
+  GetCleanedTextResult(&api, src_pix);
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  double page_seconds = 0.0;
+  for (auto &stats : api.GetStageStats()) {
+    EXPECT_EQ(stats.page_seconds, stats.total_seconds);
+    EXPECT_EQ(stats.page_count, stats.total_count);
+    page_seconds += stats.page_seconds;
+    std::string name = stats.name;
+    if (name == "threshold" || name == "layout" || name == "lstm_forward" ||
+        name == "beam_search" || name == "pages" || name == "lstm_lines" || name == "words" ||
+        name == "partition_passes" || name == "partition_visits") {
+      EXPECT_GT(stats.page_count, 0u) << name;
+    }
+    if (name == "legacy_classify" || name == "render") {
+      EXPECT_EQ(0u, stats.page_count) << name;
+    }
+  }
+  EXPECT_GT(page_seconds, 0.0);
+  EXPECT_LE(page_seconds, elapsed.count() + 0.01);
+  EXPECT_THAT(api.GetStageStatsJSON(), ContainsRegex("\"pages\":1[,}]"));
+
+  // A second page starts new page values and adds to the totals.
+  GetCleanedTextResult(&api, src_pix);
+  for (auto &stats : api.GetStageStats()) {
+    EXPECT_EQ(2 * stats.page_count, stats.total_count) << stats.name;
+  }
+  api.ResetStageStats();
+  for (auto &stats : api.GetStageStats()) {
+    EXPECT_EQ(0u, stats.total_count) << stats.name;
+  }
+  pixDestroy(&src_pix);
+}
+
+// Tests that the text profile skips paragraph detection without changing
+// the words, and that the skipped pass and the time saved are reported.
+TEST_F(TesseractTest, OutputProfileSkipsPasses) {
+#ifdef DISABLED_STAGE_STATS
+  GTEST_SKIP();
+#endif
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+    return;
+  }
+  Pix *src_pix = pixRead(TestDataNameToPath("phototest.tif").c_str());
+  CHECK(src_pix);
+  std::string texts[2];
+  for (int text_only : {0, 1}) {
+    api.SetVariable("tessedit_output_profile", text_only ? "text" : "");
+    texts[text_only] = GetTextWithoutSpaces(&api, src_pix);
+    for (auto &stats : api.GetStageStats()) {
+      std::string name = stats.name;
+      if (name == "paragraphs") {
+        EXPECT_EQ(text_only ? 0u : 1u, stats.page_count);
+      } else if (name == "skipped_passes") {
+        EXPECT_EQ(text_only ? 1u : 0u, stats.page_count);
+        // The paragraphs of the first page give the estimate.
+        if (text_only) {
+          EXPECT_GT(stats.page_seconds, 0.0);
+        }
+      }
+    }
+  }
+  EXPECT_EQ(texts[0], texts[1]);
+  EXPECT_THAT(api.GetStageStatsJSON(), ContainsRegex("\"skipped_passes\":1,\"saved_seconds\":"));
+
+  // After a reset the first page runs the skipped pass to measure it, but
+  // discards its paragraphs, so the next page has an estimate.
+  api.ResetStageStats();
+  EXPECT_EQ(texts[1], GetTextWithoutSpaces(&api, src_pix));
+  Boxa *para_boxes = api.GetComponentImages(tesseract::RIL_PARA, true, nullptr, nullptr);
+  Boxa *block_boxes = api.GetComponentImages(tesseract::RIL_BLOCK, true, nullptr, nullptr);
+  ASSERT_TRUE(para_boxes != nullptr);
+  ASSERT_TRUE(block_boxes != nullptr);
+  EXPECT_EQ(boxaGetCount(block_boxes), boxaGetCount(para_boxes));
+  boxaDestroy(&para_boxes);
+  boxaDestroy(&block_boxes);
+  for (auto &stats : api.GetStageStats()) {
+    std::string name = stats.name;
+    if (name == "paragraphs") {
+      EXPECT_EQ(1u, stats.page_count);
+    } else if (name == "skipped_passes") {
+      EXPECT_EQ(0u, stats.page_count);
+    }
+  }
+  GetCleanedTextResult(&api, src_pix);
+  for (auto &stats : api.GetStageStats()) {
+    if (std::string(stats.name) == "skipped_passes") {
+      EXPECT_EQ(1u, stats.page_count);
+      EXPECT_GT(stats.page_seconds, 0.0);
+    }
+  }
+
+  // Without a page on which the pass ran the time saved is unknown, until
+  // the pass runs.
+  api.SetVariable("paragraph_detection", "0");
+  api.ResetStageStats();
+  GetCleanedTextResult(&api, src_pix);
+  for (auto &stats : api.GetStageStats()) {
+    if (std::string(stats.name) == "skipped_passes") {
+      EXPECT_EQ(1u, stats.page_count);
+      EXPECT_EQ(-1.0, stats.page_seconds);
+      EXPECT_EQ(-1.0, stats.total_seconds);
+    }
+  }
+  EXPECT_THAT(api.GetStageStatsJSON(), HasSubstr("\"saved_seconds\":-1}"));
+  api.SetVariable("paragraph_detection", "1");
+  GetCleanedTextResult(&api, src_pix);
+  GetCleanedTextResult(&api, src_pix);
+  for (auto &stats : api.GetStageStats()) {
+    if (std::string(stats.name) == "skipped_passes") {
+      EXPECT_EQ(2u, stats.total_count);
+      EXPECT_GT(stats.total_seconds, 0.0);
+    }
+  }
+  api.SetVariable("tessedit_output_profile", "");
+  pixDestroy(&src_pix);
+}
+
+// Tests that the memory of a recognized page is accounted for, that the JSON
+// has the values of all subsystems, and that the peaks can be reset.
+TEST_F(TesseractTest, MemoryStatsCoverRecognition) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+    return;
+  }
+  Pix *src_pix = pixRead(TestDataNameToPath("phototest.tif").c_str());
+  CHECK(src_pix);
+  GetCleanedTextResult(&api, src_pix);
+  const std::vector<tesseract::TessBaseAPI::MemoryStats> stats = api.GetMemoryStats();
+  const std::string json = api.GetMemoryStatsJSON();
+  EXPECT_THAT(json, StartsWith("{\"lstm_weights\":"));
+  EXPECT_THAT(json, EndsWith("}}"));
+  size_t page_res_bytes = 0;
+  for (auto &subsystem : stats) {
+    std::string name = subsystem.name;
+    EXPECT_LE(subsystem.bytes, subsystem.page_peak) << name;
+    EXPECT_LE(subsystem.page_peak, subsystem.peak) << name;
+    if (name == "lstm_weights" || name == "images" || name == "page_res" || name == "total") {
+      EXPECT_GT(subsystem.bytes, 0u) << name;
+    }
+    if (name == "page_res") {
+      page_res_bytes = subsystem.bytes;
+    }
+    EXPECT_THAT(json, HasSubstr(absl::StrCat("\"", name, "\":{\"bytes\":", subsystem.bytes,
+                                             ",\"page_peak\":", subsystem.page_peak,
+                                             ",\"peak\":", subsystem.peak, "}")));
+  }
+
+  // Clear frees the results, which shows once the memory is measured.
+  api.Clear();
+  api.MeasureMemory();
+  for (auto &subsystem : api.GetMemoryStats()) {
+    if (std::string(subsystem.name) == "page_res") {
+      EXPECT_EQ(0u, subsystem.bytes);
+      EXPECT_GE(subsystem.peak, page_res_bytes);
+    }
+  }
+  api.ResetMemoryPeaks();
+  for (auto &subsystem : api.GetMemoryStats()) {
+    EXPECT_EQ(subsystem.bytes, subsystem.page_peak) << subsystem.name;
+    EXPECT_EQ(subsystem.bytes, subsystem.peak) << subsystem.name;
+  }
+  pixDestroy(&src_pix);
+}
+
+// Tests that a page written as a replay bundle is recognized again with the
+// same text, and that a second bundle of the same page gets its own name.
+TEST_F(TesseractTest, ReplayBundleRoundTrip) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+    return;
+  }
+  file::MakeTmpdir();
+  const std::string dir = FLAGS_test_tmpdir;
+  for (const char *name : {"phototest-0", "phototest-0-2"}) {
+    for (const char *extension : {".replay", ".png", ".bin.png", ".config"}) {
+      remove(file::JoinPath(dir, absl::StrCat(name, extension)).c_str());
+    }
+  }
+  const std::string input = TestDataNameToPath("phototest.tif");
+  Pix *src_pix = pixRead(input.c_str());
+  CHECK(src_pix);
+  const std::string expected_text = GetCleanedTextResult(&api, src_pix);
+  pixDestroy(&src_pix);
+
+  // The replay variables are global, so reset them before any check.
+  api.SetVariable("replay_dir", dir.c_str());
+  api.SetVariable("replay_min_seconds", "0");
+  const bool first_ok = api.ProcessPages(input.c_str(), nullptr, 0, nullptr);
+  const bool second_ok = api.ProcessPages(input.c_str(), nullptr, 0, nullptr);
+  api.SetVariable("replay_dir", "");
+  api.SetVariable("replay_min_seconds", "10");
+  ASSERT_TRUE(first_ok);
+  ASSERT_TRUE(second_ok);
+
+  for (const char *name : {"phototest-0", "phototest-0-2"}) {
+    const std::string manifest = file::JoinPath(dir, absl::StrCat(name, ".replay"));
+    std::string contents;
+    ASSERT_TRUE(file::GetContents(manifest, &contents, file::Defaults())) << manifest;
+    EXPECT_THAT(contents, HasSubstr(absl::StrCat("image ", name, ".png\n")));
+    tesseract::TessBaseAPI replay;
+    ASSERT_TRUE(replay.ReplayPage(manifest.c_str(), TessdataPath().c_str(), nullptr));
+    std::unique_ptr<char[]> result(replay.GetUTF8Text());
+    ASSERT_TRUE(result != nullptr);
+    std::string text = result.get();
+    absl::StripAsciiWhitespace(&text);
+    EXPECT_EQ(expected_text, text) << name;
+  }
+}
+
+// Collects the log messages of an api.
+class CollectingLogSink : public tesseract::LogSink {
+public:
+  void Write(const tesseract::LogRecord &record) override {
+    records.emplace_back(record.level, std::string(record.text, record.length));
+  }
+  std::vector<std::pair<tesseract::TessLogLevel, std::string>> records;
+};
+
+// Tests that the messages of each api go to its own sink, also when the
+// apis work in different threads at the same time.
+TEST_F(TesseractTest, LogSinkPerInstance) {
+  CollectingLogSink sinks[2];
+  const char *languages[2] = {"nosuchlang1", "nosuchlang2"};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 2; ++i) {
+    threads.emplace_back([&, i] {
+      tesseract::TessBaseAPI api;
+      api.SetLogSink(&sinks[i]);
+      EXPECT_EQ(-1, api.Init(TessdataPath().c_str(), languages[i], tesseract::OEM_LSTM_ONLY));
+      // Deleting the api writes the pending messages.
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (int i = 0; i < 2; ++i) {
+    bool found_error = false;
+    for (auto &record : sinks[i].records) {
+      EXPECT_THAT(record.second, Not(HasSubstr(languages[1 - i])));
+      if (record.first == tesseract::TESS_LOG_ERROR &&
+          record.second.find(languages[i]) != std::string::npos) {
+        found_error = true;
+      }
+    }
+    EXPECT_TRUE(found_error) << i;
+  }
+}
+
 // Tests if two instances of Tesseract/LSTM can co-exist in the same thread.
 // NOTE: This is not an exhaustive test and current support for multiple
 // instances in Tesseract is fragile. This test is intended largely as a means
@@ -0,0 +1,183 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Unit test for the recognition of many images with TessBatchAPI.
+
+#include <allheaders.h>
+#include <tesseract/baseapi.h>
+#include <tesseract/batchapi.h>
+#include "include_gunit.h"
+
+#include <atomic>
+#include <future>
+#include <string>
+#include <vector>
+
+namespace tesseract {
+
+class BatchAPITest : public ::testing::Test {
+protected:
+  static std::string TestDataNameToPath(const std::string &name) {
+    return file::JoinPath(TESTING_DIR, name);
+  }
+
+  // Returns the text of the image as recognized by a single TessBaseAPI.
+  static std::string SingleText(Pix *pix) {
+    TessBaseAPI api;
+    CHECK(api.Init(TESSDATA_DIR, "eng", OEM_LSTM_ONLY) == 0);
+    api.SetImage(pix);
+    char *text = api.GetUTF8Text();
+    std::string result = text;
+    delete[] text;
+    return result;
+  }
+};
+
+TEST_F(BatchAPITest, SubmitBeforeInitFails) {
+  TessBatchAPI batch;
+  EXPECT_EQ(0, batch.NumWorkers());
+  TessBatchAPI::Item item;
+  EXPECT_EQ(-1, batch.Submit(item, nullptr));
+  EXPECT_FALSE(batch.Submit(item).get().ok);
+}
+
+TEST_F(BatchAPITest, MatchesSingleAPIInSubmissionOrder) {
+  TessBatchAPI batch;
+  if (batch.Init(TESSDATA_DIR, "eng", OEM_LSTM_ONLY, 3) != 0) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+    return;
+  }
+  EXPECT_EQ(3, batch.NumWorkers());
+  const char *kImages[] = {"phototest.tif", "HelloGoogle.tif", "phototest.tif",
+                           "HelloGoogle.tif"};
+  std::vector<std::string> expected;
+  std::vector<std::future<TessBatchAPI::Result>> results;
+  for (auto image : kImages) {
+    Pix *pix = pixRead(TestDataNameToPath(image).c_str());
+    CHECK(pix != nullptr);
+    expected.push_back(SingleText(pix));
+    TessBatchAPI::Item item;
+    item.pix = pix;
+    results.push_back(batch.Submit(item));
+    // The batch holds its own reference.
+    pixDestroy(&pix);
+  }
+  for (size_t i = 0; i < results.size(); ++i) {
+    TessBatchAPI::Result result = results[i].get();
+    EXPECT_EQ(static_cast<int>(i), result.id);
+    EXPECT_TRUE(result.ok);
+    EXPECT_EQ(expected[i], result.text);
+    EXPECT_GE(result.recognize_seconds, 0.0);
+  }
+}
+
+TEST_F(BatchAPITest, PerItemSettingsAreRestored) {
+  TessBatchAPI batch;
+  if (batch.Init(TESSDATA_DIR, "eng", OEM_LSTM_ONLY, 1) != 0) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+    return;
+  }
+  Pix *pix = pixRead(TestDataNameToPath("HelloGoogle.tif").c_str());
+  CHECK(pix != nullptr);
+  TessBatchAPI::Item item;
+  item.pix = pix;
+  item.psm = PSM_SINGLE_LINE;
+  item.variables.emplace_back("tessedit_char_whitelist", "H");
+  std::atomic<int> calls(0);
+  batch.Submit(item, [&calls](const TessBatchAPI::Result &result, TessBaseAPI *api) {
+    ASSERT_TRUE(api != nullptr);
+    EXPECT_EQ(PSM_SINGLE_LINE, api->GetPageSegMode());
+    EXPECT_STREQ("H", api->GetStringVariable("tessedit_char_whitelist"));
+    ++calls;
+  });
+  TessBatchAPI::Item plain;
+  plain.pix = pix;
+  batch.Submit(plain, [&calls](const TessBatchAPI::Result &result, TessBaseAPI *api) {
+    ASSERT_TRUE(api != nullptr);
+    EXPECT_EQ(PSM_SINGLE_BLOCK, api->GetPageSegMode());
+    EXPECT_STREQ("", api->GetStringVariable("tessedit_char_whitelist"));
+    ++calls;
+  });
+  batch.Wait();
+  EXPECT_EQ(2, calls);
+  pixDestroy(&pix);
+}
+
+TEST_F(BatchAPITest, GlobalVariablesAreNotSet) {
+  TessBatchAPI batch;
+  if (batch.Init(TESSDATA_DIR, "eng", OEM_LSTM_ONLY, 1) != 0) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+    return;
+  }
+  Pix *pix = pixRead(TestDataNameToPath("HelloGoogle.tif").c_str());
+  CHECK(pix != nullptr);
+  TessBatchAPI::Item item;
+  item.pix = pix;
+  // debug_file is shared by all workers, so it cannot be set for an item.
+  item.variables.emplace_back("debug_file", "batch_item.log");
+  item.variables.emplace_back("tessedit_char_whitelist", "H");
+  batch.Submit(item, [](const TessBatchAPI::Result &result, TessBaseAPI *api) {
+    ASSERT_TRUE(api != nullptr);
+    EXPECT_STREQ("", api->GetStringVariable("debug_file"));
+    EXPECT_STREQ("H", api->GetStringVariable("tessedit_char_whitelist"));
+  });
+  batch.Wait();
+  pixDestroy(&pix);
+}
+
+TEST_F(BatchAPITest, EmptyRectangleIsTheWholeImage) {
+  TessBatchAPI batch;
+  if (batch.Init(TESSDATA_DIR, "eng", OEM_LSTM_ONLY, 1) != 0) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+    return;
+  }
+  Pix *pix = pixRead(TestDataNameToPath("phototest.tif").c_str());
+  CHECK(pix != nullptr);
+  const int width = pixGetWidth(pix);
+  const int height = pixGetHeight(pix);
+  std::string crop_text;
+  {
+    TessBaseAPI api;
+    CHECK(api.Init(TESSDATA_DIR, "eng", OEM_LSTM_ONLY) == 0);
+    api.SetImage(pix);
+    api.SetRectangle(0, 0, width, height / 2);
+    char *text = api.GetUTF8Text();
+    crop_text = text;
+    delete[] text;
+  }
+  TessBatchAPI::Item item;
+  item.pix = pix;
+  item.rectangles.push_back({0, 0, width, height / 2});
+  item.rectangles.push_back({0, 0, 0, 0});
+  TessBatchAPI::Result result = batch.Submit(item).get();
+  EXPECT_TRUE(result.ok);
+  EXPECT_EQ(crop_text + SingleText(pix), result.text);
+  pixDestroy(&pix);
+}
+
+TEST_F(BatchAPITest, UnreadableDataFails) {
+  TessBatchAPI batch;
+  if (batch.Init(TESSDATA_DIR, "eng", OEM_LSTM_ONLY, 1) != 0) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+    return;
+  }
+  TessBatchAPI::Item item;
+  item.data = "not an image";
+  TessBatchAPI::Result result = batch.Submit(item).get();
+  EXPECT_EQ(0, result.id);
+  EXPECT_FALSE(result.ok);
+}
+
+} // namespace tesseract
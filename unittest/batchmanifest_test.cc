@@ -0,0 +1,83 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Unit test for the manifest parsing of tesseract --batch.
+
+#include "batchmanifest.h"
+
+#include "include_gunit.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace tesseract {
+
+TEST(BatchManifestTest, TabSeparatesNamesWithSpaces) {
+  BatchJob job;
+  EXPECT_EQ(BatchLine::kJob, ParseBatchLine("my scans/page 1.png\tout dir/page 1", &job));
+  EXPECT_EQ("my scans/page 1.png", job.input);
+  EXPECT_EQ("out dir/page 1", job.outputbase);
+  EXPECT_EQ(BatchLine::kJob, ParseBatchLine("page.png\tpage\r", &job));
+  EXPECT_EQ("page.png", job.input);
+  EXPECT_EQ("page", job.outputbase);
+}
+
+TEST(BatchManifestTest, LineWithoutTabIsTheInput) {
+  BatchJob job;
+  EXPECT_EQ(BatchLine::kJob, ParseBatchLine("my scans/page 1.png", &job));
+  EXPECT_EQ("my scans/page 1.png", job.input);
+  EXPECT_EQ("my scans/page 1", job.outputbase);
+  EXPECT_EQ(BatchLine::kJob, ParseBatchLine("scans.d/page", &job));
+  EXPECT_EQ("scans.d/page", job.outputbase);
+}
+
+TEST(BatchManifestTest, SkipsEmptyLinesAndComments) {
+  BatchJob job;
+  EXPECT_EQ(BatchLine::kSkip, ParseBatchLine("", &job));
+  EXPECT_EQ(BatchLine::kSkip, ParseBatchLine("\r", &job));
+  EXPECT_EQ(BatchLine::kSkip, ParseBatchLine("# page.png\tpage", &job));
+}
+
+TEST(BatchManifestTest, RejectsMalformedLines) {
+  BatchJob job;
+  EXPECT_EQ(BatchLine::kInvalid, ParseBatchLine("page.png\t", &job));
+  EXPECT_EQ(BatchLine::kInvalid, ParseBatchLine("\tpage", &job));
+  EXPECT_EQ(BatchLine::kInvalid, ParseBatchLine("page.png\tpage\textra", &job));
+}
+
+TEST(BatchManifestTest, StdoutNames) {
+  EXPECT_TRUE(IsStdoutName("stdout"));
+  EXPECT_TRUE(IsStdoutName("-"));
+  EXPECT_FALSE(IsStdoutName("stdout.d/page"));
+}
+
+TEST(BatchManifestTest, ReadsJobsAndReportsInvalidLines) {
+  std::istringstream manifest(
+      "# scans\n"
+      "a b.png\ta b\n"
+      "\n"
+      "bad\t\n"
+      "c.tif\n");
+  std::vector<int> invalid;
+  auto report = [&](int line_number, const std::string &) { invalid.push_back(line_number); };
+  BatchJob job;
+  int line_number = 0;
+  ASSERT_TRUE(ReadBatchJob(manifest, &job, &line_number, report));
+  EXPECT_EQ("a b.png", job.input);
+  EXPECT_EQ("a b", job.outputbase);
+  ASSERT_TRUE(ReadBatchJob(manifest, &job, &line_number, report));
+  EXPECT_EQ("c.tif", job.input);
+  EXPECT_EQ("c", job.outputbase);
+  EXPECT_FALSE(ReadBatchJob(manifest, &job, &line_number, report));
+  EXPECT_EQ(std::vector<int>{4}, invalid);
+}
+
+} // namespace tesseract
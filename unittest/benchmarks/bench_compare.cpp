@@ -0,0 +1,404 @@
+///////////////////////////////////////////////////////////////////////
+// File:        bench_compare.cpp
+// Description: Compares two result files of tesseract_bench and flags
+//              the benchmarks which got slower.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// Usage: bench_compare [--threshold PERCENT] [--confidence LEVEL]
+//          [--resamples N] BASELINE.json CONTENDER.json
+//
+// For each benchmark in both files, the change of the median time per
+// iteration is computed together with a bootstrap confidence interval over
+// the timed runs. A benchmark is only reported as slower if the whole
+// interval is above the threshold, so noise does not fail the comparison.
+// The exit code is 1 if any benchmark is slower, 2 on errors and 0
+// otherwise, which makes it usable as a gate in scripts.
+
+#include <algorithm> // for std::sort
+#include <cctype>    // for isspace
+#include <cmath>     // for std::ceil, std::floor
+#include <cstdio>    // for printf, fprintf
+#include <cstdlib>   // for atof, atoi, strtod
+#include <cstring>   // for strcmp, strlen
+#include <fstream>   // for std::ifstream
+#include <map>       // for std::map
+#include <random>    // for std::mt19937
+#include <sstream>   // for std::stringstream
+#include <string>    // for std::string
+#include <vector>    // for std::vector
+
+namespace tesseract {
+
+// A value of the JSON which tesseract_bench writes. Only what is needed
+// for the comparison is supported: objects, arrays, strings without
+// unicode escapes, numbers and literals.
+struct JsonValue {
+  enum Type { NONE, NUMBER, STRING, ARRAY, OBJECT } type = NONE;
+  double number = 0.0;
+  std::string string;
+  std::vector<JsonValue> array;
+  std::map<std::string, JsonValue> object;
+
+  const JsonValue *Get(const std::string &key) const {
+    auto it = object.find(key);
+    return it != object.end() ? &it->second : nullptr;
+  }
+};
+
+class JsonParser {
+public:
+  explicit JsonParser(const std::string &text) : text_(text) {}
+
+  // Returns false if the text is not valid JSON.
+  bool Parse(JsonValue *value) {
+    return ParseValue(value) && (SkipSpace(), pos_ == text_.size());
+  }
+  size_t position() const {
+    return pos_;
+  }
+
+private:
+  void SkipSpace() {
+    while (pos_ < text_.size() && isspace(static_cast<unsigned char>(text_[pos_]))) {
+      ++pos_;
+    }
+  }
+  bool Expect(char c) {
+    SkipSpace();
+    if (pos_ < text_.size() && text_[pos_] == c) {
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+
+  bool ParseValue(JsonValue *value) {
+    SkipSpace();
+    if (pos_ >= text_.size()) {
+      return false;
+    }
+    char c = text_[pos_];
+    if (c == '{') {
+      ++pos_;
+      value->type = JsonValue::OBJECT;
+      if (Expect('}')) {
+        return true;
+      }
+      do {
+        std::string key;
+        SkipSpace();
+        if (!ParseString(&key) || !Expect(':') || !ParseValue(&value->object[key])) {
+          return false;
+        }
+      } while (Expect(','));
+      return Expect('}');
+    }
+    if (c == '[') {
+      ++pos_;
+      value->type = JsonValue::ARRAY;
+      if (Expect(']')) {
+        return true;
+      }
+      do {
+        value->array.emplace_back();
+        if (!ParseValue(&value->array.back())) {
+          return false;
+        }
+      } while (Expect(','));
+      return Expect(']');
+    }
+    if (c == '"') {
+      value->type = JsonValue::STRING;
+      return ParseString(&value->string);
+    }
+    for (const char *literal : {"true", "false", "null"}) {
+      if (text_.compare(pos_, strlen(literal), literal) == 0) {
+        pos_ += strlen(literal);
+        return true;
+      }
+    }
+    // Numbers are written in the "C" locale, which strtod uses as long as
+    // the program does not call setlocale.
+    const char *start = text_.c_str() + pos_;
+    char *end = nullptr;
+    value->number = strtod(start, &end);
+    if (end == start) {
+      return false;
+    }
+    pos_ += end - start;
+    value->type = JsonValue::NUMBER;
+    return true;
+  }
+
+  bool ParseString(std::string *str) {
+    if (pos_ >= text_.size() || text_[pos_] != '"') {
+      return false;
+    }
+    for (++pos_; pos_ < text_.size(); ++pos_) {
+      char c = text_[pos_];
+      if (c == '"') {
+        ++pos_;
+        return true;
+      }
+      if (c == '\\' && ++pos_ < text_.size()) {
+        c = text_[pos_];
+        switch (c) {
+          case 'n':
+            c = '\n';
+            break;
+          case 't':
+            c = '\t';
+            break;
+          case 'u':
+            // Not written by tesseract_bench, keep it as text.
+            *str += '\\';
+            break;
+          default:
+            break;
+        }
+      }
+      *str += c;
+    }
+    return false;
+  }
+
+  const std::string &text_;
+  size_t pos_ = 0;
+};
+
+// The runs of one benchmark in a result file.
+struct BenchmarkRuns {
+  std::vector<double> run_ns;
+  std::string error;
+};
+
+struct ResultFile {
+  std::map<std::string, std::string> context;
+  std::vector<std::string> names; // In the order of the file.
+  std::map<std::string, BenchmarkRuns> benchmarks;
+};
+
+static bool ReadResultFile(const char *filename, ResultFile *result) {
+  std::ifstream in(filename);
+  if (!in) {
+    fprintf(stderr, "Error, cannot read %s\n", filename);
+    return false;
+  }
+  std::stringstream buffer;
+  buffer << in.rdbuf();
+  std::string text = buffer.str();
+  JsonValue root;
+  JsonParser parser(text);
+  if (!parser.Parse(&root) || root.type != JsonValue::OBJECT) {
+    fprintf(stderr, "Error, invalid JSON in %s near offset %zu\n", filename, parser.position());
+    return false;
+  }
+  const JsonValue *context = root.Get("context");
+  if (context != nullptr) {
+    for (auto &entry : context->object) {
+      result->context[entry.first] = entry.second.string;
+    }
+  }
+  const JsonValue *benchmarks = root.Get("benchmarks");
+  if (benchmarks == nullptr || benchmarks->type != JsonValue::ARRAY) {
+    fprintf(stderr, "Error, %s has no benchmarks\n", filename);
+    return false;
+  }
+  for (auto &benchmark : benchmarks->array) {
+    const JsonValue *name = benchmark.Get("name");
+    if (name == nullptr || name->type != JsonValue::STRING) {
+      fprintf(stderr, "Error, benchmark without name in %s\n", filename);
+      return false;
+    }
+    BenchmarkRuns &runs = result->benchmarks[name->string];
+    result->names.push_back(name->string);
+    const JsonValue *error = benchmark.Get("error");
+    if (error != nullptr) {
+      runs.error = error->string;
+    }
+    const JsonValue *run_ns = benchmark.Get("run_ns");
+    if (run_ns != nullptr) {
+      for (auto &ns : run_ns->array) {
+        runs.run_ns.push_back(ns.number);
+      }
+    }
+    if (runs.run_ns.empty() && runs.error.empty()) {
+      runs.error = "no runs";
+    }
+  }
+  return true;
+}
+
+static double Median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  size_t middle = values.size() / 2;
+  return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+// The relative change of the median of the contender against the baseline
+// and its confidence interval.
+struct Change {
+  double change = 0.0;
+  double low = 0.0;
+  double high = 0.0;
+};
+
+// Estimates the confidence interval of the change of the medians by
+// resampling the runs of both sides. The seed is fixed, so the report of
+// the same files is always the same.
+static Change CompareRuns(const std::vector<double> &baseline,
+                          const std::vector<double> &contender, double confidence,
+                          int resamples) {
+  Change result;
+  result.change = Median(contender) / Median(baseline) - 1.0;
+  std::mt19937 random(1);
+  std::vector<double> changes;
+  std::vector<double> sample_b(baseline.size());
+  std::vector<double> sample_c(contender.size());
+  for (int r = 0; r < resamples; ++r) {
+    for (auto &value : sample_b) {
+      value = baseline[random() % baseline.size()];
+    }
+    for (auto &value : sample_c) {
+      value = contender[random() % contender.size()];
+    }
+    changes.push_back(Median(sample_c) / Median(sample_b) - 1.0);
+  }
+  std::sort(changes.begin(), changes.end());
+  double tail = (1.0 - confidence) / 2;
+  int low_index = static_cast<int>(std::floor(tail * (resamples - 1)));
+  int high_index = static_cast<int>(std::ceil((1.0 - tail) * (resamples - 1)));
+  result.low = changes[low_index];
+  result.high = changes[high_index];
+  return result;
+}
+
+static std::string FormatTime(double ns) {
+  char text[32];
+  if (ns >= 1e6) {
+    snprintf(text, sizeof(text), "%.3f ms", ns / 1e6);
+  } else if (ns >= 1e3) {
+    snprintf(text, sizeof(text), "%.3f us", ns / 1e3);
+  } else {
+    snprintf(text, sizeof(text), "%.1f ns", ns);
+  }
+  return text;
+}
+
+static void Usage(const char *program) {
+  fprintf(stderr,
+          "Usage: %s [--threshold PERCENT] [--confidence LEVEL] [--resamples N]"
+          " BASELINE.json CONTENDER.json\n"
+          "  --threshold PERCENT  Smallest slowdown which fails (default 5)\n"
+          "  --confidence LEVEL   Level of the confidence intervals (default 0.95)\n"
+          "  --resamples N        Bootstrap resamples (default 2000)\n",
+          program);
+}
+
+static int CompareFiles(int argc, char **argv) {
+  double threshold = 0.05;
+  double confidence = 0.95;
+  int resamples = 2000;
+  std::vector<const char *> files;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+      threshold = atof(argv[++i]) / 100.0;
+    } else if (strcmp(argv[i], "--confidence") == 0 && i + 1 < argc) {
+      confidence = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--resamples") == 0 && i + 1 < argc) {
+      resamples = atoi(argv[++i]);
+    } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+      Usage(argv[0]);
+      return 2;
+    } else {
+      files.push_back(argv[i]);
+    }
+  }
+  if (files.size() != 2 || threshold < 0.0 || confidence <= 0.0 || confidence >= 1.0 ||
+      resamples < 1) {
+    Usage(argv[0]);
+    return 2;
+  }
+  ResultFile baseline, contender;
+  if (!ReadResultFile(files[0], &baseline) || !ReadResultFile(files[1], &contender)) {
+    return 2;
+  }
+
+  // Results of different machines or builds are not comparable, so point
+  // out what differs.
+  for (auto &entry : baseline.context) {
+    auto it = contender.context.find(entry.first);
+    if (it != contender.context.end() && it->second != entry.second &&
+        entry.first != "tessdata") {
+      printf("Note: %s differs: %s vs %s\n", entry.first.c_str(), entry.second.c_str(),
+             it->second.c_str());
+    }
+  }
+
+  printf("%-44s %12s %12s %8s %19s  %s\n", "Benchmark", "Baseline", "Contender", "Change",
+         "CI", "Verdict");
+  int num_compared = 0, num_slower = 0, num_faster = 0;
+  std::vector<std::string> not_compared;
+  for (auto &name : baseline.names) {
+    const BenchmarkRuns &base = baseline.benchmarks[name];
+    auto it = contender.benchmarks.find(name);
+    if (it == contender.benchmarks.end()) {
+      not_compared.push_back(name + " (missing in contender)");
+      continue;
+    }
+    const BenchmarkRuns &cont = it->second;
+    if (!base.error.empty() || !cont.error.empty()) {
+      not_compared.push_back(name + " (" + (base.error.empty() ? cont.error : base.error) + ")");
+      continue;
+    }
+    ++num_compared;
+    Change change = CompareRuns(base.run_ns, cont.run_ns, confidence, resamples);
+    const char *verdict = "same";
+    if (change.low > threshold) {
+      verdict = "SLOWER";
+      ++num_slower;
+    } else if (change.high < -threshold) {
+      verdict = "faster";
+      ++num_faster;
+    } else if (change.change > threshold) {
+      verdict = "noisy, maybe slower";
+    } else if (change.change < -threshold) {
+      verdict = "noisy, maybe faster";
+    }
+    char interval[40];
+    snprintf(interval, sizeof(interval), "[%+.1f%%, %+.1f%%]", 100.0 * change.low,
+             100.0 * change.high);
+    printf("%-44s %12s %12s %+7.1f%% %19s  %s\n", name.c_str(),
+           FormatTime(Median(base.run_ns)).c_str(), FormatTime(Median(cont.run_ns)).c_str(),
+           100.0 * change.change, interval, verdict);
+  }
+  for (auto &name : contender.names) {
+    if (baseline.benchmarks.find(name) == baseline.benchmarks.end()) {
+      not_compared.push_back(name + " (missing in baseline)");
+    }
+  }
+  for (auto &name : not_compared) {
+    printf("Not compared: %s\n", name.c_str());
+  }
+  printf("\n%d benchmarks compared, %d slower and %d faster by more than %.1f%% "
+         "at %.0f%% confidence.\n",
+         num_compared, num_slower, num_faster, 100.0 * threshold, 100.0 * confidence);
+  return num_slower > 0 ? 1 : 0;
+}
+
+} // namespace tesseract
+
+int main(int argc, char **argv) {
+  return tesseract::CompareFiles(argc, argv);
+}
@@ -0,0 +1,316 @@
+///////////////////////////////////////////////////////////////////////
+// File:        benchmark.cpp
+// Description: Minimal harness for timing benchmarks with repetitions
+//              and JSON output.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "benchmark.h"
+
+#include <algorithm> // for std::sort
+#include <chrono>    // for std::chrono
+#include <cmath>     // for std::sqrt
+#include <cstdio>    // for printf, fprintf
+#include <cstdlib>   // for atoi, atof
+#include <cstring>   // for strcmp
+#include <fstream>   // for std::ofstream
+#include <iostream>  // for std::cout
+#include <locale>    // for std::locale::classic
+#include <regex>     // for std::regex
+#include <utility>   // for std::pair
+#include <vector>    // for std::vector
+
+namespace tesseract {
+
+static int64_t NowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void BenchmarkState::StartTimer() {
+  start_ns_ = NowNanos();
+  running_ = true;
+}
+
+void BenchmarkState::StopTimer() {
+  if (running_) {
+    seconds_ += (NowNanos() - start_ns_) * 1e-9;
+    running_ = false;
+  }
+}
+
+void BenchmarkState::PauseTiming() {
+  StopTimer();
+}
+
+void BenchmarkState::ResumeTiming() {
+  StartTimer();
+}
+
+namespace {
+
+struct Benchmark {
+  std::string name;
+  BenchmarkFunction function;
+};
+
+// The result of all timed runs of a benchmark.
+struct BenchmarkResult {
+  std::string name;
+  std::string label;
+  std::string error;
+  int64_t iterations = 0;
+  std::vector<double> run_ns; // Time per iteration of each run.
+  double median_ns = 0.0;
+  double mean_ns = 0.0;
+  double stddev_ns = 0.0;
+  double items_per_second = 0.0;
+  std::map<std::string, double> counters;
+};
+
+} // namespace
+
+static std::vector<Benchmark> &Benchmarks() {
+  static std::vector<Benchmark> benchmarks;
+  return benchmarks;
+}
+
+static std::vector<std::pair<std::string, std::string>> &Context() {
+  static std::vector<std::pair<std::string, std::string>> context;
+  return context;
+}
+
+bool RegisterBenchmark(const std::string &name, const BenchmarkFunction &function) {
+  Benchmarks().push_back({name, function});
+  return true;
+}
+
+void AddBenchmarkContext(const std::string &key, const std::string &value) {
+  Context().emplace_back(key, value);
+}
+
+static double Median(std::vector<double> values) {
+  if (values.empty()) {
+    return 0.0;
+  }
+  std::sort(values.begin(), values.end());
+  size_t middle = values.size() / 2;
+  return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+// Runs a benchmark until a run takes at least min_time, then repeats that
+// number of iterations for the timed runs.
+static BenchmarkResult Run(const Benchmark &benchmark, double min_time, int repetitions) {
+  BenchmarkResult result;
+  result.name = benchmark.name;
+  int64_t iterations = 1;
+  for (;;) {
+    BenchmarkState state(iterations);
+    benchmark.function(state);
+    if (!state.error().empty()) {
+      result.error = state.error();
+      return result;
+    }
+    if (state.seconds() >= min_time || iterations >= 1000000000) {
+      break;
+    }
+    // Aim a little above min_time, but grow by at most 10 times.
+    double factor = state.seconds() > 0.0 ? 1.4 * min_time / state.seconds() : 10.0;
+    factor = std::min(10.0, factor);
+    iterations = std::max(iterations + 1, static_cast<int64_t>(iterations * factor));
+  }
+  result.iterations = iterations;
+
+  std::vector<double> items_per_second;
+  for (int run = 0; run < repetitions; ++run) {
+    BenchmarkState state(iterations);
+    benchmark.function(state);
+    if (!state.error().empty()) {
+      result.error = state.error();
+      return result;
+    }
+    double seconds = std::max(state.seconds(), 1e-12);
+    result.run_ns.push_back(seconds * 1e9 / state.iterations());
+    items_per_second.push_back(state.items_processed() / seconds);
+    for (auto &counter : state.counters()) {
+      result.counters[counter.first] += counter.second / state.iterations() / repetitions;
+    }
+    result.label = state.label();
+  }
+  result.median_ns = Median(result.run_ns);
+  double sum = 0.0;
+  for (double ns : result.run_ns) {
+    sum += ns;
+  }
+  result.mean_ns = sum / result.run_ns.size();
+  double variance = 0.0;
+  for (double ns : result.run_ns) {
+    variance += (ns - result.mean_ns) * (ns - result.mean_ns);
+  }
+  if (result.run_ns.size() > 1) {
+    result.stddev_ns = std::sqrt(variance / (result.run_ns.size() - 1));
+  }
+  result.items_per_second = Median(items_per_second);
+  return result;
+}
+
+// Writes text as a JSON string.
+static void WriteJSONString(std::ostream &out, const std::string &text) {
+  out << '"';
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out << ' ';
+    } else {
+      out << c;
+    }
+  }
+  out << '"';
+}
+
+static void WriteJSON(std::ostream &out, const std::vector<BenchmarkResult> &results) {
+  out.imbue(std::locale::classic());
+  out.precision(10);
+  out << "{\n  \"context\": {";
+  const char *separator = "\n";
+  for (auto &entry : Context()) {
+    out << separator << "    ";
+    WriteJSONString(out, entry.first);
+    out << ": ";
+    WriteJSONString(out, entry.second);
+    separator = ",\n";
+  }
+  out << "\n  },\n  \"benchmarks\": [";
+  separator = "\n";
+  for (auto &result : results) {
+    out << separator << "    {\"name\": ";
+    WriteJSONString(out, result.name);
+    if (!result.error.empty()) {
+      out << ", \"error\": ";
+      WriteJSONString(out, result.error);
+      out << '}';
+      separator = ",\n";
+      continue;
+    }
+    out << ", \"iterations\": " << result.iterations << ", \"run_ns\": [";
+    for (size_t i = 0; i < result.run_ns.size(); ++i) {
+      out << (i ? ", " : "") << result.run_ns[i];
+    }
+    out << "], \"median_ns\": " << result.median_ns << ", \"mean_ns\": " << result.mean_ns
+        << ", \"stddev_ns\": " << result.stddev_ns
+        << ", \"items_per_second\": " << result.items_per_second;
+    if (!result.label.empty()) {
+      out << ", \"label\": ";
+      WriteJSONString(out, result.label);
+    }
+    if (!result.counters.empty()) {
+      out << ", \"counters\": {";
+      const char *counter_separator = "";
+      for (auto &counter : result.counters) {
+        out << counter_separator;
+        WriteJSONString(out, counter.first);
+        out << ": " << counter.second;
+        counter_separator = ", ";
+      }
+      out << '}';
+    }
+    out << '}';
+    separator = ",\n";
+  }
+  out << "\n  ]\n}\n";
+}
+
+int RunBenchmarks(int argc, char **argv) {
+  std::string filter = ".*";
+  const char *json_file = nullptr;
+  double min_time = 0.5;
+  int repetitions = 5;
+  bool list = false;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+      filter = argv[++i];
+    } else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+      min_time = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc) {
+      repetitions = std::max(1, atoi(argv[++i]));
+    } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+      json_file = argv[++i];
+    } else if (strcmp(argv[i], "--list") == 0) {
+      list = true;
+    } else {
+      fprintf(stderr, "Error, unknown command line argument '%s'\n", argv[i]);
+      return EXIT_FAILURE;
+    }
+  }
+  std::regex pattern;
+  try {
+    pattern = std::regex(filter);
+  } catch (const std::regex_error &) {
+    fprintf(stderr, "Error, invalid --filter '%s'\n", filter.c_str());
+    return EXIT_FAILURE;
+  }
+
+  // With --json -, the table goes to stderr to keep stdout valid JSON.
+  FILE *table = json_file != nullptr && strcmp(json_file, "-") == 0 ? stderr : stdout;
+  std::vector<BenchmarkResult> results;
+  if (!list) {
+    fprintf(table, "%-44s %14s %10s %10s %14s\n", "Benchmark", "Time/iter", "CV", "Iters",
+            "Items/s");
+  }
+  for (auto &benchmark : Benchmarks()) {
+    if (!std::regex_search(benchmark.name, pattern)) {
+      continue;
+    }
+    if (list) {
+      printf("%s\n", benchmark.name.c_str());
+      continue;
+    }
+    BenchmarkResult result = Run(benchmark, min_time, repetitions);
+    if (!result.error.empty()) {
+      fprintf(table, "%-44s skipped: %s\n", result.name.c_str(), result.error.c_str());
+    } else {
+      double cv = result.mean_ns > 0.0 ? 100.0 * result.stddev_ns / result.mean_ns : 0.0;
+      char time[32];
+      if (result.median_ns >= 1e6) {
+        snprintf(time, sizeof(time), "%.3f ms", result.median_ns / 1e6);
+      } else if (result.median_ns >= 1e3) {
+        snprintf(time, sizeof(time), "%.3f us", result.median_ns / 1e3);
+      } else {
+        snprintf(time, sizeof(time), "%.1f ns", result.median_ns);
+      }
+      fprintf(table, "%-44s %14s %9.1f%% %10lld %14.1f %s\n", result.name.c_str(), time, cv,
+              static_cast<long long>(result.iterations), result.items_per_second,
+              result.label.c_str());
+    }
+    fflush(table);
+    results.push_back(std::move(result));
+  }
+
+  if (json_file != nullptr && !list) {
+    if (strcmp(json_file, "-") == 0) {
+      WriteJSON(std::cout, results);
+    } else {
+      std::ofstream out(json_file);
+      WriteJSON(out, results);
+      if (!out) {
+        fprintf(stderr, "Error, could not write %s\n", json_file);
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace tesseract
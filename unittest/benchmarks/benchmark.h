@@ -0,0 +1,136 @@
+///////////////////////////////////////////////////////////////////////
+// File:        benchmark.h
+// Description: Minimal harness for timing benchmarks with repetitions
+//              and JSON output.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_UNITTEST_BENCHMARKS_BENCHMARK_H_
+#define TESSERACT_UNITTEST_BENCHMARKS_BENCHMARK_H_
+
+#include <cstdint>    // for int64_t
+#include <functional> // for std::function
+#include <map>        // for std::map
+#include <string>     // for std::string
+
+namespace tesseract {
+
+// Passed to a benchmark function, which runs the code to be measured once
+// per iteration of its loop:
+//   static void BM_Something(BenchmarkState &state) {
+//     Setup();  // Not timed.
+//     while (state.KeepRunning()) {
+//       DoSomething();
+//     }
+//     state.SetItemsProcessed(state.iterations() * items_per_call);
+//   }
+// The harness calls the function with increasing iteration counts until a
+// run takes long enough, then repeats that run to get a distribution.
+class BenchmarkState {
+public:
+  explicit BenchmarkState(int64_t max_iterations) : max_iterations_(max_iterations) {}
+
+  bool KeepRunning() {
+    if (iterations_ == 0) {
+      StartTimer();
+    }
+    if (iterations_ < max_iterations_) {
+      ++iterations_;
+      return true;
+    }
+    StopTimer();
+    return false;
+  }
+
+  // Exclude work inside the loop from the time.
+  void PauseTiming();
+  void ResumeTiming();
+
+  int64_t iterations() const {
+    return iterations_;
+  }
+  // Items such as pages or lines handled by all iterations, for the rate.
+  void SetItemsProcessed(int64_t items) {
+    items_processed_ = items;
+  }
+  void SetLabel(const std::string &label) {
+    label_ = label;
+  }
+  // Marks the benchmark as not runnable, for example if data is missing.
+  // The function should return without running the loop.
+  void SkipWithError(const std::string &message) {
+    error_ = message;
+  }
+  // Values reported with the result, averaged over the iterations.
+  std::map<std::string, double> &counters() {
+    return counters_;
+  }
+
+  double seconds() const {
+    return seconds_;
+  }
+  int64_t items_processed() const {
+    return items_processed_;
+  }
+  const std::string &label() const {
+    return label_;
+  }
+  const std::string &error() const {
+    return error_;
+  }
+
+private:
+  void StartTimer();
+  void StopTimer();
+
+  int64_t max_iterations_;
+  int64_t iterations_ = 0;
+  int64_t items_processed_ = 0;
+  double seconds_ = 0.0;
+  int64_t start_ns_ = 0;
+  bool running_ = false;
+  std::string label_;
+  std::string error_;
+  std::map<std::string, double> counters_;
+};
+
+using BenchmarkFunction = std::function<void(BenchmarkState &state)>;
+
+// Registers a benchmark under the given name. Returns true, so it can
+// initialize a static variable.
+bool RegisterBenchmark(const std::string &name, const BenchmarkFunction &function);
+
+// Registers a function as a benchmark under its own name.
+#define TESS_BENCHMARK(function) \
+  static const bool function##_registered = ::tesseract::RegisterBenchmark(#function, function)
+
+// Adds a value to the "context" object of the JSON output, which
+// describes the machine and build, such as the SIMD instructions used.
+void AddBenchmarkContext(const std::string &key, const std::string &value);
+
+// Runs the registered benchmarks whose names match the --filter regular
+// expression, prints a table and writes the results as JSON if --json is
+// given. The options are:
+//   --filter REGEX       Run only matching benchmarks.
+//   --min-time SECONDS   Minimum time of a timed run (default 0.5).
+//   --repetitions N      Number of timed runs (default 5).
+//   --json FILE          Write the results to FILE ("-" for stdout, which
+//                        moves the table to stderr).
+//   --list               Only print the names of the benchmarks.
+// The JSON holds the time per iteration of every run, so runs can be
+// compared with statistics. Returns the exit code for main.
+int RunBenchmarks(int argc, char **argv);
+
+} // namespace tesseract
+
+#endif // TESSERACT_UNITTEST_BENCHMARKS_BENCHMARK_H_
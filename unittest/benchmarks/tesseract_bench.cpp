@@ -0,0 +1,913 @@
+///////////////////////////////////////////////////////////////////////
+// File:        tesseract_bench.cpp
+// Description: Micro benchmarks of the hot kernels and macro benchmarks
+//              of the whole recognition of synthetic pages.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// The benchmarks need no input files besides the traineddata: the pages
+// are drawn by the program with a built in font and pseudo random words
+// from a fixed seed, so every run and every machine sees the same corpus.
+//
+// Usage: tesseract_bench [--tessdata-dir PATH] [--tmpdir PATH]
+//          [--filter REGEX] [--min-time SECONDS] [--repetitions N]
+//          [--json FILE] [--list]
+// The renderer benchmarks write their files to --tmpdir, by default TMPDIR
+// or /tmp, and remove them afterwards.
+
+#ifdef HAVE_CONFIG_H
+#  include "config_auto.h" // DISABLED_LEGACY_ENGINE
+#endif
+
+#include "benchmark.h"
+
+#include <allheaders.h>
+#include <tesseract/baseapi.h>
+#include <tesseract/renderer.h>
+
+#include "coutln.h"
+#include "dotproduct.h"
+#include "intsimdmatrix.h"
+#include "matrix.h"
+#include "otsuthr.h"
+#include "pdblock.h"
+#include "recodebeam.h"
+#include "scanedg.h"
+#include "simddetect.h"
+#include "tesseractclass.h"
+#include "trie.h"
+#include "unicharcompress.h"
+#include "unicharset.h"
+
+#include <cstdint> // for int8_t
+#include <cstdio>  // for fopen, fwrite, remove
+#include <cstdlib> // for getenv
+#include <cstring> // for strchr, strcmp, strlen
+#include <memory>  // for std::unique_ptr
+#include <random>  // for std::mt19937
+#include <string>  // for std::string
+#include <thread>  // for std::thread::hardware_concurrency
+#include <vector>  // for std::vector
+
+namespace tesseract {
+
+static std::string tessdata_dir;
+static std::string tmp_dir = "/tmp";
+
+// The corpus does not depend on the standard library implementation:
+// only the raw output of std::mt19937 is used.
+static const uint32_t kCorpusSeed = 20211017;
+
+// Glyphs of a 5x7 bitmap font. Each row holds 5 bits, the most
+// significant one at the left.
+static const char kGlyphChars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+static const uint8_t kGlyphs[][7] = {
+    {0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}, // A
+    {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E}, // B
+    {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E}, // C
+    {0x1E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x1E}, // D
+    {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F}, // E
+    {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10}, // F
+    {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F}, // G
+    {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}, // H
+    {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}, // I
+    {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C}, // J
+    {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11}, // K
+    {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F}, // L
+    {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11}, // M
+    {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}, // N
+    {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, // O
+    {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10}, // P
+    {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D}, // Q
+    {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11}, // R
+    {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E}, // S
+    {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}, // T
+    {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, // U
+    {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04}, // V
+    {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A}, // W
+    {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11}, // X
+    {0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04}, // Y
+    {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F}, // Z
+    {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}, // 0
+    {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}, // 1
+    {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}, // 2
+    {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E}, // 3
+    {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}, // 4
+    {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}, // 5
+    {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}, // 6
+    {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}, // 7
+    {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}, // 8
+    {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C}, // 9
+};
+static const int kNumGlyphs = sizeof(kGlyphChars) - 1;
+
+// Size of a pixel of the font in the image: 7 * 5 pixels high capitals
+// are about 10 points at 300 dpi.
+static const int kFontScale = 5;
+static const int kGlyphAdvance = 6 * kFontScale;
+static const int kLinePitch = 12 * kFontScale;
+static const int kMargin = 150;
+static const int kResolution = 300;
+
+// Returns a pseudo random word of 2 to 8 characters.
+static std::string RandomWord(std::mt19937 &random) {
+  int length = 2 + random() % 7;
+  std::string word;
+  for (int i = 0; i < length; ++i) {
+    word += kGlyphChars[random() % kNumGlyphs];
+  }
+  return word;
+}
+
+static void DrawText(Pix *pix, int x, int y, const std::string &text) {
+  for (char c : text) {
+    const char *glyph_char = strchr(kGlyphChars, c);
+    if (glyph_char != nullptr && c != '\0') {
+      const uint8_t *glyph = kGlyphs[glyph_char - kGlyphChars];
+      for (int row = 0; row < 7; ++row) {
+        for (int col = 0; col < 5; ++col) {
+          if (glyph[row] & (0x10 >> col)) {
+            pixRasterop(pix, x + col * kFontScale, y + row * kFontScale, kFontScale, kFontScale,
+                        PIX_SET, nullptr, 0, 0);
+          }
+        }
+      }
+    }
+    x += kGlyphAdvance;
+  }
+}
+
+// Returns a 1 bpp image of the given size with num_lines lines of pseudo
+// random words, or a single word if single_word is true.
+static Pix *MakeTextImage(int width, int height, int num_lines, bool single_word,
+                          uint32_t seed) {
+  std::mt19937 random(seed);
+  Pix *pix = pixCreate(width, height, 1);
+  pixSetResolution(pix, kResolution, kResolution);
+  int y = kMargin;
+  for (int line = 0; line < num_lines && y + kLinePitch <= height - kMargin; ++line) {
+    int x = kMargin;
+    for (;;) {
+      std::string word = RandomWord(random);
+      int word_width = word.size() * kGlyphAdvance;
+      if (x + word_width > width - kMargin) {
+        break;
+      }
+      DrawText(pix, x, y, word);
+      x += word_width + 3 * kGlyphAdvance;
+      if (single_word) {
+        return pix;
+      }
+    }
+    y += kLinePitch;
+  }
+  return pix;
+}
+
+// The kinds of synthetic images for the macro benchmarks.
+enum ImageKind { IMAGE_PAGE, IMAGE_LINE, IMAGE_WORD };
+
+static Pix *MakeImage(ImageKind kind) {
+  switch (kind) {
+    case IMAGE_PAGE:
+      // Letter width, 40 lines of text.
+      return MakeTextImage(2550, 2 * kMargin + 40 * kLinePitch, 40, false, kCorpusSeed);
+    case IMAGE_LINE:
+      return MakeTextImage(2550, 2 * kMargin + kLinePitch, 1, false, kCorpusSeed + 1);
+    case IMAGE_WORD:
+      return MakeTextImage(2 * kMargin + 8 * kGlyphAdvance, 2 * kMargin + kLinePitch, 1, true,
+                           kCorpusSeed + 2);
+  }
+  return nullptr;
+}
+
+// Returns an api initialized for English with the given engine, which is
+// kept for all benchmarks, or nullptr if the model cannot be loaded.
+static TessBaseAPI *SharedApi(OcrEngineMode oem) {
+  static std::unique_ptr<TessBaseAPI> apis[OEM_COUNT];
+  static bool failed[OEM_COUNT];
+  if (!apis[oem] && !failed[oem]) {
+    apis[oem].reset(new TessBaseAPI);
+    if (apis[oem]->Init(tessdata_dir.c_str(), "eng", oem) != 0) {
+      apis[oem].reset();
+      failed[oem] = true;
+    }
+  }
+  return apis[oem].get();
+}
+
+// Recognizes a synthetic image with the given page segmentation mode and
+// engine. Reports the lines per page and the time of each stage as
+// counters.
+static void RecognizeImage(BenchmarkState &state, ImageKind kind, PageSegMode psm,
+                           OcrEngineMode oem) {
+  TessBaseAPI *api = SharedApi(oem);
+  if (api == nullptr) {
+    state.SkipWithError("cannot load eng.traineddata from " + tessdata_dir);
+    return;
+  }
+  api->SetPageSegMode(psm);
+  Pix *pix = MakeImage(kind);
+  std::map<std::string, double> sums;
+  while (state.KeepRunning()) {
+    api->SetImage(pix);
+    char *text = api->GetUTF8Text();
+    delete[] text;
+    state.PauseTiming();
+    for (auto &stat : api->GetStageStats()) {
+      if (stat.is_counter) {
+        sums[stat.name] += stat.page_count;
+      } else {
+        sums[std::string(stat.name) + "_seconds"] += stat.page_seconds;
+      }
+    }
+    state.ResumeTiming();
+  }
+  api->Clear();
+  pixDestroy(&pix);
+  state.counters() = sums;
+  state.SetItemsProcessed(state.iterations());
+  state.SetLabel("pages");
+}
+
+static void RegisterRecognizeBenchmarks() {
+  static const struct {
+    const char *name;
+    ImageKind kind;
+    PageSegMode psm;
+  } kImages[] = {
+      {"page/psm_auto", IMAGE_PAGE, PSM_AUTO},
+      {"page/psm_single_block", IMAGE_PAGE, PSM_SINGLE_BLOCK},
+      {"line/psm_single_line", IMAGE_LINE, PSM_SINGLE_LINE},
+      {"word/psm_single_word", IMAGE_WORD, PSM_SINGLE_WORD},
+  };
+  static const struct {
+    const char *name;
+    OcrEngineMode oem;
+  } kEngines[] = {
+      {"lstm", OEM_LSTM_ONLY},
+#ifndef DISABLED_LEGACY_ENGINE
+      {"legacy", OEM_TESSERACT_ONLY},
+#endif
+  };
+  for (auto &engine : kEngines) {
+    for (auto &image : kImages) {
+      ImageKind kind = image.kind;
+      PageSegMode psm = image.psm;
+      OcrEngineMode oem = engine.oem;
+      RegisterBenchmark(std::string("BM_Recognize/") + image.name + "/" + engine.name,
+                        [kind, psm, oem](BenchmarkState &state) {
+                          RecognizeImage(state, kind, psm, oem);
+                        });
+    }
+  }
+}
+
+// Recognizes the line or the word image with the single line fast path,
+// which skips layout analysis, off or on.
+static void RegisterLineFastPathBenchmarks() {
+  static const struct {
+    const char *name;
+    ImageKind kind;
+    PageSegMode psm;
+  } kImages[] = {
+      {"line/psm_raw_line", IMAGE_LINE, PSM_RAW_LINE},
+      {"word/psm_single_word", IMAGE_WORD, PSM_SINGLE_WORD},
+  };
+  for (auto &image : kImages) {
+    for (bool fast_path : {false, true}) {
+      ImageKind kind = image.kind;
+      PageSegMode psm = image.psm;
+      RegisterBenchmark(std::string("BM_LineFastPath/") + image.name + (fast_path ? "/on" : "/off"),
+                        [kind, psm, fast_path](BenchmarkState &state) {
+                          TessBaseAPI *api = SharedApi(OEM_LSTM_ONLY);
+                          if (api != nullptr) {
+                            api->SetVariable("line_fast_path", fast_path ? "1" : "0");
+                          }
+                          RecognizeImage(state, kind, psm, OEM_LSTM_ONLY);
+                          if (api != nullptr) {
+                            api->SetVariable("line_fast_path", "0");
+                          }
+                        });
+    }
+  }
+}
+
+// Copies an 8 or 32 bit pix to a buffer in the format of the raw SetImage,
+// with each line padded to a multiple of 4 bytes.
+static std::vector<unsigned char> RawImageData(Pix *pix, int bytes_per_pixel,
+                                               int *bytes_per_line) {
+  const int width = pixGetWidth(pix);
+  const int height = pixGetHeight(pix);
+  *bytes_per_line = (width * bytes_per_pixel + 3) & ~3;
+  std::vector<unsigned char> data(*bytes_per_line * height);
+  for (int y = 0; y < height; ++y) {
+    const l_uint32 *line = pixGetData(pix) + y * pixGetWpl(pix);
+    unsigned char *raw = &data[y * *bytes_per_line];
+    for (int x = 0; x < width * bytes_per_pixel; ++x) {
+      raw[x] = GET_DATA_BYTE(line, x);
+    }
+  }
+  return data;
+}
+
+// Thresholds a synthetic page given as a raw frame, which SetImage copies
+// or SetImageBorrowed uses in place.
+static void ThresholdFrame(BenchmarkState &state, int bytes_per_pixel, bool borrowed) {
+  TessBaseAPI *api = SharedApi(OEM_LSTM_ONLY);
+  if (api == nullptr) {
+    state.SkipWithError("cannot load eng.traineddata from " + tessdata_dir);
+    return;
+  }
+  Pix *page = MakeImage(IMAGE_PAGE);
+  Pix *pix = bytes_per_pixel == 1 ? pixConvertTo8(page, false) : pixConvertTo32(page);
+  pixDestroy(&page);
+  const int width = pixGetWidth(pix);
+  const int height = pixGetHeight(pix);
+  int bytes_per_line;
+  std::vector<unsigned char> frame = RawImageData(pix, bytes_per_pixel, &bytes_per_line);
+  pixDestroy(&pix);
+  while (state.KeepRunning()) {
+    if (borrowed) {
+      api->SetImageBorrowed(frame.data(), width, height, bytes_per_pixel, bytes_per_line);
+    } else {
+      api->SetImage(frame.data(), width, height, bytes_per_pixel, bytes_per_line);
+    }
+    Pix *binary = api->GetThresholdedImage();
+    pixDestroy(&binary);
+  }
+  api->Clear();
+  state.SetItemsProcessed(state.iterations() * width * height);
+  state.SetLabel("pixels");
+}
+
+// Recognizes the lines of a synthetic page as regions, all of them with
+// RecognizeRegions or one after the other with SetRectangle.
+static void RecognizeLines(BenchmarkState &state, bool recognize_regions) {
+  TessBaseAPI *api = SharedApi(OEM_LSTM_ONLY);
+  if (api == nullptr) {
+    state.SkipWithError("cannot load eng.traineddata from " + tessdata_dir);
+    return;
+  }
+  Pix *pix = MakeImage(IMAGE_PAGE);
+  std::vector<TessBaseAPI::Region> regions;
+  for (int y = kMargin; y + kLinePitch <= pixGetHeight(pix) - kMargin; y += kLinePitch) {
+    TessBaseAPI::Region region;
+    region.left = kMargin / 2;
+    region.top = y - kFontScale;
+    region.width = pixGetWidth(pix) - kMargin;
+    region.height = 9 * kFontScale;
+    regions.push_back(region);
+  }
+  api->SetPageSegMode(PSM_SINGLE_LINE);
+  api->SetImage(pix);
+  std::vector<TessBaseAPI::RegionResult> results;
+  while (state.KeepRunning()) {
+    if (recognize_regions) {
+      api->RecognizeRegions(regions, &results);
+    } else {
+      for (auto &region : regions) {
+        api->SetRectangle(region.left, region.top, region.width, region.height);
+        char *text = api->GetUTF8Text();
+        delete[] text;
+      }
+    }
+  }
+  api->Clear();
+  pixDestroy(&pix);
+  state.SetItemsProcessed(state.iterations() * regions.size());
+  state.SetLabel("lines");
+}
+
+// Recognizes a synthetic page in the storage which the page result objects
+// of the previous page left for recycling, or with that storage released
+// before each page. Reports the objects made in new and in reused storage
+// per page as counters.
+static void RecognizeRecycled(BenchmarkState &state, bool release) {
+  TessBaseAPI *api = SharedApi(OEM_LSTM_ONLY);
+  if (api == nullptr) {
+    state.SkipWithError("cannot load eng.traineddata from " + tessdata_dir);
+    return;
+  }
+  api->SetPageSegMode(PSM_AUTO);
+  Pix *pix = MakeImage(IMAGE_PAGE);
+  const std::vector<TessBaseAPI::AllocatorStats> before = TessBaseAPI::GetAllocatorStats();
+  while (state.KeepRunning()) {
+    if (release) {
+      state.PauseTiming();
+      TessBaseAPI::ReleaseRecycledMemory();
+      state.ResumeTiming();
+    }
+    api->SetImage(pix);
+    char *text = api->GetUTF8Text();
+    delete[] text;
+    api->Clear();
+  }
+  const std::vector<TessBaseAPI::AllocatorStats> after = TessBaseAPI::GetAllocatorStats();
+  for (size_t i = 0; i < after.size() && i < before.size(); ++i) {
+    state.counters()[std::string(after[i].name) + "_allocated"] =
+        after[i].allocated - before[i].allocated;
+    state.counters()[std::string(after[i].name) + "_reused"] = after[i].reused - before[i].reused;
+  }
+  pixDestroy(&pix);
+  state.SetItemsProcessed(state.iterations());
+  state.SetLabel("pages");
+}
+
+// Writes the hOCR, ALTO and TSV output of a recognized synthetic page, from
+// the strings of the api or with chained renderers, which walk the results
+// once for all formats.
+static void RenderFormats(BenchmarkState &state, bool chained) {
+  static const char *const kExtensions[] = {".hocr", ".xml", ".tsv"};
+  TessBaseAPI *api = SharedApi(OEM_LSTM_ONLY);
+  if (api == nullptr) {
+    state.SkipWithError("cannot load eng.traineddata from " + tessdata_dir);
+    return;
+  }
+  api->SetPageSegMode(PSM_AUTO);
+  Pix *pix = MakeImage(IMAGE_PAGE);
+  api->SetImage(pix);
+  if (api->Recognize(nullptr) != 0) {
+    state.SkipWithError("cannot recognize the page");
+  }
+  const std::string outputbase =
+      tmp_dir + "/tesseract_bench_" + (chained ? "chained" : "strings");
+  if (!state.error().empty()) {
+    // Nothing to render.
+  } else if (chained) {
+    TessHOcrRenderer renderer(outputbase.c_str());
+    renderer.insert(new TessAltoRenderer(outputbase.c_str()));
+    renderer.insert(new TessTsvRenderer(outputbase.c_str()));
+    if (!renderer.BeginDocument("benchmark")) {
+      state.SkipWithError("cannot write to " + tmp_dir);
+    }
+    while (state.error().empty() && state.KeepRunning()) {
+      renderer.AddImage(api);
+    }
+    renderer.EndDocument();
+  } else {
+    FILE *files[3] = {};
+    for (int f = 0; f < 3; ++f) {
+      files[f] = fopen((outputbase + kExtensions[f]).c_str(), "wb");
+      if (files[f] == nullptr) {
+        state.SkipWithError("cannot write to " + tmp_dir);
+      }
+    }
+    while (state.error().empty() && state.KeepRunning()) {
+      const int page = state.iterations() - 1;
+      for (int f = 0; f < 3; ++f) {
+        char *text = f == 0 ? api->GetHOCRText(page)
+                            : f == 1 ? api->GetAltoText(page) : api->GetTSVText(page);
+        fwrite(text, 1, strlen(text), files[f]);
+        fflush(files[f]);
+        delete[] text;
+      }
+    }
+    for (auto file : files) {
+      if (file != nullptr) {
+        fclose(file);
+      }
+    }
+  }
+  for (auto extension : kExtensions) {
+    remove((outputbase + extension).c_str());
+  }
+  api->Clear();
+  pixDestroy(&pix);
+  state.SetItemsProcessed(state.iterations());
+  state.SetLabel("pages");
+}
+
+// Initializes an api for English, completely or only with the config of
+// the traineddata (tessedit_init_config_only).
+static void InitApi(BenchmarkState &state, bool config_only) {
+  std::vector<std::string> vars_vec;
+  std::vector<std::string> vars_values;
+  if (config_only) {
+    vars_vec.emplace_back("tessedit_init_config_only");
+    vars_values.emplace_back("1");
+  }
+  while (state.KeepRunning()) {
+    auto api = std::make_unique<TessBaseAPI>();
+    if (api->Init(tessdata_dir.c_str(), "eng", OEM_DEFAULT, nullptr, 0, &vars_vec, &vars_values,
+                  false) != 0) {
+      state.SkipWithError("cannot load eng.traineddata from " + tessdata_dir);
+      return;
+    }
+    state.PauseTiming();
+    api.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetLabel("inits");
+}
+
+// Registers the benchmarks which compare a feature of the api with the
+// code path it replaces or skips.
+static void RegisterApiBenchmarks() {
+  RegisterLineFastPathBenchmarks();
+  for (int bytes_per_pixel : {1, 4}) {
+    for (bool borrowed : {false, true}) {
+      RegisterBenchmark(std::string("BM_ThresholdFrame/") + (bytes_per_pixel == 1 ? "8" : "32") +
+                            "bit/" + (borrowed ? "borrowed" : "copied"),
+                        [bytes_per_pixel, borrowed](BenchmarkState &state) {
+                          ThresholdFrame(state, bytes_per_pixel, borrowed);
+                        });
+    }
+  }
+  for (bool on : {false, true}) {
+    RegisterBenchmark(std::string("BM_RecognizeLines/") +
+                          (on ? "recognize_regions" : "set_rectangle"),
+                      [on](BenchmarkState &state) { RecognizeLines(state, on); });
+    RegisterBenchmark(std::string("BM_RecognizeRecycled/") + (on ? "released" : "recycled"),
+                      [on](BenchmarkState &state) { RecognizeRecycled(state, on); });
+    RegisterBenchmark(std::string("BM_RenderFormats/") + (on ? "chained" : "strings"),
+                      [on](BenchmarkState &state) { RenderFormats(state, on); });
+    RegisterBenchmark(std::string("BM_Init/") + (on ? "config_only" : "full"),
+                      [on](BenchmarkState &state) { InitApi(state, on); });
+  }
+}
+
+// Makes a random weights matrix, as in intsimdmatrix_test.
+static GENERIC_2D_ARRAY<int8_t> RandomWeights(TRand &random, int num_out, int num_in) {
+  GENERIC_2D_ARRAY<int8_t> w(num_out, num_in + 1, 0);
+  for (int i = 0; i < num_out; ++i) {
+    for (int j = 0; j <= num_in; ++j) {
+      w(i, j) = static_cast<int8_t>(random.SignedRand(INT8_MAX));
+    }
+  }
+  return w;
+}
+
+// Size of the matrix of an LSTM layer with 96 outputs and 96 + 48 inputs.
+static const int kMatrixOutputs = 96;
+static const int kMatrixInputs = 144;
+
+static void MatrixDotVector(BenchmarkState &state, const IntSimdMatrix *matrix) {
+  TRand random;
+  GENERIC_2D_ARRAY<int8_t> w = RandomWeights(random, kMatrixOutputs, kMatrixInputs);
+  std::vector<double> scales(kMatrixOutputs);
+  for (auto &scale : scales) {
+    scale = (1.0 + random.SignedRand(1.0)) / INT8_MAX;
+  }
+  int rounded_inputs = matrix != nullptr ? matrix->RoundInputs(kMatrixInputs) : kMatrixInputs;
+  std::vector<int8_t> u(rounded_inputs, 0);
+  for (int i = 0; i < kMatrixInputs; ++i) {
+    u[i] = static_cast<int8_t>(random.SignedRand(INT8_MAX));
+  }
+  std::vector<int8_t> shaped_w;
+  int32_t rounded_outputs = kMatrixOutputs;
+  if (matrix != nullptr) {
+    matrix->Init(w, shaped_w, rounded_outputs);
+    scales.resize(rounded_outputs);
+  }
+  std::vector<double> v(rounded_outputs);
+  while (state.KeepRunning()) {
+    if (matrix != nullptr) {
+      matrix->matrixDotVectorFunction(w.dim1(), w.dim2(), &shaped_w[0], &scales[0], &u[0], &v[0]);
+    } else {
+      IntSimdMatrix::MatrixDotVector(w, scales, u.data(), v.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kMatrixOutputs * (kMatrixInputs + 1));
+  state.SetLabel("multiply-adds");
+}
+
+static void BM_IntSimdMatrixGeneric(BenchmarkState &state) {
+  MatrixDotVector(state, nullptr);
+}
+TESS_BENCHMARK(BM_IntSimdMatrixGeneric);
+
+static void BM_IntSimdMatrixSelected(BenchmarkState &state) {
+  if (IntSimdMatrix::intSimdMatrix == nullptr ||
+      IntSimdMatrix::intSimdMatrix->matrixDotVectorFunction == nullptr) {
+    state.SkipWithError("no SIMD implementation selected");
+    return;
+  }
+  MatrixDotVector(state, IntSimdMatrix::intSimdMatrix);
+}
+TESS_BENCHMARK(BM_IntSimdMatrixSelected);
+
+// Times the product of a matrix of the given shape with a vector, or with
+// batches of vectors, for an implementation or the one Tune chooses. The
+// items are floating point operations, 2 per multiply-add.
+static void ShapedMatrixDotVector(BenchmarkState &state, int num_out, int num_in,
+                                  const IntSimdMatrix *matrix, bool batched, bool tuned) {
+  const int kRows = 8;
+  TRand random;
+  GENERIC_2D_ARRAY<int8_t> w = RandomWeights(random, num_out, num_in);
+  if (tuned) {
+    matrix = matrix->Tune(w, batched);
+  }
+  std::vector<int8_t> shaped_w;
+  int32_t rounded_outputs;
+  matrix->Init(w, shaped_w, rounded_outputs);
+  std::vector<double> scales(rounded_outputs);
+  for (auto &scale : scales) {
+    scale = (1.0 + random.SignedRand(1.0)) / INT8_MAX;
+  }
+  int rounded_inputs = matrix->RoundInputs(num_in);
+  std::vector<int8_t> inputs(kRows * rounded_inputs, 0);
+  std::vector<double> outputs(kRows * rounded_outputs);
+  std::vector<const int8_t *> u(kRows);
+  std::vector<double *> v(kRows);
+  for (int r = 0; r < kRows; ++r) {
+    for (int i = 0; i < num_in; ++i) {
+      inputs[r * rounded_inputs + i] = static_cast<int8_t>(random.SignedRand(INT8_MAX));
+    }
+    u[r] = &inputs[r * rounded_inputs];
+    v[r] = &outputs[r * rounded_outputs];
+  }
+  while (state.KeepRunning()) {
+    if (batched && matrix->matrixDotVectorsFunction != nullptr) {
+      matrix->matrixDotVectorsFunction(w.dim1(), w.dim2(), &shaped_w[0], &scales[0], kRows, &u[0],
+                                       &v[0]);
+    } else {
+      for (int r = 0; r < kRows; ++r) {
+        matrix->matrixDotVectorFunction(w.dim1(), w.dim2(), &shaped_w[0], &scales[0], u[r], v[r]);
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kRows * 2 * num_out * (num_in + 1));
+  state.SetLabel(tuned ? std::string("flops ") + matrix->name_ : "flops");
+}
+
+// Registers BM_IntSimdMatrixShape/<outputs>x<inputs>/<implementation> for
+// the selected implementation, its variants and the tuned choice, single and
+// batched, for the gates of LSTM layers of common widths and a softmax.
+static void RegisterIntSimdMatrixBenchmarks() {
+  const IntSimdMatrix *selected = IntSimdMatrix::intSimdMatrix;
+  if (selected == nullptr || selected->matrixDotVectorFunction == nullptr) {
+    return;
+  }
+  static const int kShapes[][2] = {{96, 192}, {192, 384}, {384, 768}, {512, 1024}, {111, 192}};
+  std::vector<const IntSimdMatrix *> matrices = {selected};
+  for (auto variant = selected->variants_; variant != nullptr && *variant != nullptr; ++variant) {
+    matrices.push_back(*variant);
+  }
+  for (auto &shape : kShapes) {
+    int num_out = shape[0];
+    int num_in = shape[1];
+    std::string prefix = "BM_IntSimdMatrixShape/" + std::to_string(num_out) + "x" +
+                         std::to_string(num_in) + "/";
+    for (bool batched : {false, true}) {
+      std::string suffix = batched ? "/batched" : "";
+      for (auto matrix : matrices) {
+        if (batched && matrix->matrixDotVectorsFunction == nullptr) {
+          continue;
+        }
+        RegisterBenchmark(prefix + matrix->name_ + suffix,
+                          [num_out, num_in, matrix, batched](BenchmarkState &state) {
+                            ShapedMatrixDotVector(state, num_out, num_in, matrix, batched, false);
+                          });
+      }
+      RegisterBenchmark(prefix + "tuned" + suffix,
+                        [num_out, num_in, selected, batched](BenchmarkState &state) {
+                          ShapedMatrixDotVector(state, num_out, num_in, selected, batched, true);
+                        });
+    }
+  }
+}
+
+static void DotProductOf(BenchmarkState &state, DotProductFunction function) {
+  const int kSize = 256;
+  TRand random;
+  std::vector<double> u(kSize), v(kSize);
+  for (int i = 0; i < kSize; ++i) {
+    u[i] = random.SignedRand(1.0);
+    v[i] = random.SignedRand(1.0);
+  }
+  double sum = 0.0;
+  while (state.KeepRunning()) {
+    sum += function(&u[0], &v[0], kSize);
+  }
+  // Keeps the compiler from dropping the calls.
+  state.counters()["sum"] = sum;
+  state.SetItemsProcessed(state.iterations() * kSize);
+  state.SetLabel("multiply-adds");
+}
+
+static void BM_DotProductNative(BenchmarkState &state) {
+  DotProductOf(state, DotProductNative);
+}
+TESS_BENCHMARK(BM_DotProductNative);
+
+static void BM_DotProductSelected(BenchmarkState &state) {
+  DotProductOf(state, DotProduct);
+}
+TESS_BENCHMARK(BM_DotProductSelected);
+
+// Decodes random network outputs for a small alphanumeric unicharset,
+// which roughly matches a line of 100 characters.
+static void BM_BeamSearch(BenchmarkState &state) {
+  const int kTimesteps = 400;
+  UNICHARSET unicharset;
+  for (const char *c = kGlyphChars; *c != '\0'; ++c) {
+    unicharset.unichar_insert(std::string(1, *c).c_str());
+  }
+  for (char c = 'a'; c <= 'z'; ++c) {
+    unicharset.unichar_insert(std::string(1, c).c_str());
+  }
+  int null_char = unicharset.size();
+  UnicharCompress recoder;
+  if (!recoder.ComputeEncoding(unicharset, null_char, nullptr)) {
+    state.SkipWithError("cannot compute the encoding");
+    return;
+  }
+  RecodedCharID code;
+  recoder.EncodeUnichar(null_char, &code);
+  int encoded_null_char = code(0);
+  // Mostly nulls with a peak at a random character every few timesteps.
+  std::mt19937 random(kCorpusSeed);
+  GENERIC_2D_ARRAY<float> outputs(kTimesteps, recoder.code_range(), 0.0f);
+  for (int t = 0; t < kTimesteps; ++t) {
+    int peak = t % 4 == 0 ? random() % recoder.code_range() : encoded_null_char;
+    for (int c = 0; c < recoder.code_range(); ++c) {
+      outputs(t, c) = 0.1f * (random() % 1000) / 1000.0f / recoder.code_range();
+    }
+    outputs(t, peak) += 0.9f;
+  }
+  RecodeBeamSearch beam_search(recoder, encoded_null_char, false, nullptr);
+  while (state.KeepRunning()) {
+    beam_search.Decode(outputs, 3.5, -0.125, -25.0, nullptr);
+  }
+  state.SetItemsProcessed(state.iterations() * kTimesteps);
+  state.SetLabel("timesteps");
+}
+TESS_BENCHMARK(BM_BeamSearch);
+
+#ifndef DISABLED_LEGACY_ENGINE
+// Runs the class pruner of the legacy engine on random features against
+// the templates of eng.traineddata.
+static void BM_ClassPruner(BenchmarkState &state) {
+  TessBaseAPI *api = SharedApi(OEM_TESSERACT_ONLY);
+  if (api == nullptr || api->tesseract()->PreTrainedTemplates == nullptr) {
+    state.SkipWithError("no legacy model in eng.traineddata from " + tessdata_dir);
+    return;
+  }
+  Tesseract *classify = api->tesseract();
+  const INT_TEMPLATES_STRUCT *templates = classify->PreTrainedTemplates;
+  const int kNumFeatures = 60;
+  std::mt19937 random(kCorpusSeed);
+  std::vector<INT_FEATURE_STRUCT> features;
+  for (int i = 0; i < kNumFeatures; ++i) {
+    features.emplace_back(random() % 256, random() % 256, random() % 256);
+  }
+  std::vector<uint16_t> expected_num_features(templates->NumClasses, kNumFeatures);
+  std::vector<CP_RESULT_STRUCT> results;
+  while (state.KeepRunning()) {
+    classify->PruneClasses(templates, kNumFeatures, -1, &features[0], nullptr,
+                           &expected_num_features[0], &results);
+  }
+  state.SetItemsProcessed(state.iterations() * kNumFeatures);
+  state.SetLabel("features");
+}
+TESS_BENCHMARK(BM_ClassPruner);
+#endif // ndef DISABLED_LEGACY_ENGINE
+
+// Finds the outlines of all characters of a synthetic page.
+static void BM_BlockEdges(BenchmarkState &state) {
+  Pix *pix = MakeImage(IMAGE_PAGE);
+  int width = pixGetWidth(pix);
+  int height = pixGetHeight(pix);
+  PDBLK block(0, 0, width, height);
+  while (state.KeepRunning()) {
+    C_OUTLINE_LIST outlines;
+    C_OUTLINE_IT outline_it = &outlines;
+    block_edges(pix, &block, &outline_it);
+  }
+  pixDestroy(&pix);
+  state.SetItemsProcessed(state.iterations() * width * height);
+  state.SetLabel("pixels");
+}
+TESS_BENCHMARK(BM_BlockEdges);
+
+// Computes the Otsu threshold of a synthetic page.
+static void BM_OtsuThreshold(BenchmarkState &state) {
+  Pix *pix1 = MakeImage(IMAGE_PAGE);
+  Pix *pix = pixConvert1To8(nullptr, pix1, 255, 0);
+  pixDestroy(&pix1);
+  int width = pixGetWidth(pix);
+  int height = pixGetHeight(pix);
+  while (state.KeepRunning()) {
+    int *thresholds = nullptr;
+    int *hi_values = nullptr;
+    OtsuThreshold(pix, 0, 0, width, height, &thresholds, &hi_values);
+    delete[] thresholds;
+    delete[] hi_values;
+  }
+  pixDestroy(&pix);
+  state.SetItemsProcessed(state.iterations() * width * height);
+  state.SetLabel("pixels");
+}
+TESS_BENCHMARK(BM_OtsuThreshold);
+
+// Looks up all words of a synthetic word list in a dawg made from it.
+static void BM_DawgLookup(BenchmarkState &state) {
+  const int kNumWords = 5000;
+  UNICHARSET unicharset;
+  for (const char *c = kGlyphChars; *c != '\0'; ++c) {
+    unicharset.unichar_insert(std::string(1, *c).c_str());
+  }
+  std::mt19937 random(kCorpusSeed);
+  std::vector<std::string> words;
+  for (int i = 0; i < kNumWords; ++i) {
+    words.push_back(RandomWord(random));
+  }
+  Trie trie(DAWG_TYPE_WORD, "eng", NGRAM_PERM, unicharset.size(), 0);
+  if (!trie.add_word_list(words, unicharset, Trie::RRP_DO_NO_REVERSE)) {
+    state.SkipWithError("cannot build the dawg");
+    return;
+  }
+  std::unique_ptr<SquishedDawg> dawg(trie.trie_to_dawg());
+  std::vector<std::vector<UNICHAR_ID>> word_ids;
+  for (auto &word : words) {
+    std::vector<UNICHAR_ID> ids;
+    for (char c : word) {
+      ids.push_back(unicharset.unichar_to_id(std::string(1, c).c_str()));
+    }
+    word_ids.push_back(ids);
+  }
+  int64_t found = 0;
+  while (state.KeepRunning()) {
+    for (auto &ids : word_ids) {
+      NODE_REF node = 0;
+      for (size_t i = 0; i < ids.size(); ++i) {
+        EDGE_REF edge = dawg->edge_char_of(node, ids[i], i + 1 == ids.size());
+        if (edge == NO_EDGE) {
+          break;
+        }
+        if (i + 1 == ids.size()) {
+          ++found;
+        }
+        node = dawg->next_node(edge);
+      }
+    }
+  }
+  state.counters()["found"] = found;
+  state.SetItemsProcessed(state.iterations() * kNumWords);
+  state.SetLabel("words");
+}
+TESS_BENCHMARK(BM_DawgLookup);
+
+static std::string SimdFeatures() {
+  std::string features;
+  if (SIMDDetect::IsAVX512BWAvailable()) {
+    features += " avx512bw";
+  }
+  if (SIMDDetect::IsAVX2Available()) {
+    features += " avx2";
+  }
+  if (SIMDDetect::IsFMAAvailable()) {
+    features += " fma";
+  }
+  if (SIMDDetect::IsSSEAvailable()) {
+    features += " sse4.1";
+  }
+  if (SIMDDetect::IsNEONAvailable()) {
+    features += " neon";
+  }
+  return features.empty() ? "none" : features.substr(1);
+}
+
+} // namespace tesseract
+
+int main(int argc, char **argv) {
+#ifdef TESSDATA_DIR
+  tesseract::tessdata_dir = TESSDATA_DIR;
+#endif
+  if (getenv("TMPDIR") != nullptr) {
+    tesseract::tmp_dir = getenv("TMPDIR");
+  }
+  // Remove our own options and pass the rest to the harness.
+  std::vector<char *> args;
+  args.push_back(argv[0]);
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--tessdata-dir") == 0 && i + 1 < argc) {
+      tesseract::tessdata_dir = argv[++i];
+    } else if (strcmp(argv[i], "--tmpdir") == 0 && i + 1 < argc) {
+      tesseract::tmp_dir = argv[++i];
+    } else {
+      args.push_back(argv[i]);
+    }
+  }
+  tesseract::RegisterRecognizeBenchmarks();
+  tesseract::RegisterApiBenchmarks();
+  tesseract::RegisterIntSimdMatrixBenchmarks();
+  tesseract::AddBenchmarkContext("version", tesseract::TessBaseAPI::Version());
+  tesseract::AddBenchmarkContext("simd", tesseract::SimdFeatures());
+  tesseract::AddBenchmarkContext("threads",
+                                 std::to_string(std::thread::hardware_concurrency()));
+  tesseract::AddBenchmarkContext("tessdata", tesseract::tessdata_dir);
+  return tesseract::RunBenchmarks(args.size(), &args[0]);
+}
@@ -95,6 +95,42 @@ protected:
     // Compare sum of all results with expected value.
     EXPECT_FLOAT_EQ(total, 337849.39354684710);
   }
+  // Compares the results of matrixDotVectorsFunction for a few inputs at
+  // once against the generic version.
+  void ExpectEqualBatchedResults(const IntSimdMatrix &matrix) {
+    const int kNumRows = 3;
+    for (int num_out = 1; num_out < 130; num_out += 3) {
+      for (int num_in = 1; num_in < 130; num_in += 5) {
+        GENERIC_2D_ARRAY<int8_t> w = InitRandom(num_out, num_in + 1);
+        std::vector<double> scales = RandomScales(num_out);
+        std::vector<int8_t> shaped_wi;
+        int32_t rounded_num_out;
+        matrix.Init(w, shaped_wi, rounded_num_out);
+        scales.resize(rounded_num_out);
+        std::vector<std::vector<int8_t>> inputs;
+        std::vector<std::vector<double>> results;
+        std::vector<const int8_t *> u;
+        std::vector<double *> v;
+        for (int r = 0; r < kNumRows; ++r) {
+          inputs.push_back(RandomVector(num_in, matrix));
+          results.emplace_back(rounded_num_out);
+        }
+        for (int r = 0; r < kNumRows; ++r) {
+          u.push_back(inputs[r].data());
+          v.push_back(results[r].data());
+        }
+        matrix.matrixDotVectorsFunction(w.dim1(), w.dim2(), &shaped_wi[0], &scales[0], kNumRows,
+                                        &u[0], &v[0]);
+        for (int r = 0; r < kNumRows; ++r) {
+          std::vector<double> base_result(num_out);
+          IntSimdMatrix::MatrixDotVector(w, scales, inputs[r].data(), base_result.data());
+          for (int i = 0; i < num_out; ++i) {
+            EXPECT_FLOAT_EQ(base_result[i], results[r][i]) << "r=" << r << " i=" << i;
+          }
+        }
+      }
+    }
+  }
 
   TRand random_;
 };
@@ -133,4 +169,24 @@ TEST_F(IntSimdMatrixTest, AVX2) {
 #endif
 }
 
+// Tests that the variants of the AVX2 implementation get the same results
+// as the vanilla, one input at a time and batched.
+TEST_F(IntSimdMatrixTest, AVX2Variants) {
+#if defined(HAVE_AVX2)
+  if (!SIMDDetect::IsAVX2Available()) {
+    GTEST_LOG_(INFO) << "No AVX2 found! Not tested!";
+    GTEST_SKIP();
+  }
+  for (auto variant = IntSimdMatrix::intSimdMatrixAVX2.variants_; *variant != nullptr; ++variant) {
+    // Restart the random numbers for the expected total.
+    random_ = TRand();
+    ExpectEqualResults(**variant);
+    ExpectEqualBatchedResults(**variant);
+  }
+#else
+  GTEST_LOG_(INFO) << "AVX2 unsupported! Not tested!";
+  GTEST_SKIP();
+#endif
+}
+
 } // namespace tesseract
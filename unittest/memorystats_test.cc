@@ -0,0 +1,101 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Unit test for the memory accounting of MemoryRecorder and MemoryCharge.
+
+#include "memorystats.h"
+
+#include "include_gunit.h"
+
+#include <memory>
+
+namespace tesseract {
+
+TEST(MemoryStatsTest, PeaksOfPageAndTotal) {
+  MemoryRecorder recorder;
+  recorder.Add(MEMORY_IMAGES, 1000);
+  recorder.Add(MEMORY_GRIDS, 500);
+  recorder.Add(MEMORY_GRIDS, -300);
+  const MemoryRecorder::Values &values = recorder.values();
+  EXPECT_EQ(1000u, values.bytes[MEMORY_IMAGES]);
+  EXPECT_EQ(200u, values.bytes[MEMORY_GRIDS]);
+  EXPECT_EQ(500u, values.page_peak[MEMORY_GRIDS]);
+  EXPECT_EQ(500u, values.peak[MEMORY_GRIDS]);
+  EXPECT_EQ(1200u, values.total_bytes);
+  EXPECT_EQ(1500u, values.total_page_peak);
+  EXPECT_EQ(1500u, values.total_peak);
+
+  // A new page starts its peaks at the current bytes, the totals keep theirs.
+  recorder.StartPage();
+  EXPECT_EQ(200u, values.page_peak[MEMORY_GRIDS]);
+  EXPECT_EQ(500u, values.peak[MEMORY_GRIDS]);
+  EXPECT_EQ(1200u, values.total_page_peak);
+  EXPECT_EQ(1500u, values.total_peak);
+  recorder.Set(MEMORY_GRIDS, 400);
+  EXPECT_EQ(400u, values.page_peak[MEMORY_GRIDS]);
+  EXPECT_EQ(500u, values.peak[MEMORY_GRIDS]);
+  EXPECT_EQ(1400u, values.total_page_peak);
+}
+
+TEST(MemoryStatsTest, ResetPeaks) {
+  MemoryRecorder recorder;
+  recorder.Set(MEMORY_PAGE_RES, 800);
+  recorder.Set(MEMORY_PAGE_RES, 100);
+  recorder.ResetPeaks();
+  const MemoryRecorder::Values &values = recorder.values();
+  EXPECT_EQ(100u, values.page_peak[MEMORY_PAGE_RES]);
+  EXPECT_EQ(100u, values.peak[MEMORY_PAGE_RES]);
+  EXPECT_EQ(100u, values.total_page_peak);
+  EXPECT_EQ(100u, values.total_peak);
+  // Frees of memory which was charged before cannot go below zero.
+  recorder.Add(MEMORY_PAGE_RES, -500);
+  EXPECT_EQ(0u, values.bytes[MEMORY_PAGE_RES]);
+  EXPECT_EQ(0u, values.total_bytes);
+}
+
+TEST(MemoryStatsTest, ChargesGoToTheCurrentRecorder) {
+  MemoryRecorder recorder;
+  MemoryCharge outside;
+  outside.Set(MEMORY_GRIDS, 100);
+  EXPECT_EQ(0u, recorder.values().bytes[MEMORY_GRIDS]);
+  {
+    MemoryRecorder::Scope scope(&recorder);
+    MemoryCharge charge;
+    charge.Set(MEMORY_GRIDS, 300);
+    EXPECT_EQ(300u, recorder.values().bytes[MEMORY_GRIDS]);
+    charge.Set(MEMORY_GRIDS, 200);
+    EXPECT_EQ(200u, recorder.values().bytes[MEMORY_GRIDS]);
+    EXPECT_EQ(300u, recorder.values().peak[MEMORY_GRIDS]);
+    MemoryCharge copy(charge);
+    EXPECT_EQ(200u, recorder.values().bytes[MEMORY_GRIDS]);
+  }
+  EXPECT_EQ(nullptr, MemoryRecorder::Current());
+  EXPECT_EQ(0u, recorder.values().bytes[MEMORY_GRIDS]);
+}
+
+// Tests that charges which outlive their recorder release nothing.
+TEST(MemoryStatsTest, ChargesOutliveTheRecorder) {
+  std::unique_ptr<MemoryCharge> charges[3];
+  {
+    MemoryRecorder recorder;
+    MemoryRecorder::Scope scope(&recorder);
+    for (auto &charge : charges) {
+      charge = std::make_unique<MemoryCharge>();
+      charge->Set(MEMORY_GRIDS, 100);
+    }
+    charges[1].reset();
+    EXPECT_EQ(200u, recorder.values().bytes[MEMORY_GRIDS]);
+  }
+  charges[0]->Release();
+  charges[2].reset();
+  charges[0].reset();
+}
+
+} // namespace tesseract
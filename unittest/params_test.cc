@@ -0,0 +1,135 @@
+///////////////////////////////////////////////////////////////////////
+// File:        params_test.cc
+// Description: Tests of the parameter lists and overlays.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <memory> // for std::unique_ptr
+#include <string> // for std::string
+
+#include "include_gunit.h"
+#include "params.h"
+
+namespace tesseract {
+
+// Member params of a fake class, as in Tesseract.
+class ParamsTest : public testing::Test {
+protected:
+  ParamsTest()
+      : INT_MEMBER(test_int, 3, "int", &params_)
+      , BOOL_MEMBER(test_bool, false, "bool", &params_)
+      , STRING_MEMBER(test_string, "abc", "string", &params_)
+      , double_MEMBER(test_double, 0.25, "double", &params_)
+      , INT_INIT_MEMBER(test_init_int, 7, "init int", &params_) {}
+
+  ParamsVectors params_;
+  INT_VAR_H(test_int, 3, "int");
+  BOOL_VAR_H(test_bool, false, "bool");
+  STRING_VAR_H(test_string, "abc", "string");
+  double_VAR_H(test_double, 0.25, "double");
+  INT_VAR_H(test_init_int, 7, "init int");
+};
+
+TEST_F(ParamsTest, FindsMemberParams) {
+  EXPECT_EQ(&test_int, ParamUtils::FindParam<IntParam>("test_int", GlobalParams()->int_params,
+                                                       params_.int_params));
+  EXPECT_EQ(&test_string,
+            ParamUtils::FindParam<StringParam>("test_string", GlobalParams()->string_params,
+                                               params_.string_params));
+  EXPECT_EQ(nullptr, ParamUtils::FindParam<IntParam>("test_bool", GlobalParams()->int_params,
+                                                     params_.int_params));
+  EXPECT_EQ(nullptr, ParamUtils::FindParam<IntParam>("no_such_param", GlobalParams()->int_params,
+                                                     params_.int_params));
+  EXPECT_EQ(2, params_.int_params.size());
+}
+
+TEST_F(ParamsTest, RemovedParamIsReplacedByNamesake) {
+  std::unique_ptr<IntParam> first(new IntParam(1, "test_twin", "", false, &params_));
+  IntParam second(2, "test_twin", "", false, &params_);
+  EXPECT_EQ(first.get(), params_.int_params.find("test_twin"));
+  first.reset();
+  EXPECT_EQ(&second, params_.int_params.find("test_twin"));
+  EXPECT_EQ(3, params_.int_params.size());
+}
+
+TEST_F(ParamsTest, OverlayRevertsChangedParams) {
+  ParamsOverlay overlay;
+  overlay.Add("test_int", "10");
+  overlay.Add("test_bool", "T");
+  overlay.Add("test_string", "xyz");
+  overlay.Add("test_int", "11");
+  overlay.Add("test_init_int", "12");
+  EXPECT_TRUE(overlay.Apply(SET_PARAM_CONSTRAINT_NON_INIT_ONLY, &params_));
+  EXPECT_EQ(11, test_int);
+  EXPECT_TRUE(test_bool);
+  EXPECT_STREQ("xyz", test_string.c_str());
+  EXPECT_EQ(7, test_init_int);
+  EXPECT_EQ(0.25, test_double);
+
+  overlay.Revert();
+  EXPECT_EQ(3, test_int);
+  EXPECT_FALSE(test_bool);
+  EXPECT_STREQ("abc", test_string.c_str());
+
+  // The overlay can be applied again.
+  EXPECT_TRUE(overlay.Apply(SET_PARAM_CONSTRAINT_NONE, &params_));
+  EXPECT_EQ(12, test_init_int);
+  overlay.Revert();
+  EXPECT_EQ(7, test_init_int);
+}
+
+TEST_F(ParamsTest, OverlayReportsUnknownParams) {
+  ParamsOverlay overlay;
+  overlay.Add("no_such_param", "1");
+  overlay.Add("test_int", "5");
+  EXPECT_FALSE(overlay.Apply(SET_PARAM_CONSTRAINT_NONE, &params_));
+  EXPECT_EQ(5, test_int);
+  overlay.Revert();
+  EXPECT_EQ(3, test_int);
+}
+
+TEST_F(ParamsTest, CaptureRestoresAllValues) {
+  test_double = 1.0 / 3.0;
+  ParamsOverlay snapshot = ParamsOverlay::Capture(&params_);
+  test_int = 100;
+  test_string = "";
+  test_double = 2.0;
+  EXPECT_TRUE(snapshot.Apply(SET_PARAM_CONSTRAINT_NONE, &params_));
+  EXPECT_EQ(3, test_int);
+  EXPECT_STREQ("abc", test_string.c_str());
+  EXPECT_EQ(1.0 / 3.0, test_double);
+}
+
+TEST_F(ParamsTest, ChangedParamsAreWrittenAsConfig) {
+  test_int = 4;
+  test_string = "";
+  ParamsOverlay changed = ParamsOverlay::Capture(&params_, true);
+  for (auto &setting : changed.values()) {
+    EXPECT_TRUE(setting.first != "test_bool" && setting.first != "test_double" &&
+                setting.first != "test_init_int")
+        << setting.first;
+  }
+  file::MakeTmpdir();
+  const std::string config = file::JoinPath(FLAGS_test_tmpdir, "changed_params.config");
+  EXPECT_TRUE(changed.WriteFile(config.c_str()));
+
+  test_int = 3;
+  test_string = "abc";
+  ParamsOverlay overlay;
+  EXPECT_TRUE(overlay.ReadFile(config.c_str()));
+  EXPECT_TRUE(overlay.Apply(SET_PARAM_CONSTRAINT_NONE, &params_));
+  EXPECT_EQ(4, test_int);
+  EXPECT_STREQ("", test_string.c_str());
+}
+
+} // namespace tesseract
@@ -0,0 +1,112 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Unit test for the profiling sessions of Profiler.
+
+#include "profiler.h"
+
+#include "include_gunit.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tesseract {
+
+class ProfilerTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    std::locale::global(std::locale(""));
+    file::MakeTmpdir();
+  }
+
+  static std::string TmpPath(const char *name) {
+    return file::JoinPath(FLAGS_test_tmpdir, name);
+  }
+
+  static std::string ReadFile(const std::string &path) {
+    std::string contents;
+    CHECK(file::GetContents(path, &contents, file::Defaults()));
+    return contents;
+  }
+
+  static void Mark(const char *name) {
+    ProfileMarker marker(name);
+  }
+};
+
+TEST_F(ProfilerTest, SessionPathNumbersLaterSessions) {
+  Profiler::Session session;
+  session.serial = 1;
+  EXPECT_EQ("out/trace.json", Profiler::SessionPath("out/trace.json", session));
+  session.serial = 3;
+  EXPECT_EQ("out/trace.3.json", Profiler::SessionPath("out/trace.json", session));
+  EXPECT_EQ("out/stacks.3.folded", Profiler::SessionPath("out/stacks.folded", session));
+  EXPECT_EQ("out.d/trace.3", Profiler::SessionPath("out.d/trace", session));
+}
+
+// Tests that overlapping sessions keep recording until the last one stops
+// and that each one gets only the events after its start.
+TEST_F(ProfilerTest, OverlappingSessions) {
+  EXPECT_FALSE(Profiler::IsRunning());
+  Mark("before_sessions");
+  Profiler::Session outer = Profiler::Start();
+  EXPECT_TRUE(Profiler::IsRunning());
+  Mark("outer_only");
+  Profiler::Session inner = Profiler::Start();
+  EXPECT_NE(outer.serial, inner.serial);
+  Mark("both");
+  const std::string inner_path = TmpPath("profiler_inner.json");
+  ASSERT_TRUE(Profiler::Stop(&inner, inner_path.c_str()));
+  EXPECT_TRUE(Profiler::IsRunning());
+  Mark("after_inner");
+  const std::string outer_path = TmpPath("profiler_outer.json");
+  ASSERT_TRUE(Profiler::Stop(&outer, outer_path.c_str()));
+  EXPECT_FALSE(Profiler::IsRunning());
+
+  const std::string inner_trace = ReadFile(Profiler::SessionPath(inner_path.c_str(), inner));
+  const std::string outer_trace = ReadFile(Profiler::SessionPath(outer_path.c_str(), outer));
+  EXPECT_EQ(std::string::npos, inner_trace.find("before_sessions"));
+  EXPECT_EQ(std::string::npos, inner_trace.find("outer_only"));
+  EXPECT_NE(std::string::npos, inner_trace.find("both"));
+  EXPECT_EQ(std::string::npos, inner_trace.find("after_inner"));
+  EXPECT_EQ(std::string::npos, outer_trace.find("before_sessions"));
+  EXPECT_NE(std::string::npos, outer_trace.find("outer_only"));
+  EXPECT_NE(std::string::npos, outer_trace.find("both"));
+  EXPECT_NE(std::string::npos, outer_trace.find("after_inner"));
+}
+
+// Tests that the events of threads which exit during a session are written,
+// while other threads record at the same time as the session is written.
+TEST_F(ProfilerTest, ThreadsOfASession) {
+  Profiler::Session session = Profiler::Start();
+  std::thread exited([] { Mark("exited_thread"); });
+  exited.join();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([] {
+      for (int j = 0; j < 100000; ++j) {
+        Mark("busy_thread");
+      }
+    });
+  }
+  Profiler::Session other = Profiler::Start();
+  const std::string path = TmpPath("profiler_threads.json");
+  EXPECT_TRUE(Profiler::Stop(&session, path.c_str()));
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ASSERT_TRUE(Profiler::Stop(&other, TmpPath("profiler_other.json").c_str()));
+  EXPECT_FALSE(Profiler::IsRunning());
+  const std::string trace = ReadFile(Profiler::SessionPath(path.c_str(), session));
+  EXPECT_NE(std::string::npos, trace.find("exited_thread"));
+}
+
+} // namespace tesseract
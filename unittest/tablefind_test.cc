@@ -10,6 +10,7 @@
 // limitations under the License.
 
 #include <memory>
+#include <vector>
 
 #include "colpartition.h"
 #include "colpartitiongrid.h"
@@ -22,6 +23,7 @@ namespace tesseract {
 class TestableTableFinder : public tesseract::TableFinder {
 public:
   using TableFinder::GapInXProjection;
+  using TableFinder::gridheight;
   using TableFinder::HasLeaderAdjacent;
   using TableFinder::InsertLeaderPartition;
   using TableFinder::InsertTextPartition;
@@ -29,6 +31,7 @@ public:
   using TableFinder::set_global_median_ledding;
   using TableFinder::set_global_median_xheight;
   using TableFinder::SplitAndInsertFragmentedTextPartition;
+  using TableFinder::TablesArePlausible;
 
   void ExpectPartition(const TBOX &box) {
     tesseract::ColPartitionGridSearch gsearch(&fragmented_text_grid_);
@@ -115,6 +118,35 @@ protected:
     free_boxes_it_.add_after_then_move(part);
   }
 
+  // Inserts a line of text from x_min to x_max with blobs of width 3 every
+  // 5 pixels, leaving out those in [gap_min, gap_max).
+  void InsertTextLine(int x_min, int y_min, int x_max, int y_max, int gap_min, int gap_max) {
+    InsertTextPartition(MakeTextLine(x_min, y_min, x_max, y_max, gap_min, gap_max));
+  }
+
+  // Makes the line of text described above. The caller owns the partition
+  // and its blobs.
+  ColPartition *MakeTextLine(int x_min, int y_min, int x_max, int y_max, int gap_min,
+                             int gap_max) {
+    auto *part = new ColPartition(BRT_UNKNOWN, ICOORD(0, 1));
+    part->set_type(PT_FLOWING_TEXT);
+    part->set_blob_type(BRT_TEXT);
+    part->set_flow(BTFT_CHAIN);
+    part->set_left_margin(x_min);
+    part->set_right_margin(x_max);
+    TBOX blob_box(x_min, y_min, x_max, y_max);
+    for (int i = x_min; i + 4 <= x_max; i += 5) {
+      if (i >= gap_min && i < gap_max) {
+        continue;
+      }
+      blob_box.set_left(i + 1);
+      blob_box.set_right(i + 4);
+      part->AddBox(new BLOBNBOX(C_BLOB::FakeBlob(blob_box)));
+    }
+    part->ComputeLimits();
+    return part;
+  }
+
   void DeletePartitionListBoxes() {
     for (free_boxes_it_.mark_cycle_pt(); !free_boxes_it_.cycled_list(); free_boxes_it_.forward()) {
       ColPartition *part = free_boxes_it_.data();
@@ -273,4 +305,78 @@ TEST_F(TableFinderTest, SplitAndInsertFragmentedPartitionsBasicFail) {
   finder_->ExpectPartitionCount(1);
 }
 
+TEST_F(TableFinderTest, TablesArePlausibleNotOnProse) {
+  finder_->set_global_median_blob_width(3);
+  finder_->set_global_median_xheight(10);
+  EXPECT_FALSE(finder_->TablesArePlausible());
+  // Lines of text without wide gaps, one of which is short.
+  InsertTextLine(10, 100, 300, 110, 0, 0);
+  InsertTextLine(10, 85, 300, 95, 0, 0);
+  InsertTextLine(10, 70, 60, 80, 0, 0);
+  EXPECT_FALSE(finder_->TablesArePlausible());
+}
+
+TEST_F(TableFinderTest, TablesArePlausibleWithLeaders) {
+  InsertLeaderPartition(90, 0, 150, 5);
+  EXPECT_TRUE(finder_->TablesArePlausible());
+}
+
+TEST_F(TableFinderTest, TablesArePlausibleWithGappedRows) {
+  finder_->set_global_median_blob_width(3);
+  finder_->set_global_median_xheight(10);
+  InsertTextLine(10, 100, 300, 110, 100, 200);
+  EXPECT_FALSE(finder_->TablesArePlausible());
+  InsertTextLine(10, 85, 300, 95, 100, 200);
+  EXPECT_TRUE(finder_->TablesArePlausible());
+}
+
+// Runs the whole detection, pre-screen included, on a page with two lines of
+// prose above and below a borderless table of six rows and two columns.
+TEST_F(TableFinderTest, LocateTablesFindsBorderlessTable) {
+  const ICOORD bleft(0, 0);
+  const ICOORD tright(500, 500);
+  ColPartitionGrid page_grid(10, bleft, tright);
+  for (int y : {400, 380, 120, 100}) {
+    page_grid.InsertBBox(true, true, MakeTextLine(20, y, 480, y + 10, 0, 0));
+  }
+  for (int y = 300; y >= 200; y -= 20) {
+    page_grid.InsertBBox(true, true, MakeTextLine(20, y, 480, y + 10, 200, 300));
+  }
+  auto finder = std::make_unique<TestableTableFinder>();
+  finder->Init(10, bleft, tright);
+  finder->set_resolution(300);
+  finder->InsertCleanPartitions(&page_grid, nullptr);
+  // A single column spanning the page.
+  ColPartitionSet column(
+      ColPartition::MakeLinePartition(BRT_TEXT, ICOORD(0, 1), 0, 0, 500, 500));
+  std::vector<ColPartitionSet *> all_columns(finder->gridheight(), &column);
+  finder->LocateTables(&page_grid, &all_columns[0], [](int) { return false; },
+                       FCOORD(1.0f, 0.0f));
+  finder.reset(nullptr);
+
+  std::vector<ColPartition *> parts;
+  ColPartitionGridSearch gsearch(&page_grid);
+  gsearch.SetUniqueMode(true);
+  gsearch.StartFullSearch();
+  ColPartition *part = nullptr;
+  while ((part = gsearch.NextFullSearch()) != nullptr) {
+    parts.push_back(part);
+  }
+  page_grid.Clear();
+  int num_tables = 0;
+  for (auto *found : parts) {
+    if (found->type() == PT_TABLE) {
+      ++num_tables;
+      // The rows, but not the prose, are in the table.
+      const TBOX &box = found->bounding_box();
+      EXPECT_TRUE(box.contains(TBOX(21, 200, 479, 310)));
+      EXPECT_LT(box.top(), 380);
+      EXPECT_GT(box.bottom(), 130);
+    }
+    found->DeleteBoxes();
+    delete found;
+  }
+  EXPECT_EQ(1, num_tables);
+}
+
 } // namespace tesseract